@@ -108,7 +108,8 @@ cmake .. \
     -DUSE_SYSTEM_FTXUI=OFF \
     -DUSE_VENDORED_FTXUI=ON \
     -DUSE_FETCHCONTENT_FTXUI=OFF \
-    -DUSE_SYSTEM_ZXING=OFF
+    -DUSE_SYSTEM_ZXING=OFF \
+    -DAPP_LOG_MIN_LEVEL=INFO
 
 print_status "CMake configuration successful"
 
@@ -4,6 +4,7 @@ type IncomingPayload = {
   type?: string | number;
   version?: string;
   data?: {
+    raw?: string;
     hash?: string;
     signature?: { r: `0x${string}`; s: `0x${string}`; v: number };
     transaction?: {
@@ -20,6 +21,101 @@ type IncomingPayload = {
   };
 };
 
+// Raw transaction for one signer envelope: its own `raw` if it has one,
+// else serialized from the transaction fields and signature
+function rawTxFromPayload(payload: IncomingPayload | null): { rawTx?: string; error?: string } {
+  const raw = payload?.data?.raw;
+  if (typeof raw === "string" && raw.startsWith("0x")) {
+    return { rawTx: raw.trim() };
+  }
+
+  const t = payload?.data?.transaction;
+  const sig = payload?.data?.signature;
+  if (!t || !sig || !t.to || t.value == null || t.nonce == null) {
+    return { error: "Incomplete payload: missing transaction or signature" };
+  }
+
+  const isEip1559 =
+    t.maxFeePerGas != null && t.maxPriorityFeePerGas != null;
+  if (isEip1559) {
+    const tx = {
+      type: "eip1559" as const,
+      chainId: t.chainId ?? 1,
+      to: t.to,
+      value: BigInt(t.value),
+      nonce: t.nonce,
+      gas: BigInt(t.gasLimit ?? 21000),
+      maxFeePerGas: BigInt(t.maxFeePerGas!),
+      maxPriorityFeePerGas: BigInt(t.maxPriorityFeePerGas!),
+      data: (t.data ?? "0x") as `0x${string}`,
+    };
+    return {
+      rawTx: serializeTransaction(tx, {
+        v: BigInt(sig.v),
+        r: sig.r,
+        s: sig.s,
+      }),
+    };
+  }
+  const tx = {
+    type: "legacy" as const,
+    chainId: t.chainId ?? 1,
+    to: t.to,
+    value: BigInt(t.value),
+    nonce: t.nonce,
+    gas: BigInt(t.gasLimit ?? 21000),
+    gasPrice: BigInt(t.gasPrice ?? 0),
+    data: (t.data ?? "0x") as `0x${string}`,
+  };
+  return {
+    rawTx: serializeTransaction(tx, {
+      v: BigInt(sig.v),
+      r: sig.r,
+      s: sig.s,
+    }),
+  };
+}
+
+async function sendRawTransaction(rawTx: string): Promise<{ txHash?: string; error?: string }> {
+  const rpcUrl =
+    process.env.NEXT_PUBLIC_BASE_RPC_URL || "https://base.llamarpc.com";
+
+  const payload = {
+    jsonrpc: "2.0",
+    id: Date.now(),
+    method: "eth_sendRawTransaction",
+    params: [rawTx],
+  };
+
+  const rpcResponse = await fetch(rpcUrl, {
+    method: "POST",
+    headers: { "Content-Type": "application/json" },
+    body: JSON.stringify(payload),
+    // Avoid Next.js caching for RPC calls
+    cache: "no-store",
+  });
+
+  const contentType = rpcResponse.headers.get("content-type") || "";
+  const bodyText = await rpcResponse.text();
+
+  let responseJson: { result?: string; error?: { message?: string } } | null =
+    null;
+  if (contentType.includes("application/json")) {
+    try {
+      responseJson = JSON.parse(bodyText);
+    } catch {
+      // fall through to text error handling
+    }
+  }
+
+  if (rpcResponse.ok && responseJson && responseJson.result) {
+    console.log("Broadcasted tx:", responseJson.result);
+    return { txHash: responseJson.result };
+  }
+
+  return { error: responseJson?.error?.message || bodyText || "Broadcast failed" };
+}
+
 export async function POST(request: Request) {
   try {
     const body = await request.json();
@@ -27,7 +123,7 @@ export async function POST(request: Request) {
 
     // If rawTx is not provided, try to construct it from structured payload
     if (!rawTx && body?.payload) {
-      let payload: IncomingPayload | null = null;
+      let payload: IncomingPayload | IncomingPayload[] | null = null;
       try {
         payload =
           typeof body.payload === "string"
@@ -40,51 +136,38 @@ export async function POST(request: Request) {
         );
       }
 
-      const t = payload?.data?.transaction;
-      const sig = payload?.data?.signature;
-      if (!t || !sig || !t.to || t.value == null || t.nonce == null) {
-        return Response.json(
-          { error: "Incomplete payload: missing transaction or signature" },
-          { status: 400 },
-        );
+      // A signing batch is an array of envelopes in nonce order. They are
+      // sent one at a time and the first failure stops the rest, since
+      // every later nonce would only wait on the missing one.
+      if (Array.isArray(payload)) {
+        if (payload.length === 0) {
+          return Response.json({ error: "Empty batch" }, { status: 400 });
+        }
+        const txHashes: string[] = [];
+        for (let i = 0; i < payload.length; i++) {
+          const built = rawTxFromPayload(payload[i]);
+          const sent: { txHash?: string; error?: string } = built.rawTx
+            ? await sendRawTransaction(built.rawTx)
+            : { error: built.error };
+          if (!sent.txHash) {
+            return Response.json(
+              {
+                error: `Transaction ${i + 1} of ${payload.length}: ${sent.error}`,
+                txHashes,
+              },
+              { status: built.rawTx ? 500 : 400 },
+            );
+          }
+          txHashes.push(sent.txHash);
+        }
+        return Response.json({ txHash: txHashes[0], txHashes });
       }
 
-      const isEip1559 =
-        t.maxFeePerGas != null && t.maxPriorityFeePerGas != null;
-      if (isEip1559) {
-        const tx = {
-          type: "eip1559" as const,
-          chainId: t.chainId ?? 1,
-          to: t.to,
-          value: BigInt(t.value),
-          nonce: t.nonce,
-          gas: BigInt(t.gasLimit ?? 21000),
-          maxFeePerGas: BigInt(t.maxFeePerGas!),
-          maxPriorityFeePerGas: BigInt(t.maxPriorityFeePerGas!),
-          data: (t.data ?? "0x") as `0x${string}`,
-        };
-        rawTx = serializeTransaction(tx, {
-          v: BigInt(sig.v),
-          r: sig.r,
-          s: sig.s,
-        });
-      } else {
-        const tx = {
-          type: "legacy" as const,
-          chainId: t.chainId ?? 1,
-          to: t.to,
-          value: BigInt(t.value),
-          nonce: t.nonce,
-          gas: BigInt(t.gasLimit ?? 21000),
-          gasPrice: BigInt(t.gasPrice ?? 0),
-          data: (t.data ?? "0x") as `0x${string}`,
-        };
-        rawTx = serializeTransaction(tx, {
-          v: BigInt(sig.v),
-          r: sig.r,
-          s: sig.s,
-        });
+      const built = rawTxFromPayload(payload);
+      if (!built.rawTx) {
+        return Response.json({ error: built.error }, { status: 400 });
       }
+      rawTx = built.rawTx;
     }
 
     if (!rawTx) {
@@ -94,45 +177,11 @@ export async function POST(request: Request) {
       );
     }
 
-    const rpcUrl =
-      process.env.NEXT_PUBLIC_BASE_RPC_URL || "https://base.llamarpc.com";
-
-    const payload = {
-      jsonrpc: "2.0",
-      id: Date.now(),
-      method: "eth_sendRawTransaction",
-      params: [rawTx],
-    };
-
-    const rpcResponse = await fetch(rpcUrl, {
-      method: "POST",
-      headers: { "Content-Type": "application/json" },
-      body: JSON.stringify(payload),
-      // Avoid Next.js caching for RPC calls
-      cache: "no-store",
-    });
-
-    const contentType = rpcResponse.headers.get("content-type") || "";
-    const bodyText = await rpcResponse.text();
-
-    let responseJson: { result?: string; error?: { message?: string } } | null =
-      null;
-    if (contentType.includes("application/json")) {
-      try {
-        responseJson = JSON.parse(bodyText);
-      } catch {
-        // fall through to text error handling
-      }
-    }
-
-    if (rpcResponse.ok && responseJson && responseJson.result) {
-      console.log("Broadcasted tx:", responseJson.result);
-      return Response.json({ txHash: responseJson.result });
+    const sent = await sendRawTransaction(rawTx);
+    if (sent.txHash) {
+      return Response.json({ txHash: sent.txHash });
     }
-
-    const errorMessage =
-      responseJson?.error?.message || bodyText || "Broadcast failed";
-    return Response.json({ error: errorMessage }, { status: 500 });
+    return Response.json({ error: sent.error }, { status: 500 });
   } catch (error) {
     return Response.json(
       { error: error instanceof Error ? error.message : "Unknown error" },
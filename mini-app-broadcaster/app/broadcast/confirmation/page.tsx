@@ -9,9 +9,12 @@ export default async function BroadcastConfirmationPage({
 }) {
   const params = await searchParams;
   const txHashParam = params?.txHash;
-  const txHash = Array.isArray(txHashParam)
-    ? txHashParam[0]
-    : txHashParam || "";
+  // A broadcast batch passes one txHash per transaction, in nonce order
+  const txHashes = Array.isArray(txHashParam)
+    ? txHashParam
+    : txHashParam
+      ? [txHashParam]
+      : [""];
 
   type GlobalWithProcess = typeof globalThis & {
     process?: { env?: { NEXT_PUBLIC_BASESCAN_URL?: string } };
@@ -19,40 +22,45 @@ export default async function BroadcastConfirmationPage({
   const basescanBaseUrl =
     (globalThis as GlobalWithProcess).process?.env?.NEXT_PUBLIC_BASESCAN_URL ??
     "https://basescan.org";
-  const basescanTxUrl = txHash
-    ? `${basescanBaseUrl}/tx/${txHash}`
-    : basescanBaseUrl;
+  const basescanTxUrl = (txHash: string) =>
+    txHash ? `${basescanBaseUrl}/tx/${txHash}` : basescanBaseUrl;
 
   return (
     <div className="min-h-screen bg-background text-foreground">
       <div className="w-full max-w-md mx-auto px-4 py-8">
         <h1 className="text-2xl font-bold mb-6 text-center">
-          Transaction sent successfully
+          {txHashes.length > 1
+            ? `${txHashes.length} transactions sent successfully`
+            : "Transaction sent successfully"}
         </h1>
 
         <div className="rounded-xl overflow-hidden border border-[var(--app-card-border)] bg-[var(--app-card-bg)] shadow">
           <div className="px-4 py-2 border-b border-[var(--app-card-border)] text-xs text-[var(--app-foreground-muted)]">
             Transaction details
           </div>
-          <div className="p-4">
-            <div className="flex items-start gap-3">
-              <div className="flex-1 min-w-0">
-                <div className="text-xs text-[var(--app-foreground-muted)] mb-1">
-                  Transaction hash
-                </div>
-                <div className="font-mono text-sm break-all">
-                  {txHash || "—"}
+          <div className="p-4 space-y-4">
+            {txHashes.map((txHash, index) => (
+              <div key={`${index}-${txHash}`} className="flex items-start gap-3">
+                <div className="flex-1 min-w-0">
+                  <div className="text-xs text-[var(--app-foreground-muted)] mb-1">
+                    {txHashes.length > 1
+                      ? `Transaction hash ${index + 1} of ${txHashes.length}`
+                      : "Transaction hash"}
+                  </div>
+                  <div className="font-mono text-sm break-all">
+                    {txHash || "—"}
+                  </div>
                 </div>
+                <a
+                  href={basescanTxUrl(txHash)}
+                  target="_blank"
+                  rel="noopener noreferrer"
+                  className="shrink-0 inline-flex items-center gap-2 bg-[var(--app-accent)] hover:bg-[var(--app-accent-hover)] text-white px-3 py-2 rounded-lg"
+                >
+                  View on Basescan
+                </a>
               </div>
-              <a
-                href={basescanTxUrl}
-                target="_blank"
-                rel="noopener noreferrer"
-                className="shrink-0 inline-flex items-center gap-2 bg-[var(--app-accent)] hover:bg-[var(--app-accent-hover)] text-white px-3 py-2 rounded-lg"
-              >
-                View on Basescan
-              </a>
-            </div>
+            ))}
           </div>
         </div>
 
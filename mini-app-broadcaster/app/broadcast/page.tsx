@@ -19,6 +19,8 @@ export default function BroadcastPage() {
   const [error, setError] = useState<string | null>(null);
   const [txHash, setTxHash] = useState<string | null>(null);
   const [metadata, setMetadata] = useState<PayloadMetadata | null>(null);
+  // Envelopes in a signing batch; 0 for a single transaction
+  const [batchSize, setBatchSize] = useState(0);
   const router = useRouter();
 
   useEffect(() => {
@@ -46,6 +48,7 @@ export default function BroadcastPage() {
       try {
         const parsed = JSON.parse(value);
         setDisplayPayload(JSON.stringify(parsed, null, 2));
+        setBatchSize(Array.isArray(parsed) ? parsed.length : 0);
         const maybeRaw = parsed?.data?.raw;
         if (typeof maybeRaw === "string" && maybeRaw.startsWith("0x")) {
           setRawTx(maybeRaw.trim());
@@ -84,12 +87,21 @@ export default function BroadcastPage() {
           cache: "no-store",
         });
         const json = await res.json();
+        // A batch reports the hashes it sent, also when it stopped early
+        const txHashes: string[] = Array.isArray(json?.txHashes)
+          ? json.txHashes
+          : json?.txHash
+            ? [json.txHash]
+            : [];
         if (!res.ok) {
+          if (txHashes.length > 0) setTxHash(txHashes.join(", "));
           throw new Error(json?.error || "Broadcast failed");
         }
-        setTxHash(json.txHash);
-        console.log("Broadcast successful:", json.txHash);
-        const url = `/broadcast/confirmation?txHash=${encodeURIComponent(json.txHash)}`;
+        setTxHash(txHashes.join(", "));
+        console.log("Broadcast successful:", txHashes);
+        const url = `/broadcast/confirmation?${txHashes
+          .map((hash) => `txHash=${encodeURIComponent(hash)}`)
+          .join("&")}`;
         try {
           router.push(url);
         } catch {}
@@ -143,6 +155,12 @@ export default function BroadcastPage() {
             </div>
           )}
           
+          {batchSize > 0 && (
+            <div className="mb-4 rounded-xl border border-blue-300 bg-blue-50 px-4 py-2 text-sm text-blue-900 shadow">
+              Batch of {batchSize} signed transactions, broadcast in nonce order. Sending stops at the first one the network rejects.
+            </div>
+          )}
+
           {displayPayload ? (
             <div className="mb-4 rounded-xl overflow-hidden border border-[var(--app-card-border)] bg-[var(--app-card-bg)] shadow">
               <div className="px-4 py-2 border-b border-[var(--app-card-border)] text-xs text-[var(--app-foreground-muted)]">
@@ -178,7 +196,7 @@ export default function BroadcastPage() {
                 onClick={handleBroadcast}
                 disabled={isSubmitting || (!rawTx && !displayPayload)}
               >
-                {isSubmitting ? "Broadcasting..." : "Broadcast"}
+                {isSubmitting ? "Broadcasting..." : batchSize > 0 ? `Broadcast ${batchSize}` : "Broadcast"}
               </button>
             </div>
           </div>
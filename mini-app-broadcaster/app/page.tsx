@@ -36,6 +36,8 @@ import {
   hasMultiQRTimedOut,
   createPayloadMetadata
 } from "@/lib/multi-qr";
+import { decodeQRPayload } from "@/lib/qr-payload";
+import { FountainDecoder, parseFountainFrame } from "@/lib/fountain";
 
 // Minimal typings for the BarcodeDetector API to avoid 'any'
 type QRDetector = {
@@ -63,6 +65,7 @@ export default function App() {
   const canvasRef = useRef<HTMLCanvasElement | null>(null);
   const zxingReaderRef = useRef<BrowserQRCodeReader | null>(null);
   const zxingAbortRef = useRef<AbortController | null>(null);
+  const fountainDecoderRef = useRef<FountainDecoder | null>(null);
   
   // Multi-QR state
   const [scanningMode, setScanningMode] = useState<'single' | 'multi'>('single');
@@ -122,6 +125,43 @@ export default function App() {
   const handleQRDetection = useCallback((value: string) => {
     console.log('QR detected:', value);
     
+    // Fountain-coded animated QR: any large enough subset of frames completes it
+    const fountainFrame = parseFountainFrame(value);
+    if (fountainFrame) {
+      if (!fountainDecoderRef.current) {
+        fountainDecoderRef.current = new FountainDecoder();
+      }
+      const decoder = fountainDecoderRef.current;
+      try {
+        if (!decoder.receive(fountainFrame)) return;
+      } catch (error) {
+        console.error('Failed to decode animated QR:', error);
+        fountainDecoderRef.current = null;
+        setToastMessage({ 
+          message: 'Animated QR decode failed. Please rescan.', 
+          type: 'error' 
+        });
+        return;
+      }
+
+      const payload = decoder.payload;
+      if (payload !== null) {
+        fountainDecoderRef.current = null;
+        setDecodedPayload(payload);
+        try {
+          sessionStorage.setItem("decodedPayload", payload);
+        } catch {}
+        closeScanner();
+        router.push("/broadcast");
+      } else {
+        setToastMessage({ 
+          message: `Animated QR ${Math.round(decoder.progress * 100)}% received`, 
+          type: 'success' 
+        });
+      }
+      return;
+    }
+    
     // Try to parse as multi-part QR
     const qrPart = parseQRValue(value);
     
@@ -153,9 +193,20 @@ export default function App() {
     } else {
       // Single QR code (current flow)
       console.log('Single QR detected');
-      setDecodedPayload(value);
+      let payload: string;
+      try {
+        payload = decodeQRPayload(value);
+      } catch (error) {
+        console.error('Failed to decompress QR payload:', error);
+        setToastMessage({ 
+          message: 'Corrupt compressed QR code. Please rescan.', 
+          type: 'error' 
+        });
+        return;
+      }
+      setDecodedPayload(payload);
       try {
-        sessionStorage.setItem("decodedPayload", value);
+        sessionStorage.setItem("decodedPayload", payload);
       } catch {}
       closeScanner();
       router.push("/broadcast");
@@ -183,12 +234,19 @@ export default function App() {
   // Handle multi-QR completion
   const handleMultiQRComplete = useCallback(() => {
     if (multiQRState.isComplete && multiQRState.assembledData) {
-      if (validateAssembledData(multiQRState.assembledData)) {
+      let payload: string | null = null;
+      try {
+        payload = decodeQRPayload(multiQRState.assembledData);
+      } catch (error) {
+        console.error('Failed to decompress assembled payload:', error);
+      }
+
+      if (payload && validateAssembledData(payload)) {
         // Store assembled data with metadata
         const metadata = createPayloadMetadata(multiQRState);
         
         try {
-          sessionStorage.setItem("decodedPayload", multiQRState.assembledData);
+          sessionStorage.setItem("decodedPayload", payload);
           sessionStorage.setItem("payloadMetadata", JSON.stringify(metadata));
         } catch {}
         
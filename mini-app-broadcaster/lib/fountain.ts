@@ -0,0 +1,249 @@
+/**
+ * Fountain-Coded QR Decoder for BaseOS Mobile App
+ * Reassembles rateless "F:" frames cycled by the BaseOS desktop application.
+ * Any sufficiently large subset of frames is enough; order and gaps don't matter.
+ * Must mirror ui/tui/src/fountain.cpp exactly (PRNG, degree sampling, layout).
+ */
+
+import { base45Decode, zlibInflate, TX_ENVELOPE_DICTIONARY } from "./qr-payload";
+
+export const FOUNTAIN_FRAME_PREFIX = "F:";
+const HEADER_SIZE = 13;
+const FLAG_DEFLATED = 0x01;
+
+export type FountainFrame = {
+  seq: number;
+  messageLength: number;
+  checksum: number;
+  flags: number;
+  block: Uint8Array;
+};
+
+// Row of the GF(2) system: which fragments are XORed together, and their XOR
+type Row = {
+  mask: Uint8Array;
+  data: Uint8Array;
+};
+
+let crcTable: Uint32Array | null = null;
+
+/**
+ * CRC-32 (IEEE 802.3, as used by zlib/PNG)
+ */
+export function crc32(data: Uint8Array): number {
+  if (!crcTable) {
+    crcTable = new Uint32Array(256);
+    for (let i = 0; i < 256; i++) {
+      let c = i;
+      for (let k = 0; k < 8; k++) c = c & 1 ? 0xedb88320 ^ (c >>> 1) : c >>> 1;
+      crcTable[i] = c >>> 0;
+    }
+  }
+  let crc = 0xffffffff;
+  for (let i = 0; i < data.length; i++) crc = crcTable[(crc ^ data[i]) & 0xff] ^ (crc >>> 8);
+  return (crc ^ 0xffffffff) >>> 0;
+}
+
+// mulberry32, identical to FountainRng in fountain.cpp
+function createRng(seed: number): () => number {
+  let state = seed >>> 0;
+  return () => {
+    state = (state + 0x6d2b79f5) >>> 0;
+    let t = Math.imul(state ^ (state >>> 15), 1 | state);
+    t = ((t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t) >>> 0;
+    return (t ^ (t >>> 14)) >>> 0;
+  };
+}
+
+/**
+ * Fragment indexes XORed into frame `seq`
+ */
+export function fountainFragmentIndexes(seq: number, fragmentCount: number, checksum: number): number[] {
+  if (fragmentCount === 0 || seq === 0) return [];
+  if (seq <= fragmentCount) return [seq - 1];
+
+  // Each fragment joins with probability 1/2, one PRNG bit per fragment
+  const rng = createRng((Math.imul(seq, 0x9e3779b9) ^ checksum) >>> 0);
+  const indexes: number[] = [];
+  for (let base = 0; base < fragmentCount; base += 32) {
+    const bits = rng();
+    const span = Math.min(32, fragmentCount - base);
+    for (let b = 0; b < span; b++) {
+      if ((bits >>> b) & 1) indexes.push(base + b);
+    }
+  }
+  if (indexes.length === 0) indexes.push(rng() % fragmentCount);
+  return indexes;
+}
+
+/**
+ * Check whether a scanned value is a fountain frame
+ */
+export function isFountainFrame(value: string): boolean {
+  return value.startsWith(FOUNTAIN_FRAME_PREFIX);
+}
+
+/**
+ * Parse a fountain frame; returns null for anything malformed
+ */
+export function parseFountainFrame(value: string): FountainFrame | null {
+  if (!isFountainFrame(value)) return null;
+
+  let bytes: Uint8Array;
+  try {
+    bytes = base45Decode(value.slice(FOUNTAIN_FRAME_PREFIX.length));
+  } catch {
+    return null;
+  }
+  if (bytes.length <= HEADER_SIZE) return null;
+
+  const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  const seq = view.getUint32(0);
+  if (seq === 0) return null;
+
+  return {
+    seq,
+    messageLength: view.getUint32(4),
+    checksum: view.getUint32(8),
+    flags: bytes[12],
+    block: bytes.slice(HEADER_SIZE),
+  };
+}
+
+function xorInto(target: Uint8Array, source: Uint8Array): void {
+  for (let i = 0; i < target.length; i++) target[i] ^= source[i];
+}
+
+function lowestSetBit(mask: Uint8Array, from: number): number {
+  for (let byte = from >> 3; byte < mask.length; byte++) {
+    let bits = mask[byte];
+    if (byte === from >> 3) bits &= 0xff << (from & 7);
+    if (bits) return byte * 8 + (31 - Math.clz32(bits & -bits));
+  }
+  return -1;
+}
+
+/**
+ * Fountain decoder using online Gaussian elimination over GF(2). Completes as
+ * soon as the received combinations reach full rank, typically one or two
+ * frames beyond the fragment count regardless of which frames were missed.
+ */
+export class FountainDecoder {
+  private checksum: number | null = null;
+  private messageLength = 0;
+  private flags = 0;
+  private fragmentSize = 0;
+  private fragmentCount = 0;
+  private pivots: (Row | null)[] = [];
+  private rank = 0;
+  private seen = new Set<number>();
+  private result: string | null = null;
+
+  readonly scanStartTime = Date.now();
+  lastScanTime = 0;
+
+  /**
+   * Feed a frame. Returns true if it was new and belongs to the current
+   * message. A frame from a different message resets the decoder.
+   */
+  receive(frame: FountainFrame): boolean {
+    this.lastScanTime = Date.now();
+    if (this.checksum !== frame.checksum || this.messageLength !== frame.messageLength) {
+      this.reset(frame);
+    }
+    if (frame.block.length !== this.fragmentSize || this.seen.has(frame.seq) || this.isComplete) {
+      return false;
+    }
+    this.seen.add(frame.seq);
+
+    const row: Row = {
+      mask: new Uint8Array((this.fragmentCount + 7) >> 3),
+      data: frame.block.slice(),
+    };
+    for (const index of fountainFragmentIndexes(frame.seq, this.fragmentCount, frame.checksum)) {
+      row.mask[index >> 3] |= 1 << (index & 7);
+    }
+
+    // Forward-eliminate against existing pivots; each pivot row only has bits
+    // at or above its pivot, so scanning upwards never revisits a column.
+    for (let col = lowestSetBit(row.mask, 0); col >= 0; col = lowestSetBit(row.mask, col)) {
+      const pivot = this.pivots[col];
+      if (!pivot) {
+        this.pivots[col] = row;
+        this.rank++;
+        break;
+      }
+      xorInto(row.mask, pivot.mask);
+      xorInto(row.data, pivot.data);
+    }
+
+    if (this.rank === this.fragmentCount) this.finish();
+    return true;
+  }
+
+  get isComplete(): boolean {
+    return this.result !== null;
+  }
+
+  /** Decoded payload, once complete */
+  get payload(): string | null {
+    return this.result;
+  }
+
+  /** Fraction of independent fragment combinations received so far, 0..1 */
+  get progress(): number {
+    return this.fragmentCount ? this.rank / this.fragmentCount : 0;
+  }
+
+  get framesReceived(): number {
+    return this.seen.size;
+  }
+
+  get expectedFragments(): number {
+    return this.fragmentCount;
+  }
+
+  private reset(frame: FountainFrame): void {
+    this.checksum = frame.checksum;
+    this.messageLength = frame.messageLength;
+    this.flags = frame.flags;
+    this.fragmentSize = frame.block.length;
+    this.fragmentCount = Math.max(1, Math.ceil(frame.messageLength / this.fragmentSize));
+    this.clearRows();
+    this.result = null;
+  }
+
+  private clearRows(): void {
+    this.pivots = new Array(this.fragmentCount).fill(null);
+    this.rank = 0;
+    this.seen.clear();
+  }
+
+  private finish(): void {
+    // Back-substitute from the last column so each pivot row ends up holding
+    // exactly its own fragment
+    for (let col = this.fragmentCount - 1; col >= 0; col--) {
+      const row = this.pivots[col]!;
+      for (let other = lowestSetBit(row.mask, col + 1); other >= 0; other = lowestSetBit(row.mask, other + 1)) {
+        const below = this.pivots[other]!;
+        xorInto(row.mask, below.mask);
+        xorInto(row.data, below.data);
+      }
+    }
+
+    const message = new Uint8Array(this.fragmentCount * this.fragmentSize);
+    this.pivots.forEach((row, i) => message.set(row!.data, i * this.fragmentSize));
+    const body = message.subarray(0, this.messageLength);
+
+    if (crc32(body) !== this.checksum) {
+      // Corrupt frame slipped through QR error correction; start over
+      this.clearRows();
+      return;
+    }
+
+    const bytes = this.flags & FLAG_DEFLATED
+      ? zlibInflate(body, new TextEncoder().encode(TX_ENVELOPE_DICTIONARY))
+      : body;
+    this.result = new TextDecoder().decode(bytes);
+  }
+}
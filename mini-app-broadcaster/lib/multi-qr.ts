@@ -122,15 +122,16 @@ export function validateAssembledData(data: string): boolean {
   if (!data || data.length === 0) return false;
   
   try {
-    // Try to parse as JSON transaction
+    // Try to parse as JSON transaction, or a signing batch of them
     const parsed = JSON.parse(data);
+    const envelopes = Array.isArray(parsed) ? parsed : [parsed];
     
     // Check for required transaction fields
-    return !!(
-      parsed?.type &&
-      parsed?.data?.transaction &&
-      parsed?.data?.signature
-    );
+    return envelopes.length > 0 && envelopes.every((envelope) => !!(
+      envelope?.type &&
+      envelope?.data?.transaction &&
+      envelope?.data?.signature
+    ));
   } catch {
     // Could be raw hex transaction
     return data.startsWith('0x') && data.length > 10;
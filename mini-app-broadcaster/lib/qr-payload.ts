@@ -0,0 +1,296 @@
+/**
+ * Compressed QR Payload Decoder for BaseOS Mobile App
+ * Decodes "Z:" payloads produced by the BaseOS desktop application:
+ * Base45 text wrapping a zlib (deflate) stream, optionally primed with a
+ * preset dictionary of the signed-transaction JSON envelope.
+ */
+
+export const COMPRESSED_PAYLOAD_PREFIX = "Z:";
+
+/**
+ * Preset dictionary; must stay byte-identical to TxEnvelopeDictionary()
+ * in ui/tui/src/payload_codec.cpp.
+ */
+export const TX_ENVELOPE_DICTIONARY =
+  '"maxPriorityFeePerGas":"0x","maxFeePerGas":"0x","type":2,' +
+  "0123456789abcdef0123456789ABCDEF" +
+  '"nonce":,"gasPrice":"0x","gasLimit":"0x5208","data":"0x","chainId":8453},' +
+  '"timestamp":17,"network":"base"},"checksum":"' +
+  '{"type":"1","version":"1.0","data":{"hash":"0x' +
+  '","signature":{"r":"0x","s":"0x","v":"0x"},' +
+  '"transaction":{"to":"0x","value":"0x';
+
+const BASE45_ALPHABET = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ $%*+-./:";
+
+/**
+ * Decode RFC 9285 Base45 text into bytes
+ */
+export function base45Decode(text: string): Uint8Array {
+  if (text.length % 3 === 1) {
+    throw new Error("Invalid Base45 length");
+  }
+
+  const out = new Uint8Array(Math.floor(text.length / 3) * 2 + (text.length % 3 === 2 ? 1 : 0));
+  let o = 0;
+  for (let i = 0; i < text.length; i += 3) {
+    const group = Math.min(3, text.length - i);
+    let n = 0;
+    let scale = 1;
+    for (let j = 0; j < group; j++) {
+      const v = BASE45_ALPHABET.indexOf(text[i + j]);
+      if (v < 0) throw new Error("Invalid Base45 character");
+      n += v * scale;
+      scale *= 45;
+    }
+    if (group === 3) {
+      if (n > 0xffff) throw new Error("Invalid Base45 group");
+      out[o++] = n >> 8;
+      out[o++] = n & 0xff;
+    } else {
+      if (n > 0xff) throw new Error("Invalid Base45 group");
+      out[o++] = n;
+    }
+  }
+  return out;
+}
+
+// ---------------------------------------------------------------------------
+// Minimal inflate (RFC 1950/1951) with preset dictionary support
+// ---------------------------------------------------------------------------
+
+type Huffman = { counts: Uint16Array; symbols: Uint16Array };
+
+const LENGTH_BASE = [3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258];
+const LENGTH_EXTRA = [0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0];
+const DIST_BASE = [1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+  257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577];
+const DIST_EXTRA = [0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+  7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13];
+const CODE_LENGTH_ORDER = [16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15];
+
+function buildHuffman(lengths: ArrayLike<number>, offset: number, count: number): Huffman {
+  const counts = new Uint16Array(16);
+  const symbols = new Uint16Array(count);
+  for (let i = 0; i < count; i++) counts[lengths[offset + i]]++;
+  counts[0] = 0;
+
+  const offs = new Uint16Array(16);
+  for (let i = 1; i < 16; i++) offs[i] = offs[i - 1] + counts[i - 1];
+  for (let i = 0; i < count; i++) {
+    const len = lengths[offset + i];
+    if (len) symbols[offs[len]++] = i;
+  }
+  return { counts, symbols };
+}
+
+class BitReader {
+  private pos = 0;
+  private bitBuf = 0;
+  private bitCount = 0;
+
+  constructor(private readonly data: Uint8Array, start: number) {
+    this.pos = start;
+  }
+
+  bits(n: number): number {
+    while (this.bitCount < n) {
+      if (this.pos >= this.data.length) throw new Error("Unexpected end of deflate stream");
+      this.bitBuf |= this.data[this.pos++] << this.bitCount;
+      this.bitCount += 8;
+    }
+    const value = this.bitBuf & ((1 << n) - 1);
+    this.bitBuf >>>= n;
+    this.bitCount -= n;
+    return value;
+  }
+
+  alignToByte(): void {
+    this.bitBuf = 0;
+    this.bitCount = 0;
+  }
+
+  byte(): number {
+    if (this.pos >= this.data.length) throw new Error("Unexpected end of deflate stream");
+    return this.data[this.pos++];
+  }
+
+  decode(h: Huffman): number {
+    let code = 0;
+    let first = 0;
+    let index = 0;
+    for (let len = 1; len < 16; len++) {
+      code |= this.bits(1);
+      const count = h.counts[len];
+      if (code - count < first) return h.symbols[index + (code - first)];
+      index += count;
+      first = (first + count) << 1;
+      code <<= 1;
+    }
+    throw new Error("Invalid Huffman code");
+  }
+
+  get offset(): number {
+    return this.pos;
+  }
+}
+
+let fixedTables: { lit: Huffman; dist: Huffman } | null = null;
+
+function getFixedTables(): { lit: Huffman; dist: Huffman } {
+  if (!fixedTables) {
+    const lengths = new Uint8Array(288 + 30);
+    lengths.fill(8, 0, 144);
+    lengths.fill(9, 144, 256);
+    lengths.fill(7, 256, 280);
+    lengths.fill(8, 280, 288);
+    lengths.fill(5, 288, 318);
+    fixedTables = { lit: buildHuffman(lengths, 0, 288), dist: buildHuffman(lengths, 288, 30) };
+  }
+  return fixedTables;
+}
+
+function readDynamicTables(br: BitReader): { lit: Huffman; dist: Huffman } {
+  const hlit = br.bits(5) + 257;
+  const hdist = br.bits(5) + 1;
+  const hclen = br.bits(4) + 4;
+
+  const codeLengths = new Uint8Array(19);
+  for (let i = 0; i < hclen; i++) codeLengths[CODE_LENGTH_ORDER[i]] = br.bits(3);
+  const codeTable = buildHuffman(codeLengths, 0, 19);
+
+  const lengths = new Uint8Array(hlit + hdist);
+  for (let i = 0; i < hlit + hdist;) {
+    const sym = br.decode(codeTable);
+    if (sym < 16) {
+      lengths[i++] = sym;
+      continue;
+    }
+    let repeat: number;
+    let value = 0;
+    if (sym === 16) {
+      if (i === 0) throw new Error("Invalid code length repeat");
+      value = lengths[i - 1];
+      repeat = 3 + br.bits(2);
+    } else if (sym === 17) {
+      repeat = 3 + br.bits(3);
+    } else {
+      repeat = 11 + br.bits(7);
+    }
+    if (i + repeat > hlit + hdist) throw new Error("Invalid code lengths");
+    while (repeat--) lengths[i++] = value;
+  }
+
+  return { lit: buildHuffman(lengths, 0, hlit), dist: buildHuffman(lengths, hlit, hdist) };
+}
+
+function adler32(data: Uint8Array, start = 0, end = data.length): number {
+  let a = 1;
+  let b = 0;
+  for (let i = start; i < end; i++) {
+    a = (a + data[i]) % 65521;
+    b = (b + a) % 65521;
+  }
+  return ((b << 16) | a) >>> 0;
+}
+
+/**
+ * Inflate a zlib stream. If the stream was compressed with a preset
+ * dictionary, `dictionary` must match it (verified via its Adler-32).
+ */
+export function zlibInflate(data: Uint8Array, dictionary?: Uint8Array): Uint8Array {
+  if (data.length < 6) throw new Error("zlib stream too short");
+  const cmf = data[0];
+  const flg = data[1];
+  if ((cmf & 0x0f) !== 8 || ((cmf << 8) | flg) % 31 !== 0) {
+    throw new Error("Invalid zlib header");
+  }
+
+  let start = 2;
+  let dict = new Uint8Array(0);
+  if (flg & 0x20) {
+    if (!dictionary) throw new Error("zlib stream needs a preset dictionary");
+    const dictId = ((data[2] << 24) | (data[3] << 16) | (data[4] << 8) | data[5]) >>> 0;
+    if (dictId !== adler32(dictionary)) throw new Error("Unknown preset dictionary");
+    dict = dictionary;
+    start = 6;
+  }
+
+  // Output buffer starts with the dictionary so back-references can reach it
+  let out = new Uint8Array(Math.max(1024, dict.length + data.length * 4));
+  out.set(dict);
+  let outLen = dict.length;
+  const ensure = (extra: number) => {
+    if (outLen + extra <= out.length) return;
+    const grown = new Uint8Array(Math.max(out.length * 2, outLen + extra));
+    grown.set(out.subarray(0, outLen));
+    out = grown;
+  };
+
+  const br = new BitReader(data, start);
+  let last = 0;
+  while (!last) {
+    last = br.bits(1);
+    const type = br.bits(2);
+
+    if (type === 0) {
+      br.alignToByte();
+      const len = br.byte() | (br.byte() << 8);
+      const nlen = br.byte() | (br.byte() << 8);
+      if ((len ^ 0xffff) !== nlen) throw new Error("Invalid stored block");
+      ensure(len);
+      for (let i = 0; i < len; i++) out[outLen++] = br.byte();
+      continue;
+    }
+    if (type === 3) throw new Error("Invalid deflate block type");
+
+    const { lit, dist } = type === 1 ? getFixedTables() : readDynamicTables(br);
+    for (;;) {
+      const sym = br.decode(lit);
+      if (sym < 256) {
+        ensure(1);
+        out[outLen++] = sym;
+      } else if (sym === 256) {
+        break;
+      } else {
+        const li = sym - 257;
+        if (li >= 29) throw new Error("Invalid length symbol");
+        const len = LENGTH_BASE[li] + br.bits(LENGTH_EXTRA[li]);
+        const di = br.decode(dist);
+        if (di >= 30) throw new Error("Invalid distance symbol");
+        const distance = DIST_BASE[di] + br.bits(DIST_EXTRA[di]);
+        if (distance > outLen) throw new Error("Distance too far back");
+        ensure(len);
+        for (let i = 0; i < len; i++, outLen++) out[outLen] = out[outLen - distance];
+      }
+    }
+  }
+
+  const checkAt = br.offset;
+  if (checkAt + 4 > data.length) throw new Error("Missing zlib checksum");
+  const expected = ((data[checkAt] << 24) | (data[checkAt + 1] << 16) |
+    (data[checkAt + 2] << 8) | data[checkAt + 3]) >>> 0;
+  if (adler32(out, dict.length, outLen) !== expected) throw new Error("zlib checksum mismatch");
+
+  return out.slice(dict.length, outLen);
+}
+
+/**
+ * Check whether a scanned (or assembled) value is a compressed payload
+ */
+export function isCompressedPayload(value: string): boolean {
+  return value.startsWith(COMPRESSED_PAYLOAD_PREFIX);
+}
+
+/**
+ * Decode a scanned payload. Values without the compression prefix are
+ * returned unchanged; corrupt compressed payloads throw.
+ */
+export function decodeQRPayload(value: string): string {
+  if (!isCompressedPayload(value)) return value;
+
+  const compressed = base45Decode(value.slice(COMPRESSED_PAYLOAD_PREFIX.length));
+  const dictionary = new TextEncoder().encode(TX_ENVELOPE_DICTIONARY);
+  return new TextDecoder().decode(zlibInflate(compressed, dictionary));
+}
@@ -114,6 +114,7 @@ install_dependencies() {
         "pkg-config"
         "binutils"
         "libc6-dev"
+        "zlib1g-dev"
     )
     
     # Version-specific packages
@@ -15,6 +15,7 @@
  *   --gasLimit <limit> Gas limit (optional, defaults to 21000)
  *   --chainId <id>     Chain ID (optional, defaults to 1 for Ethereum mainnet)
  *   --quiet            Only output minified JSON result (optional)
+ *   --serve            Run as a long-lived signing worker for the TUI (see serve())
  * 
  * This script will:
  * 1. Connect to the first available Ledger device
@@ -317,6 +318,143 @@ function createSignedTransaction(
   return serialized;
 }
 
+// Build, sign and encode one transfer; returns the minified result JSON
+async function signTransfer(eth: Eth, fromAddress: string, options: ParsedOptions): Promise<string> {
+  // Build transaction
+  const transaction = buildTransaction(
+    fromAddress,
+    options.to,
+    options.amount,
+    options.nonce,
+    options.gasPrice,
+    options.gasLimit,
+    options.chainId
+  );
+  
+  // const transaction = JSON.parse(
+  //   '{"to":"0x8c47B9fADF822681C68f34fd9b0D3063569245A1","value":{"type":"BigNumber","hex":"0x0f4240"},"nonce":1,"gasPrice":{"type":"BigNumber","hex":"0x04a817c800"},"gasLimit":21000,"chainId":8453,"type":0}'
+  // );
+
+  // Serialize transaction
+  const rawTxHex = serializeTransaction(transaction);
+  
+  // Display unsigned transaction hex
+  log(`📄 Unsigned Transaction Hex: 0x${rawTxHex}`);
+  
+  // Sign transaction
+  const signature = await signTransaction(eth, DEFAULT_DERIVATION_PATH, rawTxHex);
+
+  // const signature = {
+  //   r: "0x60dd71f1a9cd8bfa6a84e360826ba4e66b4ef789291c0592a80b9d14719ec2da",
+  //   s: "0x3f486ca88006e7c4bf6fc055b4613632c891cf60fcf976ad10f1fc34c0070087",
+  //   v: "422d"
+  // }
+
+  log('Signature:', signature);
+
+
+    // Display signature components
+    log('\n🔐 Signature Components:');
+    log(JSON.stringify({
+      r: trimLeadingZero(signature.r.startsWith('0x') ? signature.r : '0x' + signature.r),
+      s: trimLeadingZero(signature.s.startsWith('0x') ? signature.s : '0x' + signature.s),
+      v: signature.v
+    }, null, 2));
+
+    log('Transaction:');
+    log(JSON.stringify(transaction));
+    
+  // Create final signed transaction
+  const signedTx = createSignedTransaction(transaction, signature);
+  
+
+  // Create final JSON object
+  const txHash = ethers.utils.keccak256(signedTx);
+  const finalJson = {
+    type: "1",
+    version: "1.0",
+    data: {
+      hash: txHash,
+      signature: {
+        r: trimLeadingZero(signature.r.startsWith('0x') ? signature.r : '0x' + signature.r),
+        s: trimLeadingZero(signature.s.startsWith('0x') ? signature.s : '0x' + signature.s),
+        v: signature.v.startsWith('0x') ? signature.v : '0x' + signature.v
+      },
+      transaction: {
+        to: transaction.to,
+        value: (transaction.value && typeof transaction.value === 'object' && 'hex' in transaction.value) 
+          ? (transaction.value as any).hex 
+          : ethers.utils.hexlify(transaction.value || 0),
+        nonce: transaction.nonce || 0,
+        gasPrice: (transaction.gasPrice && typeof transaction.gasPrice === 'object' && 'hex' in transaction.gasPrice) 
+          ? (transaction.gasPrice as any).hex 
+          : ethers.utils.hexlify(transaction.gasPrice || 0),
+        gasLimit: (transaction.gasLimit && typeof transaction.gasLimit === 'object' && 'hex' in transaction.gasLimit) 
+          ? (transaction.gasLimit as any).hex 
+          : ethers.utils.hexlify(transaction.gasLimit || 0),
+        data: "0x",
+        chainId: transaction.chainId || 1
+      },
+      timestamp: Date.now(),
+      network: transaction.chainId === 1 ? "ethereum" : transaction.chainId === 8453 ? "base" : `chain-${transaction.chainId || 1}`
+    },
+    checksum: ethers.utils.keccak256(ethers.utils.toUtf8Bytes(JSON.stringify({
+      hash: txHash,
+      signature: signature,
+      transaction: {
+        to: transaction.to,
+        value: (transaction.value && typeof transaction.value === 'object' && 'hex' in transaction.value) 
+          ? (transaction.value as any).hex 
+          : ethers.utils.hexlify(transaction.value || 0),
+        nonce: transaction.nonce || 0,
+        gasPrice: (transaction.gasPrice && typeof transaction.gasPrice === 'object' && 'hex' in transaction.gasPrice) 
+          ? (transaction.gasPrice as any).hex 
+          : ethers.utils.hexlify(transaction.gasPrice || 0),
+        gasLimit: (transaction.gasLimit && typeof transaction.gasLimit === 'object' && 'hex' in transaction.gasLimit) 
+          ? (transaction.gasLimit as any).hex 
+          : ethers.utils.hexlify(transaction.gasLimit || 0),
+        data: "0x",
+        chainId: transaction.chainId || 1
+      }
+    }))).slice(2, 18) // First 8 bytes as checksum
+  };
+  
+  log('\n🎉 SUCCESS!');
+  log('============');
+  log(`Signed Raw Transaction: ${signedTx}`);
+  log(`Transaction Hash: ${txHash}`);
+  
+  // Debug: Decode the signed transaction
+  log('\n🔍 Transaction Decoding Debug:');
+  try {
+    const decoded = ethers.utils.parseTransaction(signedTx);
+    log('✅ Transaction decoded successfully:');
+    log('  Nonce:', decoded.nonce);
+    log('  Gas Price:', decoded.gasPrice?.toString());
+    log('  Gas Limit:', decoded.gasLimit?.toString());
+    log('  To:', decoded.to);
+    log('  Value:', decoded.value?.toString());
+    log('  Chain ID:', decoded.chainId);
+    log('  V:', decoded.v);
+    log('  R:', decoded.r);
+    log('  S:', decoded.s);
+    
+    // Recover sender address from signature
+    if (decoded.from) {
+      log('  From (recovered):', decoded.from);
+    } else {
+      log('  From (recovered): Unable to recover sender address');
+    }
+  } catch (error: any) {
+    log('❌ Failed to decode transaction:', error.message);
+  }
+  
+  log('\n📄 Final JSON Object:');
+  log(JSON.stringify(finalJson, null, 2));
+  
+  return JSON.stringify(finalJson);
+}
+
 // Main function
 async function main(): Promise<void> {
   try {
@@ -341,139 +479,7 @@ async function main(): Promise<void> {
       const fromAddress = await getAddress(eth);
       //const fromAddress = "0xa8afD84cd993A24BeC10FDC5d6e2A0dB878C1D92";
       
-      // Build transaction
-      const transaction = buildTransaction(
-        fromAddress,
-        options.to,
-        options.amount,
-        options.nonce,
-        options.gasPrice,
-        options.gasLimit,
-        options.chainId
-      );
-      
-      // const transaction = JSON.parse(
-      //   '{"to":"0x8c47B9fADF822681C68f34fd9b0D3063569245A1","value":{"type":"BigNumber","hex":"0x0f4240"},"nonce":1,"gasPrice":{"type":"BigNumber","hex":"0x04a817c800"},"gasLimit":21000,"chainId":8453,"type":0}'
-      // );
-
-      // Serialize transaction
-      const rawTxHex = serializeTransaction(transaction);
-      
-      // Display unsigned transaction hex
-      log(`📄 Unsigned Transaction Hex: 0x${rawTxHex}`);
-      
-      // Sign transaction
-      const signature = await signTransaction(eth, DEFAULT_DERIVATION_PATH, rawTxHex);
-
-      // const signature = {
-      //   r: "0x60dd71f1a9cd8bfa6a84e360826ba4e66b4ef789291c0592a80b9d14719ec2da",
-      //   s: "0x3f486ca88006e7c4bf6fc055b4613632c891cf60fcf976ad10f1fc34c0070087",
-      //   v: "422d"
-      // }
-
-      log('Signature:', signature);
-
-
-        // Display signature components
-        log('\n🔐 Signature Components:');
-        log(JSON.stringify({
-          r: trimLeadingZero(signature.r.startsWith('0x') ? signature.r : '0x' + signature.r),
-          s: trimLeadingZero(signature.s.startsWith('0x') ? signature.s : '0x' + signature.s),
-          v: signature.v
-        }, null, 2));
-
-        log('Transaction:');
-        log(JSON.stringify(transaction));
-        
-      // Create final signed transaction
-      const signedTx = createSignedTransaction(transaction, signature);
-      
-    
-      // Create final JSON object
-      const txHash = ethers.utils.keccak256(signedTx);
-      const finalJson = {
-        type: "1",
-        version: "1.0",
-        data: {
-          hash: txHash,
-          signature: {
-            r: trimLeadingZero(signature.r.startsWith('0x') ? signature.r : '0x' + signature.r),
-            s: trimLeadingZero(signature.s.startsWith('0x') ? signature.s : '0x' + signature.s),
-            v: signature.v.startsWith('0x') ? signature.v : '0x' + signature.v
-          },
-          transaction: {
-            to: transaction.to,
-            value: (transaction.value && typeof transaction.value === 'object' && 'hex' in transaction.value) 
-              ? (transaction.value as any).hex 
-              : ethers.utils.hexlify(transaction.value || 0),
-            nonce: transaction.nonce || 0,
-            gasPrice: (transaction.gasPrice && typeof transaction.gasPrice === 'object' && 'hex' in transaction.gasPrice) 
-              ? (transaction.gasPrice as any).hex 
-              : ethers.utils.hexlify(transaction.gasPrice || 0),
-            gasLimit: (transaction.gasLimit && typeof transaction.gasLimit === 'object' && 'hex' in transaction.gasLimit) 
-              ? (transaction.gasLimit as any).hex 
-              : ethers.utils.hexlify(transaction.gasLimit || 0),
-            data: "0x",
-            chainId: transaction.chainId || 1
-          },
-          timestamp: Date.now(),
-          network: transaction.chainId === 1 ? "ethereum" : transaction.chainId === 8453 ? "base" : `chain-${transaction.chainId || 1}`
-        },
-        checksum: ethers.utils.keccak256(ethers.utils.toUtf8Bytes(JSON.stringify({
-          hash: txHash,
-          signature: signature,
-          transaction: {
-            to: transaction.to,
-            value: (transaction.value && typeof transaction.value === 'object' && 'hex' in transaction.value) 
-              ? (transaction.value as any).hex 
-              : ethers.utils.hexlify(transaction.value || 0),
-            nonce: transaction.nonce || 0,
-            gasPrice: (transaction.gasPrice && typeof transaction.gasPrice === 'object' && 'hex' in transaction.gasPrice) 
-              ? (transaction.gasPrice as any).hex 
-              : ethers.utils.hexlify(transaction.gasPrice || 0),
-            gasLimit: (transaction.gasLimit && typeof transaction.gasLimit === 'object' && 'hex' in transaction.gasLimit) 
-              ? (transaction.gasLimit as any).hex 
-              : ethers.utils.hexlify(transaction.gasLimit || 0),
-            data: "0x",
-            chainId: transaction.chainId || 1
-          }
-        }))).slice(2, 18) // First 8 bytes as checksum
-      };
-      
-      log('\n🎉 SUCCESS!');
-      log('============');
-      log(`Signed Raw Transaction: ${signedTx}`);
-      log(`Transaction Hash: ${txHash}`);
-      
-      // Debug: Decode the signed transaction
-      log('\n🔍 Transaction Decoding Debug:');
-      try {
-        const decoded = ethers.utils.parseTransaction(signedTx);
-        log('✅ Transaction decoded successfully:');
-        log('  Nonce:', decoded.nonce);
-        log('  Gas Price:', decoded.gasPrice?.toString());
-        log('  Gas Limit:', decoded.gasLimit?.toString());
-        log('  To:', decoded.to);
-        log('  Value:', decoded.value?.toString());
-        log('  Chain ID:', decoded.chainId);
-        log('  V:', decoded.v);
-        log('  R:', decoded.r);
-        log('  S:', decoded.s);
-        
-        // Recover sender address from signature
-        if (decoded.from) {
-          log('  From (recovered):', decoded.from);
-        } else {
-          log('  From (recovered): Unable to recover sender address');
-        }
-      } catch (error: any) {
-        log('❌ Failed to decode transaction:', error.message);
-      }
-      
-      log('\n📄 Final JSON Object:');
-      log(JSON.stringify(finalJson, null, 2));
-      
-      const minifiedJson = JSON.stringify(finalJson);
+      const minifiedJson = await signTransfer(eth, fromAddress, options);
       
       // In quiet mode, only output the minified JSON
       if (quietMode) {
@@ -499,6 +505,123 @@ async function main(): Promise<void> {
   }
 }
 
+// Worker mode (--serve): the TUI keeps one process alive and sends requests
+// as frames of a 4-byte big-endian length plus body on stdin, answered the
+// same way on stdout. Request body: "sign\n" then "key=value" lines using the
+// CLI option names; response body: "ok\n<minified JSON>" or "error\n<message>".
+// The Ledger transport stays open between requests and is reopened after a
+// transport failure, so each signature only waits for the device.
+const MAX_FRAME_SIZE = 1 << 20;
+
+interface LedgerSession {
+  transport: TransportNodeHid;
+  eth: Eth;
+  address: string;
+}
+
+let session: Promise<LedgerSession> | null = null;
+
+function openSession(): Promise<LedgerSession> {
+  if (!session) {
+    session = (async () => {
+      const { transport, eth } = await connectToLedger(await getLedgerDevice());
+      try {
+        const address = await getAddress(eth);
+        transport.on('disconnect', () => { session = null; });
+        return { transport, eth, address };
+      } catch (error) {
+        await transport.close().catch(() => undefined);
+        throw error;
+      }
+    })();
+    session.catch(() => { session = null; });
+  }
+  return session;
+}
+
+async function closeSession(): Promise<void> {
+  const current = session;
+  session = null;
+  if (current) {
+    await current.then(s => s.transport.close()).catch(() => undefined);
+  }
+}
+
+function parseRequest(body: string): TransactionOptions {
+  const [command, ...lines] = body.split('\n');
+  if (command !== 'sign') {
+    throw new Error(`Unknown request: ${command}`);
+  }
+
+  const options: Partial<TransactionOptions> = { quiet: true };
+  for (const line of lines) {
+    const eq = line.indexOf('=');
+    if (eq <= 0) continue;
+    const key = line.slice(0, eq) as keyof TransactionOptions;
+    if (key === 'to' || key === 'amount' || key === 'nonce' || key === 'gasPrice' || key === 'gasLimit' || key === 'chainId') {
+      options[key] = line.slice(eq + 1);
+    }
+  }
+  return options as TransactionOptions;
+}
+
+async function handleRequest(body: string): Promise<string> {
+  try {
+    const options = validateArgs(parseRequest(body));
+    const { eth, address } = await openSession();
+    try {
+      return 'ok\n' + await signTransfer(eth, address, options);
+    } catch (error: any) {
+      // A status word (e.g. rejected on device) leaves the session usable
+      if (error?.name !== 'TransportStatusError') {
+        await closeSession();
+      }
+      throw error;
+    }
+  } catch (error: any) {
+    return 'error\n' + (error?.message || String(error));
+  }
+}
+
+function writeFrame(body: string): void {
+  const payload = Buffer.from(body, 'utf8');
+  const header = Buffer.alloc(4);
+  header.writeUInt32BE(payload.length, 0);
+  process.stdout.write(Buffer.concat([header, payload]));
+}
+
+function serve(): void {
+  quietMode = true;
+
+  // Warm the device session up front; if no Ledger is attached yet the
+  // first request retries
+  openSession().catch(() => undefined);
+
+  let pending = Buffer.alloc(0);
+  let queue = Promise.resolve();
+  process.stdin.on('data', (chunk: Buffer) => {
+    pending = Buffer.concat([pending, chunk]);
+    while (pending.length >= 4) {
+      const size = pending.readUInt32BE(0);
+      if (size > MAX_FRAME_SIZE) {
+        console.error(`Oversized request frame (${size} bytes)`);
+        process.exit(1);
+      }
+      if (pending.length < 4 + size) break;
+      const body = pending.subarray(4, 4 + size).toString('utf8');
+      pending = pending.subarray(4 + size);
+      queue = queue.then(async () => writeFrame(await handleRequest(body)));
+    }
+  });
+
+  // The TUI closing its end means shut down
+  process.stdin.on('end', async () => {
+    await queue;
+    await closeSession();
+    process.exit(0);
+  });
+}
+
 // Handle uncaught exceptions
 process.on('uncaughtException', (error: Error) => {
   if (quietMode) {
@@ -520,11 +643,16 @@ process.on('unhandledRejection', (reason: any, promise: Promise<any>) => {
 
 // Run the script
 if (require.main === module) {
-  main();
+  if (process.argv.includes('--serve')) {
+    serve();
+  } else {
+    main();
+  }
 }
 
 export { 
   main, 
+  serve, 
   parseArgs, 
   validateArgs, 
   getLedgerDevice, 
@@ -0,0 +1,116 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+// Keeps the compiler from discarding a result it can prove unused
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+struct Result {
+  std::string name;
+  uint64_t iterations = 0;   // per repetition
+  int repetitions = 0;
+  double ns_per_op = 0;      // median over repetitions
+  double min_ns_per_op = 0;
+  double max_ns_per_op = 0;
+  double bytes_per_op = 0;   // 0 when throughput isn't meaningful
+};
+
+struct Options {
+  std::string filter;                          // substring of the names to run
+  std::chrono::milliseconds min_time{500};     // per benchmark, all repetitions
+  int repetitions = 5;
+};
+
+/**
+ * Minimal timing loop. Each benchmark is calibrated once (iterations are
+ * doubled until one repetition takes min_time / repetitions), then run
+ * `repetitions` times with that count; the median is reported so a single
+ * preempted repetition doesn't move the result. Inputs are built from fixed
+ * seeds, so runs on the same build and machine are comparable.
+ */
+class Runner {
+public:
+  explicit Runner(Options options) : options_(std::move(options)) {}
+
+  bool enabled(const std::string& name) const {
+    return options_.filter.empty() || name.find(options_.filter) != std::string::npos;
+  }
+
+  // Times fn(), one call per operation
+  template <typename Fn>
+  void run(const std::string& name, Fn&& fn, double bytes_per_op = 0) {
+    if (!enabled(name)) return;
+    fn();  // warm caches and lazily built tables
+    uint64_t iterations = calibrate([&](uint64_t n) { return time(fn, n); });
+    std::vector<double> samples;
+    for (int r = 0; r < options_.repetitions; ++r) {
+      samples.push_back(time(fn, iterations) / static_cast<double>(iterations));
+    }
+    record(name, iterations, samples, bytes_per_op);
+  }
+
+  // Times fn(), which performs `items` operations per call (threaded
+  // workloads whose setup must stay outside the timed region use this too)
+  template <typename Fn>
+  void runBatch(const std::string& name, size_t items, Fn&& fn) {
+    if (!enabled(name)) return;
+    fn();
+    std::vector<double> samples;
+    for (int r = 0; r < options_.repetitions; ++r) {
+      samples.push_back(time(fn, 1) / static_cast<double>(items));
+    }
+    record(name, items, samples, 0);
+  }
+
+  const std::vector<Result>& results() const { return results_; }
+  void writeJson(std::ostream& out) const;
+
+private:
+  template <typename Fn>
+  static double time(Fn& fn, uint64_t iterations) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) fn();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  template <typename TimeFn>
+  uint64_t calibrate(TimeFn&& time_n) const {
+    double target = std::chrono::duration<double, std::nano>(options_.min_time).count() /
+                    std::max(options_.repetitions, 1);
+    uint64_t n = 1;
+    for (;;) {
+      double elapsed = time_n(n);
+      if (elapsed >= target || n >= (uint64_t{1} << 40)) break;
+      // Jump most of the way once the measurement is long enough to trust
+      n = elapsed > target / 100 ? static_cast<uint64_t>(n * target / elapsed) + 1 : n * 10;
+    }
+    return n;
+  }
+
+  void record(const std::string& name, uint64_t iterations, std::vector<double> samples, double bytes_per_op);
+
+  Options options_;
+  std::vector<Result> results_;
+};
+
+// Defined in bench_render.cpp; kept apart because it is the only part
+// that needs FTXUI
+void RegisterRenderBenchmarks(Runner& runner);
+
+} // namespace bench
@@ -0,0 +1,41 @@
+#include "bench.hpp"
+#include "app/qr_element.hpp"
+#include "app/qr_generator.hpp"
+#include "app/qr_render_cache.hpp"
+#include <ftxui/dom/elements.hpp>
+#include <ftxui/dom/node.hpp>
+#include <ftxui/screen/screen.hpp>
+#include <string>
+#include <utility>
+
+namespace bench {
+
+void RegisterRenderBenchmarks(Runner& runner) {
+  // A signed EIP-1559 transfer is about 230 hex characters
+  const std::string payload =
+      "0x02f87083002105078405f5e1008459682f0082520894833589fcd6edb6e08f4c7c32d4f71b54bda0291388"
+      "06f05b59d3b2000080c001a0c5d3b7a1e8f2d4c6b8a0e2f4d6c8b0a2e4f6d8c0b2a4e6f8d0c2b4a6e8f0d2a0"
+      "1b3d5f7a9c2e4f6b8d0a2c4e6f8b0d2a4c6e8f0b2d4a6c8e0f2b4d6a8c0e2f4b6d8a0c2e4f6";
+
+  for (auto [width, height] : {std::pair<int, int>{40, 20}, {80, 40}, {160, 60}}) {
+    std::string size = std::to_string(width) + "x" + std::to_string(height);
+    auto screen = ftxui::Screen(width, height);
+
+    // Steady state: the raster is cached, so a frame only copies cells
+    runner.run("QrCodeNode::Render/cached/" + size, [&] {
+      ftxui::Element element = app::ResponsiveQrCode(payload) | ftxui::flex;
+      ftxui::Render(screen, element);
+      DoNotOptimize(screen.PixelAt(0, 0));
+    });
+
+    // First frame after a payload or size change: encode and rasterise too
+    runner.run("QrCodeNode::Render/uncached/" + size, [&] {
+      app::QRRenderCache::shared().clear();
+      ftxui::Element element = app::ResponsiveQrCode(payload) | ftxui::flex;
+      ftxui::Render(screen, element);
+      DoNotOptimize(screen.PixelAt(0, 0));
+    });
+  }
+}
+
+} // namespace bench
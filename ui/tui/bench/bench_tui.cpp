@@ -0,0 +1,339 @@
+// Microbenchmarks for the TUI's hot paths. Prints one JSON document:
+//
+//   bench_tui [--filter SUBSTRING] [--min-time-ms N] [--repetitions N] [--out FILE]
+//
+// Build with `cmake --build build --target bench_tui` (or `make bench`) in a
+// Release configuration; numbers from Debug builds are not comparable.
+#include "bench.hpp"
+#include "app/config.hpp"
+#include "app/form_validation.hpp"
+#include "app/logger.hpp"
+#include "app/qr_generator.hpp"
+#include "app/state.hpp"
+#include "app/validation.hpp"
+#include "app/wallet_detector.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#ifndef BENCH_BUILD_TYPE
+#define BENCH_BUILD_TYPE "unknown"
+#endif
+
+namespace bench {
+
+namespace {
+
+std::string JsonEscape(const std::string& text) {
+  std::string out;
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buffer[8];
+      std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+      out += buffer;
+    } else {
+      out += c;
+    }
+  }
+  return out;
+}
+
+std::string UtcTimestamp() {
+  std::time_t now = std::time(nullptr);
+  std::tm tm{};
+#ifdef _WIN32
+  gmtime_s(&tm, &now);
+#else
+  gmtime_r(&now, &tm);
+#endif
+  char buffer[32];
+  std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &tm);
+  return buffer;
+}
+
+std::string CompilerName() {
+#if defined(__clang__)
+  return "clang " __clang_version__;
+#elif defined(__GNUC__)
+  return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+  return "msvc " + std::to_string(_MSC_VER);
+#else
+  return "unknown";
+#endif
+}
+
+// Hex text like a signed transaction, from a fixed seed
+std::string HexPayload(size_t size, uint32_t seed = 1) {
+  static const char kDigits[] = "0123456789abcdef";
+  std::mt19937 rng(seed);
+  std::string out = "0x";
+  while (out.size() < size) out += kDigits[rng() % 16];
+  return out;
+}
+
+void QrBenchmarks(Runner& runner) {
+  for (size_t size : {32, 128, 512, 1024, 2048}) {
+    std::string payload = HexPayload(size);
+    runner.run("GenerateQR/bytes:" + std::to_string(size),
+               [&] { DoNotOptimize(app::GenerateQR(payload)); }, static_cast<double>(size));
+  }
+
+  for (size_t size : {1024, 4096, 16384}) {
+    std::string payload = HexPayload(size);
+    for (size_t max_length : {100, 300}) {
+      runner.run("GenerateQRs/bytes:" + std::to_string(size) + "/max_length:" + std::to_string(max_length),
+                 [&] { DoNotOptimize(app::GenerateQRs(payload, max_length)); }, static_cast<double>(size));
+    }
+  }
+
+  // Capacity-aware chunking at the symbol versions a phone camera copes with
+  std::string signed_tx = HexPayload(4096);
+  for (int version : {5, 10, 20}) {
+    app::QRPlanOptions options;
+    options.max_version = version;
+    runner.run("GenerateQRsPlanned/bytes:4096/max_version:" + std::to_string(version),
+               [&] { DoNotOptimize(app::GenerateQRsPlanned(signed_tx, options)); }, 4096.0);
+  }
+  {
+    app::QRPlanOptions options;
+    options.max_version = 20;
+    options.fast_mask = true;
+    runner.run("GenerateQRsPlanned/bytes:4096/max_version:20/fast_mask",
+               [&] { DoNotOptimize(app::GenerateQRsPlanned(signed_tx, options)); }, 4096.0);
+  }
+
+  for (size_t size : {128, 1024}) {
+    app::QRCode qr = app::GenerateQR(HexPayload(size));
+    runner.run("QRCode::toCompactAscii/modules:" + std::to_string(qr.size),
+               [&] { DoNotOptimize(qr.toCompactAscii()); });
+  }
+}
+
+void ValidatorBenchmarks(Runner& runner) {
+  using app::Validator;
+  const std::string checksummed = "0x833589fCD6eDb6E08f4c7C32D4f71b54bdA02913";
+  const std::string lower = "0x833589fcd6edb6e08f4c7c32d4f71b54bda02913";
+  const std::string ens = "vitalik.eth";
+  const std::string wei = "1500000000000000000";
+  const std::string path = "m/44'/60'/0'/0/0";
+  const std::string text = "Payment for invoice #42\t(net 30)";
+
+  runner.run("Validator::isAddress", [&] { DoNotOptimize(Validator::isAddress(checksummed)); });
+  runner.run("Validator::isAddressChecksum", [&] { DoNotOptimize(Validator::isAddressChecksum(checksummed)); });
+  runner.run("Validator::toChecksumAddress", [&] { DoNotOptimize(Validator::toChecksumAddress(lower)); });
+  runner.run("Validator::isENSName", [&] { DoNotOptimize(Validator::isENSName(ens)); });
+  runner.run("Validator::isValidWeiAmount", [&] { DoNotOptimize(Validator::isValidWeiAmount(wei)); });
+  runner.run("Validator::isValidDerivationPath", [&] { DoNotOptimize(Validator::isValidDerivationPath(path)); });
+  runner.run("Validator::sanitizeInput", [&] { DoNotOptimize(Validator::sanitizeInput(text)); });
+
+  std::string calldata = HexPayload(4096, 2);
+  runner.run("Validator::isHex/bytes:4096", [&] { DoNotOptimize(Validator::isHex(calldata)); }, 4096.0);
+
+  std::vector<std::string> batch(256, checksummed);
+  runner.run("Validator::passChecksums/addresses:256",
+             [&] { DoNotOptimize(Validator::passChecksums(batch)); });
+
+  app::UnsignedTx tx;
+  tx.to = checksummed;
+  tx.setValueFromEth("0.5");
+  tx.setNonceFromString("7");
+  tx.setGasLimitFromString("21000");
+  tx.setMaxFeeFromGwei("1.5");
+  tx.setPriorityFeeFromGwei("0.1");
+  runner.run("Validator::validateTransaction", [&] { DoNotOptimize(Validator::validateTransaction(tx)); });
+  runner.run("Validator::checkInputFrequency", [&] {
+    Validator::resetInputFrequency();
+    DoNotOptimize(Validator::checkInputFrequency("to"));
+  });
+
+  // A redraw re-checks the whole form; only the field being typed in changed
+  app::TransactionFormValidator form;
+  form.update(app::TxField::To, checksummed);
+  form.update(app::TxField::Value, "500000000000000000");
+  form.update(app::TxField::Nonce, "7");
+  form.update(app::TxField::GasLimit, "200000");
+  form.update(app::TxField::MaxFee, "1.5");
+  form.update(app::TxField::PriorityFee, "0.1");
+  std::string typed = "0x";
+  runner.run("TransactionFormValidator::update/calldata-keystroke", [&] {
+    typed += typed.size() % 2 ? 'f' : '0';
+    if (typed.size() > 8192) typed.resize(2);
+    DoNotOptimize(form.update(app::TxField::Data, typed));
+    DoNotOptimize(form.update(app::TxField::GasLimit, "200000"));
+    DoNotOptimize(form.valid());
+  });
+}
+
+void WalletDetectorBenchmarks(Runner& runner) {
+  // A mocked bus: the same two Ledgers every scan, or one of them being
+  // plugged and unplugged on alternate scans
+  auto make_device = [](int port) {
+    app::WalletDevice device;
+    device.manufacturer = "Ledger";
+    device.product = "Ledger Device";
+    device.path = "usb:2c97:0001";
+    device.key = "1-" + std::to_string(port) + ":2c97:0001";
+    device.connected = true;
+    return device;
+  };
+  std::vector<app::WalletDevice> both = {make_device(1), make_device(2)};
+  std::vector<app::WalletDevice> one = {make_device(1)};
+
+  {
+    app::WalletDetector detector;
+    detector.setDeviceSource([&] { return both; });
+    detector.scanNow();
+    runner.run("WalletDetector::updateDeviceList/steady", [&] { detector.scanNow(); });
+  }
+  {
+    app::WalletDetector detector;
+    bool plugged = false;
+    detector.setDeviceSource([&] {
+      plugged = !plugged;
+      return plugged ? both : one;
+    });
+    runner.run("WalletDetector::updateDeviceList/hotplug", [&] { detector.scanNow(); });
+  }
+}
+
+// Runs last: it initialises the logger, which the other benchmarks leave off
+void LoggerBenchmarks(Runner& runner, const std::string& log_path) {
+  constexpr size_t kMessagesPerThread = 20000;
+  auto& logger = app::Logger::getInstance();
+
+  for (bool async : {false, true}) {
+    for (size_t threads : {1, 2, 4, 8}) {
+      std::string name = std::string("Logger::log/") + (async ? "async" : "sync") +
+                         "/threads:" + std::to_string(threads);
+      if (!runner.enabled(name)) continue;
+
+      std::remove(log_path.c_str());
+      bool ok = async ? logger.initializeAsync(log_path, app::Logger::Level::INFO, false, 1024)
+                      : logger.initialize(log_path, app::Logger::Level::INFO, false, 1024);
+      if (!ok) {
+        std::cerr << "bench_tui: cannot open " << log_path << "\n";
+        return;
+      }
+      runner.runBatch(name, threads * kMessagesPerThread, [&] {
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+          workers.emplace_back([&logger, t] {
+            for (size_t i = 0; i < kMessagesPerThread; ++i) {
+              logger.logf(app::Logger::Level::INFO, __FILE__, __LINE__, __func__,
+                          "bench worker {} message {} amount {}", t, i, 0.25);
+            }
+          });
+        }
+        for (auto& worker : workers) worker.join();
+        logger.flush();  // count the writes, not just the enqueues
+      });
+      logger.shutdown();
+    }
+  }
+  std::remove(log_path.c_str());
+}
+
+} // namespace
+
+void Runner::record(const std::string& name, uint64_t iterations, std::vector<double> samples,
+                    double bytes_per_op) {
+  std::sort(samples.begin(), samples.end());
+  Result result;
+  result.name = name;
+  result.iterations = iterations;
+  result.repetitions = static_cast<int>(samples.size());
+  if (!samples.empty()) {
+    size_t mid = samples.size() / 2;
+    result.ns_per_op = samples.size() % 2 ? samples[mid] : (samples[mid - 1] + samples[mid]) / 2;
+    result.min_ns_per_op = samples.front();
+    result.max_ns_per_op = samples.back();
+  }
+  result.bytes_per_op = bytes_per_op;
+  std::cerr << name << ": " << result.ns_per_op << " ns/op\n";
+  results_.push_back(std::move(result));
+}
+
+void Runner::writeJson(std::ostream& out) const {
+  out << "{\n  \"context\": {\n"
+      << "    \"date\": \"" << UtcTimestamp() << "\",\n"
+      << "    \"build_type\": \"" << JsonEscape(BENCH_BUILD_TYPE) << "\",\n"
+      << "    \"compiler\": \"" << JsonEscape(CompilerName()) << "\",\n"
+      << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+      << "    \"repetitions\": " << options_.repetitions << ",\n"
+      << "    \"min_time_ms\": " << options_.min_time.count() << "\n"
+      << "  },\n  \"benchmarks\": [";
+  for (size_t i = 0; i < results_.size(); ++i) {
+    const Result& r = results_[i];
+    char numbers[256];
+    std::snprintf(numbers, sizeof(numbers),
+                  "\"iterations\": %llu, \"ns_per_op\": %.3f, \"min_ns_per_op\": %.3f, \"max_ns_per_op\": %.3f",
+                  static_cast<unsigned long long>(r.iterations), r.ns_per_op, r.min_ns_per_op,
+                  r.max_ns_per_op);
+    out << (i ? ",\n" : "\n") << "    {\"name\": \"" << JsonEscape(r.name) << "\", " << numbers;
+    if (r.bytes_per_op > 0 && r.ns_per_op > 0) {
+      char throughput[64];
+      std::snprintf(throughput, sizeof(throughput), ", \"bytes_per_second\": %.0f",
+                    r.bytes_per_op * 1e9 / r.ns_per_op);
+      out << throughput;
+    }
+    out << "}";
+  }
+  out << "\n  ]\n}\n";
+}
+
+} // namespace bench
+
+int main(int argc, char** argv) {
+  bench::Options options;
+  std::string out_path;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (arg == "--filter" && has_value) {
+      options.filter = argv[++i];
+    } else if (arg == "--min-time-ms" && has_value) {
+      options.min_time = std::chrono::milliseconds(std::max(1, std::atoi(argv[++i])));
+    } else if (arg == "--repetitions" && has_value) {
+      options.repetitions = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--out" && has_value) {
+      out_path = argv[++i];
+    } else {
+      std::cerr << "usage: " << argv[0]
+                << " [--filter SUBSTRING] [--min-time-ms N] [--repetitions N] [--out FILE]\n";
+      return 2;
+    }
+  }
+
+  // Validation reads its limits from the configuration defaults
+  app::Config::getInstance().load("");
+
+  bench::Runner runner(options);
+  bench::QrBenchmarks(runner);
+  bench::RegisterRenderBenchmarks(runner);
+  bench::ValidatorBenchmarks(runner);
+  bench::WalletDetectorBenchmarks(runner);
+  bench::LoggerBenchmarks(runner, out_path.empty() ? "bench_tui.log" : out_path + ".log");
+
+  if (out_path.empty()) {
+    runner.writeJson(std::cout);
+  } else {
+    std::ofstream out(out_path);
+    runner.writeJson(out);
+    if (!out) {
+      std::cerr << "bench_tui: cannot write " << out_path << "\n";
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "state.hpp"
+
+namespace app {
+
+/**
+ * Read-only address book mapped straight from its binary file. Layout
+ * (little-endian, every section 8-byte aligned):
+ *   header      magic, version, entry count and section offsets
+ *   addresses   count x 20 raw bytes, sorted, so exact and prefix lookups
+ *               are binary searches
+ *   entries     count x {name offset/length, description offset/length, type},
+ *               parallel to addresses
+ *   names       count x uint32 entry ids sorted by case-folded name
+ *   strings     UTF-8 string table the entries point into
+ * Opening validates the header and section bounds only; nothing is parsed
+ * or copied per entry. Safe to share between threads once opened.
+ */
+class MappedAddressBook {
+public:
+  struct Entry {
+    const uint8_t* address;  // 20 bytes inside the mapping
+    std::string_view name;
+    std::string_view description;
+    ContactType type;
+  };
+
+  MappedAddressBook() = default;
+  ~MappedAddressBook();
+
+  MappedAddressBook(const MappedAddressBook&) = delete;
+  MappedAddressBook& operator=(const MappedAddressBook&) = delete;
+
+  // Maps the file; false (and the book stays empty) if it is missing or
+  // malformed
+  bool open(const std::string& path) noexcept;
+  void close() noexcept;
+
+  size_t size() const noexcept { return count_; }
+  Entry entry(size_t id) const noexcept;
+
+  // EIP-55 checksummed address of an entry
+  std::string addressString(size_t id) const;
+  KnownAddress toKnownAddress(size_t id) const;
+
+  // Entry id for an exact 0x address, case-insensitive
+  std::optional<size_t> find(std::string_view address) const noexcept;
+
+  // Up to `limit` ids whose address starts with the hex query ("0x"
+  // optional) followed by those whose name starts with it, case-insensitive
+  std::vector<size_t> searchPrefix(std::string_view query, size_t limit) const;
+
+  static constexpr uint32_t kVersion = 1;
+
+private:
+  const uint32_t* nameIndex() const noexcept;
+  std::string_view string(uint32_t offset, uint32_t length) const noexcept;
+
+  // [first, last) of address-sorted ids starting with `nibbles` (0-15 each)
+  std::pair<size_t, size_t> addressRange(const uint8_t* nibbles, size_t count) const noexcept;
+  std::pair<size_t, size_t> nameRange(std::string_view folded_prefix) const noexcept;
+
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  size_t count_ = 0;
+  const uint8_t* addresses_ = nullptr;
+  const uint8_t* entries_ = nullptr;
+  const uint8_t* names_ = nullptr;
+  const uint8_t* strings_ = nullptr;
+  size_t strings_size_ = 0;
+};
+
+// Writes `addresses` as a binary address book. Invalid or bad-checksum
+// addresses are skipped and later duplicates of an address dropped; the
+// number written is returned, or nullopt if the file could not be written.
+std::optional<size_t> WriteAddressBook(const std::vector<KnownAddress>& addresses,
+                                       const std::string& path) noexcept;
+
+// Reads a JSON array of {"address", "name", "description", "type"} objects
+// or CSV rows of address,name[,description[,type]] (an optional header row
+// is skipped). The format is chosen by extension. nullopt on I/O or syntax
+// errors; unusable rows are skipped.
+std::optional<std::vector<KnownAddress>> ReadAddressBookSource(const std::string& path) noexcept;
+
+// One-time import: converts a JSON/CSV source to the binary format at `dest`
+std::optional<size_t> ImportAddressBook(const std::string& source, const std::string& dest) noexcept;
+
+// The configured book at `path`, mapped. A JSON/CSV source is converted to
+// `path + ".bosab"` first, and again only when the source is newer. Null
+// when path is empty or no usable book is there.
+std::shared_ptr<const MappedAddressBook> OpenAddressBook(const std::string& path) noexcept;
+
+} // namespace app
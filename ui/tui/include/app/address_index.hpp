@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace app {
+
+/**
+ * Case-insensitive search index over address-book entries.
+ * Names/ENS/basenames and addresses go into a trigram index for queries of
+ * three or more characters; shorter queries are checked against every entry,
+ * which is cheap at address-book sizes. An entry
+ * matches when its address or name contains the query; matches are ranked
+ * exact > prefix > word prefix > substring. Not thread-safe.
+ */
+class AddressIndex {
+public:
+  struct Match {
+    size_t id;   // caller-chosen id passed to insert()
+    int score;   // higher is better
+  };
+
+  // Score of an entry whose address equals the query, "0x" optional
+  static constexpr int kExactAddressScore = 100;
+
+  // Adds or replaces the entry with this id.
+  void insert(size_t id, const std::string& address, const std::string& name);
+  bool erase(size_t id);
+  void clear();
+
+  size_t size() const { return slot_of_.size(); }
+
+  // Bumped by every insert/erase/clear, so search sessions can tell when
+  // their cached candidates went stale.
+  uint64_t version() const { return version_; }
+
+  // Best `limit` matches for query, best first. An empty query matches nothing.
+  std::vector<Match> search(const std::string& query, size_t limit) const;
+
+private:
+  friend class AddressSearch;
+
+  struct Record {
+    size_t id = 0;
+    uint64_t seq = 0;          // insertion order, the final tie-break
+    std::string address;       // case-folded
+    std::string name;          // case-folded
+  };
+
+  // Slots of every entry matching query, unordered
+  std::vector<uint32_t> candidates(const std::string& folded) const;
+  int score(const Record& record, const std::string& folded) const;
+  std::vector<Match> rank(const std::vector<uint32_t>& slots, const std::string& folded,
+                          size_t limit) const;
+  void indexRecord(uint32_t slot, bool add);
+
+  std::vector<Record> records_;
+  std::vector<uint32_t> free_slots_;
+  std::unordered_map<size_t, uint32_t> slot_of_;
+  std::unordered_map<uint32_t, std::vector<uint32_t>> trigrams_;
+  uint64_t next_seq_ = 0;
+  uint64_t version_ = 0;
+};
+
+/**
+ * Incremental search over an AddressIndex for one input field. When the
+ * query grows by typing, the previous candidate set is filtered instead of
+ * querying the index again; anything else starts over.
+ */
+class AddressSearch {
+public:
+  explicit AddressSearch(const AddressIndex& index) : index_(&index) {}
+
+  const std::vector<AddressIndex::Match>& update(const std::string& query, size_t limit);
+  const std::vector<AddressIndex::Match>& results() const { return results_; }
+  // Matches for the current query, including those past the limit
+  size_t matchCount() const { return candidates_.size(); }
+  void reset();
+
+private:
+  const AddressIndex* index_;
+  uint64_t version_ = 0;
+  std::string query_;               // case-folded
+  std::vector<uint32_t> candidates_;
+  std::vector<AddressIndex::Match> results_;
+};
+
+// ASCII case folding shared by the index and its callers
+std::string FoldCase(const std::string& text);
+
+} // namespace app
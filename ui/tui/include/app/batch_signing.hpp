@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "signer_client.hpp"
+#include "state.hpp"
+#include "u256.hpp"
+
+namespace app {
+
+// One transfer of a batch file
+struct BatchEntry {
+  UnsignedTx tx;
+  size_t line = 0;                  // CSV line or JSON object number, 1-based
+  std::vector<std::string> errors;  // unparseable fields, then validation
+};
+
+/**
+ * Transfers to sign back to back in one signer session, read from CSV with
+ * a header row or from a JSON array of flat objects. Recognised columns:
+ *   to, amount (ETH) or value (Wei), gas_price (gwei), gas_limit, nonce, chain_id
+ * (camelCase names work too). A missing gas_limit is 21000 and a missing
+ * chain_id is Base; a row without a nonce takes the one after the previous
+ * row's, the first row start_nonce. The signer worker builds legacy
+ * transfers, so every transaction is type 0.
+ */
+struct SigningBatch {
+  std::vector<BatchEntry> entries;
+  std::string error;  // the file as a whole couldn't be read
+
+  // Something to sign and no errors anywhere
+  bool valid() const noexcept;
+  size_t invalidCount() const noexcept;
+  // Sum of the values in Wei; empty on overflow
+  std::optional<U256> totalValue() const noexcept;
+  // Lines of the form "line 3: Invalid recipient address format"
+  std::vector<std::string> errorLines(size_t max_lines = 20) const;
+};
+
+SigningBatch ParseSigningBatch(std::string_view text, uint64_t start_nonce);
+SigningBatch LoadSigningBatch(const std::string& path, uint64_t start_nonce);
+
+// Validator::validateTransaction for every entry, spread over the shared
+// worker pool since a payout run has dozens of them
+void ValidateSigningBatch(SigningBatch& batch, bool strict_mode = false);
+
+// The worker takes ETH and gwei strings
+SignRequest ToSignRequest(const UnsignedTx& tx);
+
+// Signed-transaction envelopes from the worker as one JSON array, so the
+// whole batch goes out as a single multi-part or fountain QR stream. The
+// broadcaster sends an array's envelopes in order and stops at the first
+// one the network rejects.
+std::string CombineSignedTransactions(const std::vector<SignResult>& results);
+
+} // namespace app
@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace app {
+
+/**
+ * Read side of a cancellation flag. Tasks poll cancelled() between steps; a
+ * default-constructed token is never cancelled. Copies share the flag.
+ */
+class CancellationToken {
+public:
+  CancellationToken() = default;
+
+  bool cancelled() const noexcept { return flag_ && flag_->load(std::memory_order_acquire); }
+
+private:
+  friend class CancellationSource;
+  explicit CancellationToken(std::shared_ptr<const std::atomic<bool>> flag) : flag_(std::move(flag)) {}
+
+  std::shared_ptr<const std::atomic<bool>> flag_;
+};
+
+/**
+ * Owner of a cancellation flag. reset() cancels every token handed out so
+ * far and starts a new generation, which is how route changes drop the
+ * work started for the screen being left.
+ */
+class CancellationSource {
+public:
+  CancellationSource() : flag_(std::make_shared<std::atomic<bool>>(false)) {}
+
+  CancellationToken token() const { return CancellationToken(flag_); }
+  void cancel() noexcept { flag_->store(true, std::memory_order_release); }
+
+  void reset() {
+    cancel();
+    flag_ = std::make_shared<std::atomic<bool>>(false);
+  }
+
+private:
+  std::shared_ptr<std::atomic<bool>> flag_;
+};
+
+} // namespace app
@@ -36,6 +36,7 @@ public:
         int animation_speed_ms;
         bool enable_qr_codes;
         int max_transaction_history;
+        std::string transaction_history_path;
     };
 
     // Singleton pattern for global access
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "state.hpp"
+
+namespace app {
+
+/**
+ * Incremental JSON reader for contact files. Bytes are pushed in chunks of
+ * any size and every object carrying an "address" field is reported as soon
+ * as its closing brace arrives, wherever it sits in the document (a bare
+ * array, {"contacts": [...]}, ...). Memory is bounded by the nesting depth
+ * and the longest string, not the file size. Objects that don't make a valid
+ * KnownAddress are counted and skipped.
+ */
+class ContactStreamParser {
+public:
+  using Sink = std::function<void(KnownAddress)>;
+
+  explicit ContactStreamParser(Sink sink);
+
+  // False once the input is malformed; later calls are ignored
+  bool feed(const char* data, size_t size);
+  // False if the document ended early or was malformed
+  bool finish();
+
+  size_t accepted() const { return accepted_; }
+  size_t rejected() const { return rejected_; }
+
+  static constexpr size_t kMaxDepth = 32;
+  static constexpr size_t kMaxStringLength = 1024;
+
+private:
+  enum class Expect : uint8_t { Value, Key, Colon, CommaOrEnd };
+
+  struct Frame {
+    bool object;
+    std::string address, name, description, type;
+  };
+
+  bool step(char c);
+  bool openContainer(bool object);
+  bool closeContainer(bool object);
+  bool endString();
+  bool endScalar();
+  void valueDone();
+  static void appendUtf8(std::string& out, uint32_t cp);
+
+  Sink sink_;
+  std::vector<Frame> stack_;
+  Expect expect_ = Expect::Value;
+  bool failed_ = false;
+  bool done_ = false;  // the top-level value is complete
+  bool just_opened_ = false;  // nothing read yet in the innermost container
+
+  // String being read: 0 outside, else 1 plain, 2 after '\', 3+ in \uXXXX
+  int string_state_ = 0;
+  bool string_is_key_ = false;
+  std::string string_;
+  std::string key_;
+  uint32_t unicode_ = 0;
+  uint32_t high_surrogate_ = 0;
+  bool in_scalar_ = false;  // number / true / false / null
+
+  size_t accepted_ = 0;
+  size_t rejected_ = 0;
+};
+
+// "ens", "base", "multisig", "contract" (any case); anything else is EOA
+ContactType ParseContactType(std::string_view text);
+
+} // namespace app
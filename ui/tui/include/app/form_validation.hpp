@@ -0,0 +1,101 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include "state.hpp"
+
+namespace app {
+
+// Inputs of the transaction form
+enum class TxField : uint8_t {
+  To,
+  Value,        // Wei, or ETH if the validator was made with value_in_eth
+  Nonce,
+  GasLimit,
+  GasPrice,     // Gwei, legacy only
+  MaxFee,       // Gwei, EIP-1559 only
+  PriorityFee,  // Gwei, EIP-1559 only
+  Data,         // 0x calldata
+};
+
+constexpr size_t kTxFieldCount = 8;
+
+// The field's key in AppState::field_errors
+const char* TxFieldKey(TxField field);
+
+/**
+ * Validates the transaction form as it is typed. Each field keeps the text
+ * it was last checked with and the result, so update() with unchanged text
+ * costs a string compare; a changed field is parsed once, then only the
+ * cross-field rules that read it run again:
+ *   max fee / priority fee   the priority fee can't exceed the max fee
+ *   gas limit / data         the limit must cover the intrinsic gas of the
+ *                            calldata (21000 + 4 per zero byte + 16 per
+ *                            other byte)
+ * Calldata is scanned incrementally while it is only appended to, so typing
+ * or pasting onto long data doesn't rescan what was already checked.
+ *
+ * Which fee fields apply follows the transaction type; fields that don't
+ * apply are never reported. Not thread-safe; owned by the view that edits
+ * the form.
+ */
+class TransactionFormValidator {
+public:
+  explicit TransactionFormValidator(bool eip1559 = true, bool value_in_eth = false);
+
+  // Checks the field's new text; true if any field's error changed
+  bool update(TxField field, const std::string& content);
+  bool setEip1559(bool eip1559);
+  bool eip1559() const noexcept { return eip1559_; }
+
+  // Every field that applies has been checked and has no error
+  bool valid() const noexcept;
+  // The field's own error, else the first cross-field rule it breaks
+  const std::string& error(TxField field) const noexcept;
+  // Errors keyed like AppState::field_errors. While typing, fields still
+  // left empty are usually better not flagged yet.
+  std::map<std::string, std::string> errors(bool include_empty = true) const;
+  // Changes whenever an error does, for publishing errors only when needed
+  uint64_t revision() const noexcept { return revision_; }
+
+  // Values parsed from the fields that are valid; the rest are unset
+  const UnsignedTx& parsed() const noexcept { return parsed_; }
+  // Copies the parsed fields and transaction type into tx, leaving its
+  // chain untouched. Only meaningful when valid().
+  void apply(UnsignedTx& tx) const;
+
+private:
+  struct FieldState {
+    std::string content;
+    bool checked = false;
+    std::string error;        // the field's own rule
+    std::string cross_error;  // a cross-field rule involving it
+  };
+
+  FieldState& state(TxField field) noexcept { return fields_[static_cast<size_t>(field)]; }
+  const FieldState& state(TxField field) const noexcept { return fields_[static_cast<size_t>(field)]; }
+  bool applies(TxField field) const noexcept;
+
+  std::string checkField(TxField field, const std::string& content);
+  std::string checkData(const std::string& content);
+  // Cross-field rules; true if their error changed
+  bool checkFees();
+  bool checkIntrinsicGas();
+
+  std::array<FieldState, kTxFieldCount> fields_;
+  bool eip1559_;
+  bool value_in_eth_;
+  UnsignedTx parsed_;
+  uint64_t revision_ = 0;
+
+  // Calldata scanned so far: hex digits verified after "0x", whole bytes
+  // among them
+  size_t data_checked_ = 0;
+  bool data_digits_ok_ = true;
+  uint64_t data_zero_bytes_ = 0;
+  uint64_t data_nonzero_bytes_ = 0;
+};
+
+} // namespace app
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "qr_generator.hpp"
+
+namespace app {
+
+// Marks a fountain-coded frame. The rest of the frame is Base45 of
+// FountainHeader (big endian) followed by one fragment-sized block.
+constexpr const char* kFountainFramePrefix = "F:";
+constexpr size_t kFountainHeaderSize = 13;
+
+// Set in FountainHeader::flags when the message is a zlib stream primed
+// with TxEnvelopeDictionary() rather than the raw payload.
+constexpr uint8_t kFountainFlagDeflated = 0x01;
+
+struct FountainHeader {
+  uint32_t seq = 0;             // 1-based frame number; never repeats
+  uint32_t message_length = 0;  // bytes of message before padding
+  uint32_t checksum = 0;        // CRC-32 of the message
+  uint8_t flags = 0;
+};
+
+// CRC-32 (IEEE 802.3, as used by zlib/PNG).
+uint32_t Crc32(const uint8_t* data, size_t length);
+
+// Fragment indexes XORed into frame `seq`, in ascending order. Frames
+// 1..fragment_count carry one fragment each (systematic part); later frames
+// are dense random combinations drawn from a PRNG seeded by seq and checksum,
+// so a Gaussian-elimination receiver needs only about two frames beyond
+// fragment_count whichever frames it missed.
+// mini-app-broadcaster/lib/fountain.ts mirrors this exactly.
+std::vector<uint32_t> FountainFragmentIndexes(uint32_t seq, uint32_t fragment_count, uint32_t checksum);
+
+/**
+ * Rateless (systematic random linear fountain) encoder for air-gapped QR transfer.
+ * Unlike the P{i}/{n}: sequence from GenerateQRs, the receiver can rebuild
+ * the payload from any sufficiently large set of frames, so a missed frame
+ * costs one more frame instead of a full loop.
+ */
+class FountainEncoder {
+public:
+  // Deflates payload when that makes it smaller and sizes fragments so every
+  // frame fits one symbol of at most options.max_version at options.ecc.
+  explicit FountainEncoder(const std::string& payload, const QRPlanOptions& options = {});
+
+  uint32_t fragmentCount() const { return fragment_count_; }
+  size_t fragmentSize() const { return fragment_size_; }
+  uint32_t checksum() const { return header_.checksum; }
+  bool valid() const { return fragment_count_ > 0; }
+
+  // Frame text for seq >= 1.
+  std::string frame(uint32_t seq) const;
+  QRCode qr(uint32_t seq) const;
+
+private:
+  FountainHeader header_;
+  QRPlanOptions options_;
+  std::vector<uint8_t> message_;  // padded to fragment_count_ * fragment_size_
+  size_t fragment_size_ = 0;
+  uint32_t fragment_count_ = 0;
+};
+
+} // namespace app
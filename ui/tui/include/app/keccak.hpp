@@ -0,0 +1,48 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace app {
+
+// Ethereum's Keccak-256: the original Keccak padding (0x01), not SHA3-256.
+using Hash256 = std::array<uint8_t, 32>;
+
+Hash256 Keccak256(const uint8_t* data, size_t size);
+Hash256 Keccak256(const std::string& data);
+
+// Hashes every message. Messages shorter than one block (135 bytes, which
+// covers addresses and most keys) are permuted several at a time with the
+// lanes interleaved, so the compiler can run them side by side in SIMD
+// registers; longer ones go through the streaming path.
+std::vector<Hash256> Keccak256Batch(const std::vector<std::string>& messages);
+
+/**
+ * Incremental Keccak-256 for inputs built up in pieces (e.g. an encoded
+ * transaction). finalize() may be called once; reset() starts over.
+ */
+class Keccak256Hasher {
+public:
+  Keccak256Hasher() { reset(); }
+
+  void update(const uint8_t* data, size_t size);
+  void update(const std::string& data) {
+    update(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+  }
+  Hash256 finalize();
+  void reset();
+
+  static constexpr size_t kRate = 136;  // bytes absorbed per permutation
+
+private:
+  uint64_t state_[25];
+  size_t offset_;  // bytes absorbed into the current block
+};
+
+// Lowercase hex without a prefix
+std::string ToHex(const uint8_t* data, size_t size);
+inline std::string ToHex(const Hash256& hash) { return ToHex(hash.data(), hash.size()); }
+
+} // namespace app
@@ -1,17 +1,105 @@
 #pragma once
 #include <string>
 #include <memory>
-#include <fstream>
 #include <mutex>
 #include <sstream>
 #include <chrono>
 #include <thread>
+#include <atomic>
+#include <charconv>
+#include <cstdio>
+#include <string_view>
+#include <type_traits>
+
+// Lowest level compiled in, from the APP_LOG_MIN_LEVEL CMake option
+// (0 = TRACE ... 5 = FATAL). Calls below it generate no code at all.
+#ifndef APP_LOG_MIN_LEVEL
+#define APP_LOG_MIN_LEVEL 0
+#endif
 
 namespace app {
 
+namespace detail {
+
+// Basename of a path; constexpr so the LOG_* macros strip __FILE__ at compile time
+constexpr const char* FileBaseName(const char* path) noexcept {
+    const char* base = path;
+    for (const char* p = path; *p; ++p) {
+        if (*p == '/' || *p == '\\') {
+            base = p + 1;
+        }
+    }
+    return base;
+}
+
+inline void AppendLogArg(std::string& out, const std::string& value) { out += value; }
+inline void AppendLogArg(std::string& out, std::string_view value) { out += value; }
+inline void AppendLogArg(std::string& out, const char* value) { out += value ? value : "(null)"; }
+inline void AppendLogArg(std::string& out, char value) { out += value; }
+inline void AppendLogArg(std::string& out, bool value) { out += value ? "true" : "false"; }
+
+template <typename T>
+void AppendLogArg(std::string& out, const T& value) {
+    if constexpr (std::is_enum_v<T>) {
+        AppendLogArg(out, static_cast<std::underlying_type_t<T>>(value));
+    } else if constexpr (std::is_integral_v<T>) {
+        char buffer[24];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+    } else if constexpr (std::is_floating_point_v<T>) {
+        char buffer[32];
+        int length = std::snprintf(buffer, sizeof(buffer), "%g", static_cast<double>(value));
+        out.append(buffer, length > 0 ? static_cast<size_t>(length) : 0);
+    } else if constexpr (std::is_pointer_v<T>) {
+        char buffer[24];
+        int length = std::snprintf(buffer, sizeof(buffer), "%p", static_cast<const void*>(value));
+        out.append(buffer, length > 0 ? static_cast<size_t>(length) : 0);
+    } else {
+        // Anything else with an operator<<
+        thread_local std::ostringstream stream;
+        stream.str(std::string());
+        stream << value;
+        out += stream.str();
+    }
+}
+
+// Copies the rest of fmt, collapsing "{{" and "}}"
+inline void FormatLogInto(std::string& out, const char* fmt) {
+    for (; *fmt; ++fmt) {
+        if ((fmt[0] == '{' && fmt[1] == '{') || (fmt[0] == '}' && fmt[1] == '}')) {
+            ++fmt;
+        }
+        out += *fmt;
+    }
+}
+
+// Replaces each "{}" with the next argument; surplus arguments are ignored
+template <typename T, typename... Rest>
+void FormatLogInto(std::string& out, const char* fmt, const T& first, const Rest&... rest) {
+    for (; *fmt; ++fmt) {
+        if (fmt[0] == '{' && fmt[1] == '}') {
+            AppendLogArg(out, first);
+            FormatLogInto(out, fmt + 2, rest...);
+            return;
+        }
+        if ((fmt[0] == '{' && fmt[1] == '{') || (fmt[0] == '}' && fmt[1] == '}')) {
+            ++fmt;
+        }
+        out += *fmt;
+    }
+}
+
+// Swallows the arguments of a compiled-out log call
+template <typename... Args>
+inline void DiscardLogArgs(const Args&...) noexcept {}
+
+} // namespace detail
+
 /**
  * Thread-safe logging system with configurable levels and output.
  * Supports both file and console output with timestamp formatting.
+ * In asynchronous mode callers only format and enqueue a record; a writer
+ * thread drains the queue in batches, so logging never blocks on I/O.
  */
 class Logger {
 public:
@@ -27,19 +115,67 @@ public:
     // Singleton pattern for global access
     static Logger& getInstance();
     
-    // Initialize logger with file path and level
+    // Flush policy for the asynchronous backend
+    struct AsyncOptions {
+        AsyncOptions() {}
+        
+        // Records held before new ones are dropped; rounded up to a power of two
+        size_t queue_capacity = 8192;
+        // Longest a record waits in the queue before the writer picks it up
+        std::chrono::milliseconds flush_interval{100};
+        // Records at or above this level wake the writer immediately;
+        // FATAL additionally blocks the caller until it has been written
+        Level flush_level = Level::ERROR;
+    };
+    
+    // Initialize logger with file path and level. Messages are written on the
+    // calling thread; this is the synchronous fallback.
     bool initialize(const std::string& log_file_path, Level min_level = Level::INFO, 
                    bool console_output = true, size_t max_file_size_mb = 10);
     
+    // Same, but with the asynchronous backend: a lock-free multi-producer
+    // queue of preformatted records and a writer thread issuing batched write(2)s
+    bool initializeAsync(const std::string& log_file_path, Level min_level = Level::INFO,
+                         bool console_output = true, size_t max_file_size_mb = 10,
+                         const AsyncOptions& options = AsyncOptions());
+    
+    bool isAsync() const noexcept { return async_active_.load(std::memory_order_acquire); }
+    
+    // Block until every record queued so far has been written
+    void flush() noexcept;
+    
     // Cleanup resources
     void shutdown() noexcept;
     
+    // Cheap check made by the LOG_* macros before building any message
+    bool isEnabled(Level level) const noexcept {
+        return level >= min_level_.load(std::memory_order_relaxed) &&
+               initialized_.load(std::memory_order_acquire);
+    }
+    
     // Main logging methods
     void log(Level level, const std::string& message, 
              const char* file = __FILE__, 
              int line = __LINE__,
              const char* function = nullptr) noexcept;
     
+    // Format-string logging: each "{}" in fmt takes the next argument and
+    // "{{"/"}}" are literal braces. The message is built in a per-thread
+    // buffer, so steady-state logging allocates nothing. Prefer the LOG_*F
+    // macros, which don't evaluate the arguments when the level is off.
+    template <typename... Args>
+    void logf(Level level, const char* file, int line, const char* function,
+              const char* fmt, const Args&... args) noexcept {
+        try {
+            thread_local std::string message;
+            message.clear();
+            detail::FormatLogInto(message, fmt, args...);
+            log(level, message, file, line, function);
+        } catch (...) {
+            // Logging should never throw exceptions
+        }
+    }
+    
     // Convenience methods
     void trace(const std::string& message, const char* file = __builtin_FILE(), 
                int line = __builtin_LINE(), const char* function = __builtin_FUNCTION()) noexcept {
@@ -72,11 +208,11 @@ public:
     }
     
     // Configuration
-    void setLevel(Level min_level) noexcept { min_level_ = min_level; }
-    Level getLevel() const noexcept { return min_level_; }
+    void setLevel(Level min_level) noexcept { min_level_.store(min_level, std::memory_order_relaxed); }
+    Level getLevel() const noexcept { return min_level_.load(std::memory_order_relaxed); }
     
-    void setConsoleOutput(bool enable) noexcept { console_output_ = enable; }
-    bool getConsoleOutput() const noexcept { return console_output_; }
+    void setConsoleOutput(bool enable) noexcept { console_output_.store(enable, std::memory_order_relaxed); }
+    bool getConsoleOutput() const noexcept { return console_output_.load(std::memory_order_relaxed); }
     
     // Utilities
     static std::string levelToString(Level level) noexcept;
@@ -102,43 +238,126 @@ public:
                      const char* function = __builtin_FUNCTION()) noexcept;
 
 private:
-    Logger() = default;
+    Logger();
     ~Logger();
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
     
-    // Thread-safe file writing
+    // Queue and writer thread of the asynchronous backend (logger.cpp)
+    struct AsyncBackend;
+    
+    // Thread-safe file writing. In async mode the file is only touched by
+    // the writer thread; mutex_ still guards (re)initialisation.
     mutable std::mutex mutex_;
-    std::ofstream log_file_;
+    int log_fd_ = -1;
     std::string log_file_path_;
-    Level min_level_ = Level::INFO;
-    bool console_output_ = true;
-    bool initialized_ = false;
+    std::atomic<Level> min_level_{Level::INFO};
+    std::atomic<bool> console_output_{true};
+    std::atomic<bool> initialized_{false};
+    std::atomic<bool> async_active_{false};
     size_t max_file_size_bytes_ = 10 * 1024 * 1024; // 10MB default
     size_t current_file_size_ = 0;
+    std::unique_ptr<AsyncBackend> async_;
     
     // Internal helpers
+    bool openLogFile(const std::string& log_file_path, Level min_level,
+                     bool console_output, size_t max_file_size_mb);
+    void stopAsyncWriter() noexcept;
+    void closeLogFile() noexcept;
+    void asyncWriterLoop() noexcept;
+    
     std::string formatMessage(Level level, const std::string& message,
                              const char* file, int line, const char* function) const noexcept;
+    void formatRecord(std::string& out, Level level, const std::string& message,
+                      const char* file, int line, const char* function) const noexcept;
     
     std::string getCurrentTimestamp() const noexcept;
-    void writeToFile(const std::string& formatted_message) noexcept;
-    void writeToConsole(const std::string& formatted_message) noexcept;
-    void rotateLogFileIfNeeded() noexcept;
-    std::string extractFileName(const char* file_path) const noexcept;
+    void appendTimestamp(std::string& out) const noexcept;
+    void writeRecords(const std::string& records) noexcept;
+    void writeToFile(const std::string& records) noexcept;
+    void writeToConsole(const std::string& records) noexcept;
+    // Returns the path of the backup when the file was rotated
+    std::string rotateLogFileIfNeeded() noexcept;
+    const char* extractFileName(const char* file_path) const noexcept;
 };
 
 } // namespace app
 
-// Convenient macros for logging
-#define LOG_TRACE(msg) app::Logger::getInstance().trace(msg, __FILE__, __LINE__, __FUNCTION__)
-#define LOG_DEBUG(msg) app::Logger::getInstance().debug(msg, __FILE__, __LINE__, __FUNCTION__)
-#define LOG_INFO(msg) app::Logger::getInstance().info(msg, __FILE__, __LINE__, __FUNCTION__)
-#define LOG_WARN(msg) app::Logger::getInstance().warn(msg, __FILE__, __LINE__, __FUNCTION__)
-#define LOG_ERROR(msg) app::Logger::getInstance().error(msg, __FILE__, __LINE__, __FUNCTION__)
-#define LOG_FATAL(msg) app::Logger::getInstance().fatal(msg, __FILE__, __LINE__, __FUNCTION__)
+// Source file name without its directory, resolved at compile time
+#define APP_LOG_FILE_NAME ([] { constexpr const char* name = app::detail::FileBaseName(__FILE__); return name; }())
+
+// The message expression is only evaluated when the level is enabled
+#define APP_LOG_MESSAGE(level, ...) \
+    do { \
+        if (app::Logger::getInstance().isEnabled(app::Logger::Level::level)) { \
+            app::Logger::getInstance().log(app::Logger::Level::level, __VA_ARGS__, \
+                                           APP_LOG_FILE_NAME, __LINE__, __FUNCTION__); \
+        } \
+    } while (0)
+
+#define APP_LOG_FORMAT(level, ...) \
+    do { \
+        if (app::Logger::getInstance().isEnabled(app::Logger::Level::level)) { \
+            app::Logger::getInstance().logf(app::Logger::Level::level, APP_LOG_FILE_NAME, \
+                                            __LINE__, __FUNCTION__, __VA_ARGS__); \
+        } \
+    } while (0)
+
+// Below APP_LOG_MIN_LEVEL: still type-checked, never evaluated, no code
+#define APP_LOG_DISCARD(...) \
+    do { \
+        if (false) { \
+            app::detail::DiscardLogArgs(__VA_ARGS__); \
+        } \
+    } while (0)
+
+// Convenient macros for logging. LOG_X(msg) takes a std::string;
+// LOG_XF(fmt, args...) takes a "{}" format string.
+#if APP_LOG_MIN_LEVEL <= 0
+#define LOG_TRACE(...) APP_LOG_MESSAGE(TRACE, __VA_ARGS__)
+#define LOG_TRACEF(...) APP_LOG_FORMAT(TRACE, __VA_ARGS__)
+#else
+#define LOG_TRACE(...) APP_LOG_DISCARD(__VA_ARGS__)
+#define LOG_TRACEF(...) APP_LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if APP_LOG_MIN_LEVEL <= 1
+#define LOG_DEBUG(...) APP_LOG_MESSAGE(DEBUG, __VA_ARGS__)
+#define LOG_DEBUGF(...) APP_LOG_FORMAT(DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) APP_LOG_DISCARD(__VA_ARGS__)
+#define LOG_DEBUGF(...) APP_LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if APP_LOG_MIN_LEVEL <= 2
+#define LOG_INFO(...) APP_LOG_MESSAGE(INFO, __VA_ARGS__)
+#define LOG_INFOF(...) APP_LOG_FORMAT(INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) APP_LOG_DISCARD(__VA_ARGS__)
+#define LOG_INFOF(...) APP_LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if APP_LOG_MIN_LEVEL <= 3
+#define LOG_WARN(...) APP_LOG_MESSAGE(WARN, __VA_ARGS__)
+#define LOG_WARNF(...) APP_LOG_FORMAT(WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) APP_LOG_DISCARD(__VA_ARGS__)
+#define LOG_WARNF(...) APP_LOG_DISCARD(__VA_ARGS__)
+#endif
+
+#if APP_LOG_MIN_LEVEL <= 4
+#define LOG_ERROR(...) APP_LOG_MESSAGE(ERROR, __VA_ARGS__)
+#define LOG_ERRORF(...) APP_LOG_FORMAT(ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) APP_LOG_DISCARD(__VA_ARGS__)
+#define LOG_ERRORF(...) APP_LOG_DISCARD(__VA_ARGS__)
+#endif
+
+// FATAL is never compiled out
+#define LOG_FATAL(...) APP_LOG_MESSAGE(FATAL, __VA_ARGS__)
+#define LOG_FATALF(...) APP_LOG_FORMAT(FATAL, __VA_ARGS__)
 
-#define LOG_EXCEPTION(e, context) app::Logger::getInstance().logException(e, context, __FILE__, __LINE__, __FUNCTION__)
+#define LOG_EXCEPTION(e, context) app::Logger::getInstance().logException(e, context, APP_LOG_FILE_NAME, __LINE__, __FUNCTION__)
 
 // Performance timing macro
 #define PERF_TIMER(name) auto timer_##__LINE__ = app::Logger::getInstance().createTimer(name)
\ No newline at end of file
@@ -0,0 +1,142 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace app {
+
+namespace detail {
+
+// Shard used by the calling thread. Threads are assigned round robin, so up
+// to kMetricShards threads each update their own cache lines.
+constexpr size_t kMetricShards = 8;
+size_t MetricShard() noexcept;
+
+} // namespace detail
+
+/** Monotonic event counter; add() is one relaxed atomic increment. */
+class Counter {
+public:
+  void add(uint64_t n = 1) noexcept {
+    shards_[detail::MetricShard()].value.fetch_add(n, std::memory_order_relaxed);
+  }
+  uint64_t value() const noexcept;
+
+private:
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> value{0};
+  };
+  std::array<Shard, detail::kMetricShards> shards_;
+};
+
+struct HistogramSnapshot {
+  uint64_t count = 0;
+  uint64_t sum_ns = 0;
+  uint64_t min_ns = 0;
+  uint64_t max_ns = 0;
+  std::vector<uint64_t> buckets;  // merged counts, indexed like Histogram
+
+  double meanNs() const noexcept { return count ? static_cast<double>(sum_ns) / count : 0; }
+  // Upper bound of the bucket holding the p-th percentile (0-100), capped at
+  // max_ns; within about 6% of the exact value
+  uint64_t percentileNs(double p) const noexcept;
+};
+
+/**
+ * Latency histogram with HDR-style log-linear buckets: every power of two is
+ * split into 16 sub-buckets, so any value from 1 ns up to 2^40 ns (about 18
+ * minutes) is kept to within 1/16 of itself. Larger ones land in an overflow
+ * bucket of their own (max stays exact). Bucket arrays are sharded per thread and updated with
+ * relaxed atomics, so record() never takes a lock or contends with the
+ * threads recording next to it; snapshot() merges the shards.
+ */
+class Histogram {
+public:
+  static constexpr int kSubBucketBits = 4;
+  static constexpr int kMaxExponent = 39;  // highest bit of the largest bucketed value
+  // Sub-buckets for every exponent up to kMaxExponent, then the overflow bucket
+  static constexpr size_t kOverflowBucket = (kMaxExponent - kSubBucketBits + 2) << kSubBucketBits;
+  static constexpr size_t kBucketCount = kOverflowBucket + 1;
+
+  Histogram();
+
+  void record(std::chrono::nanoseconds elapsed) noexcept {
+    recordNs(elapsed.count() > 0 ? static_cast<uint64_t>(elapsed.count()) : 0);
+  }
+  void recordNs(uint64_t ns) noexcept;
+
+  HistogramSnapshot snapshot() const;
+
+  static size_t BucketIndex(uint64_t ns) noexcept;
+  static uint64_t BucketUpperBound(size_t index) noexcept;
+
+private:
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> min{UINT64_MAX};
+    std::atomic<uint64_t> max{0};
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets{};
+  };
+  std::unique_ptr<Shard[]> shards_;
+};
+
+struct MetricsSnapshot {
+  std::vector<std::pair<std::string, uint64_t>> counters;               // by name
+  std::vector<std::pair<std::string, HistogramSnapshot>> histograms;    // by name
+
+  // {"counters": {...}, "histograms": {"name": {"count", "mean_ns", "p50_ns", ...}}}
+  std::string toJson() const;
+};
+
+/**
+ * Process-wide registry of named counters and latency histograms. Lookups
+ * take a mutex, so hot paths look their metric up once and keep the
+ * reference (metrics are never removed); recording is lock-free.
+ */
+class Metrics {
+public:
+  static Metrics& shared();
+
+  Counter& counter(const std::string& name);
+  Histogram& histogram(const std::string& name);
+
+  MetricsSnapshot snapshot() const;
+  // Writes snapshot().toJson() to path through a temporary file
+  bool writeJson(const std::string& path) const noexcept;
+
+private:
+  Metrics() = default;
+
+  mutable std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<Counter>> counters_;
+  std::map<std::string, std::unique_ptr<Histogram>> histograms_;
+};
+
+/** Records the lifetime of the enclosing scope into a histogram. */
+class ScopedLatency {
+public:
+  explicit ScopedLatency(Histogram& histogram)
+      : histogram_(histogram), started_(std::chrono::steady_clock::now()) {}
+  ~ScopedLatency() { histogram_.record(std::chrono::steady_clock::now() - started_); }
+
+  ScopedLatency(const ScopedLatency&) = delete;
+  ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+  Histogram& histogram_;
+  std::chrono::steady_clock::time_point started_;
+};
+
+// "850 ns", "12.3 us", "4.56 ms", "1.20 s"
+std::string FormatNanoseconds(uint64_t ns);
+
+} // namespace app
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace app {
+
+// Marks a payload produced by CompressPayload(). Everything after the prefix
+// is a Base45-encoded zlib stream, so the whole string stays in the QR
+// alphanumeric character set (5.5 bits per character instead of 8).
+constexpr const char* kCompressedPayloadPrefix = "Z:";
+
+// RFC 9285 Base45: every 2 bytes become 3 characters from "0-9A-Z $%*+-./:".
+std::string Base45Encode(const std::vector<uint8_t>& bytes);
+// Returns false on characters outside the alphabet or an invalid length.
+bool Base45Decode(const std::string& text, std::vector<uint8_t>& out);
+
+// Preset deflate dictionary built from the signed-transaction JSON envelope
+// emitted by signing-app/eth-signer-cli.ts. Must stay byte-identical to
+// TX_ENVELOPE_DICTIONARY in mini-app-broadcaster/lib/qr-payload.ts.
+const std::string& TxEnvelopeDictionary();
+
+// zlib-format deflate/inflate of raw bytes, optionally primed with
+// TxEnvelopeDictionary(). Return false if zlib reports an error.
+bool DeflateBytes(const std::string& data, bool use_dictionary, std::vector<uint8_t>& out);
+bool InflateBytes(const std::vector<uint8_t>& compressed, std::string& out);
+
+// Deflates data (zlib format, optionally primed with TxEnvelopeDictionary())
+// and returns kCompressedPayloadPrefix + Base45. If compression does not make
+// the payload shorter, or zlib fails, data is returned unchanged.
+std::string CompressPayload(const std::string& data, bool use_dictionary = true);
+
+// Inverse of CompressPayload. Payloads without the prefix are copied as-is.
+// Returns false if the Base45 text or the zlib stream is corrupt.
+bool DecompressPayload(const std::string& payload, std::string& out);
+
+} // namespace app
@@ -0,0 +1,15 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <ftxui/dom/elements.hpp>
+#include "qr_render_cache.hpp"
+
+namespace app {
+
+// QR symbol sized to whatever box the layout gives it, drawn with half
+// blocks from QRRenderCache::shared() so redraws only copy cells, or as an
+// image by QRGraphicsOverlay::shared() when it has a backend. `encoder`
+// builds the symbol on a cache miss; GenerateQR(payload) by default.
+ftxui::Element ResponsiveQrCode(std::string payload, QREncoder encoder = {});
+
+} // namespace app
@@ -1,25 +1,132 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
 namespace app {
 
+class WorkerPool;
+
+// Row-aligned, bit-packed module grid. Each row occupies wordsPerRow()
+// contiguous 64-bit words; module x of a row lives in bit (x % 64) of word
+// (x / 64). Padding bits past `size` are always zero, so whole words can be
+// scanned without masking.
+class QRModuleMatrix {
+public:
+  static constexpr int kWordBits = 64;
+
+  QRModuleMatrix() = default;
+  explicit QRModuleMatrix(int size) { reset(size); }
+
+  // Resizes to size x size and clears every module to light.
+  void reset(int size) {
+    size_ = size > 0 ? size : 0;
+    words_per_row_ = (size_ + kWordBits - 1) / kWordBits;
+    words_.assign(static_cast<size_t>(words_per_row_) * size_, 0);
+  }
+
+  void clear() { reset(0); }
+
+  bool empty() const { return size_ == 0; }
+  int size() const { return size_; }
+  int wordsPerRow() const { return words_per_row_; }
+
+  bool get(int x, int y) const {
+    return (row(y)[x / kWordBits] >> (x % kWordBits)) & 1u;
+  }
+
+  void set(int x, int y, bool dark) {
+    uint64_t bit = uint64_t{1} << (x % kWordBits);
+    uint64_t& word = row(y)[x / kWordBits];
+    word = dark ? (word | bit) : (word & ~bit);
+  }
+
+  // Word-at-a-time access to row y (wordsPerRow() words).
+  const uint64_t* row(int y) const {
+    return words_.data() + static_cast<size_t>(y) * words_per_row_;
+  }
+  uint64_t* row(int y) {
+    return words_.data() + static_cast<size_t>(y) * words_per_row_;
+  }
+
+  const uint64_t* data() const { return words_.data(); }
+  uint64_t* data() { return words_.data(); }
+
+  bool operator==(const QRModuleMatrix& other) const {
+    return size_ == other.size_ && words_ == other.words_;
+  }
+  bool operator!=(const QRModuleMatrix& other) const { return !(*this == other); }
+
+private:
+  int size_ = 0;
+  int words_per_row_ = 0;
+  std::vector<uint64_t> words_;
+};
+
 struct QRCode {
-  std::vector<std::vector<bool>> modules;
+  QRModuleMatrix modules;
   int size = 0;
   int part = 1;
   int total_parts = 1;
   
+  // True when module (x, y) is dark. Out-of-range coordinates are light.
+  bool isDark(int x, int y) const {
+    return x >= 0 && y >= 0 && x < modules.size() && y < modules.size() &&
+           modules.get(x, y);
+  }
+
   // Renders a font-independent, scannable QR code using ASCII characters.
   // Each module is rendered as a 2x1 character block ("##" or "  ") to
   // approximate a square aspect ratio in standard terminals.
   // Includes a spec-compliant 4-module quiet zone.
   std::string toRobustAscii() const;
   std::string toCompactAscii() const;
+  // Packs two module rows into each line with "▀", "▄" and "█", so the
+  // symbol takes half the lines of toCompactAscii at the same width.
+  std::string toHalfBlockAscii() const;
+};
+
+// Error correction levels, lowest (most capacity) to highest.
+enum class QREcc { Low, Medium, Quartile, High };
+
+// Constraints for the capacity-aware chunk planner.
+struct QRPlanOptions {
+  // Largest symbol version to emit. Version 10 (57x57 modules) still scans
+  // reliably from a terminal with a phone camera.
+  int max_version = 10;
+  QREcc ecc = QREcc::Low;
+  // Give the frames of a multi-part or fountain stream a quickly chosen mask
+  // instead of the lowest-penalty one: each frame only has to scan once, so
+  // the full search gains nothing. A result that fits one symbol keeps it.
+  bool fast_mask = false;
 };
 
 // Generate QR code from data
 QRCode GenerateQR(const std::string& data);
 std::vector<QRCode> GenerateQRs(const std::string& data, size_t max_length = 100);
 
+// Same output as GenerateQRs, bit for bit. Parts are encoded concurrently on
+// `pool` (WorkerPool::shared() when null) and returned in part order; a large
+// single-part payload has its 8 mask candidates scored concurrently instead.
+std::vector<QRCode> GenerateQRsParallel(const std::string& data, size_t max_length = 100,
+                                        WorkerPool* pool = nullptr);
+
+// Splits data into the fewest payloads that each fit one symbol of at most
+// options.max_version at options.ecc, choosing numeric/alphanumeric/byte
+// segments per payload to maximise density. When more than one payload is
+// needed each one carries the "P{i}/{n}:" header understood by the
+// broadcaster's parseQRValue. Returns an empty vector if a payload cannot be
+// made to fit at all (max_version too small for the header).
+std::vector<std::string> PlanQRChunks(const std::string& data, const QRPlanOptions& options = {});
+
+// Smallest symbol version (1 to max_version) that holds payload in one
+// symbol at ecc with the segment modes PlanQRChunks uses; 0 if none does
+int QRVersionFor(const std::string& payload, QREcc ecc = QREcc::Low, int max_version = 40);
+
+// Encodes the payloads from PlanQRChunks on `pool` (WorkerPool::shared()
+// when null), in part order.
+std::vector<QRCode> GenerateQRsPlanned(const std::string& data, const QRPlanOptions& options = {},
+                                       WorkerPool* pool = nullptr);
+
 } // namespace app
\ No newline at end of file
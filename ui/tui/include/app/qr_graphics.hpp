@@ -0,0 +1,131 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "qr_generator.hpp"
+
+namespace app {
+
+// How QR symbols reach the screen. Text draws them as FTXUI cells; the
+// others draw a pixel image over cells FTXUI leaves blank for it.
+enum class QRGraphicsBackend {
+  Text,
+  Sixel,        // DEC sixel graphics (foot, mlterm, WezTerm, xterm -ti vt340)
+  Kitty,        // kitty graphics protocol
+  Framebuffer,  // /dev/fb0, for the Linux console
+};
+
+const char* QRGraphicsBackendName(QRGraphicsBackend backend);
+// "text", "sixel", "kitty" or "fb"
+std::optional<QRGraphicsBackend> ParseQRGraphicsBackend(std::string_view name);
+
+// Best backend for the terminal, from TERM, TERM_PROGRAM and KITTY_WINDOW_ID;
+// Framebuffer only on the Linux console with a writable /dev/fb0, Text
+// when in doubt
+QRGraphicsBackend DetectQRGraphicsBackend();
+
+// qr plus its quiet zone as one image, each module scale x scale pixels,
+// dark on white. Sixel is a complete DCS sequence drawn at the cursor.
+std::string EncodeSixel(const QRCode& qr, int scale, int quiet_zone = 4);
+// Kitty transmits image `image_id` (zlib-compressed RGB) and places it at
+// the cursor, leaving the cursor where it was
+std::string EncodeKitty(const QRCode& qr, int scale, int quiet_zone, uint32_t image_id);
+
+/**
+ * Memory-mapped Linux framebuffer that QR symbols are blitted to directly.
+ * 16, 24 and 32 bits per pixel are supported; dark and light are written
+ * as all-zero and all-one pixels, which holds for any channel layout.
+ */
+class Framebuffer {
+public:
+  Framebuffer() = default;
+  ~Framebuffer();
+
+  Framebuffer(const Framebuffer&) = delete;
+  Framebuffer& operator=(const Framebuffer&) = delete;
+
+  // False (and nothing is mapped) if the device is missing or its pixel
+  // format isn't supported
+  bool open(const std::string& path = "/dev/fb0") noexcept;
+  void close() noexcept;
+  bool isOpen() const noexcept { return data_ != nullptr; }
+
+  int width() const noexcept { return width_; }
+  int height() const noexcept { return height_; }
+
+  // Draws qr with its quiet zone at pixel (x, y), clipped to the screen
+  void drawQR(const QRCode& qr, int x, int y, int scale, int quiet_zone) noexcept;
+
+private:
+  uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  int width_ = 0;
+  int height_ = 0;
+  size_t stride_ = 0;           // bytes per line
+  size_t bytes_per_pixel_ = 0;
+  size_t origin_ = 0;           // byte offset of the visible area
+};
+
+/**
+ * Draws QR symbols as images on top of the FTXUI frame. While rendering,
+ * QR elements place() their symbol in the cells they were given and, if it
+ * is accepted, leave those cells blank. Once the frame has been written to
+ * the terminal, present() draws what was placed. Text frames redraw every
+ * cell, so sixel and framebuffer images are drawn again each frame; a
+ * kitty image is only transmitted again when its symbol or scale changes.
+ *
+ * Modules are scaled by the largest integer that fits the box, which needs
+ * the cell size in pixels: TIOCGWINSZ for terminal graphics, the
+ * framebuffer resolution over the console size for Framebuffer. Symbols
+ * are refused (and drawn as text) when that is unknown or under
+ * kMinScale. Used from the UI thread.
+ */
+class QRGraphicsOverlay {
+public:
+  static constexpr int kMinScale = 2;
+  static constexpr int kQuietZone = 4;
+
+  // Text until a backend is set; a Framebuffer that can't be opened
+  // falls back to Text as well
+  void setBackend(QRGraphicsBackend backend);
+  QRGraphicsBackend backend() const;
+  bool active() const;
+
+  // Symbol for the cell box at (x, y); false if it must be drawn as text
+  bool place(std::shared_ptr<const QRCode> qr, int x, int y, int width, int height);
+
+  // Draws this frame's placements; a kitty image no longer placed is deleted
+  void present();
+
+  static QRGraphicsOverlay& shared();
+
+private:
+  struct Placement {
+    std::shared_ptr<const QRCode> qr;
+    int x, y;              // top-left cell of a terminal image
+    int pixel_x, pixel_y;  // top-left pixel on the framebuffer
+    int scale;
+  };
+  struct CellSize {
+    int columns, rows;  // terminal size in cells
+    int width, height;  // pixels per cell
+  };
+
+  std::optional<CellSize> cellSizeLocked() const;
+  void writeLocked(const std::string& bytes) const;
+
+  mutable std::mutex mutex_;
+  QRGraphicsBackend backend_ = QRGraphicsBackend::Text;
+  Framebuffer framebuffer_;
+  std::vector<Placement> placements_;
+  std::shared_ptr<const QRCode> kitty_symbol_;  // image data the terminal holds
+  int kitty_scale_ = 0;                          // pixels per module it was sent at
+  bool kitty_shown_ = false;
+};
+
+} // namespace app
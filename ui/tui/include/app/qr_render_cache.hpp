@@ -0,0 +1,106 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "qr_generator.hpp"
+
+namespace app {
+
+enum class QRRenderStyle {
+  Robust,     // "##" per module, 4-module quiet zone (toRobustAscii)
+  Compact,    // "█" per module, 2-module quiet zone (toCompactAscii)
+  HalfBlock,  // "▀▄█" with two modules per cell vertically (toHalfBlockAscii)
+};
+
+// A symbol rasterised into terminal cells for a fixed box, quiet zone
+// included and centred. Glyphs are static strings shared by all rasters.
+struct QRRaster {
+  int width = 0;
+  int height = 0;
+  int modules = 0;                  // symbol size; 0 when encoding failed
+  // Cells covered by the symbol and its quiet zone, inclusive and clipped to
+  // the box; everything outside is padding a caller may leave untouched.
+  int x_min = 0, y_min = 0, x_max = -1, y_max = -1;
+  std::vector<const char*> cells;   // row-major, width * height glyphs
+  std::vector<std::string> rows;    // the same cells joined into text lines
+
+  const char* at(int x, int y) const { return cells[static_cast<size_t>(y) * width + x]; }
+};
+
+// Rasterises qr into a width x height box; a non-positive dimension means
+// the natural size of the style. A box smaller than the symbol clips it.
+QRRaster RasterizeQR(const QRCode& qr, int width, int height, QRRenderStyle style);
+
+// How a payload becomes a symbol. `key` names the encoding (planner and
+// options) and is part of the cache key, so one payload encoded two ways
+// never shares an entry. No `build` means GenerateQR(payload), under "".
+struct QREncoder {
+  std::string key;
+  std::function<QRCode()> build;
+};
+
+/**
+ * LRU cache of encoded symbols and their rasters, so redraws only copy cells.
+ * Symbols are keyed on (payload, encoder) and rasters on (payload, encoder,
+ * box, style), so a resize re-rasterises but never re-encodes. Encoding and
+ * rasterising run outside the lock, so a miss doesn't hold up other
+ * threads' hits; two threads missing together may both encode, and the
+ * first result stored wins. Safe to use from any thread.
+ */
+class QRRenderCache {
+public:
+  explicit QRRenderCache(size_t capacity = 16);
+
+  QRRenderCache(const QRRenderCache&) = delete;
+  QRRenderCache& operator=(const QRRenderCache&) = delete;
+
+  // Raster for payload; `encoder` builds the symbol on a miss
+  std::shared_ptr<const QRRaster> get(const std::string& payload, int width, int height,
+                                      QRRenderStyle style, const QREncoder& encoder = {});
+
+  // The encoded symbol alone, for outputs that draw modules themselves
+  std::shared_ptr<const QRCode> symbolFor(const std::string& payload,
+                                          const QREncoder& encoder = {});
+
+  void clear();
+  size_t size() const;
+
+  // Cache shared by the TUI views.
+  static QRRenderCache& shared();
+
+private:
+  struct SymbolEntry {
+    size_t hash;
+    std::string payload;
+    std::string encoder;
+    std::shared_ptr<const QRCode> qr;
+  };
+  struct RasterEntry {
+    size_t hash;
+    std::string payload;
+    std::string encoder;
+    int width;
+    int height;
+    QRRenderStyle style;
+    std::shared_ptr<const QRRaster> raster;
+  };
+
+  std::shared_ptr<const QRCode> symbol(size_t hash, const std::string& payload,
+                                       const QREncoder& encoder);
+  std::shared_ptr<const QRCode> findSymbolLocked(size_t hash, const std::string& payload,
+                                                 const std::string& encoder);
+  std::shared_ptr<const QRRaster> findRasterLocked(size_t hash, const std::string& payload,
+                                                   const std::string& encoder, int width,
+                                                   int height, QRRenderStyle style);
+
+  size_t capacity_;
+  mutable std::mutex mutex_;
+  std::list<SymbolEntry> symbols_;  // most recently used first
+  std::list<RasterEntry> rasters_;
+};
+
+} // namespace app
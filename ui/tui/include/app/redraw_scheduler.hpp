@@ -0,0 +1,68 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace app {
+
+/**
+ * Decides when the TUI needs a frame, instead of redrawing on a fixed timer.
+ * A redraw is posted only when something invalidated the screen (state was
+ * published, a background job finished) or a visible animation asked for its
+ * next frame. Requests arriving before the previous frame was drawn coalesce
+ * into one post, and animation frames are paced to the configured interval,
+ * so an idle screen leaves the thread asleep.
+ */
+class RedrawScheduler {
+public:
+  // `post` asks the UI loop for a redraw (e.g. PostEvent(Event::Custom)) and
+  // must be safe to call from another thread. `on_animation_frame` runs on the
+  // scheduler thread right before an animation frame is posted.
+  RedrawScheduler(std::function<void()> post, std::chrono::milliseconds frame_interval,
+                  std::function<void()> on_animation_frame = nullptr);
+  ~RedrawScheduler();
+
+  RedrawScheduler(const RedrawScheduler&) = delete;
+  RedrawScheduler& operator=(const RedrawScheduler&) = delete;
+
+  // Something visible changed; redraw as soon as the last frame is on screen.
+  void invalidate();
+
+  // Called while rendering a spinner or progress bar: post one more frame
+  // after the frame interval. Renderers re-request on every frame they want.
+  void requestAnimationFrame();
+
+  // Called by the root renderer once a frame was drawn, releasing coalesced
+  // requests. Without it, a lost frame holds requests for one interval.
+  void frameRendered();
+
+  void stop();
+
+  std::chrono::milliseconds frameInterval() const { return frame_interval_; }
+
+  // Frame interval from AppConfig::animation_speed_ms, clamped to a sane range.
+  static std::chrono::milliseconds configuredFrameInterval();
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  void run();
+
+  std::function<void()> post_;
+  std::function<void()> on_animation_frame_;
+  const std::chrono::milliseconds frame_interval_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopping_ = false;
+  bool dirty_ = false;
+  bool animation_requested_ = false;
+  bool frame_in_flight_ = false;
+  Clock::time_point posted_at_;
+  Clock::time_point last_animation_frame_;
+  std::thread thread_;
+};
+
+} // namespace app
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include "keccak.hpp"
+#include "u256.hpp"
+
+namespace app {
+
+struct UnsignedTx;
+
+/**
+ * RLP encoder that never allocates. Output goes either to a caller-provided
+ * buffer or straight into a Keccak256Hasher. size() is the full encoded size
+ * even when the buffer was too small; in that case only the first
+ * `capacity` bytes were written and overflowed() is true.
+ */
+class RlpWriter {
+public:
+  RlpWriter(uint8_t* out, size_t capacity) : out_(out), capacity_(capacity) {}
+  explicit RlpWriter(Keccak256Hasher& hasher) : hasher_(&hasher) {}
+
+  void writeBytes(const uint8_t* data, size_t size);
+  // Hex with or without 0x; false (nothing written) if malformed or odd-length
+  bool writeHexBytes(std::string_view hex);
+  // Integers use the minimal big-endian form; zero is the empty string
+  void writeUint(const U256& value);
+  void writeUint(uint64_t value) { writeUint(U256(value)); }
+
+  // Writes a list whose items are produced by fields(RlpWriter&). The items
+  // are measured with a counting pass first, so nothing is buffered.
+  template <typename Fields>
+  void writeList(Fields&& fields) {
+    RlpWriter counter(nullptr, 0);
+    fields(counter);
+    writeLength(counter.size(), 0xc0);
+    fields(*this);
+  }
+
+  // A raw byte outside the RLP structure, e.g. an EIP-2718 type prefix
+  void writeRaw(uint8_t byte) { put(&byte, 1); }
+  // Items that are already RLP-encoded, copied as they are
+  void writeEncoded(const uint8_t* data, size_t size) { put(data, size); }
+
+  size_t size() const { return size_; }
+  bool overflowed() const { return !hasher_ && size_ > capacity_; }
+
+private:
+  void put(const uint8_t* data, size_t size);
+  void writeLength(size_t length, uint8_t offset);
+
+  uint8_t* out_ = nullptr;
+  size_t capacity_ = 0;
+  Keccak256Hasher* hasher_ = nullptr;
+  size_t size_ = 0;
+};
+
+// Signing payload of tx: rlp([nonce, gasPrice, gas, to, value, data,
+// chainId, 0, 0]) for type 0 (EIP-155), 0x02 || rlp([chainId, nonce,
+// maxPriorityFee, maxFee, gas, to, value, data, []]) for type 2. Returns the
+// encoded size, which may exceed capacity (retry with a larger buffer), or 0
+// if a required field is missing or `to`/`data` is malformed.
+size_t EncodeUnsignedTx(const UnsignedTx& tx, uint8_t* out, size_t capacity) noexcept;
+
+// Keccak-256 of the signing payload, hashed as it is encoded
+std::optional<Hash256> SigningHash(const UnsignedTx& tx) noexcept;
+
+} // namespace app
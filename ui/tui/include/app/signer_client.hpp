@@ -0,0 +1,97 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+#include "cancellation.hpp"
+
+namespace app {
+
+// Fields of an ETH transfer to sign; empty values take the signer's defaults
+struct SignRequest {
+  std::string to;
+  std::string amount;    // ETH
+  std::string nonce;
+  std::string gas_price; // gwei
+  std::string gas_limit;
+  std::string chain_id;
+};
+
+struct SignResult {
+  bool ok = false;
+  std::string payload;  // signed-transaction JSON on success, error message otherwise
+};
+
+/**
+ * Client for a long-lived signing worker (eth-signer-cli.ts --serve).
+ * The worker is spawned once with a Unix socket as its stdin/stdout and keeps
+ * its Ledger transport open between requests, so a signature costs only the
+ * on-device confirmation. Both directions use frames of a 4-byte big-endian
+ * length followed by the body:
+ *   request:  "sign\n" then one "key=value\n" line per non-empty field
+ *   response: "ok\n" + signed JSON, or "error\n" + message
+ * Requests are serialised; a worker that exits is restarted on the next one.
+ */
+class SignerClient {
+public:
+  // `argv` is run through PATH lookup from `working_dir`
+  SignerClient(std::string working_dir, std::vector<std::string> argv);
+  ~SignerClient();
+
+  SignerClient(const SignerClient&) = delete;
+  SignerClient& operator=(const SignerClient&) = delete;
+
+  // Spawns the worker if it isn't running. Call early (at launch) so the
+  // worker's start-up overlaps with the user filling in the form.
+  bool start() noexcept;
+
+  // Blocks until the worker answers or `timeout` passes, which must cover the
+  // user confirming on the device. A timed-out worker is killed, and so is
+  // one whose request is cancelled (noticed within a fraction of a second).
+  SignResult sign(const SignRequest& request,
+                  std::chrono::milliseconds timeout = std::chrono::minutes(5),
+                  const CancellationToken& cancel = {}) noexcept;
+
+  // Signs requests back to back over the same worker and device session.
+  // They are all queued with the worker up front, so it moves on to the next
+  // one the moment the device confirms the last; `timeout` applies to each.
+  // on_result(i, result) runs on the calling thread in request order, with
+  // the client locked, so it should only hand the result on. The batch stops
+  // at the first request that isn't signed (refused on the device, a dead
+  // worker, a timeout or a cancellation): everything after it fails too, as
+  // its nonce would follow a gap. Returns the number signed.
+  using BatchSink = std::function<void(size_t index, const SignResult& result)>;
+  size_t signBatch(const std::vector<SignRequest>& requests, const BatchSink& on_result,
+                   std::chrono::milliseconds timeout = std::chrono::minutes(5),
+                   const CancellationToken& cancel = {}) noexcept;
+
+  void stop() noexcept;
+  bool running() const noexcept;
+
+  static std::string EncodeFrame(const std::string& body);
+  static std::string EncodeRequest(const SignRequest& request);
+
+  // Largest frame either side accepts
+  static constexpr uint32_t kMaxFrameSize = 1u << 20;
+
+private:
+  bool startLocked() noexcept;
+  void stopLocked() noexcept;
+  bool writeAll(const std::string& data) noexcept;
+  // One response frame into result; false (worker stopped) if none came
+  bool readResponseLocked(std::chrono::steady_clock::time_point deadline,
+                          const CancellationToken& cancel, SignResult& result) noexcept;
+  bool readAll(char* data, size_t size, std::chrono::steady_clock::time_point deadline,
+               const CancellationToken& cancel) noexcept;
+
+  std::string working_dir_;
+  std::vector<std::string> argv_;
+  mutable std::mutex mutex_;
+  int fd_ = -1;
+  pid_t pid_ = -1;
+};
+
+} // namespace app
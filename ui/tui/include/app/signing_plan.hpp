@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "keccak.hpp"
+#include "qr_generator.hpp"
+#include "state.hpp"
+#include "u256.hpp"
+
+namespace app {
+
+// ECDSA signature as a hardware wallet returns it
+struct TxSignature {
+  uint8_t y_parity = 0;  // recovery id, 0 or 1
+  U256 r;
+  U256 s;
+};
+
+/**
+ * Everything about signing a transaction that doesn't depend on the
+ * signature, built while the user is still reviewing it. Once the device
+ * answers, EncodeSignedTx only appends v/r/s to the pre-encoded fields.
+ */
+struct SigningPlan {
+  UnsignedTx tx;                 // the fields the plan was built from
+  std::vector<uint8_t> payload;  // signing payload (EncodeUnsignedTx)
+  Hash256 hash{};                // keccak256(payload), what the device signs
+
+  // List items of the signed transaction that precede v, r and s
+  std::vector<uint8_t> fields;
+
+  // Broadcast QR layout for the longest possible signed transaction
+  // (32-byte r and s), so it holds for whatever signature comes back
+  size_t max_signed_hex_length = 0;  // "0x" included
+  int qr_version = 0;                // as one symbol; 0 if it doesn't fit one
+  size_t qr_frames = 0;              // frames when split per QRPlanOptions
+
+  // True while tx still has the fields this plan was built from
+  bool matches(const UnsignedTx& other) const noexcept;
+};
+
+// Empty if tx isn't complete enough to encode (see EncodeUnsignedTx)
+std::optional<SigningPlan> PlanSigning(const UnsignedTx& tx, const QRPlanOptions& qr = {}) noexcept;
+
+// Signed transaction as 0x-prefixed hex: rlp([fields..., v, r, s]), with the
+// 0x02 prefix for EIP-1559 and EIP-155 v for legacy transactions
+std::string EncodeSignedTx(const SigningPlan& plan, const TxSignature& signature);
+
+} // namespace app
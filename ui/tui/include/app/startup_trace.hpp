@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace app {
+
+/**
+ * Phase timestamps for `--trace-startup`. Marks are measured from process
+ * start (static initialisation of this module), may come from any thread and
+ * cost one relaxed load while tracing is off. The report is printed after
+ * the screen has been restored, so it never lands on top of a frame.
+ */
+class StartupTrace {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  static StartupTrace& instance();
+
+  void enable() noexcept { enabled_.store(true, std::memory_order_relaxed); }
+  bool enabled() const noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+  // Records that `phase` was reached now; repeated names are kept, in order
+  void mark(const char* phase) noexcept;
+  // Records a phase that started at `started` and ends now
+  void phase(const char* name, Clock::time_point started) noexcept;
+
+  // One line per mark, sorted by time: offset from process start, time since
+  // the previous mark, duration for phases, and the recording thread
+  std::string report() const;
+  // Writes report() to stderr and the log; no-op unless enabled
+  void dump() noexcept;
+
+private:
+  struct Mark {
+    std::string phase;
+    Clock::time_point at;
+    Clock::duration duration{};
+    std::thread::id thread;
+  };
+
+  StartupTrace() = default;
+  void record(const char* phase, Clock::time_point at, Clock::duration duration) noexcept;
+
+  std::atomic<bool> enabled_{false};
+  mutable std::mutex mutex_;
+  std::vector<Mark> marks_;
+  std::thread::id main_thread_ = std::this_thread::get_id();
+};
+
+/** Times the enclosing scope as one startup phase. */
+class StartupPhase {
+public:
+  explicit StartupPhase(const char* name)
+      : name_(name), started_(StartupTrace::Clock::now()) {}
+  ~StartupPhase() { StartupTrace::instance().phase(name_, started_); }
+
+  StartupPhase(const StartupPhase&) = delete;
+  StartupPhase& operator=(const StartupPhase&) = delete;
+
+private:
+  const char* name_;
+  StartupTrace::Clock::time_point started_;
+};
+
+} // namespace app
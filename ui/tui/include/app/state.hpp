@@ -6,15 +6,19 @@
 #include <memory>
 #include <mutex>
 #include <atomic>
+#include <cstdint>
 #include <stdexcept>
 #include <functional>
 #include "qr_generator.hpp"
+#include "address_index.hpp"
+#include "u256.hpp"
 
 namespace app {
 
 // Forward declarations
 class Config;
 class Logger;
+class MappedAddressBook;
 
 // Exception types for better error handling
 class StateException : public std::runtime_error {
@@ -69,45 +73,52 @@ struct KnownAddress {
 
 // Transaction structure supporting both legacy and EIP-1559 with validation
 struct UnsignedTx {
+  // Numeric fields are parsed once, when the user's input is accepted; an
+  // empty optional is a field that hasn't been entered yet
   std::string to;
-  std::string value;  // in Wei
+  std::optional<U256> value;  // in Wei
   std::string data;
-  std::string nonce;
-  std::string gas_limit;
+  std::optional<uint64_t> nonce;
+  std::optional<uint64_t> gas_limit;
   
-  // Legacy transaction
-  std::string gas_price;
+  // Legacy transaction (Wei)
+  std::optional<U256> gas_price;
   
-  // EIP-1559 transaction
-  std::string max_fee_per_gas;
-  std::string max_priority_fee_per_gas;
+  // EIP-1559 transaction (Wei)
+  std::optional<U256> max_fee_per_gas;
+  std::optional<U256> max_priority_fee_per_gas;
   
   int chain_id = 8453;  // Base network
   int type = 2;  // 0=legacy, 2=EIP-1559
   
   // Helper methods
   bool isEIP1559() const noexcept { return type == 2; }
-  bool isEmpty() const noexcept { return to.empty() && value.empty(); }
+  bool isEmpty() const noexcept { return to.empty() && !value; }
   
   // Validation and bounds checking
   bool isValid() const noexcept;
   std::vector<std::string> getValidationErrors() const noexcept;
   
-  // Safe numeric operations with overflow protection
-  bool setValueFromString(const std::string& value_str) noexcept;
+  // Input-time parsing with overflow protection. Each returns false and
+  // leaves the field unchanged if the text is not a valid amount.
+  bool setValueFromString(const std::string& value_str) noexcept;  // Wei, decimal or 0x
+  bool setValueFromEth(const std::string& eth_str) noexcept;       // e.g. "0.5"
   bool setNonceFromString(const std::string& nonce_str) noexcept;
   bool setGasLimitFromString(const std::string& gas_limit_str) noexcept;
+  bool setGasPriceFromGwei(const std::string& gwei_str) noexcept;
+  bool setMaxFeeFromGwei(const std::string& gwei_str) noexcept;
+  bool setPriorityFeeFromGwei(const std::string& gwei_str) noexcept;
   
   // Clear all fields safely
   void clear() noexcept {
     to.clear();
-    value.clear();
+    value.reset();
     data = "0x";
-    nonce.clear();
-    gas_limit.clear();
-    gas_price.clear();
-    max_fee_per_gas.clear();
-    max_priority_fee_per_gas.clear();
+    nonce.reset();
+    gas_limit.reset();
+    gas_price.reset();
+    max_fee_per_gas.reset();
+    max_priority_fee_per_gas.reset();
     chain_id = 8453;
     type = 2;
   }
@@ -202,9 +213,60 @@ public:
   // Input validation state
   std::map<std::string, std::string> field_errors;
 
+  /**
+   * Immutable copy of the mutex-guarded fields above, published by every
+   * setter. Readers hold a pointer instead of locking and copying, and can
+   * compare `version` with the one they last rendered to skip rebuilding.
+   * Collections are shared with the previous snapshot unless the setter
+   * changed them, so publishing a status line copies no lists. Writes made
+   * directly to the public fields are not published.
+   *
+   * The readers are the thread-safe views (views_thread_safe.cpp), which
+   * are not in the build yet; the app that runs (simple_transaction.cpp)
+   * keeps its own state and never reads a snapshot.
+   */
+  struct Snapshot {
+    uint64_t version = 0;
+
+    Route route = Route::ConnectWallet;
+    Route previous_route = Route::ConnectWallet;
+    UnsignedTx unsigned_tx;
+    std::string signed_hex;
+
+    std::string status;
+    std::string error;
+    std::string info;
+    std::string last_error;
+
+    std::string account_path;
+    std::shared_ptr<const std::vector<DeviceInfo>> devices;
+    std::shared_ptr<const std::vector<KnownAddress>> known_addresses;
+    std::shared_ptr<const std::vector<KnownAddress>> usb_contacts;
+    std::string address_suggestion;
+    std::string network_name;
+    std::shared_ptr<const std::map<std::string, std::string>> field_errors;
+
+    // Search index over known_addresses (ids are positions in it); shared
+    // between snapshots until the address book changes
+    std::shared_ptr<const AddressIndex> known_address_index;
+
+    // Imported binary address book, searched after known_addresses; null
+    // when none is configured
+    std::shared_ptr<const MappedAddressBook> address_book;
+  };
+
 private:
   // Private members for internal state management
-  mutable std::mutex mutex_;  // Thread safety
+  mutable std::mutex mutex_;  // Thread safety; serialises writers only
+  std::shared_ptr<const Snapshot> snapshot_;  // accessed via std::atomic_load/store
+  std::atomic<uint64_t> version_{0};
+  // Collections changed since the last publish; unchanged ones are shared
+  // with the previous snapshot (and known addresses keep their index)
+  bool devices_changed_ = true;
+  bool known_addresses_changed_ = true;
+  bool usb_contacts_changed_ = true;
+  bool field_errors_changed_ = true;
+  std::shared_ptr<const MappedAddressBook> address_book_;
   std::atomic<bool> shutdown_requested_{false};
   
   // Error recovery state
@@ -214,90 +276,47 @@ private:
   // State change callbacks
   std::vector<std::function<void(Route, Route)>> route_change_callbacks_;
   std::vector<std::function<void(const std::string&)>> error_callbacks_;
+  std::vector<std::function<void(uint64_t)>> change_callbacks_;
+
+  // Copies the guarded fields into a new snapshot and swaps it in; mutex_
+  // must be held so concurrent writers publish in order.
+  void publishLocked();
 
 public:
-  AppState() = default;
+  AppState();
   ~AppState() = default;
   
   // Copy prevention for thread safety
   AppState(const AppState&) = delete;
   AppState& operator=(const AppState&) = delete;
+
+  static constexpr size_t kMaxUsbContacts = 100;
   
-  // Safe getters with locking
-  Route getRoute() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return route;
-  }
-  
-  Route getPreviousRoute() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return previous_route;
-  }
-  
-  UnsignedTx getUnsignedTx() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return unsigned_tx;
-  }
-  
-  std::string getSignedHex() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return signed_hex;
-  }
-  
-  std::string getStatus() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return status;
-  }
-  
-  std::string getError() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return error;
-  }
-  
-  std::string getInfo() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return info;
-  }
-  
-  std::string getLastError() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return last_error;
-  }
-  
-  std::vector<DeviceInfo> getDevices() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return devices;
-  }
-  
-  std::vector<KnownAddress> getKnownAddresses() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return known_addresses;
-  }
-  
-  std::vector<KnownAddress> getUsbContacts() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return usb_contacts;
-  }
-  
-  std::string getAddressSuggestion() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return address_suggestion;
-  }
-  
-  std::map<std::string, std::string> getFieldErrors() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return field_errors;
-  }
-  
-  std::string getNetworkName() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return network_name;
-  }
-  
-  std::string getAccountPath() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return account_path;
+  // Latest published state; never null. Hold the pointer for a whole frame
+  // so every field read comes from the same version.
+  std::shared_ptr<const Snapshot> snapshot() const noexcept {
+    return std::atomic_load_explicit(&snapshot_, std::memory_order_acquire);
   }
+
+  // Bumped on every publish; cheaper than snapshot() for change checks.
+  uint64_t version() const noexcept { return version_.load(std::memory_order_acquire); }
+
+  // Copying getters, served from the snapshot without taking the lock
+  Route getRoute() const { return snapshot()->route; }
+  Route getPreviousRoute() const { return snapshot()->previous_route; }
+  UnsignedTx getUnsignedTx() const { return snapshot()->unsigned_tx; }
+  std::string getSignedHex() const { return snapshot()->signed_hex; }
+  std::string getStatus() const { return snapshot()->status; }
+  std::string getError() const { return snapshot()->error; }
+  std::string getInfo() const { return snapshot()->info; }
+  std::string getLastError() const { return snapshot()->last_error; }
+  std::vector<DeviceInfo> getDevices() const { return *snapshot()->devices; }
+  std::vector<KnownAddress> getKnownAddresses() const { return *snapshot()->known_addresses; }
+  std::vector<KnownAddress> getUsbContacts() const { return *snapshot()->usb_contacts; }
+  std::string getAddressSuggestion() const { return snapshot()->address_suggestion; }
+  std::map<std::string, std::string> getFieldErrors() const { return *snapshot()->field_errors; }
+  std::string getNetworkName() const { return snapshot()->network_name; }
+  std::string getAccountPath() const { return snapshot()->account_path; }
   
   // Atomic getters (no locking needed)
   bool hasUnsigned() const noexcept { return has_unsigned.load(); }
@@ -324,7 +343,11 @@ public:
   bool setDevices(const std::vector<DeviceInfo>& devices) noexcept;
   bool addKnownAddress(const KnownAddress& address) noexcept;
   bool setKnownAddresses(const std::vector<KnownAddress>& addresses) noexcept;
+  void setAddressBook(std::shared_ptr<const MappedAddressBook> book) noexcept;
   bool setUsbContacts(const std::vector<KnownAddress>& contacts) noexcept;
+  // Adds a batch from a running scan; invalid, bad-checksum and duplicate
+  // entries are dropped and the list stops growing at kMaxUsbContacts
+  bool appendUsbContacts(const std::vector<KnownAddress>& contacts) noexcept;
   void setAddressSuggestion(const std::string& suggestion) noexcept;
   void setFieldErrors(const std::map<std::string, std::string>& errors) noexcept;
   void setNetworkName(const std::string& name) noexcept;
@@ -361,9 +384,17 @@ public:
   // Callback management
   void addRouteChangeCallback(std::function<void(Route, Route)> callback);
   void addErrorCallback(std::function<void(const std::string&)> callback);
+  // Runs after each publish with the new version, with the state lock held:
+  // it must not call setters (e.g. only mark a redraw scheduler dirty).
+  void addChangeCallback(std::function<void(uint64_t)> callback);
   void clearCallbacks() noexcept;
   
   // Utility methods
+  // Best `limit` known addresses whose address or name contains query,
+  // topped up with prefix matches from the imported address book
+  std::vector<KnownAddress> searchKnownAddresses(const std::string& query, size_t limit) const;
+  // Entry with exactly this address from either source
+  std::optional<KnownAddress> findKnownAddress(const std::string& address) const;
   size_t getKnownAddressCount() const noexcept;
   size_t getUsbContactCount() const noexcept;
   bool hasFieldError(const std::string& field) const noexcept;
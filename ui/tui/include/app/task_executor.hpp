@@ -0,0 +1,81 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "cancellation.hpp"
+#include "worker_pool.hpp"
+
+namespace app {
+
+/**
+ * Runs the UI's background work on a fixed set of threads instead of one
+ * detached std::thread per operation. Each task is `work` on a worker
+ * followed by an optional `done` handed to the poster exactly once, which
+ * is expected to run it on the UI thread (ScreenInteractive::Post plus one
+ * PostEvent); `done` is the place to touch UI state. A task whose token is
+ * cancelled before it starts is dropped, and its `done` is skipped if the
+ * token is cancelled by the time `work` returns.
+ *
+ * Delayed tasks sit in a hashed timer wheel served by one thread that only
+ * wakes while timers are pending; they fire within one tick of their delay.
+ */
+class TaskExecutor {
+public:
+  using Work = std::function<void(const CancellationToken&)>;
+  using Completion = std::function<void()>;
+  using Poster = std::function<void(Completion)>;
+
+  TaskExecutor(size_t num_threads, Poster poster,
+               std::chrono::milliseconds tick = std::chrono::milliseconds(10), size_t wheel_slots = 256);
+  ~TaskExecutor();  // shutdown()
+
+  TaskExecutor(const TaskExecutor&) = delete;
+  TaskExecutor& operator=(const TaskExecutor&) = delete;
+
+  // Either of work and done may be null
+  void submit(Work work, Completion done = nullptr, CancellationToken token = {});
+  void submitAfter(std::chrono::milliseconds delay, Work work, Completion done = nullptr,
+                   CancellationToken token = {});
+
+  // Drops queued and delayed tasks, then waits for running ones, which
+  // should be watching their tokens. Nothing is posted once this returns.
+  void shutdown() noexcept;
+
+private:
+  struct Task {
+    Work work;
+    Completion done;
+    CancellationToken token;
+  };
+  struct Timer {
+    uint64_t rounds;  // full turns of the wheel left before it fires
+    Task task;
+  };
+
+  void run(Task& task) noexcept;
+  void enqueue(Task task);
+  void timerLoop();
+
+  Poster poster_;
+  const std::chrono::milliseconds tick_;
+  CancellationSource stop_;
+  const CancellationToken stopped_ = stop_.token();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopping_ = false;
+  std::vector<std::vector<Timer>> wheel_;
+  size_t cursor_ = 0;
+  size_t timer_count_ = 0;
+  std::thread timer_thread_;
+
+  std::unique_ptr<WorkerPool> workers_;
+};
+
+} // namespace app
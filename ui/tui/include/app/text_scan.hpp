@@ -0,0 +1,94 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace app {
+
+// Regex-free scanners behind Validator. The grammars are small DFAs written
+// as constexpr functions, so fixed inputs can be checked at compile time.
+
+// True if every byte is [0-9a-fA-F]; an empty range is hex. Uses SSE2 or
+// AArch64 NEON when available, 16 bytes per step.
+bool IsHexDigits(const char* data, size_t size) noexcept;
+
+namespace scan {
+
+enum class CharClass : uint8_t { Letter, Digit, Hyphen, Dot, Other };
+
+constexpr CharClass Classify(char c) {
+  if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) return CharClass::Letter;
+  if (c >= '0' && c <= '9') return CharClass::Digit;
+  if (c == '-') return CharClass::Hyphen;
+  if (c == '.') return CharClass::Dot;
+  return CharClass::Other;
+}
+
+// Consumes one or more digits at `pos`; false if there are none
+constexpr bool ConsumeDigits(std::string_view s, size_t& pos) {
+  size_t start = pos;
+  while (pos < s.size() && s[pos] >= '0' && s[pos] <= '9') ++pos;
+  return pos > start;
+}
+
+constexpr bool ConsumeLiteral(std::string_view s, size_t& pos, std::string_view literal) {
+  if (s.substr(pos, literal.size()) != literal) return false;
+  pos += literal.size();
+  return true;
+}
+
+} // namespace scan
+
+// Same language as the regex [a-zA-Z0-9\-\.]+\.[a-zA-Z]{2,}: DNS-ish labels
+// ending in a dot and an alphabetic TLD of at least two letters.
+constexpr bool MatchesEnsName(std::string_view s) {
+  using scan::CharClass;
+  // Start -> Body on any allowed char. From Body/Tld states a dot may be the
+  // TLD separator (Dot), a letter after it starts the TLD, and anything else
+  // falls back to Body. Tld2 (two or more TLD letters) is accepting.
+  enum State { Start, Body, Dot, Tld1, Tld2 };
+  State state = Start;
+  for (char c : s) {
+    CharClass cls = scan::Classify(c);
+    if (cls == CharClass::Other) return false;
+    switch (state) {
+      case Start:
+        state = Body;
+        break;
+      case Body:
+        state = cls == CharClass::Dot ? Dot : Body;
+        break;
+      case Dot:
+      case Tld1:
+      case Tld2:
+        if (cls == CharClass::Dot) {
+          state = Dot;
+        } else if (cls == CharClass::Letter) {
+          state = state == Dot ? Tld1 : Tld2;
+        } else {
+          state = Body;
+        }
+        break;
+    }
+  }
+  return state == Tld2;
+}
+
+// BIP-44 path m/44'/coin'/account'/change/index. With `binary_change` the
+// change level must be 0 or 1, as BIP-44 specifies.
+constexpr bool MatchesBip44Path(std::string_view s, bool binary_change) {
+  size_t pos = 0;
+  if (!scan::ConsumeLiteral(s, pos, "m/44'/")) return false;
+  if (!scan::ConsumeDigits(s, pos) || !scan::ConsumeLiteral(s, pos, "'/")) return false;
+  if (!scan::ConsumeDigits(s, pos) || !scan::ConsumeLiteral(s, pos, "'/")) return false;
+
+  size_t change_start = pos;
+  if (!scan::ConsumeDigits(s, pos) || !scan::ConsumeLiteral(s, pos, "/")) return false;
+  if (binary_change && (pos - change_start != 2 || (s[change_start] != '0' && s[change_start] != '1'))) {
+    return false;
+  }
+
+  return scan::ConsumeDigits(s, pos) && pos == s.size();
+}
+
+} // namespace app
@@ -0,0 +1,127 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace app {
+
+/**
+ * Append-only log of signed transactions. Layout (little-endian):
+ *   header   magic, version, byte-order mark
+ *   records  [uint32 body length][uint32 CRC-32 of body][body], the body
+ *            being a fixed 56-byte header (sequence number, timestamp,
+ *            nonce, chain id, recipient) followed by the amount and the
+ *            signer's payload
+ * Records are only ever appended, so a crash can at worst tear the last
+ * one; open() truncates the log at the first record that is short or
+ * fails its CRC. Each append() is one write and one fdatasync, however
+ * many records it carries.
+ *
+ * The log is mapped read-only for browsing. A compact index (offset and
+ * fixed header per record, in append order) is rebuilt from the mapping on
+ * open and kept up to date by appends; strings are only read from the
+ * mapping when asked for. Timestamps never go backwards within a log, so
+ * the index is also ordered by time.
+ *
+ * Past `max_records` plus a quarter of slack, compact() rewrites the log
+ * with the newest `max_records` records to a temporary file that replaces
+ * it; sequence numbers survive compaction. Thread-safe.
+ */
+class TransactionHistory {
+public:
+  struct Record {
+    uint64_t timestamp_ms = 0;  // Unix time; 0 stamps it on append
+    int chain_id = 0;
+    std::optional<uint64_t> nonce;
+    std::string to;       // 0x address; anything else is stored as no recipient
+    std::string amount;   // ETH, as entered
+    std::string payload;  // signed-transaction JSON from the signer
+  };
+
+  // Index view of a record, without its payload
+  struct Entry {
+    uint64_t seq = 0;  // 1-based, never reused
+    uint64_t timestamp_ms = 0;
+    int chain_id = 0;
+    std::optional<uint64_t> nonce;
+    std::string to;  // EIP-55 checksummed; empty if there was none
+    std::string amount;
+  };
+
+  TransactionHistory() = default;
+  ~TransactionHistory();
+
+  TransactionHistory(const TransactionHistory&) = delete;
+  TransactionHistory& operator=(const TransactionHistory&) = delete;
+
+  // Opens or creates the log; false if it can't be opened or is not a
+  // history log. max_records of 0 keeps everything.
+  bool open(const std::string& path, size_t max_records) noexcept;
+  void close() noexcept;
+  bool isOpen() const noexcept;
+
+  // Durable once this returns true; false on I/O errors or oversized fields
+  bool append(const Record& record) noexcept;
+  bool append(const std::vector<Record>& records) noexcept;
+
+  size_t size() const noexcept;
+
+  // Newest first
+  std::vector<Entry> recent(size_t limit) const;
+  std::optional<Entry> entry(uint64_t seq) const;
+  std::optional<std::string> payload(uint64_t seq) const;
+
+  // Sequence numbers of matching records, newest first
+  std::vector<uint64_t> findByNonce(int chain_id, uint64_t nonce) const;
+  std::vector<uint64_t> findByRecipient(std::string_view address) const;
+  std::vector<uint64_t> findSince(uint64_t timestamp_ms) const;
+
+  // One past the highest nonce recorded for the chain
+  std::optional<uint64_t> nextNonce(int chain_id) const noexcept;
+
+  bool needsCompaction() const noexcept;
+  // Keeps the newest max_records records; false if the log was left as is
+  bool compact() noexcept;
+
+  static constexpr uint32_t kVersion = 1;
+
+private:
+  // Index entry: where a record's body starts and its fixed fields
+  struct Slot {
+    size_t offset;
+    uint64_t seq;
+    uint64_t timestamp_ms;
+    uint64_t nonce;
+    int32_t chain_id;
+    uint16_t flags;
+    uint16_t amount_length;
+    uint32_t payload_length;
+    uint8_t to[20];
+  };
+
+  bool openLocked() noexcept;
+  void closeLocked() noexcept;
+  bool remapLocked(size_t size) noexcept;
+  bool indexLocked(size_t offset, size_t length) noexcept;
+  size_t findLocked(uint64_t seq) const noexcept;
+  Entry entryLocked(const Slot& slot) const;
+  std::string_view stringLocked(const Slot& slot, size_t skip, size_t length) const noexcept;
+
+  mutable std::mutex mutex_;
+  std::string path_;
+  size_t max_records_ = 0;
+  int fd_ = -1;
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  std::vector<Slot> slots_;
+  uint64_t last_seq_ = 0;
+  uint64_t last_timestamp_ms_ = 0;
+  std::unordered_map<int, uint64_t> next_nonce_;
+};
+
+} // namespace app
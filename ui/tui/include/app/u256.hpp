@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace app {
+
+/**
+ * Unsigned 256-bit integer for wei amounts, fees and other EVM quantities.
+ * Stored as eight 32-bit words, least significant first, so every carry and
+ * remainder fits in a uint64_t without compiler-specific 128-bit types.
+ * Text is parsed once at input time; the parsers reject anything that does
+ * not fit in 256 bits instead of wrapping.
+ */
+class U256 {
+public:
+  constexpr U256() = default;
+  constexpr U256(uint64_t value)  // NOLINT: implicit like the built-in integers
+      : words_{static_cast<uint32_t>(value), static_cast<uint32_t>(value >> 32)} {}
+
+  // Plain decimal digits, no sign or separators
+  static std::optional<U256> fromDecimal(std::string_view text);
+  // Hex digits with or without a 0x prefix; "0x" alone is zero
+  static std::optional<U256> fromHex(std::string_view text);
+  // Hex when 0x-prefixed, decimal otherwise
+  static std::optional<U256> fromString(std::string_view text);
+  // Decimal amount in a unit with `decimals` fractional digits, e.g.
+  // fromUnits("1.5", 18) is 1.5 ETH in wei. Extra precision is rejected.
+  static std::optional<U256> fromUnits(std::string_view text, unsigned decimals);
+
+  static constexpr U256 max() {
+    U256 v;
+    for (auto& w : v.words_) w = 0xffffffffu;
+    return v;
+  }
+
+  std::string toDecimal() const;
+  // Minimal 0x-prefixed lowercase hex ("0x0" for zero), as JSON-RPC quantities
+  std::string toHex() const;
+  // Inverse of fromUnits with trailing fractional zeros removed
+  std::string toUnits(unsigned decimals) const;
+
+  bool isZero() const noexcept;
+  bool fitsUint64() const noexcept;
+  uint64_t low64() const noexcept { return (uint64_t(words_[1]) << 32) | words_[0]; }
+
+  // Bytes in the minimal big-endian form, 0 for zero (the RLP integer length)
+  size_t byteLength() const noexcept;
+  // Writes the minimal big-endian form (byteLength() bytes) to out
+  void writeBigEndian(uint8_t* out) const noexcept;
+
+  // Arithmetic that reports overflow instead of wrapping
+  std::optional<U256> checkedAdd(const U256& other) const noexcept;
+  std::optional<U256> checkedMul(uint64_t factor) const noexcept;
+
+  friend bool operator==(const U256& a, const U256& b) noexcept { return compare(a, b) == 0; }
+  friend bool operator!=(const U256& a, const U256& b) noexcept { return compare(a, b) != 0; }
+  friend bool operator<(const U256& a, const U256& b) noexcept { return compare(a, b) < 0; }
+  friend bool operator<=(const U256& a, const U256& b) noexcept { return compare(a, b) <= 0; }
+  friend bool operator>(const U256& a, const U256& b) noexcept { return compare(a, b) > 0; }
+  friend bool operator>=(const U256& a, const U256& b) noexcept { return compare(a, b) >= 0; }
+
+private:
+  static int compare(const U256& a, const U256& b) noexcept;
+  // this = this * factor + addend; false on overflow
+  bool mulAddSmall(uint32_t factor, uint32_t addend) noexcept;
+  // Divides in place and returns the remainder
+  uint32_t divSmall(uint32_t divisor) noexcept;
+
+  static constexpr size_t kWords = 8;
+  uint32_t words_[kWords] = {};
+};
+
+// Common EVM unit scales
+constexpr unsigned kEtherDecimals = 18;
+constexpr unsigned kGweiDecimals = 9;
+
+} // namespace app
@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "state.hpp"
+
+namespace app {
+
+struct UsbScanOptions {
+  // Directories to scan; empty means every mounted removable volume
+  std::vector<std::string> roots;
+  size_t max_concurrent_io = 2;        // walker threads, each doing one I/O at a time
+  int max_depth = 4;                   // directory levels below a volume root
+  size_t max_file_size = 4 * 1024 * 1024;
+  size_t batch_size = 16;              // contacts per on_batch call, at most
+};
+
+/**
+ * Finds contacts.json files on removable volumes and streams the contacts
+ * out in batches while the walk is still running. Directories from every
+ * volume go into one work queue served by `max_concurrent_io` threads, so a
+ * slow stick ties up at most its share of them. cancel() only raises a flag
+ * the walkers check between directory entries and read chunks; it never
+ * waits, so it is safe to call from UI code and state callbacks.
+ */
+class UsbContactScanner {
+public:
+  // Both run on scanner threads. No batch is delivered once cancel() has
+  // returned (one already being delivered finishes); on_done runs exactly
+  // once per scan, with `cancelled` set if it was cut short.
+  using BatchCallback = std::function<void(std::vector<KnownAddress>)>;
+  using DoneCallback = std::function<void(size_t found, bool cancelled)>;
+
+  explicit UsbContactScanner(UsbScanOptions options = {});
+  ~UsbContactScanner();  // cancels and joins
+
+  UsbContactScanner(const UsbContactScanner&) = delete;
+  UsbContactScanner& operator=(const UsbContactScanner&) = delete;
+
+  // Starts a scan, cancelling the one in progress (its callbacks stop)
+  void start(BatchCallback on_batch, DoneCallback on_done);
+  void cancel() noexcept;
+  bool running() const noexcept;
+
+  // Mount points of removable media: /proc/mounts entries whose block
+  // device is marked removable or that live under /media, /run/media or
+  // /mnt on Linux; /Volumes on macOS
+  static std::vector<std::string> RemovableMounts();
+
+private:
+  struct Scan;
+
+  static void run(std::shared_ptr<Scan> scan);
+
+  UsbScanOptions options_;
+  mutable std::mutex mutex_;
+  std::shared_ptr<Scan> current_;
+  std::vector<std::pair<std::shared_ptr<Scan>, std::thread>> scans_;  // with their coordinators
+};
+
+} // namespace app
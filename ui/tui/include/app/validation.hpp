@@ -2,7 +2,6 @@
 #include <string>
 #include <vector>
 #include <optional>
-#include <regex>
 #include <limits>
 #include <cstdint>
 
@@ -22,13 +21,18 @@ public:
     static bool isAddress(const std::string& s) noexcept;
     static bool isAddressChecksum(const std::string& address) noexcept;
     static std::optional<std::string> toChecksumAddress(const std::string& address) noexcept;
+    // True unless the address is mixed-case with a wrong EIP-55 checksum;
+    // all-lowercase and all-uppercase addresses carry no checksum.
+    static bool passesChecksum(const std::string& address) noexcept;
+    // passesChecksum() for many addresses, hashed in one batch
+    static std::vector<bool> passChecksums(const std::vector<std::string>& addresses) noexcept;
     static bool isENSName(const std::string& s) noexcept;
     
     // Numeric validation with bounds checking
     static bool isNumeric(const std::string& s) noexcept;
     static bool isValidWeiAmount(const std::string& value) noexcept;
     static bool isValidGasLimit(const std::string& gas_limit) noexcept;
-    static bool isValidGasPrice(const std::string& gas_price) noexcept;
+    static bool isValidGasPrice(const std::string& gas_price) noexcept;  // in Gwei
     static bool isValidNonce(const std::string& nonce) noexcept;
     static bool isValidChainId(int chain_id) noexcept;
     
@@ -64,9 +68,8 @@ private:
     // Internal helpers
     static std::string toLowerCase(const std::string& s) noexcept;
     static std::string toUpperCase(const std::string& s) noexcept;
-    static bool isOverflowSafe(const std::string& numeric_str, uint64_t max_value) noexcept;
     
-    // Checksum calculation (simplified Keccak-256 alternative for validation)
+    // EIP-55 checksum casing of an address
     static std::string calculateAddressChecksum(const std::string& address) noexcept;
 };
 
@@ -125,7 +128,6 @@ namespace ValidationLimits {
     constexpr uint64_t MIN_GAS_LIMIT = 21000;
     constexpr uint64_t MAX_GAS_LIMIT = 30000000;
     constexpr uint64_t MAX_GAS_PRICE = 1000000000000ULL;  // 1000 Gwei
-    constexpr uint64_t MAX_WEI_AMOUNT = std::numeric_limits<uint64_t>::max() / 2;
     constexpr uint32_t MAX_NONCE = std::numeric_limits<uint32_t>::max();
     
     constexpr int MIN_CHAIN_ID = 1;
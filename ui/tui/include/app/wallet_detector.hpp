@@ -8,6 +8,13 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+
+// libusb's opaque types (Linux only; unused on other platforms)
+struct libusb_context;
+struct libusb_device;
+struct libusb_device_handle;
 
 namespace app {
 
@@ -20,6 +27,9 @@ struct WalletDevice {
     bool connected = false;
     bool app_open = false;
     std::string version;
+    // Stable identity used to diff scans: bus/port/VID:PID on Linux,
+    // the device path elsewhere
+    std::string key;
     
     bool isValid() const noexcept {
         return !path.empty() && !product.empty();
@@ -45,6 +55,8 @@ public:
     using DeviceFoundCallback = std::function<void(const WalletDevice&)>;
     using StatusChangeCallback = std::function<void(DetectionStatus)>;
     using ErrorCallback = std::function<void(const std::string&)>;
+    // Produces the devices currently attached, in place of the USB bus
+    using DeviceSource = std::function<std::vector<WalletDevice>()>;
     
     WalletDetector();
     ~WalletDetector();
@@ -74,6 +86,20 @@ public:
     void disconnect();
     bool testConnection();
     
+    // Ask the detection thread to rescan now instead of at the next poll.
+    // Called from the hotplug callback; safe from any thread.
+    void requestRescan();
+    
+    // Rescan on the calling thread and apply the result before returning
+    void scanNow() { updateDeviceList(); }
+    
+    // Take device lists from `source` instead of the USB bus (benchmarks,
+    // tests); null restores the bus. Set before startDetection.
+    void setDeviceSource(DeviceSource source) { device_source_ = std::move(source); }
+    
+    // True when USB arrival/removal is event-driven rather than polled
+    bool usesHotplug() const noexcept { return hotplug_registered_.load(); }
+    
     // Utility methods
     static std::vector<WalletDevice> scanForDevices();
     static bool isLedgerDevice(const std::string& manufacturer, const std::string& product);
@@ -91,6 +117,25 @@ private:
     bool testDeviceConnection(const WalletDevice& device);
     void updateDeviceList();
     
+    // Hotplug backend (libusb on Linux); the poll loop is the fallback
+    bool registerHotplug();
+    void deregisterHotplug();
+    void hotplugLoop();
+    void pollLoop();
+    static std::vector<WalletDevice> scanForDevices(libusb_context* context);
+    
+    // Persistent device table (Linux): a device is opened and its strings
+    // read once when it appears, and the handle is kept for connection tests
+    struct CachedUsbDevice {
+        WalletDevice device;
+        libusb_device* usb_device = nullptr;         // referenced while cached
+        libusb_device_handle* handle = nullptr;      // null while inaccessible
+    };
+    std::vector<WalletDevice> scanDeviceTable();
+    bool openCachedDevice(CachedUsbDevice& entry);
+    void closeCachedDevice(CachedUsbDevice& entry);
+    void clearDeviceTable();
+    
     // Thread safety
     mutable std::mutex devices_mutex_;
     mutable std::mutex callbacks_mutex_;
@@ -109,11 +154,22 @@ private:
     
     // Threading
     std::unique_ptr<std::thread> detection_thread_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::atomic<bool> rescan_requested_{false};
+    
+    // USB library state, kept for the lifetime of the detector
+    libusb_context* usb_context_ = nullptr;
+    std::unordered_map<std::string, CachedUsbDevice> device_table_;
+    std::mutex table_mutex_;
+    int hotplug_handle_ = 0;
+    std::atomic<bool> hotplug_registered_{false};
     
     // Callbacks
     DeviceFoundCallback device_found_callback_;
     StatusChangeCallback status_change_callback_;
     ErrorCallback error_callback_;
+    DeviceSource device_source_;
     
     // Timing
     std::chrono::steady_clock::time_point last_scan_time_;
@@ -0,0 +1,49 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace app {
+
+/**
+ * Fixed-size pool of worker threads fed from a FIFO queue.
+ * Threads are started once and reused for every submitted job, so callers
+ * with short bursts of CPU work (QR encoding) don't pay thread start-up per call.
+ */
+class WorkerPool {
+public:
+  explicit WorkerPool(size_t num_threads);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  size_t size() const { return workers_.size(); }
+
+  // Queue a job; it runs on one of the worker threads.
+  void submit(std::function<void()> job);
+
+  // Run fn(0) .. fn(count - 1) on the pool and block until all have finished.
+  // The calling thread also drains jobs while it waits. Exceptions thrown by
+  // fn are swallowed; fn is expected to report failure through its own output.
+  void parallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+  // Pool shared by QR encoding, sized to the hardware (at most 8 threads).
+  static WorkerPool& shared();
+
+private:
+  void workerLoop();
+  bool runOne();
+
+  std::vector<std::thread> workers_;
+  std::deque<std::function<void()>> jobs_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopping_ = false;
+};
+
+} // namespace app
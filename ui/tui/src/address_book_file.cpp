@@ -0,0 +1,504 @@
+#include "app/address_book_file.hpp"
+#include "app/contact_stream_parser.hpp"
+#include "app/logger.hpp"
+#include "app/validation.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace app {
+
+namespace {
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;  // kByteOrderMark as written; rejects foreign-endian files
+  uint64_t count;
+  uint64_t addresses_offset;
+  uint64_t entries_offset;
+  uint64_t names_offset;
+  uint64_t strings_offset;
+  uint64_t strings_size;
+};
+
+struct FileRecord {
+  uint32_t name_offset;
+  uint32_t description_offset;
+  uint16_t name_length;
+  uint16_t description_length;
+  uint8_t type;
+  uint8_t reserved[3];
+};
+
+static_assert(sizeof(FileHeader) == 64, "address book header layout");
+static_assert(sizeof(FileRecord) == 16, "address book entry layout");
+
+constexpr char kMagic[8] = {'B', 'O', 'S', 'A', 'B', 'O', 'O', 'K'};
+constexpr uint32_t kByteOrderMark = 0x01020304;
+constexpr size_t kAddressSize = 20;
+constexpr size_t kAlignment = 8;
+
+using Address = std::array<uint8_t, kAddressSize>;
+
+inline char Fold(char c) {
+  return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// Case-insensitive comparison of name against prefix over prefix's length;
+// a name shorter than the prefix (and equal so far) sorts first
+int ComparePrefix(std::string_view name, std::string_view folded_prefix) {
+  size_t n = std::min(name.size(), folded_prefix.size());
+  for (size_t i = 0; i < n; ++i) {
+    char a = Fold(name[i]);
+    if (a != folded_prefix[i]) return static_cast<unsigned char>(a) < static_cast<unsigned char>(folded_prefix[i]) ? -1 : 1;
+  }
+  return name.size() < folded_prefix.size() ? -1 : 0;
+}
+
+bool FoldedLess(std::string_view a, std::string_view b) {
+  size_t n = std::min(a.size(), b.size());
+  for (size_t i = 0; i < n; ++i) {
+    unsigned char x = static_cast<unsigned char>(Fold(a[i]));
+    unsigned char y = static_cast<unsigned char>(Fold(b[i]));
+    if (x != y) return x < y;
+  }
+  return a.size() < b.size();
+}
+
+int Nibble(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  c = Fold(c);
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+std::string_view StripHexPrefix(std::string_view hex) {
+  if (hex.size() >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) hex.remove_prefix(2);
+  return hex;
+}
+
+bool ParseAddress(std::string_view text, Address& out) {
+  text = StripHexPrefix(text);
+  if (text.size() != 2 * kAddressSize) return false;
+  for (size_t i = 0; i < kAddressSize; ++i) {
+    int hi = Nibble(text[2 * i]);
+    int lo = Nibble(text[2 * i + 1]);
+    if (hi < 0 || lo < 0) return false;
+    out[i] = static_cast<uint8_t>(hi << 4 | lo);
+  }
+  return true;
+}
+
+uint64_t AlignUp(uint64_t offset) {
+  return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+// Section [offset, offset + count * item) lies inside a file of `size` bytes
+bool SectionFits(uint64_t offset, uint64_t count, uint64_t item, uint64_t size) {
+  if (offset % kAlignment != 0 || offset > size) return false;
+  return count <= (size - offset) / item;
+}
+
+bool HasExtension(const std::string& path, const char* ext) {
+  size_t n = std::strlen(ext);
+  if (path.size() < n) return false;
+  for (size_t i = 0; i < n; ++i) {
+    if (Fold(path[path.size() - n + i]) != ext[i]) return false;
+  }
+  return true;
+}
+
+void AddRow(std::vector<KnownAddress>& out, const std::string& address, const std::string& name,
+            const std::string& description, const std::string& type) {
+  if (auto entry = KnownAddress::create(address, name, description, ParseContactType(type))) {
+    out.push_back(std::move(*entry));
+  }
+}
+
+// RFC 4180-style fields: commas separate, double quotes wrap, "" escapes
+std::vector<std::string> SplitCsvLine(const std::string& line) {
+  std::vector<std::string> fields(1);
+  bool quoted = false;
+  for (size_t i = 0; i < line.size(); ++i) {
+    char c = line[i];
+    if (quoted) {
+      if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+        fields.back() += '"';
+        ++i;
+      } else if (c == '"') {
+        quoted = false;
+      } else {
+        fields.back() += c;
+      }
+    } else if (c == '"') {
+      quoted = true;
+    } else if (c == ',') {
+      fields.emplace_back();
+    } else if (c != '\r') {
+      fields.back() += c;
+    }
+  }
+  for (auto& field : fields) {
+    size_t first = field.find_first_not_of(" \t");
+    size_t last = field.find_last_not_of(" \t");
+    field = first == std::string::npos ? std::string() : field.substr(first, last - first + 1);
+  }
+  return fields;
+}
+
+} // namespace
+
+MappedAddressBook::~MappedAddressBook() {
+  close();
+}
+
+bool MappedAddressBook::open(const std::string& path) noexcept {
+  close();
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    LOG_WARN("Address book not found: " + path);
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+    ::close(fd);
+    LOG_WARN("Address book is truncated: " + path);
+    return false;
+  }
+  size_t size = static_cast<size_t>(st.st_size);
+  void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    LOG_WARN("Failed to map address book: " + path);
+    return false;
+  }
+
+  FileHeader header;
+  std::memcpy(&header, map, sizeof(header));
+  bool ok = std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+            header.version == kVersion && header.byte_order == kByteOrderMark &&
+            header.count <= UINT32_MAX &&
+            SectionFits(header.addresses_offset, header.count, kAddressSize, size) &&
+            SectionFits(header.entries_offset, header.count, sizeof(FileRecord), size) &&
+            SectionFits(header.names_offset, header.count, sizeof(uint32_t), size) &&
+            SectionFits(header.strings_offset, header.strings_size, 1, size);
+  if (!ok) {
+    munmap(map, size);
+    LOG_WARN("Address book is malformed: " + path);
+    return false;
+  }
+
+  data_ = static_cast<const uint8_t*>(map);
+  size_ = size;
+  count_ = static_cast<size_t>(header.count);
+  addresses_ = data_ + header.addresses_offset;
+  entries_ = data_ + header.entries_offset;
+  names_ = data_ + header.names_offset;
+  strings_ = data_ + header.strings_offset;
+  strings_size_ = static_cast<size_t>(header.strings_size);
+  LOG_INFOF("Mapped address book {} ({} entries)", path, count_);
+  return true;
+}
+
+void MappedAddressBook::close() noexcept {
+  if (data_) munmap(const_cast<uint8_t*>(data_), size_);
+  data_ = addresses_ = entries_ = names_ = strings_ = nullptr;
+  size_ = count_ = strings_size_ = 0;
+}
+
+const uint32_t* MappedAddressBook::nameIndex() const noexcept {
+  return reinterpret_cast<const uint32_t*>(names_);
+}
+
+std::string_view MappedAddressBook::string(uint32_t offset, uint32_t length) const noexcept {
+  // String bounds are checked per access rather than per entry at open time
+  if (offset > strings_size_ || length > strings_size_ - offset) return {};
+  return std::string_view(reinterpret_cast<const char*>(strings_) + offset, length);
+}
+
+MappedAddressBook::Entry MappedAddressBook::entry(size_t id) const noexcept {
+  const FileRecord& r = reinterpret_cast<const FileRecord*>(entries_)[id];
+  return Entry{addresses_ + id * kAddressSize, string(r.name_offset, r.name_length),
+               string(r.description_offset, r.description_length),
+               r.type <= static_cast<uint8_t>(ContactType::EOA) ? static_cast<ContactType>(r.type)
+                                                               : ContactType::EOA};
+}
+
+std::string MappedAddressBook::addressString(size_t id) const {
+  static const char kDigits[] = "0123456789abcdef";
+  const uint8_t* address = addresses_ + id * kAddressSize;
+  std::string hex = "0x";
+  for (size_t i = 0; i < kAddressSize; ++i) {
+    hex += kDigits[address[i] >> 4];
+    hex += kDigits[address[i] & 0x0f];
+  }
+  return Validator::toChecksumAddress(hex).value_or(hex);
+}
+
+KnownAddress MappedAddressBook::toKnownAddress(size_t id) const {
+  Entry e = entry(id);
+  return KnownAddress{addressString(id), std::string(e.name), std::string(e.description), e.type};
+}
+
+std::optional<size_t> MappedAddressBook::find(std::string_view address) const noexcept {
+  Address key;
+  if (!ParseAddress(address, key)) return std::nullopt;
+  size_t lo = 0, hi = count_;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    int c = std::memcmp(addresses_ + mid * kAddressSize, key.data(), kAddressSize);
+    if (c == 0) return mid;
+    if (c < 0) lo = mid + 1; else hi = mid;
+  }
+  return std::nullopt;
+}
+
+std::pair<size_t, size_t> MappedAddressBook::addressRange(const uint8_t* nibbles, size_t count) const noexcept {
+  auto compare = [&](size_t id) {
+    const uint8_t* address = addresses_ + id * kAddressSize;
+    for (size_t i = 0; i < count; ++i) {
+      uint8_t n = (i % 2 == 0) ? address[i / 2] >> 4 : address[i / 2] & 0x0f;
+      if (n != nibbles[i]) return n < nibbles[i] ? -1 : 1;
+    }
+    return 0;
+  };
+  size_t lo = 0, hi = count_;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (compare(mid) < 0) lo = mid + 1; else hi = mid;
+  }
+  size_t first = lo;
+  hi = count_;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (compare(mid) <= 0) lo = mid + 1; else hi = mid;
+  }
+  return {first, lo};
+}
+
+std::pair<size_t, size_t> MappedAddressBook::nameRange(std::string_view folded_prefix) const noexcept {
+  const uint32_t* index = nameIndex();
+  auto compare = [&](size_t pos) {
+    uint32_t id = index[pos];
+    if (id >= count_) return -1;  // corrupt index entry; never matches
+    const FileRecord& r = reinterpret_cast<const FileRecord*>(entries_)[id];
+    return ComparePrefix(string(r.name_offset, r.name_length), folded_prefix);
+  };
+  size_t lo = 0, hi = count_;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (compare(mid) < 0) lo = mid + 1; else hi = mid;
+  }
+  size_t first = lo;
+  hi = count_;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (compare(mid) <= 0) lo = mid + 1; else hi = mid;
+  }
+  return {first, lo};
+}
+
+std::vector<size_t> MappedAddressBook::searchPrefix(std::string_view query, size_t limit) const {
+  std::vector<size_t> ids;
+  if (query.empty() || count_ == 0 || limit == 0) return ids;
+
+  std::string_view hex = StripHexPrefix(query);
+  uint8_t nibbles[2 * kAddressSize];
+  bool is_hex = !hex.empty() && hex.size() <= 2 * kAddressSize;
+  for (size_t i = 0; is_hex && i < hex.size(); ++i) {
+    int n = Nibble(hex[i]);
+    is_hex = n >= 0;
+    nibbles[i] = static_cast<uint8_t>(n);
+  }
+  if (is_hex) {
+    auto [first, last] = addressRange(nibbles, hex.size());
+    for (size_t id = first; id < last && ids.size() < limit; ++id) ids.push_back(id);
+  }
+
+  std::string folded(query);
+  for (char& c : folded) c = Fold(c);
+  auto [first, last] = nameRange(folded);
+  size_t address_matches = ids.size();
+  for (size_t pos = first; pos < last && ids.size() < limit; ++pos) {
+    size_t id = nameIndex()[pos];
+    if (id >= count_) continue;  // corrupt index entry, as in nameRange()
+    if (std::find(ids.begin(), ids.begin() + address_matches, id) == ids.begin() + address_matches) {
+      ids.push_back(id);
+    }
+  }
+  return ids;
+}
+
+std::optional<size_t> WriteAddressBook(const std::vector<KnownAddress>& addresses,
+                                       const std::string& path) noexcept {
+  try {
+    // Valid entries with their raw addresses, deduplicated keeping the first
+    std::vector<std::string> hex;
+    hex.reserve(addresses.size());
+    for (const auto& a : addresses) hex.push_back(a.address);
+    auto checksums = Validator::passChecksums(hex);
+
+    struct Row {
+      Address address;
+      size_t source;
+    };
+    std::vector<Row> rows;
+    rows.reserve(addresses.size());
+    for (size_t i = 0; i < addresses.size(); ++i) {
+      Row row{{}, i};
+      if (addresses[i].isValid() && checksums[i] && ParseAddress(addresses[i].address, row.address)) {
+        rows.push_back(row);
+      }
+    }
+    std::stable_sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) { return a.address < b.address; });
+    rows.erase(std::unique(rows.begin(), rows.end(),
+                           [](const Row& a, const Row& b) { return a.address == b.address; }),
+               rows.end());
+
+    std::string strings;
+    std::vector<FileRecord> records(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+      const KnownAddress& a = addresses[rows[i].source];
+      FileRecord& r = records[i];
+      r = FileRecord{};
+      r.name_offset = static_cast<uint32_t>(strings.size());
+      r.name_length = static_cast<uint16_t>(a.name.size());
+      strings += a.name;
+      r.description_offset = static_cast<uint32_t>(strings.size());
+      r.description_length = static_cast<uint16_t>(a.description.size());
+      strings += a.description;
+      r.type = static_cast<uint8_t>(a.type);
+    }
+
+    std::vector<uint32_t> names(rows.size());
+    for (size_t i = 0; i < names.size(); ++i) names[i] = static_cast<uint32_t>(i);
+    std::stable_sort(names.begin(), names.end(), [&](uint32_t a, uint32_t b) {
+      return FoldedLess(addresses[rows[a].source].name, addresses[rows[b].source].name);
+    });
+
+    uint64_t count = rows.size();
+    uint64_t addresses_offset = AlignUp(sizeof(FileHeader));
+    uint64_t entries_offset = AlignUp(addresses_offset + count * kAddressSize);
+    uint64_t names_offset = AlignUp(entries_offset + count * sizeof(FileRecord));
+    uint64_t strings_offset = AlignUp(names_offset + count * sizeof(uint32_t));
+
+    std::string tmp = path + ".tmp";
+    {
+      std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+      if (!out) return std::nullopt;
+      auto pad_to = [&](uint64_t offset) {
+        static const char kZeros[kAlignment] = {};
+        uint64_t at = static_cast<uint64_t>(out.tellp());
+        out.write(kZeros, static_cast<std::streamsize>(offset - at));
+      };
+
+      FileHeader header{};
+      std::memcpy(header.magic, kMagic, sizeof(kMagic));
+      header.version = MappedAddressBook::kVersion;
+      header.byte_order = kByteOrderMark;
+      header.count = count;
+      header.addresses_offset = addresses_offset;
+      header.entries_offset = entries_offset;
+      header.names_offset = names_offset;
+      header.strings_offset = strings_offset;
+      header.strings_size = strings.size();
+      out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+      pad_to(addresses_offset);
+      for (const auto& row : rows) out.write(reinterpret_cast<const char*>(row.address.data()), kAddressSize);
+      pad_to(entries_offset);
+      out.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(FileRecord)));
+      pad_to(names_offset);
+      out.write(reinterpret_cast<const char*>(names.data()), static_cast<std::streamsize>(names.size() * sizeof(uint32_t)));
+      pad_to(strings_offset);
+      out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+      if (!out) return std::nullopt;
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+      std::remove(tmp.c_str());
+      return std::nullopt;
+    }
+    return rows.size();
+  } catch (const std::exception& e) {
+    LOG_EXCEPTION(e, "WriteAddressBook");
+    return std::nullopt;
+  }
+}
+
+std::optional<std::vector<KnownAddress>> ReadAddressBookSource(const std::string& path) noexcept {
+  try {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return std::nullopt;
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    std::string text = buffer.str();
+
+    std::vector<KnownAddress> out;
+    if (HasExtension(path, ".json")) {
+      ContactStreamParser parser([&out](KnownAddress entry) { out.push_back(std::move(entry)); });
+      if (!parser.feed(text.data(), text.size()) || !parser.finish()) {
+        LOG_WARN("Address book JSON is malformed: " + path);
+        return std::nullopt;
+      }
+      return out;
+    }
+
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+      auto fields = SplitCsvLine(line);
+      fields.resize(std::max<size_t>(fields.size(), 4));
+      AddRow(out, fields[0], fields[1], fields[2], fields[3]);
+    }
+    return out;
+  } catch (const std::exception& e) {
+    LOG_EXCEPTION(e, "ReadAddressBookSource");
+    return std::nullopt;
+  }
+}
+
+std::optional<size_t> ImportAddressBook(const std::string& source, const std::string& dest) noexcept {
+  auto entries = ReadAddressBookSource(source);
+  if (!entries) return std::nullopt;
+  auto written = WriteAddressBook(*entries, dest);
+  if (written) {
+    LOG_INFOF("Imported {} of {} address book entries from {}", *written, entries->size(), source);
+  }
+  return written;
+}
+
+std::shared_ptr<const MappedAddressBook> OpenAddressBook(const std::string& path) noexcept {
+  try {
+    if (path.empty()) return nullptr;
+    std::string binary = path;
+    std::string ext = std::filesystem::path(path).extension().string();
+    if (ext == ".json" || ext == ".csv") {
+      binary = path + ".bosab";
+      std::error_code source_error, binary_error;
+      auto source_time = std::filesystem::last_write_time(path, source_error);
+      auto binary_time = std::filesystem::last_write_time(binary, binary_error);
+      if (source_error) {
+        LOG_WARNF("Address book source {} is missing; using {} if present", path, binary);
+      } else if (binary_error || binary_time < source_time) {
+        ImportAddressBook(path, binary);
+      }
+    }
+    auto book = std::make_shared<MappedAddressBook>();
+    if (!book->open(binary)) return nullptr;
+    return book;
+  } catch (const std::exception& e) {
+    LOG_EXCEPTION(e, "OpenAddressBook");
+    return nullptr;
+  }
+}
+
+} // namespace app
@@ -0,0 +1,228 @@
+#include "app/address_index.hpp"
+#include <algorithm>
+#include <cctype>
+
+namespace app {
+
+namespace {
+
+constexpr size_t kTrigram = 3;
+
+bool IsWordChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) != 0;
+}
+
+// "0x"-prefixed hex addresses are also found without the prefix
+std::string StripHexPrefix(const std::string& folded) {
+  if (folded.size() >= 2 && folded[0] == '0' && folded[1] == 'x') return folded.substr(2);
+  return folded;
+}
+
+uint32_t TrigramAt(const std::string& text, size_t i) {
+  return static_cast<uint32_t>(static_cast<unsigned char>(text[i])) << 16 |
+         static_cast<uint32_t>(static_cast<unsigned char>(text[i + 1])) << 8 |
+         static_cast<uint32_t>(static_cast<unsigned char>(text[i + 2]));
+}
+
+void AppendTrigrams(const std::string& text, std::vector<uint32_t>& out) {
+  for (size_t i = 0; i + kTrigram <= text.size(); ++i) out.push_back(TrigramAt(text, i));
+}
+
+bool StartsWith(const std::string& text, const std::string& prefix) {
+  return text.compare(0, prefix.size(), prefix) == 0;
+}
+
+bool HasWordStartingWith(const std::string& text, const std::string& prefix) {
+  for (size_t pos = text.find(prefix); pos != std::string::npos; pos = text.find(prefix, pos + 1)) {
+    if (pos == 0 || !IsWordChar(text[pos - 1])) return true;
+  }
+  return false;
+}
+
+void EraseValue(std::vector<uint32_t>& values, uint32_t value) {
+  values.erase(std::remove(values.begin(), values.end(), value), values.end());
+}
+
+} // namespace
+
+std::string FoldCase(const std::string& text) {
+  std::string folded(text);
+  for (auto& c : folded) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  return folded;
+}
+
+void AddressIndex::insert(size_t id, const std::string& address, const std::string& name) {
+  erase(id);
+
+  uint32_t slot;
+  if (!free_slots_.empty()) {
+    slot = free_slots_.back();
+    free_slots_.pop_back();
+  } else {
+    slot = static_cast<uint32_t>(records_.size());
+    records_.emplace_back();
+  }
+
+  Record& record = records_[slot];
+  record.id = id;
+  record.seq = next_seq_++;
+  record.address = FoldCase(address);
+  record.name = FoldCase(name);
+  slot_of_[id] = slot;
+  indexRecord(slot, true);
+  ++version_;
+}
+
+bool AddressIndex::erase(size_t id) {
+  auto it = slot_of_.find(id);
+  if (it == slot_of_.end()) return false;
+
+  uint32_t slot = it->second;
+  indexRecord(slot, false);
+  records_[slot] = Record{};
+  free_slots_.push_back(slot);
+  slot_of_.erase(it);
+  ++version_;
+  return true;
+}
+
+void AddressIndex::clear() {
+  records_.clear();
+  free_slots_.clear();
+  slot_of_.clear();
+  trigrams_.clear();
+  ++version_;
+}
+
+void AddressIndex::indexRecord(uint32_t slot, bool add) {
+  const Record& record = records_[slot];
+
+  std::vector<uint32_t> grams;
+  AppendTrigrams(record.name, grams);
+  AppendTrigrams(record.address, grams);
+  std::sort(grams.begin(), grams.end());
+  grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+  for (uint32_t gram : grams) {
+    if (add) {
+      trigrams_[gram].push_back(slot);
+      continue;
+    }
+    auto it = trigrams_.find(gram);
+    if (it == trigrams_.end()) continue;
+    EraseValue(it->second, slot);
+    if (it->second.empty()) trigrams_.erase(it);
+  }
+}
+
+int AddressIndex::score(const Record& record, const std::string& folded) const {
+  std::string hex = StripHexPrefix(folded);
+  const std::string& address = record.address;
+  size_t hex_start = address.size() - StripHexPrefix(address).size();
+
+  if (address == folded || (!hex.empty() && address.compare(hex_start, std::string::npos, hex) == 0)) {
+    return kExactAddressScore;
+  }
+  if (StartsWith(address, folded) || (!hex.empty() && address.compare(hex_start, hex.size(), hex) == 0)) {
+    return 80;
+  }
+  if (record.name == folded) return 70;
+  if (StartsWith(record.name, folded)) return 60;
+  if (HasWordStartingWith(record.name, folded)) return 50;
+  if (record.name.find(folded) != std::string::npos) return 30;
+  if (address.find(folded) != std::string::npos) return 20;
+  return 0;
+}
+
+std::vector<uint32_t> AddressIndex::candidates(const std::string& folded) const {
+  std::vector<uint32_t> slots;
+
+  if (folded.size() >= kTrigram) {
+    // Every match contains every trigram of the query, so the shortest
+    // posting list bounds the candidates
+    const std::vector<uint32_t>* shortest = nullptr;
+    for (size_t i = 0; i + kTrigram <= folded.size(); ++i) {
+      auto it = trigrams_.find(TrigramAt(folded, i));
+      if (it == trigrams_.end()) return slots;
+      if (!shortest || it->second.size() < shortest->size()) shortest = &it->second;
+    }
+    slots = *shortest;
+  } else {
+    // Too short for a trigram: score() checks every live entry, which for a
+    // book of at most a thousand entries costs less than an index would
+    slots.reserve(slot_of_.size());
+    for (const auto& entry : slot_of_) slots.push_back(entry.second);
+  }
+
+  slots.erase(std::remove_if(slots.begin(), slots.end(),
+                             [&](uint32_t slot) { return score(records_[slot], folded) == 0; }),
+              slots.end());
+  return slots;
+}
+
+std::vector<AddressIndex::Match> AddressIndex::rank(const std::vector<uint32_t>& slots,
+                                                    const std::string& folded, size_t limit) const {
+  struct Ranked {
+    int score;
+    uint32_t slot;
+  };
+  std::vector<Ranked> ranked;
+  ranked.reserve(slots.size());
+  for (uint32_t slot : slots) ranked.push_back({score(records_[slot], folded), slot});
+
+  auto better = [this](const Ranked& a, const Ranked& b) {
+    if (a.score != b.score) return a.score > b.score;
+    const Record& ra = records_[a.slot];
+    const Record& rb = records_[b.slot];
+    if (ra.name.size() != rb.name.size()) return ra.name.size() < rb.name.size();
+    return ra.seq < rb.seq;
+  };
+  size_t count = std::min(limit, ranked.size());
+  std::partial_sort(ranked.begin(), ranked.begin() + count, ranked.end(), better);
+
+  std::vector<Match> matches;
+  matches.reserve(count);
+  for (size_t i = 0; i < count; ++i) matches.push_back({records_[ranked[i].slot].id, ranked[i].score});
+  return matches;
+}
+
+std::vector<AddressIndex::Match> AddressIndex::search(const std::string& query, size_t limit) const {
+  if (query.empty() || limit == 0) return {};
+  std::string folded = FoldCase(query);
+  return rank(candidates(folded), folded, limit);
+}
+
+const std::vector<AddressIndex::Match>& AddressSearch::update(const std::string& query, size_t limit) {
+  std::string folded = FoldCase(query);
+  if (folded.empty()) {
+    reset();
+    return results_;
+  }
+
+  // Typing onto a result set can only narrow it: anything that contains the
+  // longer query also contained the shorter one
+  bool refine = !query_.empty() && version_ == index_->version() && folded.size() > query_.size() &&
+                StartsWith(folded, query_);
+  if (refine) {
+    candidates_.erase(std::remove_if(candidates_.begin(), candidates_.end(),
+                                     [&](uint32_t slot) {
+                                       return index_->score(index_->records_[slot], folded) == 0;
+                                     }),
+                      candidates_.end());
+  } else if (folded != query_ || version_ != index_->version()) {
+    candidates_ = index_->candidates(folded);
+  }
+
+  version_ = index_->version();
+  query_ = std::move(folded);
+  results_ = index_->rank(candidates_, query_, limit);
+  return results_;
+}
+
+void AddressSearch::reset() {
+  version_ = 0;
+  query_.clear();
+  candidates_.clear();
+  results_.clear();
+}
+
+} // namespace app
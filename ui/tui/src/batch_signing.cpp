@@ -0,0 +1,374 @@
+#include "app/batch_signing.hpp"
+#include "app/logger.hpp"
+#include "app/validation.hpp"
+#include "app/worker_pool.hpp"
+#include <charconv>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+
+namespace app {
+
+namespace {
+
+constexpr uint64_t kTransferGasLimit = 21000;
+
+// Column name -> value, in file order
+using Row = std::vector<std::pair<std::string, std::string>>;
+
+inline bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+std::string_view Trim(std::string_view text) {
+  while (!text.empty() && IsSpace(text.front())) text.remove_prefix(1);
+  while (!text.empty() && IsSpace(text.back())) text.remove_suffix(1);
+  return text;
+}
+
+// "gas_price", "gasPrice" and "Gas Price" are the same column
+std::string ColumnKey(std::string_view name) {
+  std::string key;
+  for (char c : name) {
+    if (c == '_' || c == '-' || c == ' ') continue;
+    key += (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+  }
+  return key;
+}
+
+BatchEntry MakeEntry(const Row& row, size_t line, uint64_t& next_nonce) {
+  BatchEntry entry;
+  entry.line = line;
+  entry.tx.type = 0;
+  bool has_amount = false;
+  bool has_value = false;
+  bool bad_nonce = false;
+  for (const auto& [name, value] : row) {
+    if (value.empty()) continue;
+    std::string key = ColumnKey(name);
+    if (key == "to") {
+      entry.tx.to = value;
+    } else if (key == "amount") {
+      has_amount = true;
+      if (!entry.tx.setValueFromEth(value)) entry.errors.push_back("Invalid amount: " + value);
+    } else if (key == "value") {
+      has_value = true;
+      if (!entry.tx.setValueFromString(value)) entry.errors.push_back("Invalid value: " + value);
+    } else if (key == "gasprice") {
+      if (!entry.tx.setGasPriceFromGwei(value)) entry.errors.push_back("Invalid gas price: " + value);
+    } else if (key == "gaslimit") {
+      if (!entry.tx.setGasLimitFromString(value)) entry.errors.push_back("Invalid gas limit: " + value);
+    } else if (key == "nonce") {
+      bad_nonce = !entry.tx.setNonceFromString(value);
+      if (bad_nonce) entry.errors.push_back("Invalid nonce: " + value);
+    } else if (key == "chainid") {
+      int chain_id = 0;
+      auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), chain_id);
+      if (ec != std::errc() || end != value.data() + value.size()) {
+        entry.errors.push_back("Invalid chain id: " + value);
+      } else {
+        entry.tx.chain_id = chain_id;
+      }
+    }
+    // Anything else (names, memos) is for the operator, not the signer
+  }
+  if (has_amount && has_value) entry.errors.push_back("Give either amount or value, not both");
+  if (!entry.tx.gas_limit) entry.tx.gas_limit = kTransferGasLimit;
+  if (!entry.tx.nonce && !bad_nonce) entry.tx.nonce = next_nonce;
+  if (entry.tx.nonce) next_nonce = *entry.tx.nonce + 1;
+  return entry;
+}
+
+// Fields of one CSV line; "" inside a quoted field is a literal quote
+bool SplitCsvLine(std::string_view line, std::vector<std::string>& fields) {
+  fields.clear();
+  std::string field;
+  bool quoted = false;
+  bool was_quoted = false;
+  for (size_t i = 0; i < line.size(); ++i) {
+    char c = line[i];
+    if (quoted) {
+      if (c != '"') {
+        field += c;
+      } else if (i + 1 < line.size() && line[i + 1] == '"') {
+        field += '"';
+        ++i;
+      } else {
+        quoted = false;
+      }
+    } else if (c == '"' && Trim(field).empty()) {
+      field.clear();
+      quoted = was_quoted = true;
+    } else if (c == ',') {
+      fields.push_back(was_quoted ? field : std::string(Trim(field)));
+      field.clear();
+      was_quoted = false;
+    } else {
+      field += c;
+    }
+  }
+  if (quoted) return false;
+  fields.push_back(was_quoted ? field : std::string(Trim(field)));
+  return true;
+}
+
+SigningBatch ParseCsv(std::string_view text, uint64_t start_nonce) {
+  SigningBatch batch;
+  std::vector<std::string> header;
+  std::vector<std::string> fields;
+  uint64_t next_nonce = start_nonce;
+  size_t line_number = 0;
+  while (!text.empty()) {
+    size_t end = text.find('\n');
+    std::string_view line = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    ++line_number;
+
+    std::string_view trimmed = Trim(line);
+    if (trimmed.empty() || trimmed.front() == '#') continue;
+    if (!SplitCsvLine(line, fields)) {
+      batch.error = "line " + std::to_string(line_number) + ": unterminated quoted field";
+      return batch;
+    }
+    if (header.empty()) {
+      header = fields;
+      continue;
+    }
+
+    Row row;
+    for (size_t i = 0; i < header.size() && i < fields.size(); ++i) {
+      row.emplace_back(header[i], fields[i]);
+    }
+    BatchEntry entry = MakeEntry(row, line_number, next_nonce);
+    if (fields.size() > header.size()) entry.errors.push_back("More fields than header columns");
+    batch.entries.push_back(std::move(entry));
+  }
+  if (header.empty()) batch.error = "No header row";
+  return batch;
+}
+
+/**
+ * Reader for a JSON array of flat objects, the one shape a batch file has.
+ * Strings, numbers, booleans and null are taken as text (null as empty);
+ * nested arrays and objects are rejected.
+ */
+class JsonRows {
+public:
+  explicit JsonRows(std::string_view text) : text_(text) {}
+
+  bool read(std::vector<Row>& rows, std::string& error) {
+    if (!consume('[')) return fail(error, "expected '['");
+    if (consume(']')) return finish(error);
+    do {
+      Row row;
+      if (!readObject(row, error)) return false;
+      rows.push_back(std::move(row));
+    } while (consume(','));
+    if (!consume(']')) return fail(error, "expected ',' or ']'");
+    return finish(error);
+  }
+
+private:
+  void skipSpace() {
+    while (pos_ < text_.size() && IsSpace(text_[pos_])) ++pos_;
+  }
+
+  bool consume(char c) {
+    skipSpace();
+    if (pos_ < text_.size() && text_[pos_] == c) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  bool fail(std::string& error, const char* what) {
+    error = "offset " + std::to_string(pos_) + ": " + what;
+    return false;
+  }
+
+  bool finish(std::string& error) {
+    skipSpace();
+    return pos_ == text_.size() || fail(error, "trailing characters");
+  }
+
+  bool readObject(Row& row, std::string& error) {
+    if (!consume('{')) return fail(error, "expected an object");
+    if (consume('}')) return true;
+    do {
+      std::string key, value;
+      skipSpace();
+      if (!readString(key)) return fail(error, "expected a key");
+      if (!consume(':')) return fail(error, "expected ':'");
+      if (!readValue(value)) return fail(error, "expected a string, number, boolean or null");
+      row.emplace_back(std::move(key), std::move(value));
+    } while (consume(','));
+    return consume('}') || fail(error, "expected ',' or '}'");
+  }
+
+  bool readValue(std::string& value) {
+    skipSpace();
+    if (pos_ < text_.size() && text_[pos_] == '"') return readString(value);
+    size_t start = pos_;
+    while (pos_ < text_.size() && !IsSpace(text_[pos_]) && text_[pos_] != ',' && text_[pos_] != '}' &&
+           text_[pos_] != ']' && text_[pos_] != '{' && text_[pos_] != '[') {
+      ++pos_;
+    }
+    value.assign(text_.substr(start, pos_ - start));
+    if (value == "null") value.clear();
+    return pos_ > start;
+  }
+
+  // Escapes beyond ASCII aren't needed for addresses and amounts
+  bool readString(std::string& out) {
+    if (pos_ >= text_.size() || text_[pos_] != '"') return false;
+    ++pos_;
+    while (pos_ < text_.size()) {
+      char c = text_[pos_++];
+      if (c == '"') return true;
+      if (c != '\\') {
+        out += c;
+        continue;
+      }
+      if (pos_ >= text_.size()) return false;
+      char e = text_[pos_++];
+      switch (e) {
+        case '"': case '\\': case '/': out += e; break;
+        case 'n': out += '\n'; break;
+        case 't': out += '\t'; break;
+        case 'r': out += '\r'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'u': {
+          unsigned cp = 0;
+          if (pos_ + 4 > text_.size()) return false;
+          auto [end, ec] = std::from_chars(text_.data() + pos_, text_.data() + pos_ + 4, cp, 16);
+          if (ec != std::errc() || end != text_.data() + pos_ + 4 || cp >= 0x80) return false;
+          out += static_cast<char>(cp);
+          pos_ += 4;
+          break;
+        }
+        default: return false;
+      }
+    }
+    return false;
+  }
+
+  std::string_view text_;
+  size_t pos_ = 0;
+};
+
+SigningBatch ParseJson(std::string_view text, uint64_t start_nonce) {
+  SigningBatch batch;
+  std::vector<Row> rows;
+  if (!JsonRows(text).read(rows, batch.error)) return batch;
+  uint64_t next_nonce = start_nonce;
+  for (size_t i = 0; i < rows.size(); ++i) {
+    batch.entries.push_back(MakeEntry(rows[i], i + 1, next_nonce));
+  }
+  return batch;
+}
+
+} // namespace
+
+bool SigningBatch::valid() const noexcept {
+  return error.empty() && !entries.empty() && invalidCount() == 0;
+}
+
+size_t SigningBatch::invalidCount() const noexcept {
+  size_t count = 0;
+  for (const auto& entry : entries) count += entry.errors.empty() ? 0 : 1;
+  return count;
+}
+
+std::optional<U256> SigningBatch::totalValue() const noexcept {
+  U256 total;
+  for (const auto& entry : entries) {
+    if (!entry.tx.value) continue;
+    auto sum = total.checkedAdd(*entry.tx.value);
+    if (!sum) return std::nullopt;
+    total = *sum;
+  }
+  return total;
+}
+
+std::vector<std::string> SigningBatch::errorLines(size_t max_lines) const {
+  std::vector<std::string> lines;
+  if (!error.empty()) lines.push_back(error);
+  size_t total = lines.size();
+  for (const auto& entry : entries) {
+    for (const auto& message : entry.errors) {
+      if (++total <= max_lines) lines.push_back("line " + std::to_string(entry.line) + ": " + message);
+    }
+  }
+  if (total > max_lines) lines.push_back("... and " + std::to_string(total - max_lines) + " more");
+  return lines;
+}
+
+SigningBatch ParseSigningBatch(std::string_view text, uint64_t start_nonce) {
+  std::string_view body = Trim(text);
+  SigningBatch batch = !body.empty() && body.front() == '[' ? ParseJson(body, start_nonce)
+                                                             : ParseCsv(text, start_nonce);
+  if (batch.error.empty() && batch.entries.empty()) batch.error = "No transactions in batch";
+  return batch;
+}
+
+SigningBatch LoadSigningBatch(const std::string& path, uint64_t start_nonce) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    SigningBatch batch;
+    batch.error = "Cannot open " + path;
+    return batch;
+  }
+  std::ostringstream text;
+  text << in.rdbuf();
+  SigningBatch batch = ParseSigningBatch(text.str(), start_nonce);
+  LOG_INFOF("Loaded batch {} ({} transactions, {} invalid)", path, batch.entries.size(),
+            batch.invalidCount());
+  return batch;
+}
+
+void ValidateSigningBatch(SigningBatch& batch, bool strict_mode) {
+  // Rows that didn't parse would only repeat their errors as missing fields
+  WorkerPool::shared().parallelFor(batch.entries.size(), [&](size_t i) {
+    BatchEntry& entry = batch.entries[i];
+    if (!entry.errors.empty()) return;
+    entry.errors = Validator::validateTransaction(entry.tx, strict_mode);
+  });
+
+  // Two payouts with one nonce: the second would never be mined
+  std::unordered_map<uint64_t, size_t> nonce_lines;
+  for (auto& entry : batch.entries) {
+    if (!entry.tx.nonce) continue;
+    auto [it, inserted] = nonce_lines.emplace(*entry.tx.nonce, entry.line);
+    if (!inserted) {
+      entry.errors.push_back("Nonce " + std::to_string(*entry.tx.nonce) + " is also used on line " +
+                             std::to_string(it->second));
+    }
+  }
+}
+
+SignRequest ToSignRequest(const UnsignedTx& tx) {
+  SignRequest request;
+  request.to = tx.to;
+  if (tx.value) request.amount = tx.value->toUnits(18);
+  if (tx.nonce) request.nonce = std::to_string(*tx.nonce);
+  if (tx.gas_price) request.gas_price = tx.gas_price->toUnits(9);
+  if (tx.gas_limit) request.gas_limit = std::to_string(*tx.gas_limit);
+  request.chain_id = std::to_string(tx.chain_id);
+  return request;
+}
+
+std::string CombineSignedTransactions(const std::vector<SignResult>& results) {
+  std::string combined = "[";
+  for (const auto& result : results) {
+    if (!result.ok) continue;
+    if (combined.size() > 1) combined += ',';
+    combined += result.payload;
+  }
+  combined += ']';
+  return combined;
+}
+
+} // namespace app
@@ -33,6 +33,7 @@ void Config::initializeDefaults() noexcept {
     app_config_.animation_speed_ms = 100;
     app_config_.enable_qr_codes = true;
     app_config_.max_transaction_history = 100;
+    app_config_.transaction_history_path = "transaction_history.log";
 }
 
 bool Config::load(const std::string& config_file_path) {
@@ -0,0 +1,234 @@
+#include "app/contact_stream_parser.hpp"
+
+namespace app {
+
+namespace {
+
+constexpr uint32_t kReplacementChar = 0xfffd;
+
+inline int HexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  c = static_cast<char>(c | 0x20);
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+inline bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline bool IsScalarChar(char c) {
+  return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         c == '-' || c == '+' || c == '.';
+}
+
+} // namespace
+
+ContactType ParseContactType(std::string_view text) {
+  std::string folded;
+  for (char c : text) folded += (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+  if (folded == "ens") return ContactType::ENS;
+  if (folded == "base") return ContactType::Base;
+  if (folded == "multisig") return ContactType::Multisig;
+  if (folded == "contract") return ContactType::Contract;
+  return ContactType::EOA;
+}
+
+ContactStreamParser::ContactStreamParser(Sink sink) : sink_(std::move(sink)) {}
+
+bool ContactStreamParser::feed(const char* data, size_t size) {
+  for (size_t i = 0; i < size && !failed_; ++i) {
+    if (!step(data[i])) failed_ = true;
+  }
+  return !failed_;
+}
+
+bool ContactStreamParser::finish() {
+  if (!failed_ && in_scalar_) {
+    in_scalar_ = false;
+    if (!endScalar()) failed_ = true;
+  }
+  return !failed_ && done_ && string_state_ == 0;
+}
+
+void ContactStreamParser::appendUtf8(std::string& out, uint32_t cp) {
+  if (cp < 0x80) {
+    out += static_cast<char>(cp);
+  } else if (cp < 0x800) {
+    out += static_cast<char>(0xc0 | cp >> 6);
+    out += static_cast<char>(0x80 | (cp & 0x3f));
+  } else if (cp < 0x10000) {
+    out += static_cast<char>(0xe0 | cp >> 12);
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (cp & 0x3f));
+  } else {
+    out += static_cast<char>(0xf0 | cp >> 18);
+    out += static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (cp & 0x3f));
+  }
+}
+
+bool ContactStreamParser::step(char c) {
+  if (string_state_ != 0) {
+    // A high surrogate must be followed directly by a \u low surrogate
+    if (high_surrogate_ && string_state_ == 1 && c != '\\') {
+      appendUtf8(string_, kReplacementChar);
+      high_surrogate_ = 0;
+    }
+    if (string_state_ == 1) {
+      if (c == '"') return endString();
+      if (c == '\\') {
+        string_state_ = 2;
+        return true;
+      }
+      if (static_cast<unsigned char>(c) < 0x20) return false;
+      // Over-long strings are truncated; no contact field is valid at this length
+      if (string_.size() < kMaxStringLength) string_ += c;
+      return true;
+    }
+    if (string_state_ == 2) {
+      if (high_surrogate_ && c != 'u') {
+        appendUtf8(string_, kReplacementChar);
+        high_surrogate_ = 0;
+      }
+      string_state_ = 1;
+      switch (c) {
+        case '"': case '\\': case '/': string_ += c; return true;
+        case 'b': string_ += '\b'; return true;
+        case 'f': string_ += '\f'; return true;
+        case 'n': string_ += '\n'; return true;
+        case 'r': string_ += '\r'; return true;
+        case 't': string_ += '\t'; return true;
+        case 'u': string_state_ = 3; unicode_ = 0; return true;
+        default: return false;
+      }
+    }
+    int nibble = HexValue(c);
+    if (nibble < 0) return false;
+    unicode_ = unicode_ << 4 | static_cast<uint32_t>(nibble);
+    if (++string_state_ < 7) return true;
+    string_state_ = 1;
+    if (unicode_ >= 0xd800 && unicode_ < 0xdc00) {
+      if (high_surrogate_) appendUtf8(string_, kReplacementChar);
+      high_surrogate_ = unicode_;
+    } else if (unicode_ >= 0xdc00 && unicode_ < 0xe000) {
+      appendUtf8(string_, high_surrogate_ ? 0x10000 + ((high_surrogate_ - 0xd800) << 10) + (unicode_ - 0xdc00)
+                                          : kReplacementChar);
+      high_surrogate_ = 0;
+    } else {
+      appendUtf8(string_, unicode_);
+    }
+    return true;
+  }
+
+  if (in_scalar_) {
+    if (IsScalarChar(c)) return true;
+    in_scalar_ = false;
+    if (!endScalar()) return false;
+  }
+  if (IsSpace(c)) return true;
+  if (done_) return false;
+
+  switch (expect_) {
+    case Expect::Value:
+      if (c == '{') return openContainer(true);
+      if (c == '[') return openContainer(false);
+      if (c == ']' && just_opened_ && !stack_.back().object) return closeContainer(false);
+      if (c == '"') {
+        string_state_ = 1;
+        string_is_key_ = false;
+        string_.clear();
+        return true;
+      }
+      if (c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n') {
+        in_scalar_ = true;
+        return true;
+      }
+      return false;
+    case Expect::Key:
+      if (c == '}' && just_opened_) return closeContainer(true);
+      if (c != '"') return false;
+      string_state_ = 1;
+      string_is_key_ = true;
+      string_.clear();
+      return true;
+    case Expect::Colon:
+      if (c != ':') return false;
+      expect_ = Expect::Value;
+      return true;
+    case Expect::CommaOrEnd:
+      if (c == ',') {
+        expect_ = stack_.back().object ? Expect::Key : Expect::Value;
+        return true;
+      }
+      if (c == '}' || c == ']') return closeContainer(c == '}');
+      return false;
+  }
+  return false;
+}
+
+bool ContactStreamParser::openContainer(bool object) {
+  if (stack_.size() >= kMaxDepth) return false;
+  stack_.push_back(Frame{object, {}, {}, {}, {}});
+  expect_ = object ? Expect::Key : Expect::Value;
+  just_opened_ = true;
+  return true;
+}
+
+bool ContactStreamParser::closeContainer(bool object) {
+  if (stack_.empty() || stack_.back().object != object) return false;
+  Frame frame = std::move(stack_.back());
+  stack_.pop_back();
+  if (object && !frame.address.empty()) {
+    if (auto contact = KnownAddress::create(frame.address, frame.name, frame.description,
+                                            ParseContactType(frame.type))) {
+      ++accepted_;
+      sink_(std::move(*contact));
+    } else {
+      ++rejected_;
+    }
+  }
+  valueDone();
+  return true;
+}
+
+bool ContactStreamParser::endString() {
+  string_state_ = 0;
+  if (high_surrogate_) {
+    appendUtf8(string_, kReplacementChar);
+    high_surrogate_ = 0;
+  }
+  if (string_is_key_) {
+    key_ = std::move(string_);
+    expect_ = Expect::Colon;
+    just_opened_ = false;
+    return true;
+  }
+  if (!stack_.empty() && stack_.back().object) {
+    Frame& frame = stack_.back();
+    if (key_ == "address") frame.address = std::move(string_);
+    else if (key_ == "name") frame.name = std::move(string_);
+    else if (key_ == "description") frame.description = std::move(string_);
+    else if (key_ == "type") frame.type = std::move(string_);
+  }
+  string_.clear();
+  valueDone();
+  return true;
+}
+
+bool ContactStreamParser::endScalar() {
+  valueDone();
+  return true;
+}
+
+void ContactStreamParser::valueDone() {
+  just_opened_ = false;
+  if (stack_.empty()) {
+    done_ = true;
+  } else {
+    expect_ = Expect::CommaOrEnd;
+  }
+}
+
+} // namespace app
@@ -0,0 +1,246 @@
+#include "app/form_validation.hpp"
+#include "app/text_scan.hpp"
+#include "app/validation.hpp"
+#include <utility>
+
+namespace app {
+namespace {
+
+constexpr uint64_t kTxBaseGas = 21000;
+constexpr uint64_t kZeroByteGas = 4;
+constexpr uint64_t kNonzeroByteGas = 16;
+
+bool HasHexPrefix(const std::string& s) {
+  return s.size() >= 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X');
+}
+
+bool Assign(std::string& slot, std::string value) {
+  if (slot == value) return false;
+  slot = std::move(value);
+  return true;
+}
+
+} // namespace
+
+const char* TxFieldKey(TxField field) {
+  switch (field) {
+    case TxField::To: return "to";
+    case TxField::Value: return "value";
+    case TxField::Nonce: return "nonce";
+    case TxField::GasLimit: return "gas_limit";
+    case TxField::GasPrice: return "gas_price";
+    case TxField::MaxFee: return "max_fee";
+    case TxField::PriorityFee: return "max_priority";
+    case TxField::Data: return "data";
+  }
+  return "";
+}
+
+TransactionFormValidator::TransactionFormValidator(bool eip1559, bool value_in_eth)
+    : eip1559_(eip1559), value_in_eth_(value_in_eth) {
+  parsed_.type = eip1559 ? 2 : 0;
+}
+
+bool TransactionFormValidator::update(TxField field, const std::string& content) {
+  FieldState& f = state(field);
+  if (f.checked && f.content == content) return false;
+
+  // checkField() sees the previous content, which checkData() resumes from
+  bool changed = Assign(f.error, checkField(field, content));
+  f.content = content;
+  f.checked = true;
+
+  switch (field) {
+    case TxField::MaxFee:
+    case TxField::PriorityFee:
+      changed |= checkFees();
+      break;
+    case TxField::GasLimit:
+    case TxField::Data:
+      changed |= checkIntrinsicGas();
+      break;
+    default:
+      break;
+  }
+
+  if (changed) ++revision_;
+  return changed;
+}
+
+bool TransactionFormValidator::setEip1559(bool eip1559) {
+  if (eip1559 == eip1559_) return false;
+  eip1559_ = eip1559;
+  parsed_.type = eip1559 ? 2 : 0;
+  checkFees();
+  // Fee fields came or went, so the reported errors changed either way
+  ++revision_;
+  return true;
+}
+
+bool TransactionFormValidator::valid() const noexcept {
+  for (size_t i = 0; i < kTxFieldCount; ++i) {
+    auto field = static_cast<TxField>(i);
+    const FieldState& f = fields_[i];
+    if (applies(field) && (!f.checked || !f.error.empty() || !f.cross_error.empty())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const std::string& TransactionFormValidator::error(TxField field) const noexcept {
+  static const std::string kNone;
+  if (!applies(field)) return kNone;
+  const FieldState& f = state(field);
+  return f.error.empty() ? f.cross_error : f.error;
+}
+
+std::map<std::string, std::string> TransactionFormValidator::errors(bool include_empty) const {
+  std::map<std::string, std::string> result;
+  for (size_t i = 0; i < kTxFieldCount; ++i) {
+    auto field = static_cast<TxField>(i);
+    const FieldState& f = fields_[i];
+    if (!f.checked || (!include_empty && f.content.empty())) continue;
+    const std::string& message = error(field);
+    if (!message.empty()) result.emplace(TxFieldKey(field), message);
+  }
+  return result;
+}
+
+void TransactionFormValidator::apply(UnsignedTx& tx) const {
+  tx.to = parsed_.to;
+  tx.value = parsed_.value;
+  tx.data = parsed_.data;
+  tx.nonce = parsed_.nonce;
+  tx.gas_limit = parsed_.gas_limit;
+  if (eip1559_) {
+    tx.max_fee_per_gas = parsed_.max_fee_per_gas;
+    tx.max_priority_fee_per_gas = parsed_.max_priority_fee_per_gas;
+  } else {
+    tx.gas_price = parsed_.gas_price;
+  }
+  tx.type = parsed_.type;
+}
+
+bool TransactionFormValidator::applies(TxField field) const noexcept {
+  switch (field) {
+    case TxField::GasPrice: return !eip1559_;
+    case TxField::MaxFee:
+    case TxField::PriorityFee: return eip1559_;
+    default: return true;
+  }
+}
+
+// The setters leave a field alone when they fail, so each is reset first
+std::string TransactionFormValidator::checkField(TxField field, const std::string& content) {
+  switch (field) {
+    case TxField::To:
+      if (!IsAddress(content)) {
+        parsed_.to.clear();
+        return "Invalid Ethereum address format";
+      }
+      parsed_.to = content;
+      return "";
+    case TxField::Value:
+      parsed_.value.reset();
+      if (value_in_eth_) {
+        return parsed_.setValueFromEth(content) ? "" : "Amount must be in ETH, with at most 18 decimals";
+      }
+      return parsed_.setValueFromString(content) ? "" : "Amount must be a whole number of Wei";
+    case TxField::Nonce:
+      parsed_.nonce.reset();
+      return parsed_.setNonceFromString(content) ? "" : "Nonce must be a number";
+    case TxField::GasLimit:
+      parsed_.gas_limit.reset();
+      return parsed_.setGasLimitFromString(content) ? "" : "Gas limit must be between 21,000 and 30,000,000";
+    case TxField::GasPrice:
+      parsed_.gas_price.reset();
+      return parsed_.setGasPriceFromGwei(content) ? "" : "Gas price must be a Gwei amount up to 1000";
+    case TxField::MaxFee:
+      parsed_.max_fee_per_gas.reset();
+      return parsed_.setMaxFeeFromGwei(content) ? "" : "Max fee must be a Gwei amount up to 1000";
+    case TxField::PriorityFee:
+      parsed_.max_priority_fee_per_gas.reset();
+      return parsed_.setPriorityFeeFromGwei(content) ? "" : "Priority fee must be a Gwei amount up to 1000";
+    case TxField::Data:
+      return checkData(content);
+  }
+  return "";
+}
+
+// Same rules as Validator::isValidTransactionData, without rescanning the
+// digits of data that has only been appended to
+std::string TransactionFormValidator::checkData(const std::string& content) {
+  const FieldState& f = state(TxField::Data);
+  bool appended = f.checked && f.content.size() >= 2 && content.size() >= f.content.size() &&
+                  content.compare(0, f.content.size(), f.content) == 0;
+  if (!appended) {
+    data_checked_ = 0;
+    data_digits_ok_ = true;
+    data_zero_bytes_ = 0;
+    data_nonzero_bytes_ = 0;
+  }
+
+  parsed_.data.clear();
+  if (content.empty() || content == "0x") {
+    parsed_.data = content;
+    return "";
+  }
+  if (content.size() > ValidationLimits::MAX_INPUT_LENGTH ||
+      content.size() > ValidationLimits::MAX_DATA_LENGTH) {
+    data_checked_ = 0;
+    data_digits_ok_ = true;
+    data_zero_bytes_ = 0;
+    data_nonzero_bytes_ = 0;
+    return "Data is too long";
+  }
+  if (!HasHexPrefix(content)) {
+    return "Data must start with 0x";
+  }
+
+  size_t digits = content.size() - 2;
+  const char* hex = content.data() + 2;
+  if (data_digits_ok_ && digits > data_checked_) {
+    data_digits_ok_ = IsHexDigits(hex + data_checked_, digits - data_checked_);
+    if (data_digits_ok_) {
+      for (size_t byte = data_checked_ / 2; byte < digits / 2; ++byte) {
+        if (hex[2 * byte] == '0' && hex[2 * byte + 1] == '0') {
+          ++data_zero_bytes_;
+        } else {
+          ++data_nonzero_bytes_;
+        }
+      }
+      data_checked_ = digits;
+    }
+  }
+
+  if (!data_digits_ok_) return "Data must be hex digits after 0x";
+  if (digits % 2 != 0) return "Data must be whole bytes (an even number of hex digits)";
+  parsed_.data = content;
+  return "";
+}
+
+bool TransactionFormValidator::checkFees() {
+  std::string message;
+  const auto& max_fee = parsed_.max_fee_per_gas;
+  const auto& priority_fee = parsed_.max_priority_fee_per_gas;
+  if (eip1559_ && max_fee && priority_fee && *priority_fee > *max_fee) {
+    message = "Priority fee cannot exceed max fee";
+  }
+  return Assign(state(TxField::PriorityFee).cross_error, std::move(message));
+}
+
+bool TransactionFormValidator::checkIntrinsicGas() {
+  std::string message;
+  const FieldState& data = state(TxField::Data);
+  bool data_ok = !data.checked || data.error.empty();
+  if (parsed_.gas_limit && data_ok) {
+    uint64_t needed = kTxBaseGas + kZeroByteGas * data_zero_bytes_ + kNonzeroByteGas * data_nonzero_bytes_;
+    if (*parsed_.gas_limit < needed) {
+      message = "Gas limit is below the " + std::to_string(needed) + " gas this calldata needs";
+    }
+  }
+  return Assign(state(TxField::GasLimit).cross_error, std::move(message));
+}
+
+} // namespace app
@@ -0,0 +1,160 @@
+#include "app/fountain.hpp"
+#include "app/payload_codec.hpp"
+#include "app/logger.hpp"
+#include "qr_ecc.hpp"
+#include "qrcodegen.hpp"
+#include <algorithm>
+#include <array>
+
+namespace app {
+
+namespace {
+
+// mulberry32; chosen because it is trivial to reproduce bit-exactly in JS
+class FountainRng {
+public:
+  explicit FountainRng(uint32_t seed) : state_(seed) {}
+
+  uint32_t next() {
+    state_ += 0x6D2B79F5u;
+    uint32_t t = (state_ ^ (state_ >> 15)) * (1u | state_);
+    t = (t + ((t ^ (t >> 7)) * (61u | t))) ^ t;
+    return t ^ (t >> 14);
+  }
+
+private:
+  uint32_t state_;
+};
+
+void PutBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+  out.push_back(static_cast<uint8_t>(value >> 24));
+  out.push_back(static_cast<uint8_t>(value >> 16));
+  out.push_back(static_cast<uint8_t>(value >> 8));
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+size_t Base45Length(size_t bytes) {
+  return bytes / 2 * 3 + (bytes % 2) * 2;
+}
+
+// Largest fragment size whose frame text fits one alphanumeric symbol.
+size_t MaxFragmentSize(const QRPlanOptions& options) {
+  const int version = std::max(1, std::min(40, options.max_version));
+  const int capacity = qrcodegen::QrCode::getDataCapacityBits(version, ToQrcodegenEcc(options.ecc));
+  const size_t prefix = std::char_traits<char>::length(kFountainFramePrefix);
+
+  auto fits = [&](size_t fragment) {
+    std::string probe(prefix + Base45Length(kFountainHeaderSize + fragment), 'A');
+    std::vector<qrcodegen::QrSegment> segs{qrcodegen::QrSegment::makeAlphanumeric(probe.c_str())};
+    int bits = qrcodegen::QrSegment::getTotalBits(segs, version);
+    return bits >= 0 && bits <= capacity;
+  };
+
+  size_t lo = 0;
+  size_t hi = 4096;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo + 1) / 2;
+    if (fits(mid)) lo = mid; else hi = mid - 1;
+  }
+  return lo;
+}
+
+} // namespace
+
+uint32_t Crc32(const uint8_t* data, size_t length) {
+  static const std::array<uint32_t, 256> table = [] {
+    std::array<uint32_t, 256> t{};
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      t[i] = c;
+    }
+    return t;
+  }();
+
+  uint32_t crc = 0xFFFFFFFFu;
+  for (size_t i = 0; i < length; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  return crc ^ 0xFFFFFFFFu;
+}
+
+std::vector<uint32_t> FountainFragmentIndexes(uint32_t seq, uint32_t fragment_count, uint32_t checksum) {
+  if (fragment_count == 0 || seq == 0) return {};
+  if (seq <= fragment_count) return {seq - 1};
+
+  // Each fragment joins with probability 1/2, one PRNG bit per fragment
+  FountainRng rng((seq * 0x9E3779B9u) ^ checksum);
+  std::vector<uint32_t> indexes;
+  for (uint32_t base = 0; base < fragment_count; base += 32) {
+    uint32_t bits = rng.next();
+    uint32_t span = std::min<uint32_t>(32, fragment_count - base);
+    for (uint32_t b = 0; b < span; ++b) {
+      if ((bits >> b) & 1u) indexes.push_back(base + b);
+    }
+  }
+  if (indexes.empty()) indexes.push_back(rng.next() % fragment_count);
+  return indexes;
+}
+
+FountainEncoder::FountainEncoder(const std::string& payload, const QRPlanOptions& options)
+    : options_(options) {
+  std::vector<uint8_t> compressed;
+  if (DeflateBytes(payload, true, compressed) && compressed.size() < payload.size()) {
+    message_ = std::move(compressed);
+    header_.flags = kFountainFlagDeflated;
+  } else {
+    message_.assign(payload.begin(), payload.end());
+  }
+  header_.message_length = static_cast<uint32_t>(message_.size());
+  header_.checksum = Crc32(message_.data(), message_.size());
+
+  fragment_size_ = std::min(MaxFragmentSize(options), std::max<size_t>(1, message_.size()));
+  if (fragment_size_ == 0) {
+    LOG_WARN("Fountain frames cannot fit QR version " + std::to_string(options.max_version));
+    return;
+  }
+  fragment_count_ = static_cast<uint32_t>(std::max<size_t>(1, (message_.size() + fragment_size_ - 1) / fragment_size_));
+  message_.resize(fragment_count_ * fragment_size_, 0);
+}
+
+std::string FountainEncoder::frame(uint32_t seq) const {
+  if (!valid() || seq == 0) return std::string();
+
+  std::vector<uint8_t> bytes;
+  bytes.reserve(kFountainHeaderSize + fragment_size_);
+  PutBigEndian(bytes, seq);
+  PutBigEndian(bytes, header_.message_length);
+  PutBigEndian(bytes, header_.checksum);
+  bytes.push_back(header_.flags);
+
+  size_t block_start = bytes.size();
+  bytes.resize(block_start + fragment_size_, 0);
+  for (uint32_t index : FountainFragmentIndexes(seq, fragment_count_, header_.checksum)) {
+    const uint8_t* fragment = message_.data() + static_cast<size_t>(index) * fragment_size_;
+    for (size_t i = 0; i < fragment_size_; ++i) bytes[block_start + i] ^= fragment[i];
+  }
+
+  return kFountainFramePrefix + Base45Encode(bytes);
+}
+
+QRCode FountainEncoder::qr(uint32_t seq) const {
+  QRCode code;
+  std::string text = frame(seq);
+  if (text.empty()) return code;
+
+  try {
+    const int version = std::max(1, std::min(40, options_.max_version));
+    std::vector<qrcodegen::QrSegment> segs{qrcodegen::QrSegment::makeAlphanumeric(text.c_str())};
+    const int mask = options_.fast_mask ? qrcodegen::QrCode::FAST_MASK : -1;
+    qrcodegen::QrCode symbol = qrcodegen::QrCode::encodeSegments(segs, ToQrcodegenEcc(options_.ecc), 1, version, mask, true);
+    code.size = symbol.getSize();
+    code.modules.reset(code.size);
+    symbol.exportModules(code.modules.data(), static_cast<size_t>(code.modules.wordsPerRow()));
+  } catch (const std::exception& e) {
+    LOG_ERROR(std::string("Fountain frame encoding failed: ") + e.what());
+    code.size = 0;
+    code.modules.clear();
+  }
+  return code;
+}
+
+} // namespace app
@@ -0,0 +1,188 @@
+#include "app/keccak.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace app {
+
+namespace {
+
+constexpr uint64_t kRoundConstants[24] = {
+  0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+  0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+  0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+  0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+  0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+  0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+};
+
+// Rotation and destination of each lane in the combined rho + pi step,
+// walked as the usual 24-step cycle starting from lane 1
+constexpr int kRho[24] = {1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14,
+                          27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44};
+constexpr int kPi[24] = {10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4,
+                         15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1};
+
+constexpr size_t kBatchLanes = 4;
+constexpr size_t kRateWords = Keccak256Hasher::kRate / 8;
+
+inline uint64_t Rotl(uint64_t v, int n) {
+  return (v << n) | (v >> (64 - n));
+}
+
+// Keccak-f[1600] on `Lanes` independent states stored lane-interleaved
+// (word w of state l at a[w * Lanes + l]). Every step is a loop over the
+// lanes with no cross-lane dependency, which the compiler turns into vector
+// code.
+template <size_t Lanes>
+void KeccakF1600(uint64_t* state) {
+  auto a = reinterpret_cast<uint64_t (*)[Lanes]>(state);
+  uint64_t c[5][Lanes];
+  uint64_t t[Lanes];
+  for (int round = 0; round < 24; ++round) {
+    // theta
+    for (int x = 0; x < 5; ++x) {
+      for (size_t l = 0; l < Lanes; ++l) {
+        c[x][l] = a[x][l] ^ a[x + 5][l] ^ a[x + 10][l] ^ a[x + 15][l] ^ a[x + 20][l];
+      }
+    }
+    for (int x = 0; x < 5; ++x) {
+      for (size_t l = 0; l < Lanes; ++l) {
+        uint64_t d = c[(x + 4) % 5][l] ^ Rotl(c[(x + 1) % 5][l], 1);
+        for (int y = 0; y < 25; y += 5) a[y + x][l] ^= d;
+      }
+    }
+
+    // rho + pi
+    for (size_t l = 0; l < Lanes; ++l) t[l] = a[1][l];
+    for (int i = 0; i < 24; ++i) {
+      int j = kPi[i];
+      for (size_t l = 0; l < Lanes; ++l) {
+        uint64_t next = a[j][l];
+        a[j][l] = Rotl(t[l], kRho[i]);
+        t[l] = next;
+      }
+    }
+
+    // chi
+    for (int y = 0; y < 25; y += 5) {
+      for (int x = 0; x < 5; ++x) {
+        for (size_t l = 0; l < Lanes; ++l) c[x][l] = a[y + x][l];
+      }
+      for (int x = 0; x < 5; ++x) {
+        for (size_t l = 0; l < Lanes; ++l) {
+          a[y + x][l] = c[x][l] ^ (~c[(x + 1) % 5][l] & c[(x + 2) % 5][l]);
+        }
+      }
+    }
+
+    // iota
+    for (size_t l = 0; l < Lanes; ++l) a[0][l] ^= kRoundConstants[round];
+  }
+}
+
+inline uint64_t LoadLe64(const uint8_t* p) {
+  uint64_t v = 0;
+  for (int i = 7; i >= 0; --i) v = (v << 8) | p[i];
+  return v;
+}
+
+inline void StoreLe64(uint64_t v, uint8_t* p) {
+  for (int i = 0; i < 8; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+// Message of less than one block, padded into a full block
+void PadSingleBlock(const std::string& message, uint8_t (&block)[Keccak256Hasher::kRate]) {
+  std::memset(block, 0, sizeof(block));
+  std::memcpy(block, message.data(), message.size());
+  block[message.size()] ^= 0x01;
+  block[Keccak256Hasher::kRate - 1] ^= 0x80;
+}
+
+} // namespace
+
+void Keccak256Hasher::reset() {
+  std::memset(state_, 0, sizeof(state_));
+  offset_ = 0;
+}
+
+void Keccak256Hasher::update(const uint8_t* data, size_t size) {
+  while (size > 0) {
+    size_t take = std::min(size, kRate - offset_);
+    for (size_t i = 0; i < take; ++i) {
+      size_t pos = offset_ + i;
+      state_[pos / 8] ^= static_cast<uint64_t>(data[i]) << (8 * (pos % 8));
+    }
+    offset_ += take;
+    data += take;
+    size -= take;
+    if (offset_ == kRate) {
+      KeccakF1600<1>(state_);
+      offset_ = 0;
+    }
+  }
+}
+
+Hash256 Keccak256Hasher::finalize() {
+  state_[offset_ / 8] ^= 0x01ULL << (8 * (offset_ % 8));
+  state_[kRateWords - 1] ^= 0x80ULL << 56;
+  KeccakF1600<1>(state_);
+
+  Hash256 hash;
+  for (size_t w = 0; w < 4; ++w) StoreLe64(state_[w], hash.data() + 8 * w);
+  return hash;
+}
+
+Hash256 Keccak256(const uint8_t* data, size_t size) {
+  Keccak256Hasher hasher;
+  hasher.update(data, size);
+  return hasher.finalize();
+}
+
+Hash256 Keccak256(const std::string& data) {
+  return Keccak256(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+}
+
+std::vector<Hash256> Keccak256Batch(const std::vector<std::string>& messages) {
+  std::vector<Hash256> hashes(messages.size());
+
+  // Short messages are gathered kBatchLanes at a time; a partial final
+  // group just permutes a few zero lanes it throws away
+  size_t group[kBatchLanes];
+  size_t filled = 0;
+  auto flush = [&] {
+    uint64_t a[25][kBatchLanes] = {};
+    uint8_t block[Keccak256Hasher::kRate];
+    for (size_t l = 0; l < filled; ++l) {
+      PadSingleBlock(messages[group[l]], block);
+      for (size_t w = 0; w < kRateWords; ++w) a[w][l] = LoadLe64(block + 8 * w);
+    }
+    KeccakF1600<kBatchLanes>(&a[0][0]);
+    for (size_t l = 0; l < filled; ++l) {
+      for (size_t w = 0; w < 4; ++w) StoreLe64(a[w][l], hashes[group[l]].data() + 8 * w);
+    }
+    filled = 0;
+  };
+
+  for (size_t i = 0; i < messages.size(); ++i) {
+    if (messages[i].size() >= Keccak256Hasher::kRate) {
+      hashes[i] = Keccak256(messages[i]);
+      continue;
+    }
+    group[filled++] = i;
+    if (filled == kBatchLanes) flush();
+  }
+  if (filled > 0) flush();
+  return hashes;
+}
+
+std::string ToHex(const uint8_t* data, size_t size) {
+  static const char kDigits[] = "0123456789abcdef";
+  std::string hex(size * 2, '0');
+  for (size_t i = 0; i < size; ++i) {
+    hex[2 * i] = kDigits[data[i] >> 4];
+    hex[2 * i + 1] = kDigits[data[i] & 0x0f];
+  }
+  return hex;
+}
+
+} // namespace app
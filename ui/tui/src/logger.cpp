@@ -1,33 +1,202 @@
 #include "app/logger.hpp"
+#include "app/metrics.hpp"
 #include <iostream>
 #include <iomanip>
 #include <filesystem>
 #include <algorithm>
+#include <condition_variable>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace app {
 
+namespace {
+
+// Size of the batch buffer the async writer fills before issuing a write(2)
+constexpr size_t kAsyncBatchBytes = 64 * 1024;
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// write(2) until everything is out, retrying on EINTR and partial writes
+void WriteAll(int fd, const char* data, size_t length) noexcept {
+    while (length > 0) {
+        ssize_t written = ::write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+    }
+}
+
+} // namespace
+
+/**
+ * Bounded multi-producer/single-consumer ring (Vyukov's sequence-per-slot
+ * scheme). Producers claim a slot with one CAS and hand over a string by
+ * move; only the writer thread dequeues, so the consumer side is plain loads.
+ */
+struct Logger::AsyncBackend {
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        std::string text;
+    };
+    
+    AsyncBackend(const AsyncOptions& opts)
+        : options(opts)
+        , mask(RoundUpToPowerOfTwo(std::max<size_t>(2, opts.queue_capacity)) - 1)
+        , slots(new Slot[mask + 1]) {
+        for (size_t i = 0; i <= mask; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    
+    // Copies into the slot's string, which keeps its capacity between uses,
+    // so once every slot has been warmed up enqueueing allocates nothing
+    bool tryPush(const std::string& text) noexcept {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots[pos & mask];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    try {
+                        slot.text.assign(text);
+                    } catch (...) {
+                        slot.text.clear();
+                    }
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // Full
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    
+    // Consumer only: appends the next record to `out`
+    bool tryPop(std::string& out) noexcept {
+        Slot& slot = slots[dequeue_pos & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos + 1) {
+            return false;
+        }
+        out += slot.text;
+        slot.text.clear();
+        slot.sequence.store(dequeue_pos + mask + 1, std::memory_order_release);
+        ++dequeue_pos;
+        return true;
+    }
+    
+    void wake() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            wake_requested = true;
+        }
+        wake_cv.notify_one();
+    }
+    
+    const AsyncOptions options;
+    const size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    alignas(64) std::atomic<size_t> enqueue_pos{0};
+    alignas(64) size_t dequeue_pos = 0;
+    std::atomic<size_t> dropped{0};
+    
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;
+    bool wake_requested = false;
+    bool stopping = false;
+    
+    // Records dequeued and written so far, for flush()
+    std::condition_variable written_cv;
+    size_t written_pos = 0;
+    
+    std::thread writer;
+};
+
 Logger& Logger::getInstance() {
     static Logger instance;
     return instance;
 }
 
+Logger::Logger() = default;
+
 Logger::~Logger() {
     shutdown();
 }
 
 bool Logger::initialize(const std::string& log_file_path, Level min_level, 
                        bool console_output, size_t max_file_size_mb) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopAsyncWriter();
+        if (!openLogFile(log_file_path, min_level, console_output, max_file_size_mb)) {
+            return false;
+        }
+        initialized_.store(true, std::memory_order_release);
+    }
     
+    // Log initialization
+    info("Logger initialized: level=" + levelToString(min_level) + 
+         ", console=" + (console_output ? "true" : "false") + 
+         ", file=" + log_file_path);
+    return true;
+}
+
+bool Logger::initializeAsync(const std::string& log_file_path, Level min_level,
+                             bool console_output, size_t max_file_size_mb,
+                             const AsyncOptions& options) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopAsyncWriter();
+        if (!openLogFile(log_file_path, min_level, console_output, max_file_size_mb)) {
+            return false;
+        }
+        
+        try {
+            async_.reset();
+            async_ = std::make_unique<AsyncBackend>(options);
+            async_->writer = std::thread(&Logger::asyncWriterLoop, this);
+        } catch (const std::exception& e) {
+            std::cerr << "Logger: Failed to start async writer, using synchronous mode: "
+                      << e.what() << std::endl;
+            async_.reset();
+        }
+        async_active_.store(async_ != nullptr, std::memory_order_release);
+        initialized_.store(true, std::memory_order_release);
+    }
+    
+    info("Logger initialized: level=" + levelToString(min_level) + 
+         ", console=" + (console_output ? "true" : "false") + 
+         ", file=" + log_file_path + ", async=" + (isAsync() ? "true" : "false"));
+    return true;
+}
+
+// Caller holds mutex_
+bool Logger::openLogFile(const std::string& log_file_path, Level min_level,
+                         bool console_output, size_t max_file_size_mb) {
     try {
         // Close existing log file if open
-        if (log_file_.is_open()) {
-            log_file_.close();
-        }
+        closeLogFile();
         
         log_file_path_ = log_file_path;
-        min_level_ = min_level;
-        console_output_ = console_output;
+        min_level_.store(min_level, std::memory_order_relaxed);
+        console_output_.store(console_output, std::memory_order_relaxed);
         max_file_size_bytes_ = max_file_size_mb * 1024 * 1024;
         current_file_size_ = 0;
         
@@ -38,8 +207,8 @@ bool Logger::initialize(const std::string& log_file_path, Level min_level,
         }
         
         // Open log file in append mode
-        log_file_.open(log_file_path_, std::ios::app);
-        if (!log_file_.is_open()) {
+        log_fd_ = ::open(log_file_path_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (log_fd_ < 0) {
             std::cerr << "Logger: Failed to open log file: " << log_file_path_ << std::endl;
             return false;
         }
@@ -53,13 +222,6 @@ bool Logger::initialize(const std::string& log_file_path, Level min_level,
             current_file_size_ = 0;
         }
         
-        initialized_ = true;
-        
-        // Log initialization
-        info("Logger initialized: level=" + levelToString(min_level_) + 
-             ", console=" + (console_output_ ? "true" : "false") + 
-             ", file=" + log_file_path_);
-        
         return true;
         
     } catch (const std::exception& e) {
@@ -68,50 +230,116 @@ bool Logger::initialize(const std::string& log_file_path, Level min_level,
     }
 }
 
+void Logger::closeLogFile() noexcept {
+    if (log_fd_ >= 0) {
+        ::close(log_fd_);
+        log_fd_ = -1;
+    }
+}
+
+// Caller holds mutex_. Drains everything already queued before returning.
+void Logger::stopAsyncWriter() noexcept {
+    if (!async_) {
+        return;
+    }
+    
+    async_active_.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(async_->wake_mutex);
+        async_->stopping = true;
+    }
+    async_->wake_cv.notify_one();
+    if (async_->writer.joinable()) {
+        async_->writer.join();
+    }
+    // The backend itself stays allocated until the next initializeAsync or
+    // destruction, so a producer racing with shutdown pushes into a dead
+    // queue rather than freed memory
+}
+
 void Logger::shutdown() noexcept {
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        if (initialized_) {
+        if (initialized_.load(std::memory_order_acquire)) {
             info("Logger shutting down");
-            initialized_ = false;
         }
         
-        if (log_file_.is_open()) {
-            log_file_.close();
-        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopAsyncWriter();
+        initialized_.store(false, std::memory_order_release);
+        closeLogFile();
         
     } catch (...) {
         // Swallow all exceptions in shutdown
     }
 }
 
+void Logger::flush() noexcept {
+    try {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!async_active_.load(std::memory_order_acquire)) {
+            return; // Synchronous writes are already on disk
+        }
+        
+        AsyncBackend& backend = *async_;
+        size_t target = backend.enqueue_pos.load(std::memory_order_acquire);
+        backend.wake();
+        
+        std::unique_lock<std::mutex> wait_lock(backend.wake_mutex);
+        backend.written_cv.wait_for(wait_lock, std::chrono::seconds(2), [&] {
+            return backend.written_pos >= target;
+        });
+    } catch (...) {
+        // Flushing is best effort
+    }
+}
+
 void Logger::log(Level level, const std::string& message, 
                 const char* file, int line, const char* function) noexcept {
     try {
         // Early return if level is below threshold
-        if (level < min_level_) {
+        if (level < min_level_.load(std::memory_order_relaxed) ||
+            !initialized_.load(std::memory_order_acquire)) {
             return;
         }
         
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        if (!initialized_) {
+        // Records are built in a per-thread buffer that keeps its capacity
+        thread_local std::string record;
+        record.clear();
+        formatRecord(record, level, message, file, line, function);
+        record += '\n';
+        
+        if (async_active_.load(std::memory_order_acquire)) {
+            AsyncBackend& backend = *async_;
+            bool queued = backend.tryPush(record);
+            if (!queued) {
+                backend.dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (!queued || level >= backend.options.flush_level) {
+                backend.wake();
+            }
+            if (level == Level::FATAL) {
+                flush();
+            }
             return;
         }
         
-        std::string formatted_message = formatMessage(level, message, file, line, function);
-        
-        // Write to file
-        writeToFile(formatted_message);
-        
-        // Write to console
-        if (console_output_) {
-            writeToConsole(formatted_message);
+        std::string rotated;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            
+            if (!initialized_.load(std::memory_order_relaxed)) {
+                return;
+            }
+            
+            writeRecords(record);
+            
+            // Check if log rotation is needed
+            rotated = rotateLogFileIfNeeded();
         }
         
-        // Check if log rotation is needed
-        rotateLogFileIfNeeded();
+        if (!rotated.empty()) {
+            info("Log file rotated, backup saved as " + rotated);
+        }
         
     } catch (...) {
         // Logging should never throw exceptions
@@ -124,6 +352,62 @@ void Logger::log(Level level, const std::string& message,
     }
 }
 
+void Logger::asyncWriterLoop() noexcept {
+    AsyncBackend& backend = *async_;
+    std::string batch;
+    batch.reserve(kAsyncBatchBytes);
+    
+    for (;;) {
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(backend.wake_mutex);
+            backend.wake_cv.wait_for(lock, backend.options.flush_interval, [&] {
+                return backend.wake_requested || backend.stopping;
+            });
+            backend.wake_requested = false;
+            stopping = backend.stopping;
+        }
+        
+        size_t dropped = backend.dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            batch += formatMessage(Level::WARN, "Logger queue full, dropped " + std::to_string(dropped) +
+                                   " messages", nullptr, 0, nullptr);
+            batch += '\n';
+        }
+        
+        // Drain in batch-sized write(2)s
+        for (;;) {
+            while (batch.size() < kAsyncBatchBytes && backend.tryPop(batch)) {
+            }
+            if (batch.empty()) {
+                break;
+            }
+            writeRecords(batch);
+            batch.clear();
+            
+            std::string rotated = rotateLogFileIfNeeded();
+            if (!rotated.empty()) {
+                batch += formatMessage(Level::INFO, "Log file rotated, backup saved as " + rotated,
+                                       nullptr, 0, nullptr);
+                batch += '\n';
+            }
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(backend.wake_mutex);
+            backend.written_pos = backend.dequeue_pos;
+        }
+        backend.written_cv.notify_all();
+        
+        // Producers have stopped by now (async_active_ is false), so an empty
+        // queue really is the end
+        if (stopping && backend.slots[backend.dequeue_pos & backend.mask].sequence.load(
+                            std::memory_order_acquire) != backend.dequeue_pos + 1) {
+            return;
+        }
+    }
+}
+
 void Logger::logException(const std::exception& e, const std::string& context,
                          const char* file, int line, const char* function) noexcept {
     try {
@@ -175,85 +459,136 @@ std::unique_ptr<Logger::PerformanceTimer> Logger::createTimer(const std::string&
 
 std::string Logger::formatMessage(Level level, const std::string& message,
                                  const char* file, int line, const char* function) const noexcept {
+    std::string formatted;
+    formatRecord(formatted, level, message, file, line, function);
+    return formatted;
+}
+
+void Logger::formatRecord(std::string& out, Level level, const std::string& message,
+                          const char* file, int line, const char* function) const noexcept {
     try {
-        std::ostringstream formatted;
+        // Formatted once per thread instead of streaming the id per message
+        thread_local const std::string thread_id = [] {
+            std::ostringstream id;
+            id << std::this_thread::get_id();
+            return id.str();
+        }();
+        
+        static const char* const kPaddedLevels[] = {"TRACE", "DEBUG", " INFO", " WARN", "ERROR", "FATAL"};
+        int level_index = static_cast<int>(level);
         
         // Timestamp
-        formatted << "[" << getCurrentTimestamp() << "] ";
+        out += '[';
+        appendTimestamp(out);
+        out += "] [";
         
         // Level
-        formatted << "[" << std::setw(5) << levelToString(level) << "] ";
+        out += (level_index >= 0 && level_index <= 5) ? kPaddedLevels[level_index] : "UNKNOWN";
+        out += "] [";
         
         // Thread ID
-        formatted << "[" << std::this_thread::get_id() << "] ";
+        out += thread_id;
+        out += "] ";
         
         // Message
-        formatted << message;
+        out += message;
         
         // Source location (only for debug/trace levels to reduce noise)
         if (level <= Level::DEBUG && file && function) {
-            formatted << " (" << extractFileName(file) << ":" << line << " in " << function << ")";
+            char line_number[16];
+            std::snprintf(line_number, sizeof(line_number), ":%d", line);
+            out += " (";
+            out += extractFileName(file);
+            out += line_number;
+            out += " in ";
+            out += function;
+            out += ')';
         }
         
-        return formatted.str();
-        
     } catch (...) {
-        return "[TIMESTAMP] [ERROR] Logger formatting error: " + message;
+        try {
+            out = "[TIMESTAMP] [ERROR] Logger formatting error: " + message;
+        } catch (...) {
+            out.clear();
+        }
     }
 }
 
 std::string Logger::getCurrentTimestamp() const noexcept {
+    std::string timestamp;
+    appendTimestamp(timestamp);
+    return timestamp;
+}
+
+void Logger::appendTimestamp(std::string& out) const noexcept {
     try {
         auto now = std::chrono::system_clock::now();
         auto time_t = std::chrono::system_clock::to_time_t(now);
         auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
             now.time_since_epoch()) % 1000;
         
-        std::ostringstream timestamp;
-        timestamp << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-        timestamp << "." << std::setfill('0') << std::setw(3) << milliseconds.count();
+        // localtime_r and strftime only run when the second changes
+        thread_local std::time_t cached_second = static_cast<std::time_t>(-1);
+        thread_local char cached_prefix[32];
+        thread_local size_t cached_length = 0;
+        if (time_t != cached_second) {
+            std::tm local_time;
+            localtime_r(&time_t, &local_time);
+            cached_length = std::strftime(cached_prefix, sizeof(cached_prefix), "%Y-%m-%d %H:%M:%S", &local_time);
+            if (cached_length == 0) {
+                out += "TIMESTAMP_ERROR";
+                return;
+            }
+            cached_second = time_t;
+        }
         
-        return timestamp.str();
+        char millis[8];
+        std::snprintf(millis, sizeof(millis), ".%03d", static_cast<int>(milliseconds.count()));
+        out.append(cached_prefix, cached_length);
+        out += millis;
         
     } catch (...) {
-        return "TIMESTAMP_ERROR";
+        out += "TIMESTAMP_ERROR";
     }
 }
 
-void Logger::writeToFile(const std::string& formatted_message) noexcept {
-    try {
-        if (!log_file_.is_open()) {
-            return;
-        }
-        
-        log_file_ << formatted_message << std::endl;
-        log_file_.flush();
-        
-        current_file_size_ += formatted_message.length() + 1; // +1 for newline
-        
-    } catch (...) {
-        // Silent failure for file writing
+// `records` is one or more newline-terminated records
+void Logger::writeRecords(const std::string& records) noexcept {
+    writeToFile(records);
+    
+    if (console_output_.load(std::memory_order_relaxed)) {
+        writeToConsole(records);
     }
 }
 
-void Logger::writeToConsole(const std::string& formatted_message) noexcept {
+void Logger::writeToFile(const std::string& records) noexcept {
+    if (log_fd_ < 0) {
+        return;
+    }
+    
+    WriteAll(log_fd_, records.data(), records.size());
+    current_file_size_ += records.size();
+}
+
+void Logger::writeToConsole(const std::string& records) noexcept {
+    // Shares stdout with iostream users; flush their buffer first so lines
+    // don't interleave out of order
     try {
-        std::cout << formatted_message << std::endl;
         std::cout.flush();
-        
     } catch (...) {
         // Silent failure for console writing
     }
+    WriteAll(STDOUT_FILENO, records.data(), records.size());
 }
 
-void Logger::rotateLogFileIfNeeded() noexcept {
+std::string Logger::rotateLogFileIfNeeded() noexcept {
     try {
         if (current_file_size_ < max_file_size_bytes_) {
-            return;
+            return std::string();
         }
         
         // Close current file
-        log_file_.close();
+        closeLogFile();
         
         // Rotate files: log.1 -> log.2, log -> log.1
         std::string backup_path = log_file_path_ + ".1";
@@ -269,12 +604,10 @@ void Logger::rotateLogFileIfNeeded() noexcept {
         }
         
         // Reopen log file
-        log_file_.open(log_file_path_, std::ios::app);
+        log_fd_ = ::open(log_file_path_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
         current_file_size_ = 0;
         
-        if (log_file_.is_open()) {
-            info("Log file rotated, backup saved as " + backup_path);
-        }
+        return log_fd_ >= 0 ? backup_path : std::string();
         
     } catch (const std::exception& e) {
         // Try to continue with current file
@@ -283,27 +616,17 @@ void Logger::rotateLogFileIfNeeded() noexcept {
         } catch (...) {
             // Give up silently
         }
+        if (log_fd_ < 0) {
+            log_fd_ = ::open(log_file_path_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        }
+        return std::string();
     }
 }
 
-std::string Logger::extractFileName(const char* file_path) const noexcept {
-    try {
-        if (!file_path) {
-            return "unknown_file";
-        }
-        
-        std::string path_str(file_path);
-        size_t last_slash = path_str.find_last_of("/\\");
-        
-        if (last_slash != std::string::npos && last_slash + 1 < path_str.length()) {
-            return path_str.substr(last_slash + 1);
-        }
-        
-        return path_str;
-        
-    } catch (...) {
-        return "file_extract_error";
-    }
+// The LOG_* macros already pass a compile-time basename; this covers the
+// convenience methods, which default to the full __builtin_FILE() path
+const char* Logger::extractFileName(const char* file_path) const noexcept {
+    return file_path ? detail::FileBaseName(file_path) : "unknown_file";
 }
 
 // PerformanceTimer implementation
@@ -316,6 +639,7 @@ Logger::PerformanceTimer::~PerformanceTimer() {
     try {
         auto end_time = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time_);
+        Metrics::shared().histogram(operation_name_).record(end_time - start_time_);
         
         std::ostringstream msg;
         msg << "Performance: " << operation_name_ << " took " << duration.count() << " μs";
@@ -1,12 +1,24 @@
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <string>
+#include "app/batch_signing.hpp"
+#include "app/config.hpp"
+#include "app/metrics.hpp"
+#include "app/qr_graphics.hpp"
+#include "app/startup_trace.hpp"
 
 int RunHelloWorld();         // Ultra-minimal test (hello_world.cpp)
-int RunSimpleTransaction();  // Comprehensive transaction app (simple_transaction.cpp)
+int RunSimpleTransaction(const app::SigningBatch* batch);  // Comprehensive transaction app (simple_transaction.cpp)
 int RunWalletDetectionApp(); // Wallet detection with polling (main_with_wallet_detection.cpp)
 
 int main(int argc, char* argv[]){ 
+  std::string metrics_path;
+  std::string batch_path;
+  uint64_t start_nonce = 0;
+  std::string qr_backend = "auto";
+  std::string address_book_path;
+  
   // Handle command-line arguments
   for (int i = 1; i < argc; i++) {
     std::string arg = argv[i];
@@ -14,6 +26,18 @@ int main(int argc, char* argv[]){
       std::cout << "Base OS TUI v1.0.0" << std::endl;
       std::cout << "Simple Ethereum transaction interface" << std::endl;
       return 0;
+    } else if (arg == "--trace-startup") {
+      app::StartupTrace::instance().enable();
+    } else if (arg == "--metrics-out" && i + 1 < argc) {
+      metrics_path = argv[++i];
+    } else if (arg == "--batch" && i + 1 < argc) {
+      batch_path = argv[++i];
+    } else if (arg == "--start-nonce" && i + 1 < argc) {
+      start_nonce = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--qr-backend" && i + 1 < argc) {
+      qr_backend = argv[++i];
+    } else if (arg == "--address-book" && i + 1 < argc) {
+      address_book_path = argv[++i];
     } else if (arg == "--help" || arg == "-h") {
       std::cout << "Base OS TUI - Simple Ethereum Transaction Interface" << std::endl;
       std::cout << std::endl;
@@ -22,16 +46,55 @@ int main(int argc, char* argv[]){
       std::cout << "Options:" << std::endl;
       std::cout << "  --version, -v    Show version information" << std::endl;
       std::cout << "  --help, -h       Show this help message" << std::endl;
+      std::cout << "  --trace-startup  Print startup phase timings on exit" << std::endl;
+      std::cout << "  --metrics-out F  Write counters and latency histograms to F (JSON) on exit" << std::endl;
+      std::cout << "  --batch F        Sign every transfer in F (CSV or JSON) in one device session" << std::endl;
+      std::cout << "  --start-nonce N  Nonce of the first batch transfer without one (default 0)" << std::endl;
+      std::cout << "  --qr-backend B   Draw QR codes as text, sixel, kitty or fb (/dev/fb0); default auto" << std::endl;
+      std::cout << "  --address-book F Suggest recipients from F (.json, .csv or a converted .bosab book)" << std::endl;
       std::cout << std::endl;
       std::cout << "Controls:" << std::endl;
       std::cout << "  Tab              Navigate between fields" << std::endl;
       std::cout << "  Enter            Submit/Continue" << std::endl;
       std::cout << "  Escape           Go back" << std::endl;
+      std::cout << "  m                Show or hide live latency metrics" << std::endl;
       std::cout << "  Ctrl+C           Quit" << std::endl;
       return 0;
     }
   }
   
+  app::StartupTrace::instance().mark("main");
+  app::Config::getInstance().load();
+  if (!address_book_path.empty()) {
+    auto config = app::Config::getInstance().getAppConfig();
+    config.address_book_path = address_book_path;
+    app::Config::getInstance().setAppConfig(config);
+  }
+  
+  auto backend = qr_backend == "auto" ? app::DetectQRGraphicsBackend() : app::ParseQRGraphicsBackend(qr_backend);
+  if (!backend) {
+    std::cerr << "Unknown QR backend: " << qr_backend << std::endl;
+    return 1;
+  }
+  app::QRGraphicsOverlay::shared().setBackend(*backend);
+  
+  // A batch is checked in full before anything is sent to the device
+  app::SigningBatch batch;
+  if (!batch_path.empty()) {
+    batch = app::LoadSigningBatch(batch_path, start_nonce);
+    if (batch.error.empty()) app::ValidateSigningBatch(batch);
+    if (!batch.valid()) {
+      std::cerr << "Batch " << batch_path << " cannot be signed:" << std::endl;
+      for (const auto& line : batch.errorLines()) std::cerr << "  " << line << std::endl;
+      return 1;
+    }
+  }
+  
   // Use the original comprehensive interface with integrated wallet detection
-  return RunSimpleTransaction(); 
+  int status = RunSimpleTransaction(batch_path.empty() ? nullptr : &batch);
+  app::StartupTrace::instance().dump();
+  if (!metrics_path.empty() && !app::Metrics::shared().writeJson(metrics_path)) {
+    std::cerr << "Could not write metrics to " << metrics_path << std::endl;
+  }
+  return status;
 }
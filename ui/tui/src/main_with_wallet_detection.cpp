@@ -5,6 +5,7 @@
 #include <ftxui/component/event.hpp>
 #include "app/state.hpp"
 #include "app/wallet_detector.hpp"
+#include "app/redraw_scheduler.hpp"
 #include <string>
 #include <thread>
 #include <chrono>
@@ -164,21 +165,19 @@ int RunWalletDetectionApp() {
         return false;
     });
     
-    // Animation thread for status updates
-    std::thread animation_thread([&] {
-        while (true) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            state->incrementAnimationFrame();
-            screen.PostEvent(Event::Custom);
-        }
-    });
+    // Redraw when the detector callbacks publish new state; nothing on these
+    // screens animates, so an idle screen is never redrawn
+    app::RedrawScheduler redraw([&] { screen.PostEvent(Event::Custom); },
+                                app::RedrawScheduler::configuredFrameInterval());
+    state->addChangeCallback([&redraw](uint64_t) { redraw.invalidate(); });
     
     // Run the application
     screen.Loop(event_handler);
     
     // Cleanup
     detector->stopDetection();
-    animation_thread.join();
+    state->clearCallbacks();
+    redraw.stop();
     
     return 0;
 }
@@ -0,0 +1,224 @@
+#include "app/metrics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+namespace app {
+
+namespace detail {
+
+size_t MetricShard() noexcept {
+  static std::atomic<size_t> next{0};
+  thread_local const size_t shard = next.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+  return shard;
+}
+
+} // namespace detail
+
+namespace {
+
+int HighestBit(uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  return 63 - __builtin_clzll(value);
+#else
+  int bit = 0;
+  while (value >>= 1) ++bit;
+  return bit;
+#endif
+}
+
+void AtomicMin(std::atomic<uint64_t>& target, uint64_t value) noexcept {
+  uint64_t current = target.load(std::memory_order_relaxed);
+  while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+void AtomicMax(std::atomic<uint64_t>& target, uint64_t value) noexcept {
+  uint64_t current = target.load(std::memory_order_relaxed);
+  while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+void AppendJsonString(std::string& out, const std::string& text) {
+  out += '"';
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+      out += escaped;
+    } else {
+      out += c;
+    }
+  }
+  out += '"';
+}
+
+} // namespace
+
+uint64_t Counter::value() const noexcept {
+  uint64_t total = 0;
+  for (const auto& shard : shards_) total += shard.value.load(std::memory_order_relaxed);
+  return total;
+}
+
+uint64_t HistogramSnapshot::percentileNs(double p) const noexcept {
+  uint64_t total = 0;
+  for (uint64_t n : buckets) total += n;
+  if (total == 0) return 0;
+  if (p <= 0) return min_ns;
+
+  auto rank = static_cast<uint64_t>(std::ceil(std::min(p, 100.0) / 100.0 * static_cast<double>(total)));
+  rank = std::max<uint64_t>(rank, 1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    seen += buckets[i];
+    if (seen >= rank) return std::min(Histogram::BucketUpperBound(i), max_ns);
+  }
+  return max_ns;
+}
+
+Histogram::Histogram() : shards_(new Shard[detail::kMetricShards]) {}
+
+size_t Histogram::BucketIndex(uint64_t ns) noexcept {
+  constexpr uint64_t kSubBuckets = uint64_t{1} << kSubBucketBits;
+  if (ns < kSubBuckets) return static_cast<size_t>(ns);
+  int exponent = HighestBit(ns);
+  if (exponent > kMaxExponent) return kOverflowBucket;
+  int shift = exponent - kSubBucketBits;
+  return (static_cast<size_t>(exponent - kSubBucketBits + 1) << kSubBucketBits) +
+         static_cast<size_t>((ns >> shift) & (kSubBuckets - 1));
+}
+
+uint64_t Histogram::BucketUpperBound(size_t index) noexcept {
+  constexpr uint64_t kSubBuckets = uint64_t{1} << kSubBucketBits;
+  if (index < kSubBuckets) return index;
+  if (index >= kOverflowBucket) return UINT64_MAX;
+  int shift = static_cast<int>(index >> kSubBucketBits) - 1;
+  uint64_t lower = (kSubBuckets + (index & (kSubBuckets - 1))) << shift;
+  return lower + (uint64_t{1} << shift) - 1;
+}
+
+void Histogram::recordNs(uint64_t ns) noexcept {
+  Shard& shard = shards_[detail::MetricShard()];
+  shard.count.fetch_add(1, std::memory_order_relaxed);
+  shard.sum.fetch_add(ns, std::memory_order_relaxed);
+  shard.buckets[BucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+  AtomicMin(shard.min, ns);
+  AtomicMax(shard.max, ns);
+}
+
+HistogramSnapshot Histogram::snapshot() const {
+  HistogramSnapshot snap;
+  snap.buckets.assign(kBucketCount, 0);
+  uint64_t min = UINT64_MAX;
+  for (size_t s = 0; s < detail::kMetricShards; ++s) {
+    const Shard& shard = shards_[s];
+    snap.count += shard.count.load(std::memory_order_relaxed);
+    snap.sum_ns += shard.sum.load(std::memory_order_relaxed);
+    min = std::min(min, shard.min.load(std::memory_order_relaxed));
+    snap.max_ns = std::max(snap.max_ns, shard.max.load(std::memory_order_relaxed));
+    for (size_t i = 0; i < kBucketCount; ++i) {
+      snap.buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+    }
+  }
+  snap.min_ns = snap.count ? min : 0;
+  return snap;
+}
+
+std::string MetricsSnapshot::toJson() const {
+  std::string out = "{\n  \"counters\": {";
+  const char* separator = "\n";
+  for (const auto& [name, value] : counters) {
+    out += separator;
+    out += "    ";
+    AppendJsonString(out, name);
+    out += ": " + std::to_string(value);
+    separator = ",\n";
+  }
+  out += counters.empty() ? "},\n" : "\n  },\n";
+
+  out += "  \"histograms\": {";
+  separator = "\n";
+  char line[256];
+  for (const auto& [name, h] : histograms) {
+    out += separator;
+    out += "    ";
+    AppendJsonString(out, name);
+    std::snprintf(line, sizeof(line),
+                  ": {\"count\": %llu, \"mean_ns\": %.1f, \"min_ns\": %llu, \"p50_ns\": %llu, "
+                  "\"p90_ns\": %llu, \"p99_ns\": %llu, \"max_ns\": %llu}",
+                  static_cast<unsigned long long>(h.count), h.meanNs(),
+                  static_cast<unsigned long long>(h.min_ns),
+                  static_cast<unsigned long long>(h.percentileNs(50)),
+                  static_cast<unsigned long long>(h.percentileNs(90)),
+                  static_cast<unsigned long long>(h.percentileNs(99)),
+                  static_cast<unsigned long long>(h.max_ns));
+    out += line;
+    separator = ",\n";
+  }
+  out += histograms.empty() ? "}\n}\n" : "\n  }\n}\n";
+  return out;
+}
+
+Metrics& Metrics::shared() {
+  static Metrics metrics;
+  return metrics;
+}
+
+Counter& Metrics::counter(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& slot = counters_[name];
+  if (!slot) slot = std::make_unique<Counter>();
+  return *slot;
+}
+
+Histogram& Metrics::histogram(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& slot = histograms_[name];
+  if (!slot) slot = std::make_unique<Histogram>();
+  return *slot;
+}
+
+MetricsSnapshot Metrics::snapshot() const {
+  MetricsSnapshot snap;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& [name, counter] : counters_) snap.counters.emplace_back(name, counter->value());
+  for (const auto& [name, histogram] : histograms_) snap.histograms.emplace_back(name, histogram->snapshot());
+  return snap;
+}
+
+bool Metrics::writeJson(const std::string& path) const noexcept {
+  try {
+    std::string json = snapshot().toJson();
+    std::string tmp = path + ".tmp";
+    {
+      std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+      if (!out) return false;
+      out << json;
+      if (!out.flush()) return false;
+    }
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+  } catch (...) {
+    return false;
+  }
+}
+
+std::string FormatNanoseconds(uint64_t ns) {
+  char text[32];
+  if (ns < 1000) {
+    std::snprintf(text, sizeof(text), "%llu ns", static_cast<unsigned long long>(ns));
+  } else if (ns < 1000 * 1000) {
+    std::snprintf(text, sizeof(text), "%.1f us", ns / 1e3);
+  } else if (ns < 1000ull * 1000 * 1000) {
+    std::snprintf(text, sizeof(text), "%.2f ms", ns / 1e6);
+  } else {
+    std::snprintf(text, sizeof(text), "%.2f s", ns / 1e9);
+  }
+  return text;
+}
+
+} // namespace app
@@ -0,0 +1,166 @@
+#include "app/payload_codec.hpp"
+#include "app/logger.hpp"
+#include <zlib.h>
+#include <algorithm>
+#include <cstring>
+
+namespace app {
+
+namespace {
+
+const char kBase45Alphabet[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ $%*+-./:";
+
+int Base45Value(char c) {
+  const char* pos = std::strchr(kBase45Alphabet, c);
+  return (pos && c != '\0') ? static_cast<int>(pos - kBase45Alphabet) : -1;
+}
+
+} // namespace
+
+std::string Base45Encode(const std::vector<uint8_t>& bytes) {
+  std::string out;
+  out.reserve(bytes.size() / 2 * 3 + 2);
+  size_t i = 0;
+  for (; i + 1 < bytes.size(); i += 2) {
+    unsigned n = bytes[i] * 256u + bytes[i + 1];
+    out += kBase45Alphabet[n % 45];
+    out += kBase45Alphabet[(n / 45) % 45];
+    out += kBase45Alphabet[n / 2025];
+  }
+  if (i < bytes.size()) {
+    unsigned n = bytes[i];
+    out += kBase45Alphabet[n % 45];
+    out += kBase45Alphabet[n / 45];
+  }
+  return out;
+}
+
+bool Base45Decode(const std::string& text, std::vector<uint8_t>& out) {
+  out.clear();
+  if (text.size() % 3 == 1) return false;
+  out.reserve(text.size() / 3 * 2 + 1);
+
+  for (size_t i = 0; i < text.size(); i += 3) {
+    size_t group = std::min<size_t>(3, text.size() - i);
+    unsigned n = 0;
+    unsigned scale = 1;
+    for (size_t j = 0; j < group; ++j) {
+      int v = Base45Value(text[i + j]);
+      if (v < 0) return false;
+      n += static_cast<unsigned>(v) * scale;
+      scale *= 45;
+    }
+    if (group == 3) {
+      if (n > 0xFFFF) return false;
+      out.push_back(static_cast<uint8_t>(n >> 8));
+      out.push_back(static_cast<uint8_t>(n & 0xFF));
+    } else {
+      if (n > 0xFF) return false;
+      out.push_back(static_cast<uint8_t>(n));
+    }
+  }
+  return true;
+}
+
+const std::string& TxEnvelopeDictionary() {
+  // Rarest strings first: zlib favours matches near the end of the dictionary
+  static const std::string dictionary =
+    "\"maxPriorityFeePerGas\":\"0x\",\"maxFeePerGas\":\"0x\",\"type\":2,"
+    "0123456789abcdef0123456789ABCDEF"
+    "\"nonce\":,\"gasPrice\":\"0x\",\"gasLimit\":\"0x5208\",\"data\":\"0x\",\"chainId\":8453},"
+    "\"timestamp\":17,\"network\":\"base\"},\"checksum\":\""
+    "{\"type\":\"1\",\"version\":\"1.0\",\"data\":{\"hash\":\"0x"
+    "\",\"signature\":{\"r\":\"0x\",\"s\":\"0x\",\"v\":\"0x\"},"
+    "\"transaction\":{\"to\":\"0x\",\"value\":\"0x";
+  return dictionary;
+}
+
+bool DeflateBytes(const std::string& data, bool use_dictionary, std::vector<uint8_t>& out) {
+  z_stream stream;
+  std::memset(&stream, 0, sizeof(stream));
+  if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 15, 9, Z_DEFAULT_STRATEGY) != Z_OK) {
+    LOG_WARN("deflateInit2 failed");
+    return false;
+  }
+
+  if (use_dictionary) {
+    const std::string& dict = TxEnvelopeDictionary();
+    deflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(dict.data()),
+                         static_cast<uInt>(dict.size()));
+  }
+
+  out.resize(deflateBound(&stream, static_cast<uLong>(data.size())));
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in = static_cast<uInt>(data.size());
+  stream.next_out = out.data();
+  stream.avail_out = static_cast<uInt>(out.size());
+
+  int rc = deflate(&stream, Z_FINISH);
+  out.resize(stream.total_out);
+  deflateEnd(&stream);
+  if (rc != Z_STREAM_END) {
+    LOG_WARN("deflate failed (" + std::to_string(rc) + ")");
+    return false;
+  }
+  return true;
+}
+
+bool InflateBytes(const std::vector<uint8_t>& compressed, std::string& out) {
+  z_stream stream;
+  std::memset(&stream, 0, sizeof(stream));
+  if (inflateInit(&stream) != Z_OK) return false;
+  stream.next_in = const_cast<Bytef*>(compressed.data());
+  stream.avail_in = static_cast<uInt>(compressed.size());
+
+  out.clear();
+  char buffer[4096];
+  int rc = Z_OK;
+  while (rc != Z_STREAM_END) {
+    stream.next_out = reinterpret_cast<Bytef*>(buffer);
+    stream.avail_out = sizeof(buffer);
+    rc = inflate(&stream, Z_NO_FLUSH);
+    if (rc == Z_NEED_DICT) {
+      const std::string& dict = TxEnvelopeDictionary();
+      rc = inflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(dict.data()),
+                                static_cast<uInt>(dict.size()));
+    }
+    if (rc != Z_OK && rc != Z_STREAM_END) {
+      inflateEnd(&stream);
+      return false;
+    }
+    out.append(buffer, sizeof(buffer) - stream.avail_out);
+    if (rc == Z_OK && stream.avail_in == 0 && stream.avail_out != 0) {
+      // Truncated stream
+      inflateEnd(&stream);
+      return false;
+    }
+  }
+  inflateEnd(&stream);
+  return true;
+}
+
+std::string CompressPayload(const std::string& data, bool use_dictionary) {
+  if (data.empty()) return data;
+
+  std::vector<uint8_t> compressed;
+  if (!DeflateBytes(data, use_dictionary, compressed)) {
+    return data;  // Send uncompressed rather than fail the signing flow
+  }
+
+  std::string encoded = kCompressedPayloadPrefix + Base45Encode(compressed);
+  return encoded.size() < data.size() ? encoded : data;
+}
+
+bool DecompressPayload(const std::string& payload, std::string& out) {
+  const size_t prefix_len = std::strlen(kCompressedPayloadPrefix);
+  if (payload.compare(0, prefix_len, kCompressedPayloadPrefix) != 0) {
+    out = payload;
+    return true;
+  }
+
+  std::vector<uint8_t> compressed;
+  if (!Base45Decode(payload.substr(prefix_len), compressed)) return false;
+  return InflateBytes(compressed, out);
+}
+
+} // namespace app
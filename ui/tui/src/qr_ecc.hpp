@@ -0,0 +1,18 @@
+#pragma once
+#include "app/qr_generator.hpp"
+#include "qrcodegen.hpp"
+
+namespace app {
+
+// QREcc as the vendored encoder's level; shared by the encoders in src/
+inline qrcodegen::QrCode::Ecc ToQrcodegenEcc(QREcc ecc) {
+  switch (ecc) {
+    case QREcc::Medium:   return qrcodegen::QrCode::Ecc::MEDIUM;
+    case QREcc::Quartile: return qrcodegen::QrCode::Ecc::QUARTILE;
+    case QREcc::High:     return qrcodegen::QrCode::Ecc::HIGH;
+    case QREcc::Low:
+    default:              return qrcodegen::QrCode::Ecc::LOW;
+  }
+}
+
+} // namespace app
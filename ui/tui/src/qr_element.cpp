@@ -0,0 +1,84 @@
+#include "app/qr_element.hpp"
+#include "app/qr_graphics.hpp"
+#include "app/qr_render_cache.hpp"
+#include <ftxui/dom/node.hpp>
+#include <ftxui/screen/box.hpp>
+#include <ftxui/screen/color.hpp>
+#include <ftxui/screen/pixel.hpp>
+#include <ftxui/screen/screen.hpp>
+#include <memory>
+
+namespace app {
+
+namespace {
+
+class QrCodeNode : public ftxui::Node {
+public:
+  QrCodeNode(std::string payload, QREncoder encoder)
+      : payload_(std::move(payload)), encoder_(std::move(encoder)) {}
+
+  void ComputeRequirement() override {
+    requirement_.min_x = 2;
+    requirement_.min_y = 1;
+    requirement_.flex_grow_x = 0;
+    requirement_.flex_grow_y = 0;
+    requirement_.flex_shrink_x = 1;
+    requirement_.flex_shrink_y = 1;
+  }
+
+  void Render(ftxui::Screen& screen) override {
+    Node::Render(screen);
+    int width = box_.x_max - box_.x_min + 1;
+    int height = box_.y_max - box_.y_min + 1;
+
+    if (width <= 0 || height <= 0 || payload_.empty()) {
+      return;
+    }
+
+    // An image backend draws the symbol over the box once the frame is
+    // out; the cells only have to be blank underneath it
+    QRGraphicsOverlay& overlay = QRGraphicsOverlay::shared();
+    if (overlay.active() &&
+        overlay.place(QRRenderCache::shared().symbolFor(payload_, encoder_), box_.x_min, box_.y_min,
+                      width, height)) {
+      for (int y = box_.y_min; y <= box_.y_max; ++y) {
+        for (int x = box_.x_min; x <= box_.x_max; ++x) {
+          ftxui::Pixel& p = screen.PixelAt(x, y);
+          p.character = " ";
+          p.background_color = ftxui::Color::White;
+        }
+      }
+      return;
+    }
+
+    // Encoding and rasterising happen once per (payload, box); redraws
+    // from the animation timer only copy the cached cells. Half blocks
+    // keep modules square at one column and half a line each.
+    auto raster = QRRenderCache::shared().get(payload_, width, height,
+                                              QRRenderStyle::HalfBlock, encoder_);
+    if (raster->modules == 0) {
+      return;
+    }
+
+    for (int y = raster->y_min; y <= raster->y_max; ++y) {
+      for (int x = raster->x_min; x <= raster->x_max; ++x) {
+        ftxui::Pixel& p = screen.PixelAt(box_.x_min + x, box_.y_min + y);
+        p.character = raster->at(x, y);
+        p.foreground_color = ftxui::Color::Black;
+        p.background_color = ftxui::Color::White;
+      }
+    }
+  }
+
+private:
+  std::string payload_;
+  QREncoder encoder_;
+};
+
+} // namespace
+
+ftxui::Element ResponsiveQrCode(std::string payload, QREncoder encoder) {
+  return std::make_shared<QrCodeNode>(std::move(payload), std::move(encoder));
+}
+
+} // namespace app
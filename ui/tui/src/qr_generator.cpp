@@ -1,10 +1,200 @@
 #include "app/qr_generator.hpp"
+#include "app/metrics.hpp"
+#include "app/worker_pool.hpp"
+#include "qr_ecc.hpp"
 #include "qrcodegen.hpp"
-#include <sstream>
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <functional>
+#include <limits>
+#include <sstream>
 
 namespace app {
 
+namespace {
+
+// Fills the bit-packed matrix straight from qrcodegen's module buffer.
+void CopyModules(const qrcodegen::QrCode& qrCode, QRCode& qr) {
+  qr.size = qrCode.getSize();
+  qr.modules.reset(qr.size);
+  qrCode.exportModules(qr.modules.data(), static_cast<size_t>(qr.modules.wordsPerRow()));
+}
+
+// Below this many characters a symbol is small enough (roughly version 10)
+// that scoring masks on separate threads costs more than it saves.
+constexpr size_t kParallelMaskMinLength = 300;
+
+int CountParts(const std::string& data, size_t max_length) {
+  return static_cast<int>(std::ceil(static_cast<double>(data.length()) / max_length));
+}
+
+// Builds the "P{i}/{n}:" prefixed payload for zero-based chunk `index`.
+std::string MakeChunk(const std::string& data, size_t max_length, int index, int num_parts) {
+  std::string part_header = "P" + std::to_string(index + 1) + "/" + std::to_string(num_parts) + ":";
+  size_t start = static_cast<size_t>(index) * max_length;
+  size_t length = std::min(max_length, data.length() - start);
+  return part_header + data.substr(start, length);
+}
+
+// Encodes one symbol. On failure the returned QR has size 0 but still carries
+// its part numbering so callers can keep multi-part sequences aligned.
+QRCode EncodeSegments(const std::vector<qrcodegen::QrSegment>& segs, qrcodegen::QrCode::Ecc ecc,
+                      int max_version, int part, int total_parts,
+                      const qrcodegen::QrCode::ParallelFor& mask_runner, int mask = -1) {
+  static Histogram& encode_part = Metrics::shared().histogram("qr.encode_part");
+  ScopedLatency timer(encode_part);
+  QRCode qr;
+  qr.part = part;
+  qr.total_parts = total_parts;
+
+  try {
+    // Use encodeSegments to specify advanced parameters
+    qrcodegen::QrCode qrCode = qrcodegen::QrCode::encodeSegments(
+      segs,
+      ecc,
+      1, max_version, mask, true,
+      mask_runner
+    );
+    
+    CopyModules(qrCode, qr);
+  } catch (const std::exception& e) {
+    // Fallback for safety, though should be rare.
+    qr.size = 0;
+    qr.modules.clear();
+  }
+
+  return qr;
+}
+
+QRCode EncodeChunk(const std::string& payload, int part, int total_parts,
+                   const qrcodegen::QrCode::ParallelFor& mask_runner) {
+  std::vector<qrcodegen::QrSegment> segs;
+  try {
+    // Manually create segments to gain more control over generation
+    segs = qrcodegen::QrSegment::makeSegments(payload.c_str());
+  } catch (const std::exception& e) {
+    QRCode qr;
+    qr.part = part;
+    qr.total_parts = total_parts;
+    return qr;
+  }
+  return EncodeSegments(segs, qrcodegen::QrCode::Ecc::LOW, 40, part, total_parts, mask_runner);
+}
+
+qrcodegen::QrCode::ParallelFor MaskRunnerFor(WorkerPool& workers) {
+  return [&workers](int count, const std::function<void(int)>& body) {
+    workers.parallelFor(static_cast<size_t>(count), [&body](size_t i) { body(static_cast<int>(i)); });
+  };
+}
+
+// Segment modes in the order used by the planner's cost arrays.
+enum SegmentMode { kByte = 0, kAlphanumeric = 1, kNumeric = 2, kNumModes = 3 };
+
+bool IsAlphanumericChar(unsigned char c) {
+  return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || c == ' ' || c == '$' ||
+         c == '%' || c == '*' || c == '+' || c == '-' || c == '.' || c == '/' || c == ':';
+}
+
+int CharCountBits(int mode, int version) {
+  switch (mode) {
+    case kNumeric:      return qrcodegen::QrSegment::Mode::NUMERIC.numCharCountBits(version);
+    case kAlphanumeric: return qrcodegen::QrSegment::Mode::ALPHANUMERIC.numCharCountBits(version);
+    default:            return qrcodegen::QrSegment::Mode::BYTE.numCharCountBits(version);
+  }
+}
+
+// Splits text into the numeric/alphanumeric/byte segments with the smallest
+// total bit length at `version`. Dynamic programme over characters with costs
+// in sixths of a bit (numeric 10/3 bits, alphanumeric 11/2, byte 8), as in
+// Nayuki's optimal segmentation.
+std::vector<qrcodegen::QrSegment> MakeOptimalSegments(const std::string& text, int version) {
+  std::vector<qrcodegen::QrSegment> segs;
+  if (text.empty()) return segs;
+
+  const long kInfinity = std::numeric_limits<long>::max() / 4;
+  long head_costs[kNumModes];
+  for (int m = 0; m < kNumModes; ++m) {
+    head_costs[m] = (4 + CharCountBits(m, version)) * 6;
+  }
+
+  // char_modes[i][m]: mode used for character i on the best path that is in
+  // mode m after character i.
+  std::vector<std::array<signed char, kNumModes>> char_modes(text.size());
+  long prev_costs[kNumModes] = {head_costs[0], head_costs[1], head_costs[2]};
+
+  for (size_t i = 0; i < text.size(); ++i) {
+    unsigned char c = static_cast<unsigned char>(text[i]);
+    long cur_costs[kNumModes] = {kInfinity, kInfinity, kInfinity};
+    auto& modes = char_modes[i];
+    modes.fill(-1);
+
+    cur_costs[kByte] = prev_costs[kByte] + 48;
+    modes[kByte] = kByte;
+    if (IsAlphanumericChar(c)) {
+      cur_costs[kAlphanumeric] = prev_costs[kAlphanumeric] + 33;
+      modes[kAlphanumeric] = kAlphanumeric;
+    }
+    if (c >= '0' && c <= '9') {
+      cur_costs[kNumeric] = prev_costs[kNumeric] + 20;
+      modes[kNumeric] = kNumeric;
+    }
+
+    // Start a new segment after this character to switch modes
+    long extended[kNumModes] = {cur_costs[0], cur_costs[1], cur_costs[2]};
+    std::array<signed char, kNumModes> extended_modes = modes;
+    for (int to = 0; to < kNumModes; ++to) {
+      for (int from = 0; from < kNumModes; ++from) {
+        if (extended_modes[from] < 0) continue;
+        long cost = (extended[from] + 5) / 6 * 6 + head_costs[to];
+        if (modes[to] < 0 || cost < cur_costs[to]) {
+          cur_costs[to] = cost;
+          modes[to] = static_cast<signed char>(from);
+        }
+      }
+    }
+    std::copy(cur_costs, cur_costs + kNumModes, prev_costs);
+  }
+
+  int mode = static_cast<int>(std::min_element(prev_costs, prev_costs + kNumModes) - prev_costs);
+  std::vector<signed char> per_char(text.size());
+  for (size_t i = text.size(); i-- > 0;) {
+    mode = char_modes[i][mode];
+    per_char[i] = static_cast<signed char>(mode);
+  }
+
+  size_t start = 0;
+  while (start < text.size()) {
+    size_t end = start + 1;
+    while (end < text.size() && per_char[end] == per_char[start]) ++end;
+    std::string run = text.substr(start, end - start);
+    switch (per_char[start]) {
+      case kNumeric:
+        segs.push_back(qrcodegen::QrSegment::makeNumeric(run.c_str()));
+        break;
+      case kAlphanumeric:
+        segs.push_back(qrcodegen::QrSegment::makeAlphanumeric(run.c_str()));
+        break;
+      default:
+        segs.push_back(qrcodegen::QrSegment::makeBytes(std::vector<uint8_t>(run.begin(), run.end())));
+        break;
+    }
+    start = end;
+  }
+  return segs;
+}
+
+bool FitsSymbol(const std::string& payload, int version, int capacity_bits) {
+  int bits = qrcodegen::QrSegment::getTotalBits(MakeOptimalSegments(payload, version), version);
+  return bits >= 0 && bits <= capacity_bits;
+}
+
+bool IsUtf8Continuation(char c) {
+  return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
+
+} // namespace
+
 std::string QRCode::toRobustAscii() const {
   if (modules.empty()) return "(No QR data)";
   
@@ -26,8 +216,10 @@ std::string QRCode::toRobustAscii() const {
 
   for (int y = 0; y < size; ++y) {
     for (int i = 0; i < quiet_zone; ++i) result += white;
+    const uint64_t* row = modules.row(y);
     for (int x = 0; x < size; ++x) {
-      result += modules[y][x] ? black : white;
+      bool dark = (row[x / QRModuleMatrix::kWordBits] >> (x % QRModuleMatrix::kWordBits)) & 1u;
+      result += dark ? black : white;
     }
     for (int i = 0; i < quiet_zone; ++i) result += white;
     result += '\n';
@@ -59,8 +251,10 @@ std::string QRCode::toCompactAscii() const {
 
   for (int y = 0; y < size; ++y) {
     for (int i = 0; i < quiet_zone; ++i) result += white;
+    const uint64_t* row = modules.row(y);
     for (int x = 0; x < size; ++x) {
-      result += modules[y][x] ? black : white;
+      bool dark = (row[x / QRModuleMatrix::kWordBits] >> (x % QRModuleMatrix::kWordBits)) & 1u;
+      result += dark ? black : white;
     }
     for (int i = 0; i < quiet_zone; ++i) result += white;
     result += '\n';
@@ -70,35 +264,30 @@ std::string QRCode::toCompactAscii() const {
   
   return result;
 }
-  
-QRCode GenerateQR(const std::string& data) {
-  QRCode qr;
-  
-  try {
-    // Manually create segments to gain more control over generation
-    std::vector<qrcodegen::QrSegment> segs = qrcodegen::QrSegment::makeSegments(data.c_str());
-    
-    // Use encodeSegments to specify advanced parameters
-    qrcodegen::QrCode qrCode = qrcodegen::QrCode::encodeSegments(
-      segs,
-      qrcodegen::QrCode::Ecc::LOW,
-      1, 40, -1, true
-    );
-    
-    qr.size = qrCode.getSize();
-    qr.modules.resize(qr.size, std::vector<bool>(qr.size));
-    
-    for (int y = 0; y < qr.size; ++y) {
-      for (int x = 0; x < qr.size; ++x) {
-        qr.modules[y][x] = qrCode.getModule(x, y);
-      }
+
+std::string QRCode::toHalfBlockAscii() const {
+  if (modules.empty()) return "(No QR data)";
+
+  std::string result;
+  // Indexed by (top dark) | (bottom dark) << 1
+  const char* const glyphs[4] = {" ", "▀", "▄", "█"};
+  const int quiet_zone = 2;
+  const int span = size + 2 * quiet_zone;
+
+  for (int y = -quiet_zone; y < size + quiet_zone; y += 2) {
+    for (int x = -quiet_zone; x < span - quiet_zone; ++x) {
+      unsigned top = isDark(x, y) ? 1u : 0u;
+      unsigned bottom = isDark(x, y + 1) ? 1u : 0u;
+      result += glyphs[top | bottom << 1];
     }
-  } catch (const std::exception& e) {
-    // Fallback for safety, though should be rare.
-    qr.size = 0;
+    result += '\n';
   }
+
+  return result;
+}
   
-  return qr;
+QRCode GenerateQR(const std::string& data) {
+  return EncodeChunk(data, 1, 1, qrcodegen::QrCode::ParallelFor());
 }
 
 std::vector<QRCode> GenerateQRs(const std::string& data, size_t max_length) {
@@ -108,55 +297,139 @@ std::vector<QRCode> GenerateQRs(const std::string& data, size_t max_length) {
   if (data.length() <= max_length) {
     QRCode qr = GenerateQR(data);
     if (qr.size > 0) {
-      qr.part = 1;
-      qr.total_parts = 1;
       qrs.push_back(qr);
     }
     return qrs;
   }
 
-  // Calculate number of parts needed
-  int num_parts = static_cast<int>(std::ceil(static_cast<double>(data.length()) / max_length));
-  
+  int num_parts = CountParts(data, max_length);
   for (int i = 0; i < num_parts; ++i) {
-    // Create part header like "P1/3:"
-    std::string part_header = "P" + std::to_string(i + 1) + "/" + std::to_string(num_parts) + ":";
-    
-    // Extract chunk of data
-    size_t start = i * max_length;
-    size_t length = std::min(max_length, data.length() - start);
-    std::string chunk = part_header + data.substr(start, length);
-
-    try {
-      // Generate QR code for this chunk
-      std::vector<qrcodegen::QrSegment> segs = qrcodegen::QrSegment::makeSegments(chunk.c_str());
-      qrcodegen::QrCode qrCode = qrcodegen::QrCode::encodeSegments(
-        segs,
-        qrcodegen::QrCode::Ecc::LOW,
-        1, 40, -1, true
-      );
-      
-      QRCode qr;
-      qr.size = qrCode.getSize();
-      qr.part = i + 1;
-      qr.total_parts = num_parts;
-      qr.modules.resize(qr.size, std::vector<bool>(qr.size));
-      
-      for (int y = 0; y < qr.size; ++y) {
-        for (int x = 0; x < qr.size; ++x) {
-          qr.modules[y][x] = qrCode.getModule(x, y);
+    qrs.push_back(EncodeChunk(MakeChunk(data, max_length, i, num_parts), i + 1, num_parts,
+                              qrcodegen::QrCode::ParallelFor()));
+  }
+
+  return qrs;
+}
+
+std::vector<QRCode> GenerateQRsParallel(const std::string& data, size_t max_length, WorkerPool* pool) {
+  WorkerPool& workers = pool ? *pool : WorkerPool::shared();
+  std::vector<QRCode> qrs;
+
+  // A single symbol has nothing to fan out except its mask search
+  if (data.length() <= max_length) {
+    qrcodegen::QrCode::ParallelFor mask_runner;
+    if (data.length() >= kParallelMaskMinLength && workers.size() > 1) {
+      mask_runner = MaskRunnerFor(workers);
+    }
+    QRCode qr = EncodeChunk(data, 1, 1, mask_runner);
+    if (qr.size > 0) {
+      qrs.push_back(qr);
+    }
+    return qrs;
+  }
+
+  // Each part is written to its own slot, so results come back in part order
+  int num_parts = CountParts(data, max_length);
+  qrs.resize(static_cast<size_t>(num_parts));
+  workers.parallelFor(qrs.size(), [&](size_t i) {
+    int index = static_cast<int>(i);
+    qrs[i] = EncodeChunk(MakeChunk(data, max_length, index, num_parts), index + 1, num_parts,
+                         qrcodegen::QrCode::ParallelFor());
+  });
+
+  return qrs;
+}
+
+std::vector<std::string> PlanQRChunks(const std::string& data, const QRPlanOptions& options) {
+  const int version = std::max(1, std::min(40, options.max_version));
+  const int capacity = qrcodegen::QrCode::getDataCapacityBits(version, ToQrcodegenEcc(options.ecc));
+
+  std::vector<std::string> chunks;
+  if (FitsSymbol(data, version, capacity)) {
+    chunks.push_back(data);
+    return chunks;
+  }
+
+  // Plan against the widest header for the part count's digit width; shorter
+  // real headers only free up bits. Retry with a wider header if the plan
+  // needs more parts than the width allows.
+  for (int digits = 1; digits <= 6; ++digits) {
+    const std::string nines(static_cast<size_t>(digits), '9');
+    const std::string header_template = "P" + nines + "/" + nines + ":";
+    const size_t max_parts = static_cast<size_t>(std::stoul(nines));
+
+    std::vector<std::pair<size_t, size_t>> ranges;
+    size_t pos = 0;
+    bool failed = false;
+    while (pos < data.length() && ranges.size() <= max_parts) {
+      // Greedy longest prefix that still fits; bit cost grows monotonically
+      // with length, so taking the maximum every time minimises frame count.
+      size_t lo = 0;
+      size_t hi = data.length() - pos;
+      while (lo < hi) {
+        size_t mid = lo + (hi - lo + 1) / 2;
+        if (FitsSymbol(header_template + data.substr(pos, mid), version, capacity)) {
+          lo = mid;
+        } else {
+          hi = mid - 1;
         }
       }
-      qrs.push_back(qr);
-    } catch (const std::exception& e) {
-      // If this chunk fails, create an empty QR to maintain part numbering
-      QRCode qr;
-      qr.size = 0;
-      qr.part = i + 1;
-      qr.total_parts = num_parts;
-      qrs.push_back(qr);
+      // Never split a UTF-8 sequence across frames
+      while (lo > 0 && pos + lo < data.length() && IsUtf8Continuation(data[pos + lo])) --lo;
+      if (lo == 0) {
+        failed = true;
+        break;
+      }
+      ranges.emplace_back(pos, lo);
+      pos += lo;
+    }
+
+    if (failed) return {};
+    if (ranges.size() > max_parts) continue;
+
+    const std::string total = std::to_string(ranges.size());
+    for (size_t i = 0; i < ranges.size(); ++i) {
+      chunks.push_back("P" + std::to_string(i + 1) + "/" + total + ":" +
+                       data.substr(ranges[i].first, ranges[i].second));
     }
+    return chunks;
+  }
+
+  return {};
+}
+
+int QRVersionFor(const std::string& payload, QREcc ecc, int max_version) {
+  const qrcodegen::QrCode::Ecc level = ToQrcodegenEcc(ecc);
+  for (int version = 1; version <= std::min(40, max_version); ++version) {
+    if (FitsSymbol(payload, version, qrcodegen::QrCode::getDataCapacityBits(version, level))) return version;
   }
+  return 0;
+}
+
+std::vector<QRCode> GenerateQRsPlanned(const std::string& data, const QRPlanOptions& options, WorkerPool* pool) {
+  WorkerPool& workers = pool ? *pool : WorkerPool::shared();
+  const int version = std::max(1, std::min(40, options.max_version));
+  const qrcodegen::QrCode::Ecc ecc = ToQrcodegenEcc(options.ecc);
+
+  std::vector<std::string> chunks = PlanQRChunks(data, options);
+  std::vector<QRCode> qrs(chunks.size());
+  int total_parts = static_cast<int>(chunks.size());
+
+  if (chunks.size() == 1) {
+    qrcodegen::QrCode::ParallelFor mask_runner;
+    if (data.length() >= kParallelMaskMinLength && workers.size() > 1) {
+      mask_runner = MaskRunnerFor(workers);
+    }
+    qrs[0] = EncodeSegments(MakeOptimalSegments(chunks[0], version), ecc, version, 1, 1, mask_runner);
+    if (qrs[0].size == 0) qrs.clear();
+    return qrs;
+  }
+
+  const int mask = options.fast_mask ? qrcodegen::QrCode::FAST_MASK : -1;
+  workers.parallelFor(chunks.size(), [&](size_t i) {
+    qrs[i] = EncodeSegments(MakeOptimalSegments(chunks[i], version), ecc, version,
+                            static_cast<int>(i) + 1, total_parts, qrcodegen::QrCode::ParallelFor(), mask);
+  });
 
   return qrs;
 }
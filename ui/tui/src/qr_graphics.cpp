@@ -0,0 +1,390 @@
+#include "app/qr_graphics.hpp"
+#include "app/logger.hpp"
+#include "app/payload_codec.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/fb.h>
+#endif
+
+namespace app {
+
+namespace {
+
+constexpr uint32_t kKittyImageId = 1;
+constexpr size_t kKittyChunk = 4096;  // base64 bytes per escape, the protocol's limit
+
+bool StartsWith(std::string_view s, std::string_view prefix) {
+  return s.substr(0, prefix.size()) == prefix;
+}
+
+std::string EnvString(const char* name) {
+  const char* value = std::getenv(name);
+  return value ? value : "";
+}
+
+// Sixel data for `count` columns of the same six pixels
+void AppendSixelRun(std::string& out, char sixel, int count) {
+  if (count >= 4) {
+    out += '!';
+    out += std::to_string(count);
+    out += sixel;
+  } else {
+    out.append(static_cast<size_t>(count), sixel);
+  }
+}
+
+std::string Base64(const std::vector<uint8_t>& bytes) {
+  static const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  out.reserve((bytes.size() + 2) / 3 * 4);
+  size_t i = 0;
+  for (; i + 3 <= bytes.size(); i += 3) {
+    uint32_t v = uint32_t{bytes[i]} << 16 | uint32_t{bytes[i + 1]} << 8 | bytes[i + 2];
+    out += kAlphabet[v >> 18];
+    out += kAlphabet[(v >> 12) & 63];
+    out += kAlphabet[(v >> 6) & 63];
+    out += kAlphabet[v & 63];
+  }
+  if (i < bytes.size()) {
+    uint32_t v = uint32_t{bytes[i]} << 16 | (i + 1 < bytes.size() ? uint32_t{bytes[i + 1]} << 8 : 0);
+    out += kAlphabet[v >> 18];
+    out += kAlphabet[(v >> 12) & 63];
+    out += i + 1 < bytes.size() ? kAlphabet[(v >> 6) & 63] : '=';
+    out += '=';
+  }
+  return out;
+}
+
+std::string MoveCursor(int x, int y) {
+  return "\033[" + std::to_string(y + 1) + ";" + std::to_string(x + 1) + "H";
+}
+
+} // namespace
+
+const char* QRGraphicsBackendName(QRGraphicsBackend backend) {
+  switch (backend) {
+    case QRGraphicsBackend::Sixel:       return "sixel";
+    case QRGraphicsBackend::Kitty:       return "kitty";
+    case QRGraphicsBackend::Framebuffer: return "fb";
+    default:                             return "text";
+  }
+}
+
+std::optional<QRGraphicsBackend> ParseQRGraphicsBackend(std::string_view name) {
+  if (name == "text") return QRGraphicsBackend::Text;
+  if (name == "sixel") return QRGraphicsBackend::Sixel;
+  if (name == "kitty") return QRGraphicsBackend::Kitty;
+  if (name == "fb") return QRGraphicsBackend::Framebuffer;
+  return std::nullopt;
+}
+
+QRGraphicsBackend DetectQRGraphicsBackend() {
+  if (!isatty(STDOUT_FILENO)) return QRGraphicsBackend::Text;
+  std::string term = EnvString("TERM");
+  std::string program = EnvString("TERM_PROGRAM");
+  if (!EnvString("KITTY_WINDOW_ID").empty() || term == "xterm-kitty") return QRGraphicsBackend::Kitty;
+  if (StartsWith(term, "foot") || StartsWith(term, "mlterm") || StartsWith(term, "contour") ||
+      term.find("sixel") != std::string::npos || program == "WezTerm") {
+    return QRGraphicsBackend::Sixel;
+  }
+  if (term == "linux" && access("/dev/fb0", W_OK) == 0) return QRGraphicsBackend::Framebuffer;
+  return QRGraphicsBackend::Text;
+}
+
+std::string EncodeSixel(const QRCode& qr, int scale, int quiet_zone) {
+  if (qr.size <= 0 || scale <= 0) return "";
+  int span = qr.size + 2 * quiet_zone;
+  int pixels = span * scale;
+
+  // P2=1: pixels not painted keep the background, but both colours are
+  // painted anyway so the result doesn't depend on it
+  std::string out = "\033P0;1;0q\"1;1;" + std::to_string(pixels) + ";" + std::to_string(pixels);
+  out += "#0;2;100;100;100#1;2;0;0;0";
+
+  // Dark bits of the current six-pixel band, per module column
+  std::vector<uint8_t> dark(static_cast<size_t>(span));
+  for (int band = 0; band < pixels; band += 6) {
+    int rows = std::min(6, pixels - band);
+    std::fill(dark.begin(), dark.end(), 0);
+    for (int r = 0; r < rows; ++r) {
+      int my = (band + r) / scale - quiet_zone;
+      for (int mx = 0; mx < span; ++mx) {
+        if (qr.isDark(mx - quiet_zone, my)) dark[mx] |= static_cast<uint8_t>(1u << r);
+      }
+    }
+    uint8_t band_mask = static_cast<uint8_t>((1u << rows) - 1);
+
+    // Light pass, back to the start of the band, then the dark pass
+    for (int color = 0; color < 2; ++color) {
+      out += color == 0 ? "#0" : "$#1";
+      for (int mx = 0; mx < span;) {
+        uint8_t bits = color == 0 ? band_mask & ~dark[mx] : dark[mx];
+        int end = mx + 1;
+        while (end < span && (color == 0 ? band_mask & ~dark[end] : dark[end]) == bits) ++end;
+        AppendSixelRun(out, static_cast<char>(63 + bits), (end - mx) * scale);
+        mx = end;
+      }
+    }
+    if (band + 6 < pixels) out += '-';
+  }
+  out += "\033\\";
+  return out;
+}
+
+std::string EncodeKitty(const QRCode& qr, int scale, int quiet_zone, uint32_t image_id) {
+  if (qr.size <= 0 || scale <= 0) return "";
+  int span = qr.size + 2 * quiet_zone;
+  size_t pixels = static_cast<size_t>(span) * scale;
+  size_t row_bytes = pixels * 3;
+
+  // 24-bit RGB, one pixel row per module row repeated `scale` times
+  std::string rgb(row_bytes * pixels, '\0');
+  std::string row(row_bytes, '\0');
+  for (int my = 0; my < span; ++my) {
+    for (int mx = 0; mx < span; ++mx) {
+      char value = qr.isDark(mx - quiet_zone, my - quiet_zone) ? '\0' : '\xff';
+      std::memset(&row[static_cast<size_t>(mx) * scale * 3], value, static_cast<size_t>(scale) * 3);
+    }
+    for (int r = 0; r < scale; ++r) {
+      std::memcpy(&rgb[(static_cast<size_t>(my) * scale + r) * row_bytes], row.data(), row_bytes);
+    }
+  }
+
+  std::vector<uint8_t> compressed;
+  bool deflated = DeflateBytes(rgb, false, compressed);
+  std::string data = deflated ? Base64(compressed)
+                              : Base64(std::vector<uint8_t>(rgb.begin(), rgb.end()));
+
+  std::string out;
+  for (size_t at = 0; at < data.size() || at == 0; at += kKittyChunk) {
+    bool more = at + kKittyChunk < data.size();
+    out += "\033_G";
+    if (at == 0) {
+      out += "a=T,f=24,s=" + std::to_string(pixels) + ",v=" + std::to_string(pixels) +
+             (deflated ? ",o=z" : "") + ",i=" + std::to_string(image_id) + ",p=1,C=1,q=2,";
+    }
+    out += more ? "m=1;" : "m=0;";
+    out.append(data, at, kKittyChunk);
+    out += "\033\\";
+  }
+  return out;
+}
+
+Framebuffer::~Framebuffer() {
+  close();
+}
+
+bool Framebuffer::open(const std::string& path) noexcept {
+  close();
+#if defined(__linux__)
+  int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+  if (fd < 0) {
+    LOG_WARN("Cannot open framebuffer: " + path);
+    return false;
+  }
+  fb_var_screeninfo var{};
+  fb_fix_screeninfo fix{};
+  bool ok = ioctl(fd, FBIOGET_VSCREENINFO, &var) == 0 && ioctl(fd, FBIOGET_FSCREENINFO, &fix) == 0 &&
+            fix.type == FB_TYPE_PACKED_PIXELS &&
+            (var.bits_per_pixel == 16 || var.bits_per_pixel == 24 || var.bits_per_pixel == 32);
+  void* map = ok ? mmap(nullptr, fix.smem_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    LOG_WARN("Unsupported framebuffer: " + path);
+    return false;
+  }
+  data_ = static_cast<uint8_t*>(map);
+  size_ = fix.smem_len;
+  width_ = static_cast<int>(var.xres);
+  height_ = static_cast<int>(var.yres);
+  stride_ = fix.line_length;
+  bytes_per_pixel_ = var.bits_per_pixel / 8;
+  origin_ = var.yoffset * stride_ + var.xoffset * bytes_per_pixel_;
+  return true;
+#else
+  (void)path;
+  return false;
+#endif
+}
+
+void Framebuffer::close() noexcept {
+  if (data_) munmap(data_, size_);
+  data_ = nullptr;
+  size_ = 0;
+  width_ = height_ = 0;
+  stride_ = bytes_per_pixel_ = origin_ = 0;
+}
+
+void Framebuffer::drawQR(const QRCode& qr, int x, int y, int scale, int quiet_zone) noexcept {
+  if (!data_ || qr.size <= 0 || scale <= 0) return;
+  int span = qr.size + 2 * quiet_zone;
+  int pixels = span * scale;
+  int x0 = std::max(x, 0);
+  int x1 = std::min(x + pixels, width_);
+  if (x0 >= x1) return;
+
+  // One line per module row, copied to each of its pixel rows
+  thread_local std::vector<uint8_t> line;
+  line.resize(static_cast<size_t>(x1 - x0) * bytes_per_pixel_);
+  for (int my = 0; my < span; ++my) {
+    for (int px = x0; px < x1;) {
+      int mx = (px - x) / scale;
+      int end = std::min(x + (mx + 1) * scale, x1);
+      uint8_t value = qr.isDark(mx - quiet_zone, my - quiet_zone) ? 0x00 : 0xff;
+      std::memset(line.data() + static_cast<size_t>(px - x0) * bytes_per_pixel_, value,
+                  static_cast<size_t>(end - px) * bytes_per_pixel_);
+      px = end;
+    }
+    for (int r = 0; r < scale; ++r) {
+      int py = y + my * scale + r;
+      if (py < 0 || py >= height_) continue;
+      size_t offset = origin_ + static_cast<size_t>(py) * stride_ + static_cast<size_t>(x0) * bytes_per_pixel_;
+      if (offset + line.size() > size_) return;
+      std::memcpy(data_ + offset, line.data(), line.size());
+    }
+  }
+}
+
+void QRGraphicsOverlay::setBackend(QRGraphicsBackend backend) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  placements_.clear();
+  kitty_symbol_.reset();
+  kitty_scale_ = 0;
+  kitty_shown_ = false;
+  framebuffer_.close();
+  if (backend == QRGraphicsBackend::Framebuffer && !framebuffer_.open()) backend = QRGraphicsBackend::Text;
+  backend_ = backend;
+  LOG_INFO(std::string("QR output: ") + QRGraphicsBackendName(backend_));
+}
+
+QRGraphicsBackend QRGraphicsOverlay::backend() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return backend_;
+}
+
+bool QRGraphicsOverlay::active() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return backend_ != QRGraphicsBackend::Text;
+}
+
+std::optional<QRGraphicsOverlay::CellSize> QRGraphicsOverlay::cellSizeLocked() const {
+  winsize ws{};
+  if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) != 0 || ws.ws_col == 0 || ws.ws_row == 0) return std::nullopt;
+  CellSize cell{ws.ws_col, ws.ws_row, 0, 0};
+  if (backend_ == QRGraphicsBackend::Framebuffer) {
+    cell.width = framebuffer_.width() / cell.columns;
+    cell.height = framebuffer_.height() / cell.rows;
+  } else {
+    cell.width = ws.ws_xpixel / cell.columns;
+    cell.height = ws.ws_ypixel / cell.rows;
+  }
+  if (cell.width <= 0 || cell.height <= 0) return std::nullopt;
+  return cell;
+}
+
+bool QRGraphicsOverlay::place(std::shared_ptr<const QRCode> qr, int x, int y, int width, int height) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (backend_ == QRGraphicsBackend::Text || !qr || qr->size <= 0) return false;
+  // The kitty image id is reused every frame, so one symbol at a time
+  if (backend_ == QRGraphicsBackend::Kitty && !placements_.empty()) return false;
+  auto cell = cellSizeLocked();
+  if (!cell) return false;
+
+  int span = qr->size + 2 * kQuietZone;
+  int box_width = width * cell->width;
+  int box_height = height * cell->height;
+  int scale = std::min(box_width, box_height) / span;
+  if (scale < kMinScale) return false;
+
+  // Terminal images start on a cell; the framebuffer centres to the pixel
+  int pixels = span * scale;
+  int columns = (pixels + cell->width - 1) / cell->width;
+  int rows = (pixels + cell->height - 1) / cell->height;
+  Placement p;
+  p.qr = std::move(qr);
+  p.x = x + (width - columns) / 2;
+  p.y = y + (height - rows) / 2;
+  p.pixel_x = x * cell->width + (box_width - pixels) / 2;
+  p.pixel_y = y * cell->height + (box_height - pixels) / 2;
+  p.scale = scale;
+  placements_.push_back(std::move(p));
+  return true;
+}
+
+void QRGraphicsOverlay::present() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Placement> placements;
+  placements.swap(placements_);
+  std::string out;
+
+  switch (backend_) {
+    case QRGraphicsBackend::Sixel:
+      for (const auto& p : placements) {
+        out += "\0337" + MoveCursor(p.x, p.y) + EncodeSixel(*p.qr, p.scale, kQuietZone) + "\0338";
+      }
+      break;
+    case QRGraphicsBackend::Kitty:
+      if (placements.empty()) {
+        if (kitty_shown_) out += "\033_Ga=d,d=I,i=" + std::to_string(kKittyImageId) + ",q=2\033\\";
+        kitty_shown_ = false;
+        kitty_symbol_.reset();
+        kitty_scale_ = 0;
+        break;
+      }
+      // The image data stays with the terminal; an unchanged symbol at the
+      // same scale is only placed again over the cells the text frame just
+      // rewrote. A resize changes the scale, and the image is sent again.
+      out += "\0337" + MoveCursor(placements[0].x, placements[0].y);
+      if (placements[0].qr != kitty_symbol_ || placements[0].scale != kitty_scale_) {
+        out += EncodeKitty(*placements[0].qr, placements[0].scale, kQuietZone, kKittyImageId);
+        kitty_symbol_ = placements[0].qr;
+        kitty_scale_ = placements[0].scale;
+      } else {
+        out += "\033_Ga=p,i=" + std::to_string(kKittyImageId) + ",p=1,C=1,q=2\033\\";
+      }
+      out += "\0338";
+      kitty_shown_ = true;
+      break;
+    case QRGraphicsBackend::Framebuffer:
+      // The console has drawn the text frame by the time the write returns
+      std::cout.flush();
+      for (const auto& p : placements) {
+        framebuffer_.drawQR(*p.qr, p.pixel_x, p.pixel_y, p.scale, kQuietZone);
+      }
+      break;
+    default:
+      break;
+  }
+  if (!out.empty()) writeLocked(out);
+}
+
+void QRGraphicsOverlay::writeLocked(const std::string& bytes) const {
+  // After whatever FTXUI still has buffered, so the image lands on top
+  std::cout.flush();
+  const char* data = bytes.data();
+  size_t size = bytes.size();
+  while (size > 0) {
+    ssize_t n = ::write(STDOUT_FILENO, data, size);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      return;
+    }
+    data += n;
+    size -= static_cast<size_t>(n);
+  }
+}
+
+QRGraphicsOverlay& QRGraphicsOverlay::shared() {
+  static QRGraphicsOverlay overlay;
+  return overlay;
+}
+
+} // namespace app
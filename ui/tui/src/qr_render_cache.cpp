@@ -0,0 +1,156 @@
+#include "app/qr_render_cache.hpp"
+#include <algorithm>
+
+namespace app {
+
+namespace {
+
+struct StyleSpec {
+  int quiet_zone;
+  int cols_per_module;
+  int modules_per_cell;      // stacked vertically in one cell
+  const char* glyphs[4];     // indexed by top dark | bottom dark << 1
+};
+
+const StyleSpec& SpecFor(QRRenderStyle style) {
+  static const StyleSpec kRobust{4, 2, 1, {" ", "#", "#", "#"}};
+  static const StyleSpec kCompact{2, 1, 1, {" ", "█", "█", "█"}};
+  static const StyleSpec kHalfBlock{2, 1, 2, {" ", "▀", "▄", "█"}};
+  switch (style) {
+    case QRRenderStyle::Robust:  return kRobust;
+    case QRRenderStyle::Compact: return kCompact;
+    default:                     return kHalfBlock;
+  }
+}
+
+// The cache holds a handful of symbols per view, far fewer than rasters.
+constexpr size_t kSymbolsPerRaster = 4;
+
+template <typename List, typename Match>
+typename List::iterator FindAndPromote(List& list, Match match) {
+  auto it = std::find_if(list.begin(), list.end(), match);
+  if (it != list.end() && it != list.begin()) {
+    list.splice(list.begin(), list, it);
+    it = list.begin();
+  }
+  return it;
+}
+
+} // namespace
+
+QRRaster RasterizeQR(const QRCode& qr, int width, int height, QRRenderStyle style) {
+  const StyleSpec& spec = SpecFor(style);
+  QRRaster raster;
+  raster.modules = qr.size;
+
+  int span = qr.size > 0 ? qr.size + 2 * spec.quiet_zone : 0;
+  int natural_width = span * spec.cols_per_module;
+  int natural_height = (span + spec.modules_per_cell - 1) / spec.modules_per_cell;
+  raster.width = width > 0 ? width : natural_width;
+  raster.height = height > 0 ? height : natural_height;
+
+  int offset_x = (raster.width - natural_width) / 2;
+  int offset_y = (raster.height - natural_height) / 2;
+  raster.x_min = std::max(0, offset_x);
+  raster.y_min = std::max(0, offset_y);
+  raster.x_max = std::min(raster.width, offset_x + natural_width) - 1;
+  raster.y_max = std::min(raster.height, offset_y + natural_height) - 1;
+
+  raster.cells.resize(static_cast<size_t>(raster.width) * raster.height, spec.glyphs[0]);
+  raster.rows.resize(static_cast<size_t>(raster.height));
+  for (int y = 0; y < raster.height; ++y) {
+    std::string& line = raster.rows[y];
+    int cell_y = y - offset_y;
+    for (int x = 0; x < raster.width; ++x) {
+      int cell_x = x - offset_x;
+      const char* glyph = spec.glyphs[0];
+      if (cell_x >= 0 && cell_x < natural_width && cell_y >= 0 && cell_y < natural_height) {
+        int mx = cell_x / spec.cols_per_module - spec.quiet_zone;
+        int my = cell_y * spec.modules_per_cell - spec.quiet_zone;
+        unsigned top = qr.isDark(mx, my) ? 1u : 0u;
+        unsigned bottom = spec.modules_per_cell > 1 ? (qr.isDark(mx, my + 1) ? 1u : 0u) : top;
+        glyph = spec.glyphs[top | bottom << 1];
+      }
+      raster.cells[static_cast<size_t>(y) * raster.width + x] = glyph;
+      line += glyph;
+    }
+  }
+  return raster;
+}
+
+QRRenderCache::QRRenderCache(size_t capacity) : capacity_(std::max<size_t>(1, capacity)) {}
+
+std::shared_ptr<const QRRaster> QRRenderCache::get(const std::string& payload, int width, int height,
+                                                   QRRenderStyle style, const QREncoder& encoder) {
+  size_t hash = std::hash<std::string>{}(payload);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto hit = findRasterLocked(hash, payload, encoder.key, width, height, style)) return hit;
+  }
+
+  auto qr = symbol(hash, payload, encoder);
+  auto raster = std::make_shared<const QRRaster>(RasterizeQR(*qr, width, height, style));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto hit = findRasterLocked(hash, payload, encoder.key, width, height, style)) return hit;
+  rasters_.push_front(RasterEntry{hash, payload, encoder.key, width, height, style, raster});
+  if (rasters_.size() > capacity_) rasters_.pop_back();
+  return raster;
+}
+
+std::shared_ptr<const QRCode> QRRenderCache::symbolFor(const std::string& payload,
+                                                       const QREncoder& encoder) {
+  return symbol(std::hash<std::string>{}(payload), payload, encoder);
+}
+
+std::shared_ptr<const QRCode> QRRenderCache::symbol(size_t hash, const std::string& payload,
+                                                    const QREncoder& encoder) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto hit = findSymbolLocked(hash, payload, encoder.key)) return hit;
+  }
+
+  auto qr = std::make_shared<const QRCode>(encoder.build ? encoder.build() : GenerateQR(payload));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto hit = findSymbolLocked(hash, payload, encoder.key)) return hit;
+  symbols_.push_front(SymbolEntry{hash, payload, encoder.key, qr});
+  if (symbols_.size() > std::max<size_t>(1, capacity_ / kSymbolsPerRaster)) symbols_.pop_back();
+  return qr;
+}
+
+std::shared_ptr<const QRCode> QRRenderCache::findSymbolLocked(size_t hash, const std::string& payload,
+                                                              const std::string& encoder) {
+  auto hit = FindAndPromote(symbols_, [&](const SymbolEntry& e) {
+    return e.hash == hash && e.payload == payload && e.encoder == encoder;
+  });
+  return hit != symbols_.end() ? hit->qr : nullptr;
+}
+
+std::shared_ptr<const QRRaster> QRRenderCache::findRasterLocked(size_t hash, const std::string& payload,
+                                                                const std::string& encoder, int width,
+                                                                int height, QRRenderStyle style) {
+  auto hit = FindAndPromote(rasters_, [&](const RasterEntry& e) {
+    return e.hash == hash && e.width == width && e.height == height && e.style == style &&
+           e.payload == payload && e.encoder == encoder;
+  });
+  return hit != rasters_.end() ? hit->raster : nullptr;
+}
+
+void QRRenderCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  symbols_.clear();
+  rasters_.clear();
+}
+
+size_t QRRenderCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return rasters_.size();
+}
+
+QRRenderCache& QRRenderCache::shared() {
+  static QRRenderCache cache(32);
+  return cache;
+}
+
+} // namespace app
@@ -27,10 +27,18 @@
 #include <cstddef>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <utility>
 #include "qrcodegen.hpp"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 using std::int8_t;
 using std::uint8_t;
 using std::size_t;
@@ -39,6 +47,292 @@ using std::vector;
 
 namespace qrcodegen {
 
+/*---- Reed-Solomon tables ----*/
+
+namespace {
+
+// Exponent and logarithm tables of GF(2^8/0x11D) for the generator 0x02, built at compile time.
+// The exponent table is repeated so exp[log[x] + log[y]] needs no reduction modulo 255.
+struct GfTables {
+	uint8_t exp[512];
+	uint8_t log[256];
+	
+	constexpr GfTables() : exp(), log() {
+		int x = 1;
+		for (int i = 0; i < 255; i++) {
+			exp[i] = static_cast<uint8_t>(x);
+			exp[i + 255] = static_cast<uint8_t>(x);
+			log[x] = static_cast<uint8_t>(i);
+			x <<= 1;
+			if (x & 0x100)
+				x ^= 0x11D;
+		}
+	}
+};
+
+constexpr GfTables GF;
+
+inline uint8_t gfMultiply(uint8_t x, uint8_t y) {
+	return x == 0 || y == 0 ? 0 : GF.exp[GF.log[x] + GF.log[y]];
+}
+
+
+// The longest ECC block of any QR Code is 30 codewords; rows are padded to 32 bytes
+constexpr int RS_MAX_TABLE_DEGREE = 30;
+constexpr size_t RS_ROW_BYTES = 32;
+
+// Every multiple of one generator polynomial: row f is the divisor times f, zero padded.
+// Dividing by the polynomial then costs one row XOR per data byte instead of one
+// field multiplication per coefficient.
+struct RsProductTable {
+	alignas(16) uint8_t rows[256][RS_ROW_BYTES];
+};
+
+// Built on first use for each degree and shared by all threads after that
+const RsProductTable &rsProductTable(int degree) {
+	static std::once_flag built[RS_MAX_TABLE_DEGREE + 1];
+	static std::unique_ptr<RsProductTable> tables[RS_MAX_TABLE_DEGREE + 1];
+	size_t index = static_cast<size_t>(degree);
+	std::call_once(built[index], [degree, index]() {
+		// Product (x - r^0) * (x - r^1) * ... * (x - r^{degree-1}) without its leading 1x^degree term
+		uint8_t divisor[RS_ROW_BYTES] = {};
+		divisor[degree - 1] = 1;
+		uint8_t root = 1;
+		for (int i = 0; i < degree; i++) {
+			for (int j = 0; j < degree; j++) {
+				divisor[j] = gfMultiply(divisor[j], root);
+				if (j + 1 < degree)
+					divisor[j] ^= divisor[j + 1];
+			}
+			root = gfMultiply(root, 0x02);
+		}
+		std::unique_ptr<RsProductTable> table(new RsProductTable());
+		for (int f = 0; f < 256; f++) {
+			for (int j = 0; j < degree; j++)
+				table->rows[f][j] = gfMultiply(divisor[j], static_cast<uint8_t>(f));
+		}
+		tables[index] = std::move(table);
+	});
+	return *tables[index];
+}
+
+
+// remainder[0..32] holds the running remainder followed by zeros; shifts it one byte
+// left and adds row, i.e. one step of the polynomial division
+inline void rsDivisionStep(uint8_t *remainder, const uint8_t *row) {
+#if defined(__SSE2__)
+	__m128i lo = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(remainder + 1)),
+		_mm_load_si128(reinterpret_cast<const __m128i*>(row)));
+	__m128i hi = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(remainder + 17)),
+		_mm_load_si128(reinterpret_cast<const __m128i*>(row + 16)));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(remainder), lo);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(remainder + 16), hi);
+#elif defined(__ARM_NEON)
+	uint8x16_t lo = veorq_u8(vld1q_u8(remainder + 1), vld1q_u8(row));
+	uint8x16_t hi = veorq_u8(vld1q_u8(remainder + 17), vld1q_u8(row + 16));
+	vst1q_u8(remainder, lo);
+	vst1q_u8(remainder + 16, hi);
+#else
+	uint8_t next[RS_ROW_BYTES];
+	for (size_t i = 0; i < RS_ROW_BYTES; i++)
+		next[i] = remainder[i + 1] ^ row[i];
+	std::memcpy(remainder, next, RS_ROW_BYTES);
+#endif
+}
+
+
+/*---- Capacity table ----*/
+
+// Number of data bits that fit a QR Code of the given version, after all function modules are
+// excluded. Includes remainder bits, so it might not be a multiple of 8.
+constexpr int rawDataModules(int ver) {
+	int result = (16 * ver + 128) * ver + 64;
+	if (ver >= 2) {
+		int numAlign = ver / 7 + 2;
+		result -= (25 * numAlign - 10) * numAlign - 55;
+		if (ver >= 7)
+			result -= 36;
+	}
+	return result;
+}
+
+struct RawDataModulesTable {
+	int counts[41];
+	
+	constexpr RawDataModulesTable() : counts() {
+		for (int ver = 1; ver <= 40; ver++)
+			counts[ver] = rawDataModules(ver);
+	}
+};
+
+constexpr RawDataModulesTable RAW_DATA_MODULES;
+static_assert(RAW_DATA_MODULES.counts[1] == 208 && RAW_DATA_MODULES.counts[40] == 29648, "QR capacity table");
+
+
+/*---- Bitboards for mask selection ----*/
+
+// Modules of a symbol packed 64 to a word, module x of row y in bit x % 64 of word
+// y * words + x / 64. Bits past the right edge are always zero.
+struct Bitboard {
+	int size;
+	size_t words;
+	vector<uint64_t> bits;
+	
+	explicit Bitboard(int sz) :
+		size(sz),
+		words(static_cast<size_t>(sz + 63) / 64),
+		bits(static_cast<size_t>(sz) * words) {}
+	
+	uint64_t *row(int y) { return bits.data() + static_cast<size_t>(y) * words; }
+	const uint64_t *row(int y) const { return bits.data() + static_cast<size_t>(y) * words; }
+	
+	void set(int x, int y, bool dark) {
+		uint64_t bit = uint64_t(1) << (x & 63);
+		uint64_t &word = row(y)[x >> 6];
+		word = dark ? (word | bit) : (word & ~bit);
+	}
+	
+	void operator^=(const Bitboard &other) {
+		for (size_t i = 0; i < bits.size(); i++)
+			bits[i] ^= other.bits[i];
+	}
+};
+
+
+// In-place transpose of a 64*64 bit matrix (bit j of word i moves to bit i of word j)
+void transpose64(uint64_t a[64]) {
+	uint64_t m = 0x00000000FFFFFFFFULL;
+	for (int j = 32; j != 0; j >>= 1, m ^= m << j) {
+		for (int k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+			uint64_t t = ((a[k] >> j) ^ a[k | j]) & m;
+			a[k] ^= t << j;
+			a[k | j] ^= t;
+		}
+	}
+}
+
+
+// Columns of board as rows, one 64*64 block at a time
+Bitboard transpose(const Bitboard &board) {
+	Bitboard result(board.size);
+	uint64_t block[64];
+	for (size_t bx = 0; bx < board.words; bx++) {
+		for (size_t by = 0; by < board.words; by++) {
+			for (int i = 0; i < 64; i++) {
+				int y = static_cast<int>(by * 64) + i;
+				block[i] = y < board.size ? board.row(y)[bx] : 0;
+			}
+			transpose64(block);
+			for (int i = 0; i < 64; i++) {
+				int y = static_cast<int>(bx * 64) + i;
+				if (y < board.size)
+					result.row(y)[by] = block[i];
+			}
+		}
+	}
+	return result;
+}
+
+
+// Bit x of the result is bit x + 1 of the multi-word row
+inline uint64_t shiftedWord(const uint64_t *row, size_t words, size_t w) {
+	return (row[w] >> 1) | (w + 1 < words ? row[w + 1] << 63 : 0);
+}
+
+
+// Bits 0 .. size - 1 of word w
+inline uint64_t validBits(int size, size_t w) {
+	int left = size - static_cast<int>(w * 64);
+	return left >= 64 ? ~uint64_t(0) : (uint64_t(1) << left) - 1;
+}
+
+
+// Number of 2*2 blocks of one color
+long countSameColorBlocks(const Bitboard &board) {
+	long count = 0;
+	for (int y = 0; y + 1 < board.size; y++) {
+		const uint64_t *r0 = board.row(y);
+		const uint64_t *r1 = board.row(y + 1);
+		for (size_t w = 0; w < board.words; w++) {
+			uint64_t vertical = ~(r0[w] ^ r1[w]);
+			uint64_t verticalNext = ~(shiftedWord(r0, board.words, w) ^ shiftedWord(r1, board.words, w));
+			uint64_t horizontal = ~(r0[w] ^ shiftedWord(r0, board.words, w));
+			count += __builtin_popcountll(vertical & verticalNext & horizontal & validBits(board.size - 1, w));
+		}
+	}
+	return count;
+}
+
+
+long countDarkModules(const Bitboard &board) {
+	long count = 0;
+	for (uint64_t word : board.bits)
+		count += __builtin_popcountll(word);
+	return count;
+}
+
+
+// The 8 mask patterns restricted to the modules they apply to, which depends only on the version
+const std::array<Bitboard,8> &maskBoards(int version, const vector<vector<bool> > &isFunction) {
+	static std::once_flag built[41];
+	static std::unique_ptr<std::array<Bitboard,8> > boards[41];
+	size_t index = static_cast<size_t>(version);
+	std::call_once(built[index], [&isFunction, index]() {
+		int sz = static_cast<int>(isFunction.size());
+		std::unique_ptr<std::array<Bitboard,8> > masks(new std::array<Bitboard,8>{{
+			Bitboard(sz), Bitboard(sz), Bitboard(sz), Bitboard(sz),
+			Bitboard(sz), Bitboard(sz), Bitboard(sz), Bitboard(sz)}});
+		for (int y = 0; y < sz; y++) {
+			for (int x = 0; x < sz; x++) {
+				if (isFunction[static_cast<size_t>(y)][static_cast<size_t>(x)])
+					continue;
+				std::array<bool,8> invert = {{
+					(x + y) % 2 == 0,
+					y % 2 == 0,
+					x % 3 == 0,
+					(x + y) % 3 == 0,
+					(x / 3 + y / 2) % 2 == 0,
+					x * y % 2 + x * y % 3 == 0,
+					(x * y % 2 + x * y % 3) % 2 == 0,
+					((x + y) % 2 + x * y % 3) % 2 == 0}};
+				for (size_t m = 0; m < 8; m++) {
+					if (invert[m])
+						(*masks)[m].set(x, y, true);
+				}
+			}
+		}
+		boards[index] = std::move(masks);
+	});
+	return *boards[index];
+}
+
+
+// Calls fn(x, y, dark) for each of the format information modules, bits being the 15-bit format word
+template <typename Fn>
+void forEachFormatModule(int size, int bits, Fn fn) {
+	auto bit = [bits](int i) { return ((bits >> i) & 1) != 0; };
+	
+	// First copy
+	for (int i = 0; i <= 5; i++)
+		fn(8, i, bit(i));
+	fn(8, 7, bit(6));
+	fn(8, 8, bit(7));
+	fn(7, 8, bit(8));
+	for (int i = 9; i < 15; i++)
+		fn(14 - i, 8, bit(i));
+	
+	// Second copy
+	for (int i = 0; i < 8; i++)
+		fn(size - 1 - i, 8, bit(i));
+	for (int i = 8; i < 15; i++)
+		fn(8, size - 15 + i, bit(i));
+	fn(8, size - 8, true);  // Always dark
+}
+
+}  // namespace
+
+
+
 /*---- Class QrSegment ----*/
 
 QrSegment::Mode::Mode(int mode, int cc0, int cc1, int cc2) :
@@ -258,7 +552,13 @@ QrCode QrCode::encodeBinary(const vector<uint8_t> &data, Ecc ecl) {
 
 QrCode QrCode::encodeSegments(const vector<QrSegment> &segs, Ecc ecl,
 		int minVersion, int maxVersion, int mask, bool boostEcl) {
-	if (!(MIN_VERSION <= minVersion && minVersion <= maxVersion && maxVersion <= MAX_VERSION) || mask < -1 || mask > 7)
+	return encodeSegments(segs, ecl, minVersion, maxVersion, mask, boostEcl, ParallelFor());
+}
+
+
+QrCode QrCode::encodeSegments(const vector<QrSegment> &segs, Ecc ecl,
+		int minVersion, int maxVersion, int mask, bool boostEcl, const ParallelFor &maskRunner) {
+	if (!(MIN_VERSION <= minVersion && minVersion <= maxVersion && maxVersion <= MAX_VERSION) || mask < FAST_MASK || mask > 7)
 		throw std::invalid_argument("Invalid value");
 	
 	// Find the minimal version number to use
@@ -313,17 +613,22 @@ QrCode QrCode::encodeSegments(const vector<QrSegment> &segs, Ecc ecl,
 		dataCodewords.at(i >> 3) |= (bb.at(i) ? 1 : 0) << (7 - (i & 7));
 	
 	// Create the QR Code object
-	return QrCode(version, ecl, dataCodewords, mask);
+	return QrCode(version, ecl, dataCodewords, mask, maskRunner);
 }
 
 
 QrCode::QrCode(int ver, Ecc ecl, const vector<uint8_t> &dataCodewords, int msk) :
+		QrCode(ver, ecl, dataCodewords, msk, ParallelFor()) {}
+
+
+QrCode::QrCode(int ver, Ecc ecl, const vector<uint8_t> &dataCodewords, int msk,
+		const ParallelFor &maskRunner) :
 		// Initialize fields and check arguments
 		version(ver),
 		errorCorrectionLevel(ecl) {
 	if (ver < MIN_VERSION || ver > MAX_VERSION)
 		throw std::domain_error("Version value out of range");
-	if (msk < -1 || msk > 7)
+	if (msk < FAST_MASK || msk > 7)
 		throw std::domain_error("Mask value out of range");
 	size = ver * 4 + 17;
 	size_t sz = static_cast<size_t>(size);
@@ -336,19 +641,8 @@ QrCode::QrCode(int ver, Ecc ecl, const vector<uint8_t> &dataCodewords, int msk)
 	drawCodewords(allCodewords);
 	
 	// Do masking
-	if (msk == -1) {  // Automatically choose best mask
-		long minPenalty = LONG_MAX;
-		for (int i = 0; i < 8; i++) {
-			applyMask(i);
-			drawFormatBits(i);
-			long penalty = getPenaltyScore();
-			if (penalty < minPenalty) {
-				msk = i;
-				minPenalty = penalty;
-			}
-			applyMask(i);  // Undoes the mask due to XOR
-		}
-	}
+	if (msk < 0)  // Automatically choose best mask, or a good one for FAST_MASK
+		msk = chooseMask(msk == FAST_MASK, maskRunner);
 	assert(0 <= msk && msk <= 7);
 	mask = msk;
 	applyMask(msk);  // Apply the final choice of mask
@@ -359,6 +653,13 @@ QrCode::QrCode(int ver, Ecc ecl, const vector<uint8_t> &dataCodewords, int msk)
 }
 
 
+int QrCode::getDataCapacityBits(int ver, Ecc ecl) {
+	if (ver < MIN_VERSION || ver > MAX_VERSION)
+		throw std::domain_error("Version value out of range");
+	return getNumDataCodewords(ver, ecl) * 8;
+}
+
+
 int QrCode::getVersion() const {
 	return version;
 }
@@ -384,6 +685,18 @@ bool QrCode::getModule(int x, int y) const {
 }
 
 
+void QrCode::exportModules(std::uint64_t *words, std::size_t wordsPerRow) const {
+	for (std::size_t y = 0; y < modules.size(); y++) {
+		const std::vector<bool> &srcRow = modules[y];
+		std::uint64_t *dstRow = words + y * wordsPerRow;
+		for (std::size_t x = 0; x < srcRow.size(); x++) {
+			if (srcRow[x])
+				dstRow[x >> 6] |= std::uint64_t{1} << (x & 63);
+		}
+	}
+}
+
+
 void QrCode::drawFunctionPatterns() {
 	// Draw horizontal and vertical timing patterns
 	for (int i = 0; i < size; i++) {
@@ -413,30 +726,22 @@ void QrCode::drawFunctionPatterns() {
 }
 
 
-void QrCode::drawFormatBits(int msk) {
+int QrCode::getFormatWord(Ecc ecl, int msk) {
 	// Calculate error correction code and pack bits
-	int data = getFormatBits(errorCorrectionLevel) << 3 | msk;  // errCorrLvl is uint2, msk is uint3
+	int data = getFormatBits(ecl) << 3 | msk;  // errCorrLvl is uint2, msk is uint3
 	int rem = data;
 	for (int i = 0; i < 10; i++)
 		rem = (rem << 1) ^ ((rem >> 9) * 0x537);
 	int bits = (data << 10 | rem) ^ 0x5412;  // uint15
 	assert(bits >> 15 == 0);
-	
-	// Draw first copy
-	for (int i = 0; i <= 5; i++)
-		setFunctionModule(8, i, getBit(bits, i));
-	setFunctionModule(8, 7, getBit(bits, 6));
-	setFunctionModule(8, 8, getBit(bits, 7));
-	setFunctionModule(7, 8, getBit(bits, 8));
-	for (int i = 9; i < 15; i++)
-		setFunctionModule(14 - i, 8, getBit(bits, i));
-	
-	// Draw second copy
-	for (int i = 0; i < 8; i++)
-		setFunctionModule(size - 1 - i, 8, getBit(bits, i));
-	for (int i = 8; i < 15; i++)
-		setFunctionModule(8, size - 15 + i, getBit(bits, i));
-	setFunctionModule(8, size - 8, true);  // Always dark
+	return bits;
+}
+
+
+void QrCode::drawFormatBits(int msk) {
+	forEachFormatModule(size, getFormatWord(errorCorrectionLevel, msk), [this](int x, int y, bool dark) {
+		setFunctionModule(x, y, dark);
+	});
 }
 
 
@@ -508,14 +813,14 @@ vector<uint8_t> QrCode::addEccAndInterleave(const vector<uint8_t> &data) const {
 	
 	// Split data into blocks and append ECC to each block
 	vector<vector<uint8_t> > blocks;
-	const vector<uint8_t> rsDiv = reedSolomonComputeDivisor(blockEccLen);
 	for (int i = 0, k = 0; i < numBlocks; i++) {
-		vector<uint8_t> dat(data.cbegin() + k, data.cbegin() + (k + shortBlockLen - blockEccLen + (i < numShortBlocks ? 0 : 1)));
-		k += static_cast<int>(dat.size());
-		const vector<uint8_t> ecc = reedSolomonComputeRemainder(dat, rsDiv);
+		size_t datLen = static_cast<size_t>(shortBlockLen - blockEccLen + (i < numShortBlocks ? 0 : 1));
+		vector<uint8_t> dat(data.cbegin() + k, data.cbegin() + k + static_cast<int>(datLen));
+		k += static_cast<int>(datLen);
 		if (i < numShortBlocks)
 			dat.push_back(0);
-		dat.insert(dat.end(), ecc.cbegin(), ecc.cend());
+		dat.resize(dat.size() + static_cast<size_t>(blockEccLen));
+		reedSolomonComputeRemainder(dat.data(), datLen, blockEccLen, dat.data() + dat.size() - blockEccLen);
 		blocks.push_back(std::move(dat));
 	}
 	
@@ -584,80 +889,96 @@ void QrCode::applyMask(int msk) {
 }
 
 
-long QrCode::getPenaltyScore() const {
-	long result = 0;
-	
-	// Adjacent modules in row having same color, and finder-like patterns
+int QrCode::chooseMask(bool fast, const ParallelFor &maskRunner) const {
+	const std::array<Bitboard,8> &masks = maskBoards(version, isFunction);
+	Bitboard base(size);
 	for (int y = 0; y < size; y++) {
-		bool runColor = false;
-		int runX = 0;
-		std::array<int,7> runHistory = {};
 		for (int x = 0; x < size; x++) {
-			if (module(x, y) == runColor) {
-				runX++;
-				if (runX == 5)
-					result += PENALTY_N1;
-				else if (runX > 5)
-					result++;
-			} else {
-				finderPenaltyAddHistory(runX, runHistory);
-				if (!runColor)
-					result += finderPenaltyCountPatterns(runHistory) * PENALTY_N3;
-				runColor = module(x, y);
-				runX = 1;
-			}
+			if (module(x, y))
+				base.set(x, y, true);
 		}
-		result += finderPenaltyTerminateAndCount(runColor, runX, runHistory) * PENALTY_N3;
 	}
-	// Adjacent modules in column having same color, and finder-like patterns
-	for (int x = 0; x < size; x++) {
+	
+	// Each candidate is scored on its own copy, so they can run concurrently.
+	// Scores are never negative; -1 marks a candidate not scored yet.
+	std::array<long,8> penalties;
+	penalties.fill(-1);
+	auto score = [&](int i) {
+		Bitboard trial = base;
+		trial ^= masks.at(static_cast<size_t>(i));
+		forEachFormatModule(size, getFormatWord(errorCorrectionLevel, i), [&trial](int x, int y, bool dark) {
+			trial.set(x, y, dark);
+		});
+		
+		// Fast mode skips the run-length rules (N1, N3), the costly half of the score;
+		// blocks and balance still steer it away from masks that leave large uniform areas
+		long result = countSameColorBlocks(trial) * PENALTY_N2 + getBalancePenalty(countDarkModules(trial));
+		if (!fast) {
+			result += getRunPenalty(trial.bits.data(), trial.words);
+			Bitboard columns = transpose(trial);
+			result += getRunPenalty(columns.bits.data(), columns.words);
+		}
+		penalties.at(static_cast<size_t>(i)) = result;
+	};
+	if (maskRunner && !fast)
+		maskRunner(8, score);
+	// Candidates the runner didn't finish (a task that threw on the pool is
+	// swallowed there) are scored here, where an exception reaches the caller
+	for (int i = 0; i < 8; i++) {
+		if (penalties.at(static_cast<size_t>(i)) < 0)
+			score(i);
+	}
+	
+	int best = 0;
+	for (int i = 1; i < 8; i++) {  // Lowest score wins, ties to the lowest mask number
+		if (penalties.at(static_cast<size_t>(i)) < penalties.at(static_cast<size_t>(best)))
+			best = i;
+	}
+	return best;
+}
+
+
+long QrCode::getRunPenalty(const uint64_t *rows, size_t wordsPerRow) const {
+	long result = 0;
+	size_t sz = static_cast<size_t>(size);
+	for (size_t y = 0; y < sz; y++) {
+		const uint64_t *row = rows + y * wordsPerRow;
 		bool runColor = false;
-		int runY = 0;
+		int runStart = 0;
 		std::array<int,7> runHistory = {};
-		for (int y = 0; y < size; y++) {
-			if (module(x, y) == runColor) {
-				runY++;
-				if (runY == 5)
-					result += PENALTY_N1;
-				else if (runY > 5)
-					result++;
-			} else {
-				finderPenaltyAddHistory(runY, runHistory);
+		
+		// Every color change ends a run; the row starts after a light border module
+		for (size_t w = 0; w < wordsPerRow; w++) {
+			uint64_t previous = (row[w] << 1) | (w > 0 ? row[w - 1] >> 63 : 0);
+			uint64_t changes = (row[w] ^ previous) & validBits(size, w);
+			while (changes != 0) {
+				int x = static_cast<int>(w * 64) + __builtin_ctzll(changes);
+				changes &= changes - 1;
+				int runLength = x - runStart;
+				if (runLength >= 5)
+					result += PENALTY_N1 + runLength - 5;
+				finderPenaltyAddHistory(runLength, runHistory);
 				if (!runColor)
 					result += finderPenaltyCountPatterns(runHistory) * PENALTY_N3;
-				runColor = module(x, y);
-				runY = 1;
+				runColor = !runColor;
+				runStart = x;
 			}
 		}
-		result += finderPenaltyTerminateAndCount(runColor, runY, runHistory) * PENALTY_N3;
+		int runLength = size - runStart;
+		if (runLength >= 5)
+			result += PENALTY_N1 + runLength - 5;
+		result += finderPenaltyTerminateAndCount(runColor, runLength, runHistory) * PENALTY_N3;
 	}
-	
-	// 2*2 blocks of modules having same color
-	for (int y = 0; y < size - 1; y++) {
-		for (int x = 0; x < size - 1; x++) {
-			bool  color = module(x, y);
-			if (  color == module(x + 1, y) &&
-			      color == module(x, y + 1) &&
-			      color == module(x + 1, y + 1))
-				result += PENALTY_N2;
-		}
-	}
-	
-	// Balance of dark and light modules
-	int dark = 0;
-	for (const vector<bool> &row : modules) {
-		for (bool color : row) {
-			if (color)
-				dark++;
-		}
-	}
-	int total = size * size;  // Note that size is odd, so dark/total != 1/2
+	return result;
+}
+
+
+long QrCode::getBalancePenalty(long dark) const {
+	long total = static_cast<long>(size) * size;  // Note that size is odd, so dark/total != 1/2
 	// Compute the smallest integer k >= 0 such that (45-5k)% <= dark/total <= (55+5k)%
-	int k = static_cast<int>((std::abs(dark * 20L - total * 10L) + total - 1) / total) - 1;
+	long k = (std::abs(dark * 20L - total * 10L) + total - 1) / total - 1;
 	assert(0 <= k && k <= 9);
-	result += k * PENALTY_N4;
-	assert(0 <= result && result <= 2568888L);  // Non-tight upper bound based on default values of PENALTY_N1, ..., N4
-	return result;
+	return k * PENALTY_N4;
 }
 
 
@@ -679,15 +1000,7 @@ vector<int> QrCode::getAlignmentPatternPositions() const {
 int QrCode::getNumRawDataModules(int ver) {
 	if (ver < MIN_VERSION || ver > MAX_VERSION)
 		throw std::domain_error("Version number out of range");
-	int result = (16 * ver + 128) * ver + 64;
-	if (ver >= 2) {
-		int numAlign = ver / 7 + 2;
-		result -= (25 * numAlign - 10) * numAlign - 55;
-		if (ver >= 7)
-			result -= 36;
-	}
-	assert(208 <= result && result <= 29648);
-	return result;
+	return RAW_DATA_MODULES.counts[ver];
 }
 
 
@@ -701,6 +1014,10 @@ int QrCode::getNumDataCodewords(int ver, Ecc ecl) {
 vector<uint8_t> QrCode::reedSolomonComputeDivisor(int degree) {
 	if (degree < 1 || degree > 255)
 		throw std::domain_error("Degree out of range");
+	if (degree <= RS_MAX_TABLE_DEGREE) {  // Row 1 of the product table is the divisor itself
+		const uint8_t *row = rsProductTable(degree).rows[1];
+		return vector<uint8_t>(row, row + degree);
+	}
 	// Polynomial coefficients are stored from highest to lowest power, excluding the leading term which is always 1.
 	// For example the polynomial x^3 + 255x^2 + 8x + 93 is stored as the uint8 array {255, 8, 93}.
 	vector<uint8_t> result(static_cast<size_t>(degree));
@@ -736,15 +1053,19 @@ vector<uint8_t> QrCode::reedSolomonComputeRemainder(const vector<uint8_t> &data,
 }
 
 
+void QrCode::reedSolomonComputeRemainder(const uint8_t *data, size_t len, int degree, uint8_t *result) {
+	if (degree < 1 || degree > RS_MAX_TABLE_DEGREE)
+		throw std::domain_error("Degree out of range");
+	const RsProductTable &table = rsProductTable(degree);
+	uint8_t remainder[RS_ROW_BYTES + 1] = {};  // The extra zero is shifted in at each step
+	for (size_t i = 0; i < len; i++)
+		rsDivisionStep(remainder, table.rows[data[i] ^ remainder[0]]);
+	std::memcpy(result, remainder, static_cast<size_t>(degree));
+}
+
+
 uint8_t QrCode::reedSolomonMultiply(uint8_t x, uint8_t y) {
-	// Russian peasant multiplication
-	int z = 0;
-	for (int i = 7; i >= 0; i--) {
-		z = (z << 1) ^ ((z >> 7) * 0x11D);
-		z ^= ((y >> i) & 1) * x;
-	}
-	assert(z >> 8 == 0);
-	return static_cast<uint8_t>(z);
+	return gfMultiply(x, y);
 }
 
 
@@ -24,7 +24,9 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -282,7 +284,8 @@ class QrCode final {
 	 * chosen for the output. Iff boostEcl is true, then the ECC level of the result
 	 * may be higher than the ecl argument if it can be done without increasing the
 	 * version. The mask number is either between 0 to 7 (inclusive) to force that
-	 * mask, or -1 to automatically choose an appropriate mask (which may be slow).
+	 * mask, -1 to automatically choose an appropriate mask (which may be slow), or FAST_MASK
+	 * for a quicker choice that is good but not necessarily the best.
 	 * This function allows the user to create a custom sequence of segments that switches
 	 * between modes (such as alphanumeric and byte) to encode text in less space.
 	 * This is a mid-level API; the high-level API is encodeText() and encodeBinary().
@@ -291,6 +294,42 @@ class QrCode final {
 		int minVersion=1, int maxVersion=40, int mask=-1, bool boostEcl=true);  // All optional parameters
 	
 	
+	/* 
+	 * Callback used to run the automatic mask search concurrently. It must invoke
+	 * body(0) .. body(count - 1), in any order and on any threads, and return only
+	 * after all invocations have completed. An invocation that throws may have its
+	 * exception dropped; its mask is then scored again on the calling thread.
+	 */
+	public: using ParallelFor = std::function<void(int count, const std::function<void(int)> &body)>;
+	
+	
+	/* 
+	 * Mask argument that picks a good mask quickly instead of the best one, scoring only
+	 * the cheap penalty rules. Meant for long animated streams, where every frame only
+	 * needs to scan and the best-possible mask gains nothing.
+	 */
+	public: static constexpr int FAST_MASK = -2;
+	
+	
+	/* 
+	 * Same as the other encodeSegments(), except that when mask is -1 the penalty
+	 * scores of the 8 candidate masks are computed through maskRunner instead of
+	 * sequentially. The chosen mask, and thus the output, is identical to the
+	 * sequential search.
+	 */
+	public: static QrCode encodeSegments(const std::vector<QrSegment> &segs, Ecc ecl,
+		int minVersion, int maxVersion, int mask, bool boostEcl, const ParallelFor &maskRunner);
+	
+	
+	
+	/* 
+	 * Returns the number of data bits (excluding error correction) that a QR Code of the
+	 * given version and error correction level can hold. Segments whose getTotalBits()
+	 * at that version is at most this value fit into the symbol.
+	 */
+	public: static int getDataCapacityBits(int ver, Ecc ecl);
+	
+	
 	
 	/*---- Instance fields ----*/
 	
@@ -334,6 +373,14 @@ class QrCode final {
 	public: QrCode(int ver, Ecc ecl, const std::vector<std::uint8_t> &dataCodewords, int msk);
 	
 	
+	/* 
+	 * Same as the other constructor, but evaluates automatic mask candidates
+	 * through maskRunner when msk is -1 (see encodeSegments()).
+	 */
+	public: QrCode(int ver, Ecc ecl, const std::vector<std::uint8_t> &dataCodewords, int msk,
+		const ParallelFor &maskRunner);
+	
+	
 	
 	/*---- Public instance methods ----*/
 	
@@ -369,6 +416,16 @@ class QrCode final {
 	public: bool getModule(int x, int y) const;
 	
 	
+	/* 
+	 * Writes every module into a caller-provided bit-packed buffer of size rows,
+	 * each row being wordsPerRow 64-bit words. Module x of row y is stored in bit
+	 * (x % 64) of words[y * wordsPerRow + x / 64]; dark modules are set bits.
+	 * The buffer must be zero-initialized and wordsPerRow must be at least
+	 * ceil(size / 64). Avoids the per-module bounds checks of getModule().
+	 */
+	public: void exportModules(std::uint64_t *words, std::size_t wordsPerRow) const;
+	
+	
 	
 	/*---- Private helper methods for constructor: Drawing function modules ----*/
 	
@@ -425,9 +482,20 @@ class QrCode final {
 	private: void applyMask(int msk);
 	
 	
-	// Calculates and returns the penalty score based on state of this QR Code's current modules.
-	// This is used by the automatic mask choice algorithm to find the mask pattern that yields the lowest score.
-	private: long getPenaltyScore() const;
+	// Returns the mask pattern with the lowest penalty score for the current (unmasked) modules.
+	// Candidates are scored on bit-packed copies, with whole-row XORs for the mask and word
+	// operations on the rows and the transposed columns for the rules. With fast set only the
+	// 2*2 block and balance rules are scored. The full scores match the reference algorithm.
+	private: int chooseMask(bool fast, const ParallelFor &maskRunner) const;
+	
+	
+	// Penalty rules N1 (runs of 5 or more) and N3 (finder-like patterns) summed over the
+	// given bit-packed lines, each size modules long.
+	private: long getRunPenalty(const std::uint64_t *rows, std::size_t wordsPerRow) const;
+	
+	
+	// Penalty rule N4 for the given number of dark modules.
+	private: long getBalancePenalty(long dark) const;
 	
 	
 	
@@ -441,7 +509,7 @@ class QrCode final {
 	
 	// Returns the number of data bits that can be stored in a QR Code of the given version number, after
 	// all function modules are excluded. This includes remainder bits, so it might not be a multiple of 8.
-	// The result is in the range [208, 29648]. This could be implemented as a 40-entry lookup table.
+	// The result is in the range [208, 29648]. Served from a table built at compile time.
 	private: static int getNumRawDataModules(int ver);
 	
 	
@@ -451,8 +519,8 @@ class QrCode final {
 	private: static int getNumDataCodewords(int ver, Ecc ecl);
 	
 	
-	// Returns a Reed-Solomon ECC generator polynomial for the given degree. This could be
-	// implemented as a lookup table over all possible parameter values, instead of as an algorithm.
+	// Returns a Reed-Solomon ECC generator polynomial for the given degree. Degrees used by
+	// QR Codes come from a table built once per degree, others are computed.
 	private: static std::vector<std::uint8_t> reedSolomonComputeDivisor(int degree);
 	
 	
@@ -460,24 +528,33 @@ class QrCode final {
 	private: static std::vector<std::uint8_t> reedSolomonComputeRemainder(const std::vector<std::uint8_t> &data, const std::vector<std::uint8_t> &divisor);
 	
 	
+	// Writes the degree ECC codewords of the len data codewords to result, dividing by the
+	// cached generator polynomial of that degree (at most 30, the longest QR Code block ECC).
+	private: static void reedSolomonComputeRemainder(const std::uint8_t *data, std::size_t len, int degree, std::uint8_t *result);
+	
+	
 	// Returns the product of the two given field elements modulo GF(2^8/0x11D).
-	// All inputs are valid. This could be implemented as a 256*256 lookup table.
+	// All inputs are valid. Uses compile-time log/antilog tables.
 	private: static std::uint8_t reedSolomonMultiply(std::uint8_t x, std::uint8_t y);
 	
 	
 	// Can only be called immediately after a light run is added, and
-	// returns either 0, 1, or 2. A helper function for getPenaltyScore().
+	// returns either 0, 1, or 2. A helper function for getRunPenalty().
 	private: int finderPenaltyCountPatterns(const std::array<int,7> &runHistory) const;
 	
 	
-	// Must be called at the end of a line (row or column) of modules. A helper function for getPenaltyScore().
+	// Must be called at the end of a line (row or column) of modules. A helper function for getRunPenalty().
 	private: int finderPenaltyTerminateAndCount(bool currentRunColor, int currentRunLength, std::array<int,7> &runHistory) const;
 	
 	
-	// Pushes the given value to the front and drops the last value. A helper function for getPenaltyScore().
+	// Pushes the given value to the front and drops the last value. A helper function for getRunPenalty().
 	private: void finderPenaltyAddHistory(int currentRunLength, std::array<int,7> &runHistory) const;
 	
 	
+	// Returns the 15-bit format information word for the given error correction level and mask.
+	private: static int getFormatWord(Ecc ecl, int msk);
+	
+	
 	// Returns true iff the i'th bit of x is set to 1.
 	private: static bool getBit(long x, int i);
 	
@@ -491,7 +568,7 @@ class QrCode final {
 	public: static constexpr int MAX_VERSION = 40;
 	
 	
-	// For use in getPenaltyScore(), when evaluating which mask is best.
+	// For use in chooseMask(), when evaluating which mask is best.
 	private: static const int PENALTY_N1;
 	private: static const int PENALTY_N2;
 	private: static const int PENALTY_N3;
@@ -0,0 +1,110 @@
+#include "app/redraw_scheduler.hpp"
+#include "app/config.hpp"
+#include <algorithm>
+
+namespace app {
+
+namespace {
+
+constexpr int kMinFrameIntervalMs = 16;
+constexpr int kMaxFrameIntervalMs = 1000;
+
+} // namespace
+
+RedrawScheduler::RedrawScheduler(std::function<void()> post, std::chrono::milliseconds frame_interval,
+                                 std::function<void()> on_animation_frame)
+    : post_(std::move(post)),
+      on_animation_frame_(std::move(on_animation_frame)),
+      frame_interval_(std::max(frame_interval, std::chrono::milliseconds(1))) {
+  thread_ = std::thread([this] { run(); });
+}
+
+RedrawScheduler::~RedrawScheduler() {
+  stop();
+}
+
+void RedrawScheduler::invalidate() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dirty_ = true;
+  }
+  cv_.notify_one();
+}
+
+void RedrawScheduler::requestAnimationFrame() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (animation_requested_) return;
+    animation_requested_ = true;
+  }
+  cv_.notify_one();
+}
+
+void RedrawScheduler::frameRendered() {
+  bool pending;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    frame_in_flight_ = false;
+    pending = dirty_ || animation_requested_;
+  }
+  // Only wake the thread if something is waiting on this frame
+  if (pending) cv_.notify_one();
+}
+
+void RedrawScheduler::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_one();
+  if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id()) {
+    thread_.join();
+  }
+}
+
+std::chrono::milliseconds RedrawScheduler::configuredFrameInterval() {
+  int ms = Config::getInstance().getAppConfig().animation_speed_ms;
+  return std::chrono::milliseconds(std::clamp(ms, kMinFrameIntervalMs, kMaxFrameIntervalMs));
+}
+
+void RedrawScheduler::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    if (!dirty_ && !animation_requested_) {
+      cv_.wait(lock);
+      continue;
+    }
+
+    auto now = Clock::now();
+    // Hold requests until the posted frame is drawn, but not forever: a
+    // frame the UI loop dropped is given up on after one interval.
+    auto in_flight_until = posted_at_ + frame_interval_;
+    if (frame_in_flight_ && now < in_flight_until) {
+      cv_.wait_until(lock, in_flight_until);
+      continue;
+    }
+    auto animation_due = last_animation_frame_ + frame_interval_;
+    if (!dirty_ && now < animation_due) {
+      cv_.wait_until(lock, animation_due);
+      continue;
+    }
+
+    // An invalidation may be served early, but then carries the animation
+    // frame along only once it is due, so spinners keep a steady pace.
+    bool animate = animation_requested_ && now >= animation_due;
+    if (animate) {
+      animation_requested_ = false;
+      last_animation_frame_ = now;
+    }
+    dirty_ = false;
+    frame_in_flight_ = true;
+    posted_at_ = now;
+
+    lock.unlock();
+    if (animate && on_animation_frame_) on_animation_frame_();
+    post_();
+    lock.lock();
+  }
+}
+
+} // namespace app
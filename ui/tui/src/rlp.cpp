@@ -0,0 +1,140 @@
+#include "app/rlp.hpp"
+#include "app/state.hpp"
+#include "app/text_scan.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace app {
+
+namespace {
+
+constexpr uint8_t kEip1559TxType = 0x02;
+
+inline uint8_t HexNibble(char c) {
+  return static_cast<uint8_t>(c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+}
+
+std::string_view StripHexPrefix(std::string_view hex) {
+  if (hex.size() >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) hex.remove_prefix(2);
+  return hex;
+}
+
+bool IsEvenHex(std::string_view hex) {
+  hex = StripHexPrefix(hex);
+  return hex.size() % 2 == 0 && IsHexDigits(hex.data(), hex.size());
+}
+
+// Everything the encoder needs present and well-formed; `to` may be empty
+// for contract creation
+bool IsEncodable(const UnsignedTx& tx) {
+  if (!tx.nonce || !tx.gas_limit || !tx.value || tx.chain_id <= 0) return false;
+  if (tx.isEIP1559() ? !(tx.max_fee_per_gas && tx.max_priority_fee_per_gas)
+                     : !(tx.type == 0 && tx.gas_price)) {
+    return false;
+  }
+  if (!tx.to.empty() && (StripHexPrefix(tx.to).size() != 40 || !IsEvenHex(tx.to))) return false;
+  return IsEvenHex(tx.data);
+}
+
+void WriteSigningPayload(const UnsignedTx& tx, RlpWriter& w) {
+  uint64_t chain_id = static_cast<uint64_t>(tx.chain_id);
+  if (tx.isEIP1559()) {
+    w.writeRaw(kEip1559TxType);
+    w.writeList([&](RlpWriter& f) {
+      f.writeUint(chain_id);
+      f.writeUint(*tx.nonce);
+      f.writeUint(*tx.max_priority_fee_per_gas);
+      f.writeUint(*tx.max_fee_per_gas);
+      f.writeUint(*tx.gas_limit);
+      f.writeHexBytes(tx.to);
+      f.writeUint(*tx.value);
+      f.writeHexBytes(tx.data);
+      f.writeList([](RlpWriter&) {});  // empty access list
+    });
+  } else {
+    w.writeList([&](RlpWriter& f) {
+      f.writeUint(*tx.nonce);
+      f.writeUint(*tx.gas_price);
+      f.writeUint(*tx.gas_limit);
+      f.writeHexBytes(tx.to);
+      f.writeUint(*tx.value);
+      f.writeHexBytes(tx.data);
+      f.writeUint(chain_id);
+      f.writeUint(uint64_t{0});
+      f.writeUint(uint64_t{0});
+    });
+  }
+}
+
+} // namespace
+
+void RlpWriter::put(const uint8_t* data, size_t size) {
+  if (hasher_) {
+    hasher_->update(data, size);
+  } else if (size_ < capacity_) {
+    std::memcpy(out_ + size_, data, std::min(size, capacity_ - size_));
+  }
+  size_ += size;
+}
+
+void RlpWriter::writeLength(size_t length, uint8_t offset) {
+  if (length < 56) {
+    writeRaw(static_cast<uint8_t>(offset + length));
+    return;
+  }
+  uint8_t header[1 + sizeof(size_t)];
+  size_t n = 0;
+  for (size_t v = length; v != 0; v >>= 8) ++n;
+  header[0] = static_cast<uint8_t>(offset + 55 + n);
+  for (size_t i = 0; i < n; ++i) header[1 + i] = static_cast<uint8_t>(length >> (8 * (n - 1 - i)));
+  put(header, 1 + n);
+}
+
+void RlpWriter::writeBytes(const uint8_t* data, size_t size) {
+  if (size != 1 || data[0] >= 0x80) writeLength(size, 0x80);
+  put(data, size);
+}
+
+bool RlpWriter::writeHexBytes(std::string_view hex) {
+  hex = StripHexPrefix(hex);
+  if (hex.size() % 2 != 0 || !IsHexDigits(hex.data(), hex.size())) return false;
+
+  size_t size = hex.size() / 2;
+  uint8_t first = size > 0 ? static_cast<uint8_t>(HexNibble(hex[0]) << 4 | HexNibble(hex[1])) : 0;
+  if (size != 1 || first >= 0x80) writeLength(size, 0x80);
+
+  // Decode through a small stack buffer so long calldata needs no copy
+  uint8_t chunk[64];
+  for (size_t i = 0; i < size;) {
+    size_t n = std::min(size - i, sizeof(chunk));
+    for (size_t k = 0; k < n; ++k) {
+      chunk[k] = static_cast<uint8_t>(HexNibble(hex[2 * (i + k)]) << 4 | HexNibble(hex[2 * (i + k) + 1]));
+    }
+    put(chunk, n);
+    i += n;
+  }
+  return true;
+}
+
+void RlpWriter::writeUint(const U256& value) {
+  uint8_t bytes[32];
+  value.writeBigEndian(bytes);
+  writeBytes(bytes, value.byteLength());
+}
+
+size_t EncodeUnsignedTx(const UnsignedTx& tx, uint8_t* out, size_t capacity) noexcept {
+  if (!IsEncodable(tx)) return 0;
+  RlpWriter writer(out, capacity);
+  WriteSigningPayload(tx, writer);
+  return writer.size();
+}
+
+std::optional<Hash256> SigningHash(const UnsignedTx& tx) noexcept {
+  if (!IsEncodable(tx)) return std::nullopt;
+  Keccak256Hasher hasher;
+  RlpWriter writer(hasher);
+  WriteSigningPayload(tx, writer);
+  return hasher.finalize();
+}
+
+} // namespace app
@@ -0,0 +1,321 @@
+#include "app/signer_client.hpp"
+#include "app/logger.hpp"
+#include "app/metrics.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0  // macOS: SO_NOSIGPIPE is set on the socket instead
+#endif
+
+namespace app {
+
+namespace {
+
+uint32_t DecodeLength(const unsigned char* p) {
+  return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+// Field values are single-line by construction; drop anything that would
+// break the key=value framing rather than send a different request
+std::string SingleLine(const std::string& value) {
+  std::string out;
+  out.reserve(value.size());
+  for (char c : value) {
+    if (c != '\n' && c != '\r') out += c;
+  }
+  return out;
+}
+
+} // namespace
+
+SignerClient::SignerClient(std::string working_dir, std::vector<std::string> argv)
+    : working_dir_(std::move(working_dir)), argv_(std::move(argv)) {}
+
+SignerClient::~SignerClient() {
+  stop();
+}
+
+std::string SignerClient::EncodeFrame(const std::string& body) {
+  uint32_t n = static_cast<uint32_t>(body.size());
+  std::string frame;
+  frame.reserve(4 + body.size());
+  frame += static_cast<char>(n >> 24);
+  frame += static_cast<char>(n >> 16);
+  frame += static_cast<char>(n >> 8);
+  frame += static_cast<char>(n);
+  frame += body;
+  return frame;
+}
+
+std::string SignerClient::EncodeRequest(const SignRequest& request) {
+  std::string body = "sign\n";
+  auto field = [&](const char* key, const std::string& value) {
+    if (value.empty()) return;
+    body += key;
+    body += '=';
+    body += SingleLine(value);
+    body += '\n';
+  };
+  field("to", request.to);
+  field("amount", request.amount);
+  field("nonce", request.nonce);
+  field("gasPrice", request.gas_price);
+  field("gasLimit", request.gas_limit);
+  field("chainId", request.chain_id);
+  return body;
+}
+
+bool SignerClient::start() noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return startLocked();
+}
+
+bool SignerClient::running() const noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pid_ > 0;
+}
+
+void SignerClient::stop() noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stopLocked();
+}
+
+bool SignerClient::startLocked() noexcept {
+  if (pid_ > 0) {
+    // Reap a worker that exited on its own so it gets restarted below
+    int status = 0;
+    if (waitpid(pid_, &status, WNOHANG) == 0) return true;
+    LOG_WARN("Signer worker exited; restarting");
+    pid_ = -1;
+    if (fd_ >= 0) {
+      close(fd_);
+      fd_ = -1;
+    }
+  }
+  if (argv_.empty()) return false;
+
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+    LOG_ERRORF("Signer socketpair failed: {}", errno);
+    return false;
+  }
+  fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+  int one = 1;
+  setsockopt(fds[0], SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+  // Build argv before forking; the child may only call async-signal-safe functions
+  std::vector<char*> args;
+  for (auto& arg : argv_) args.push_back(const_cast<char*>(arg.c_str()));
+  args.push_back(nullptr);
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    LOG_ERRORF("Signer fork failed: {}", errno);
+    close(fds[0]);
+    close(fds[1]);
+    return false;
+  }
+  if (pid == 0) {
+    // Child: the socket is stdin and stdout; stderr is dropped so worker
+    // diagnostics can't scribble over the TUI
+    dup2(fds[1], STDIN_FILENO);
+    dup2(fds[1], STDOUT_FILENO);
+    int devnull = open("/dev/null", O_WRONLY);
+    if (devnull >= 0) dup2(devnull, STDERR_FILENO);
+    close(fds[1]);
+    if (!working_dir_.empty() && chdir(working_dir_.c_str()) != 0) _exit(127);
+    execvp(args[0], args.data());
+    _exit(127);
+  }
+
+  close(fds[1]);
+  fd_ = fds[0];
+  pid_ = pid;
+  LOG_INFOF("Started signer worker (pid {})", static_cast<long>(pid));
+  return true;
+}
+
+void SignerClient::stopLocked() noexcept {
+  if (fd_ >= 0) {
+    // Closing the socket is the worker's cue to release the device and exit
+    close(fd_);
+    fd_ = -1;
+  }
+  if (pid_ > 0) {
+    int status = 0;
+    for (int i = 0; i < 20 && waitpid(pid_, &status, WNOHANG) == 0; ++i) {
+      usleep(10000);
+      if (i == 9) kill(pid_, SIGTERM);
+    }
+    if (waitpid(pid_, &status, WNOHANG) == 0) {
+      kill(pid_, SIGKILL);
+      waitpid(pid_, &status, 0);
+    }
+    pid_ = -1;
+  }
+}
+
+bool SignerClient::writeAll(const std::string& data) noexcept {
+  size_t done = 0;
+  while (done < data.size()) {
+    ssize_t n = send(fd_, data.data() + done, data.size() - done, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    done += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+bool SignerClient::readAll(char* data, size_t size, std::chrono::steady_clock::time_point deadline,
+                           const CancellationToken& cancel) noexcept {
+  size_t done = 0;
+  while (done < size) {
+    if (cancel.cancelled()) return false;
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now());
+    if (left.count() <= 0) return false;
+    pollfd pfd{fd_, POLLIN, 0};
+    int ready = poll(&pfd, 1, static_cast<int>(std::min<int64_t>(left.count(), 200)));
+    if (ready < 0 && errno != EINTR) return false;
+    if (ready <= 0) continue;
+    ssize_t n = recv(fd_, data + done, size - done, 0);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;  // worker closed its end
+    done += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+bool SignerClient::readResponseLocked(std::chrono::steady_clock::time_point deadline,
+                                      const CancellationToken& cancel, SignResult& result) noexcept {
+  result.ok = false;
+  unsigned char header[4];
+  if (!readAll(reinterpret_cast<char*>(header), sizeof(header), deadline, cancel)) {
+    stopLocked();
+    result.payload = cancel.cancelled() ? "Signing cancelled" : "Signer worker did not respond";
+    return false;
+  }
+
+  uint32_t size = DecodeLength(header);
+  if (size > kMaxFrameSize) {
+    stopLocked();
+    result.payload = "Signer worker sent an oversized response";
+    return false;
+  }
+  std::string body(size, '\0');
+  if (!readAll(&body[0], size, deadline, cancel)) {
+    stopLocked();
+    result.payload = cancel.cancelled() ? "Signing cancelled" : "Signer worker did not respond";
+    return false;
+  }
+
+  size_t newline = body.find('\n');
+  std::string status = body.substr(0, newline);
+  result.payload = newline == std::string::npos ? std::string() : body.substr(newline + 1);
+  result.ok = status == "ok";
+  if (!result.ok && status != "error") {
+    result.payload = "Unexpected signer response: " + status;
+  }
+  return true;
+}
+
+SignResult SignerClient::sign(const SignRequest& request, std::chrono::milliseconds timeout,
+                              const CancellationToken& cancel) noexcept {
+  static Histogram& round_trip = Metrics::shared().histogram("signer.round_trip");
+  static Counter& failures = Metrics::shared().counter("signer.failures");
+  SignResult result;
+  try {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!startLocked()) {
+      failures.add();
+      result.payload = "Signer worker could not be started";
+      return result;
+    }
+    ScopedLatency timer(round_trip);
+
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    if (!writeAll(EncodeFrame(EncodeRequest(request)))) {
+      stopLocked();
+      failures.add();
+      result.payload = "Signer worker did not respond";
+      return result;
+    }
+    readResponseLocked(deadline, cancel, result);
+    if (!result.ok && !cancel.cancelled()) failures.add();
+  } catch (const std::exception& e) {
+    LOG_EXCEPTION(e, "SignerClient::sign");
+    failures.add();
+    result.ok = false;
+    result.payload = e.what();
+  }
+  return result;
+}
+
+size_t SignerClient::signBatch(const std::vector<SignRequest>& requests, const BatchSink& on_result,
+                               std::chrono::milliseconds timeout, const CancellationToken& cancel) noexcept {
+  static Histogram& round_trip = Metrics::shared().histogram("signer.round_trip");
+  static Counter& failures = Metrics::shared().counter("signer.failures");
+  size_t signed_count = 0;
+  size_t next = 0;
+  auto report = [&](const SignResult& result) {
+    if (result.ok) {
+      ++signed_count;
+    } else if (!cancel.cancelled()) {
+      failures.add();
+    }
+    if (on_result) on_result(next, result);
+    ++next;
+  };
+  try {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SignResult failed;
+    if (!startLocked()) {
+      failed.payload = "Signer worker could not be started";
+    } else {
+      // The worker answers in order, so the whole batch can be in its queue
+      std::string frames;
+      for (const auto& request : requests) frames += EncodeFrame(EncodeRequest(request));
+      if (!writeAll(frames)) {
+        stopLocked();
+        failed.payload = "Signer worker did not respond";
+      }
+    }
+
+    // Each response is timed from the previous one, i.e. one device tap
+    while (failed.payload.empty() && next < requests.size()) {
+      auto started = std::chrono::steady_clock::now();
+      SignResult result;
+      bool answered = readResponseLocked(started + timeout, cancel, result);
+      if (!answered) {
+        failed = result;
+        break;
+      }
+      round_trip.record(std::chrono::steady_clock::now() - started);
+      report(result);
+      if (!result.ok && next < requests.size()) {
+        // Signing on would leave a nonce gap the later ones can't be mined
+        // past; the worker still has them queued, so it goes too
+        stopLocked();
+        failed.payload = "Not signed: an earlier transaction of the batch was not signed";
+      }
+    }
+    while (next < requests.size()) report(failed);
+  } catch (const std::exception& e) {
+    LOG_EXCEPTION(e, "SignerClient::signBatch");
+    SignResult failed;
+    failed.payload = e.what();
+    while (next < requests.size()) report(failed);
+  }
+  return signed_count;
+}
+
+} // namespace app
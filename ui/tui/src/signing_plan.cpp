@@ -0,0 +1,108 @@
+#include "app/signing_plan.hpp"
+#include "app/logger.hpp"
+#include "app/rlp.hpp"
+
+namespace app {
+
+namespace {
+
+constexpr uint8_t kEip1559TxType = 0x02;
+
+// Offset and length of the body of the RLP list starting at data[pos]
+bool ListBody(const std::vector<uint8_t>& data, size_t pos, size_t& body, size_t& length) {
+  if (pos >= data.size() || data[pos] < 0xc0) return false;
+  uint8_t head = data[pos];
+  if (head <= 0xf7) {
+    body = pos + 1;
+    length = head - 0xc0u;
+  } else {
+    size_t n = head - 0xf7u;
+    if (pos + 1 + n > data.size()) return false;
+    length = 0;
+    for (size_t i = 0; i < n; ++i) length = length << 8 | data[pos + 1 + i];
+    body = pos + 1 + n;
+  }
+  return body + length == data.size();
+}
+
+uint64_t SignatureV(const UnsignedTx& tx, uint8_t y_parity) {
+  // EIP-155 folds the chain id into v; typed transactions carry the parity
+  return tx.isEIP1559() ? y_parity : static_cast<uint64_t>(tx.chain_id) * 2 + 35 + y_parity;
+}
+
+void WriteSignedTx(const SigningPlan& plan, const TxSignature& signature, RlpWriter& w) {
+  if (plan.tx.isEIP1559()) w.writeRaw(kEip1559TxType);
+  w.writeList([&](RlpWriter& f) {
+    f.writeEncoded(plan.fields.data(), plan.fields.size());
+    f.writeUint(SignatureV(plan.tx, signature.y_parity));
+    f.writeUint(signature.r);
+    f.writeUint(signature.s);
+  });
+}
+
+} // namespace
+
+bool SigningPlan::matches(const UnsignedTx& other) const noexcept {
+  return tx.to == other.to && tx.value == other.value && tx.data == other.data &&
+         tx.nonce == other.nonce && tx.gas_limit == other.gas_limit &&
+         tx.gas_price == other.gas_price && tx.max_fee_per_gas == other.max_fee_per_gas &&
+         tx.max_priority_fee_per_gas == other.max_priority_fee_per_gas &&
+         tx.chain_id == other.chain_id && tx.type == other.type;
+}
+
+std::optional<SigningPlan> PlanSigning(const UnsignedTx& tx, const QRPlanOptions& qr) noexcept {
+  try {
+    SigningPlan plan;
+    plan.tx = tx;
+    size_t size = EncodeUnsignedTx(tx, nullptr, 0);
+    if (size == 0) return std::nullopt;
+    plan.payload.resize(size);
+    EncodeUnsignedTx(tx, plan.payload.data(), plan.payload.size());
+    plan.hash = Keccak256(plan.payload.data(), plan.payload.size());
+
+    // The signing payload is [fields..., []] for EIP-1559, where the access
+    // list is the last field, and [fields..., chainId, 0, 0] for EIP-155
+    size_t body = 0;
+    size_t length = 0;
+    if (!ListBody(plan.payload, tx.isEIP1559() ? 1 : 0, body, length)) return std::nullopt;
+    if (!tx.isEIP1559()) {
+      RlpWriter trailer(nullptr, 0);
+      trailer.writeUint(static_cast<uint64_t>(tx.chain_id));
+      trailer.writeUint(uint64_t{0});
+      trailer.writeUint(uint64_t{0});
+      if (trailer.size() > length) return std::nullopt;
+      length -= trailer.size();
+    }
+    plan.fields.assign(plan.payload.begin() + body, plan.payload.begin() + body + length);
+
+    // Worst case: r and s both need all 32 bytes
+    TxSignature widest;
+    widest.y_parity = 1;
+    widest.r = U256::max();
+    widest.s = U256::max();
+    RlpWriter counter(nullptr, 0);
+    WriteSignedTx(plan, widest, counter);
+    plan.max_signed_hex_length = 2 + 2 * counter.size();
+
+    // Lowercase hex goes out in byte mode, the densest mode it can use, so
+    // any hex of this length needs the same symbol
+    std::string placeholder = "0x" + std::string(plan.max_signed_hex_length - 2, 'f');
+    plan.qr_version = QRVersionFor(placeholder, qr.ecc);
+    plan.qr_frames = PlanQRChunks(placeholder, qr).size();
+    return plan;
+  } catch (const std::exception& e) {
+    LOG_EXCEPTION(e, "PlanSigning");
+    return std::nullopt;
+  }
+}
+
+std::string EncodeSignedTx(const SigningPlan& plan, const TxSignature& signature) {
+  RlpWriter counter(nullptr, 0);
+  WriteSignedTx(plan, signature, counter);
+  std::vector<uint8_t> encoded(counter.size());
+  RlpWriter writer(encoded.data(), encoded.size());
+  WriteSignedTx(plan, signature, writer);
+  return "0x" + ToHex(encoded.data(), encoded.size());
+}
+
+} // namespace app
@@ -3,10 +3,7 @@
 #include <ftxui/dom/elements.hpp>
 #include <ftxui/screen/color.hpp>
 #include <ftxui/component/event.hpp>
-#include <ftxui/dom/node.hpp>
 #include <ftxui/screen/screen.hpp>
-#include <ftxui/screen/box.hpp>
-#include <ftxui/screen/pixel.hpp>
 #include "app/wallet_detector.hpp"
 #include <string>
 #include <thread>
@@ -15,112 +12,45 @@
 #include <algorithm>
 #include <map>
 #include <sstream>
+#include <cctype>
 #include <cmath>
+#include <ctime>
 #include "app/qr_generator.hpp"
+#include "app/payload_codec.hpp"
+#include "app/fountain.hpp"
+#include "app/qr_render_cache.hpp"
+#include "app/qr_element.hpp"
+#include "app/qr_graphics.hpp"
+#include "app/address_book_file.hpp"
+#include "app/address_index.hpp"
+#include "app/signer_client.hpp"
+#include "app/usb_contact_scanner.hpp"
+#include "app/startup_trace.hpp"
+#include "app/metrics.hpp"
+#include "app/task_executor.hpp"
+#include "app/redraw_scheduler.hpp"
+#include "app/batch_signing.hpp"
+#include "app/form_validation.hpp"
+#include "app/config.hpp"
+#include "app/tx_history.hpp"
+#include "app/logger.hpp"
 #include <iostream>
 #include <cstdio>
 #include <memory>
 #include <stdexcept>
 #include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
 
 using namespace ftxui;
 using app::WalletDetector;
 using app::DetectionStatus;
+using app::ResponsiveQrCode;
 
-// Function to execute shell command and capture output
-std::string execCommand(const std::string& cmd) {
-    std::array<char, 128> buffer;
-    std::string result;
-    std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(cmd.c_str(), "r"), pclose);
-    if (!pipe) {
-        throw std::runtime_error("popen() failed!");
-    }
-    while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
-        result += buffer.data();
-    }
-    return result;
-}
-
-// Simple compression function using base64 encoding (placeholder for actual compression)
-std::string compressData(const std::string& data) {
-    // For now, just return a compressed-looking version
-    // In a real implementation, you'd use actual compression like gzip
-    std::string compressed = "COMPRESSED:" + data.substr(0, std::min(100UL, data.length()));
-    if (data.length() > 100) {
-        compressed += "...";
-    }
-    return compressed;
-}
-
-class QrCodeNode : public ftxui::Node {
-public:
-    QrCodeNode(app::QRCode qr) : qr_data_(std::move(qr)) {}
-
-    void ComputeRequirement() override {
-        requirement_.min_x = 2;
-        requirement_.min_y = 1;
-        requirement_.flex_grow_x = 0;
-        requirement_.flex_grow_y = 0;
-        requirement_.flex_shrink_x = 1;
-        requirement_.flex_shrink_y = 1;
-    }
-
-    void Render(ftxui::Screen& screen) override {
-        Node::Render(screen);
-        int width = box_.x_max - box_.x_min + 1;
-        int height = box_.y_max - box_.y_min + 1;
-
-        if (width <= 0 || height <= 0 || qr_data_.size == 0) {
-            return;
-        }
-
-        // Following the official Nayuki demo approach but with smaller border
-        int border = 2;
-        int total_size = qr_data_.size + 2 * border;
-        
-        // Calculate scale to fit in available space, but cap it to keep size very small
-        int scale = std::min(width / (total_size * 2), height / total_size);
-        if (scale < 1) scale = 1;
-        if (scale > 1) scale = 1; // Force scale to 1 to keep QR code as small as possible
-        
-        int render_width = total_size * scale * 2;
-        int render_height = total_size * scale;
-        
-        int offset_x = (width - render_width) / 2;
-        int offset_y = (height - render_height) / 2;
-
-        for (int y = 0; y < render_height; ++y) {
-            for (int x = 0; x < render_width; ++x) {
-                // Map screen coordinates back to QR coordinates
-                int qr_x = (x / (scale * 2)) - border;
-                int qr_y = (y / scale) - border;
-                
-                bool is_black = false;
-                if (qr_x >= 0 && qr_x < qr_data_.size && qr_y >= 0 && qr_y < qr_data_.size) {
-                    is_black = qr_data_.modules[qr_y][qr_x];
-                }
-
-                ftxui::Pixel& p = screen.PixelAt(box_.x_min + offset_x + x, box_.y_min + offset_y + y);
-                if (is_black) {
-                    p.character = "█";
-                    p.foreground_color = ftxui::Color::Black;
-                    p.background_color = ftxui::Color::Black;
-                } else {
-                    p.character = " ";
-                    p.foreground_color = ftxui::Color::White;
-                    p.background_color = ftxui::Color::White;
-                }
-            }
-        }
-    }
-
-private:
-    app::QRCode qr_data_;
-};
-
-ftxui::Element ResponsiveQrCode(app::QRCode qr) {
-    return std::make_shared<QrCodeNode>(std::move(qr));
-}
+// Signing app checkout; the signer worker runs from here
+const char* const kSigningAppDir = "/Users/kiki/Documents/ETHWARSAW_2025/base-os/signing-app";
+const int kBaseChainId = 8453;
 
 // Contact data structure
 struct Contact {
@@ -134,6 +64,34 @@ struct Contact {
   int threshold = 0;
 };
 
+// Contact::type spelling of a scanned contact's type
+std::string contact_type_name(app::ContactType type) {
+  switch (type) {
+    case app::ContactType::ENS: return "ens";
+    case app::ContactType::Base: return "base";
+    case app::ContactType::Multisig: return "multisig";
+    case app::ContactType::Contract: return "contract";
+    default: return "eoa";
+  }
+}
+
+// Same 0x address, whatever its checksum casing
+bool same_address(const std::string& a, const std::string& b) {
+  return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](char x, char y) {
+    return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+  });
+}
+
+// Local date and time of a history record
+std::string format_timestamp(uint64_t timestamp_ms) {
+  std::time_t seconds = static_cast<std::time_t>(timestamp_ms / 1000);
+  std::tm local{};
+  localtime_r(&seconds, &local);
+  char buffer[32];
+  std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M", &local);
+  return buffer;
+}
+
 // Address book for autocomplete
 struct AddressEntry {
   std::string address;
@@ -141,18 +99,21 @@ struct AddressEntry {
   std::string type;
 };
 
-// Comprehensive TUI Application
-int RunSimpleTransaction() {
+// Comprehensive TUI Application. With a batch the app opens on its review
+// screen and signs every transfer in one go; afterwards it works as usual.
+int RunSimpleTransaction(const app::SigningBatch* batch) {
   // Application state
   enum class Screen { CONNECT_WALLET, USB_CONTACTS, TRANSACTION_INPUT, CONFIRMATION, RESULT };
-  Screen current_screen = Screen::CONNECT_WALLET;
-  std::vector<Screen> navigation_history = {Screen::CONNECT_WALLET};
+  bool batch_pending = batch != nullptr && !batch->entries.empty();
+  Screen current_screen = batch_pending ? Screen::CONFIRMATION : Screen::CONNECT_WALLET;
+  std::vector<Screen> navigation_history = {current_screen};
   
-  enum class ResultView { QR_CODE_COMPRESSED, QR_CODE_UNCOMPRESSED, TX_DATA };
+  enum class ResultView { QR_CODE_COMPRESSED, QR_CODE_UNCOMPRESSED, QR_CODE_FOUNTAIN, TX_DATA };
   ResultView current_result_view = ResultView::QR_CODE_COMPRESSED;
   // UI state
   int focused_element = 0;
   bool show_help = false;
+  bool show_metrics = false;  // live latency panel, the same figures as --metrics-out
   bool show_confirm_dialog = false;
   std::string confirm_dialog_message = "";
   std::string command_buffer = "";
@@ -184,24 +145,85 @@ int RunSimpleTransaction() {
     {"0x7a250d5630B4cF539739dF2C5dAcb4c659F2488D", "Uniswap V2 Router", "contract"}
   };
   
+  // Suggestions shown under the address field, best match first. The index
+  // is built on the first lookup rather than before the first frame.
+  constexpr size_t kMaxSuggestions = 5;
+  app::AddressIndex address_index;
+  std::once_flag address_index_built;
+  auto ensure_address_index = [&]() {
+    std::call_once(address_index_built, [&]() {
+      app::StartupPhase phase("address_index");
+      for (size_t i = 0; i < address_book.size(); ++i) {
+        address_index.insert(i, address_book[i].address, address_book[i].name);
+      }
+    });
+  };
+  app::AddressSearch address_search(address_index);
+  // The --address-book book, searched after the built-in entries; handed
+  // over by the deferred init once it is mapped
+  std::shared_ptr<const app::MappedAddressBook> imported_book;
+  
   std::vector<AddressEntry> autocomplete_results;
+  size_t autocomplete_match_count = 0;
   bool show_autocomplete = false;
   int autocomplete_index = 0;
   
   // Transaction state
   bool is_signing = false;
   std::string tx_hash = "";
+  
+  // Batch progress; the counters are bumped by the signing worker
+  std::atomic<size_t> batch_done{0};
+  std::atomic<size_t> batch_signed{0};
+  std::vector<std::string> batch_failures;
+  size_t batch_streamed = 0;  // transfers in the batch's result stream
   std::string status_message = "Welcome to Offline Signer";
   
-  // Wallet detection state
-  std::unique_ptr<WalletDetector> wallet_detector = std::make_unique<WalletDetector>();
+  // Animated fountain QR state. Drawn as an image the symbol skips text
+  // rendering, so frames come faster.
+  app::QRGraphicsOverlay& qr_overlay = app::QRGraphicsOverlay::shared();
+  const int fountain_frame_interval_ms = qr_overlay.active() ? 100 : 250;
+  std::unique_ptr<app::FountainEncoder> fountain_encoder;
+  std::string fountain_payload;
+  std::atomic<uint32_t> fountain_seq{1};
+  // Read by the redraw scheduler and scanner threads, set by the UI thread
+  std::atomic<ScreenInteractive*> active_screen{nullptr};
+  
+  // Animation frames: the fountain view asks for its next frame each time it
+  // is drawn, so frames only advance while it is on screen and an idle
+  // screen leaves the scheduler asleep
+  app::RedrawScheduler redraw(
+    [&active_screen] {
+      if (ScreenInteractive* screen = active_screen.load()) screen->PostEvent(Event::Custom);
+    },
+    std::chrono::milliseconds(fountain_frame_interval_ms),
+    [&fountain_seq] { fountain_seq++; });
+  
+  // Compressed form of the last result payload; recomputed only when it changes
+  std::string compressed_source;
+  std::string compressed_data;
+  
+  // Every signed transaction is logged, so the last nonce can be filled in and
+  // past transactions shown again without re-signing. While browsing,
+  // history_entries holds the log newest first and the live result waits
+  // in live_result.
+  app::TransactionHistory history;
+  std::vector<app::TransactionHistory::Entry> history_entries;
+  size_t history_position = 0;
+  bool browsing_history = false;
+  std::string live_result;
+  
+  // Wallet detection state; the detector (and its libusb context) is created
+  // by a deferred startup task once the first frame is on screen
+  std::unique_ptr<WalletDetector> wallet_detector;
   DetectionStatus wallet_status = DetectionStatus::DISCONNECTED;
   std::string wallet_device_info = "No device detected";
-  bool wallet_detection_started = false;
   
   // Wallet detection setup
   auto setup_wallet_detection = [&]() {
-    if (!wallet_detection_started) {
+    {
+      app::StartupPhase phase("wallet_detector");
+      wallet_detector = std::make_unique<WalletDetector>();
       wallet_detector->setStatusChangeCallback([&](DetectionStatus status) {
         wallet_status = status;
         // Only update device info if we don't have specific device information
@@ -232,59 +254,80 @@ int RunSimpleTransaction() {
       });
       
       wallet_detector->startDetection();
-      wallet_detection_started = true;
     }
   };
   
-  // Mock contacts data
-  auto load_mock_contacts = [&]() {
-    contacts = {
-      {"1", "Alice", "0x742d35Cc6634C0532925a3b8D4C9db96590c6C87", "ens", "alice.eth", "", {}, 0},
-      {"2", "Bob Base", "0x8ba1f109551bD432803012645Hac136c22C177ec", "base", "", "bob.base.eth", {}, 0},
-      {"3", "Treasury Safe", "0x1234567890123456789012345678901234567890", "multisig", "", "", {"0x111...", "0x222...", "0x333..."}, 2},
-      {"4", "Charlie", "0x9876543210987654321098765432109876543210", "ens", "charlie.eth", "", {}, 0},
-      {"5", "Dev Multisig", "0xabcdefabcdefabcdefabcdefabcdefabcdefabcd", "multisig", "", "", {"0xaaa...", "0xbbb...", "0xccc...", "0xddd..."}, 3}
-    };
-    selected_contact_index = 0;
+  // USB scanning: contacts are handed to the UI thread batch by batch
+  auto usb_scanner = std::make_unique<app::UsbContactScanner>();
+  
+  // Background work started for a screen is cancelled when it is left
+  app::CancellationSource screen_tasks;
+  app::CancellationSource autocomplete_debounce;
+  
+  // Leaving the contacts screen stops a scan still running on it
+  auto leave_screen = [&](Screen next) {
+    if (current_screen == Screen::USB_CONTACTS && next != Screen::USB_CONTACTS && is_scanning) {
+      usb_scanner->cancel();
+      is_scanning = false;
+    }
+    screen_tasks.reset();
+    is_signing = false;
+  };
+  
+  // The nonce after the last one signed, unless the user has typed one
+  auto fill_nonce = [&]() {
+    if (!form_data["nonce"].empty()) return;
+    if (auto next = history.nextNonce(kBaseChainId)) form_data["nonce"] = std::to_string(*next);
   };
   
   // Navigation functions
   auto navigate_to_screen = [&](Screen screen) {
     if (screen != current_screen) {
+      leave_screen(screen);
       navigation_history.push_back(screen);
       current_screen = screen;
       focused_element = 0;
+      if (screen == Screen::TRANSACTION_INPUT) fill_nonce();
     }
   };
   
   auto go_back = [&]() {
     if (navigation_history.size() > 1) {
       navigation_history.pop_back();
+      leave_screen(navigation_history.back());
       current_screen = navigation_history.back();
       focused_element = 0;
     }
   };
   
-  // Autocomplete filtering
+  // Autocomplete filtering, once per keystroke in the address field
+  app::Histogram& keystroke_latency = app::Metrics::shared().histogram("autocomplete.keystroke");
   auto filter_addresses = [&](const std::string& input) {
+    app::ScopedLatency timer(keystroke_latency);
+    autocomplete_results.clear();
+    ensure_address_index();
     if (input.length() < 2) {
       show_autocomplete = false;
-      autocomplete_results.clear();
+      address_search.reset();
       return;
     }
     
-    autocomplete_results.clear();
-    for (const auto& entry : address_book) {
-      std::string lower_input = input;
-      std::transform(lower_input.begin(), lower_input.end(), lower_input.begin(), ::tolower);
-      std::string lower_address = entry.address;
-      std::transform(lower_address.begin(), lower_address.end(), lower_address.begin(), ::tolower);
-      std::string lower_name = entry.name;
-      std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(), ::tolower);
-      
-      if (lower_address.find(lower_input) != std::string::npos || 
-          lower_name.find(lower_input) != std::string::npos) {
-        autocomplete_results.push_back(entry);
+    // Refines the previous keystroke's matches when the input only grew
+    for (const auto& match : address_search.update(input, kMaxSuggestions)) {
+      autocomplete_results.push_back(address_book[match.id]);
+    }
+    autocomplete_match_count = address_search.matchCount();
+    
+    // Topped up with prefix matches from the imported book
+    if (imported_book && autocomplete_results.size() < kMaxSuggestions) {
+      for (size_t id : imported_book->searchPrefix(input, kMaxSuggestions)) {
+        if (autocomplete_results.size() >= kMaxSuggestions) break;
+        app::KnownAddress known = imported_book->toKnownAddress(id);
+        bool shown = std::any_of(autocomplete_results.begin(), autocomplete_results.end(),
+                                 [&](const AddressEntry& entry) { return same_address(entry.address, known.address); });
+        if (shown) continue;
+        autocomplete_results.push_back({known.address, known.name, contact_type_name(known.type)});
+        autocomplete_match_count++;
       }
     }
     
@@ -292,69 +335,269 @@ int RunSimpleTransaction() {
     autocomplete_index = 0;
   };
   
-  // USB scanning simulation
-  auto simulate_usb_scan = [&]() {
+  auto start_usb_scan = [&]() {
+    if (!active_screen) return;
+    contacts.clear();
+    selected_contact_index = -1;
     is_scanning = true;
-    std::thread([&]() {
-      std::this_thread::sleep_for(std::chrono::milliseconds(2000));
-      load_mock_contacts();
-      is_scanning = false;
-    }).detach();
+    usb_scanner->start(
+      [&](std::vector<app::KnownAddress> batch) {
+        ScreenInteractive* screen = active_screen.load();
+        if (!screen) return;
+        screen->Post([&, batch = std::move(batch)] {
+          for (const auto& found : batch) {
+            Contact contact;
+            contact.id = std::to_string(contacts.size() + 1);
+            contact.name = found.name;
+            contact.address = found.address;
+            contact.type = contact_type_name(found.type);
+            contacts.push_back(std::move(contact));
+          }
+          if (selected_contact_index < 0 && !contacts.empty()) selected_contact_index = 0;
+        });
+        screen->PostEvent(Event::Custom);
+      },
+      [&](size_t, bool cancelled) {
+        ScreenInteractive* screen = active_screen.load();
+        if (cancelled || !screen) return;
+        screen->Post([&] { is_scanning = false; });
+        screen->PostEvent(Event::Custom);
+      });
+  };
+  
+  // Signing worker: started right after the first frame so Node and the
+  // Ledger transport are warm by the time the user confirms, then reused for
+  // every signature (sign() starts it itself if that hasn't happened yet)
+  app::SignerClient signer(kSigningAppDir, {"npx", "ts-node", "eth-signer-cli.ts", "--serve"});
+  
+  // Background work runs here; completions run on the UI thread, which then
+  // redraws once. Shut down right after the loop, while everything its tasks
+  // capture is still alive.
+  app::TaskExecutor executor(2, [&](app::TaskExecutor::Completion done) {
+    ScreenInteractive* screen = active_screen.load();
+    if (!screen) return;
+    screen->Post(std::move(done));
+    screen->PostEvent(Event::Custom);
+  });
+  
+  // Everything not needed for the ConnectWallet frame comes up here, off the
+  // UI thread, once that frame has been drawn
+  bool first_frame_drawn = false;
+  auto start_deferred_init = [&]() {
+    app::StartupTrace::instance().mark("first_frame");
+    executor.submit([&](const app::CancellationToken&) { setup_wallet_detection(); }, [] {});
+    executor.submit([&](const app::CancellationToken&) {
+      {
+        app::StartupPhase phase("signer_start");
+        signer.start();
+      }
+      {
+        app::StartupPhase phase("tx_history");
+        const auto& config = app::Config::getInstance().getAppConfig();
+        if (!config.transaction_history_path.empty()) {
+          history.open(config.transaction_history_path,
+                       static_cast<size_t>(std::max(config.max_transaction_history, 0)));
+        }
+      }
+      {
+        // Starts the shared worker pool and touches the encoder's code paths
+        // so the first real QR doesn't pay for them
+        app::StartupPhase phase("qr_warmup");
+        app::GenerateQRsPlanned(std::string(230, 'f'));
+      }
+      app::StartupTrace::instance().mark("deferred_init_done");
+    });
+    auto book = std::make_shared<std::shared_ptr<const app::MappedAddressBook>>();
+    executor.submit(
+      [book](const app::CancellationToken&) {
+        app::StartupPhase phase("address_book");
+        *book = app::OpenAddressBook(app::Config::getInstance().getAppConfig().address_book_path);
+      },
+      [&, book] { imported_book = std::move(*book); });
+  };
+  
+  // Per-field checks of the form, in the order of its inputs. Each field
+  // keeps the text it was last checked with, so validating on every frame
+  // only parses what was just typed. The form is legacy (gas price) with the
+  // amount in ETH.
+  app::TransactionFormValidator form_validator(false, true);
+  const std::array<app::TxField, 5> form_fields = {
+    app::TxField::To, app::TxField::Value, app::TxField::Nonce, app::TxField::GasPrice, app::TxField::GasLimit
+  };
+  const std::array<const char*, 5> form_field_keys = {"toAddress", "amount", "nonce", "gasPrice", "gasLimit"};
+  app::Histogram& validation_latency = app::Metrics::shared().histogram("validation.form");
+  auto validate_form = [&]() {
+    app::ScopedLatency timer(validation_latency);
+    for (size_t i = 0; i < form_fields.size(); ++i) {
+      form_validator.update(form_fields[i], form_data[form_field_keys[i]]);
+    }
+  };
+  // Fields left empty fall back to their placeholders, so only text that
+  // was typed is flagged
+  auto form_error = [&](size_t i) -> std::string {
+    if (form_data[form_field_keys[i]].empty()) return "";
+    return form_validator.error(form_fields[i]);
+  };
+  
+  // The signer builds and encodes the transaction itself, so the part of
+  // signing that can start while the user reviews is bringing its session
+  // up (it may have exited since startup); editing makes it moot. A form
+  // with an error goes back to its first bad field instead.
+  auto review_transaction = [&]() {
+    validate_form();
+    for (size_t i = 0; i < form_fields.size(); ++i) {
+      if (form_error(i).empty()) continue;
+      navigate_to_screen(Screen::TRANSACTION_INPUT);
+      focused_element = static_cast<int>(i);
+      return;
+    }
+    navigate_to_screen(Screen::CONFIRMATION);
+    if (signer.running()) return;
+    executor.submit([&signer](const app::CancellationToken&) { signer.start(); }, nullptr,
+                    screen_tasks.token());
   };
   
-  // Execute TypeScript signing script
+  // Signed transactions are logged off the UI thread; once the log has
+  // outgrown its cap it is compacted by the same task
+  auto record_signed = [&](std::vector<app::TransactionHistory::Record> records) {
+    if (records.empty()) return;
+    executor.submit([&history, records = std::move(records)](const app::CancellationToken&) {
+      if (history.append(records) && history.needsCompaction()) history.compact();
+    });
+  };
+  
+  auto history_record = [](const app::SignRequest& request, std::optional<uint64_t> nonce,
+                           const app::SignResult& result) {
+    app::TransactionHistory::Record record;
+    record.chain_id = kBaseChainId;
+    record.nonce = nonce;
+    record.to = request.to;
+    record.amount = request.amount;
+    record.payload = result.payload;
+    return record;
+  };
+  
+  // [ steps back through the log from the newest record, ] forward again
+  // and past the newest back to the live result
+  auto step_history = [&](int step) {
+    if (!browsing_history) {
+      if (step > 0) return;
+      history_entries = history.recent(history.size());
+      if (history_entries.empty()) return;
+      browsing_history = true;
+      history_position = 0;
+      live_result = tx_hash;
+    } else if (step < 0) {
+      if (history_position + 1 >= history_entries.size()) return;
+      ++history_position;
+    } else if (history_position == 0) {
+      browsing_history = false;
+      history_entries.clear();
+      tx_hash = live_result;
+      return;
+    } else {
+      --history_position;
+    }
+    // Compaction may have dropped it since the list was read
+    auto payload = history.payload(history_entries[history_position].seq);
+    tx_hash = payload ? *payload : "Error: transaction " + std::to_string(history_entries[history_position].seq) +
+                                   " is no longer in the history log";
+  };
+  
+  auto stop_browsing_history = [&]() {
+    browsing_history = false;
+    history_entries.clear();
+    live_result.clear();
+  };
+  
+  // Send the form to the signing worker; leaving the screen cancels it
   auto execute_signing_script = [&]() {
     is_signing = true;
-    std::thread([&]() {
-      try {
-        // Build the command to execute the TypeScript script
-        std::string script_path = "/Users/kiki/Documents/ETHWARSAW_2025/base-os/signing-app";
-        std::string command = "cd " + script_path + " && npx ts-node eth-signer-cli.ts";
-        
-        // Add parameters from form data
-        if (!form_data["toAddress"].empty()) {
-          command += " --to " + form_data["toAddress"];
-        }
-        if (!form_data["amount"].empty()) {
-          command += " --amount " + form_data["amount"];
-        }
-        if (!form_data["nonce"].empty()) {
-          command += " --nonce " + form_data["nonce"];
-        }
-        // Add default chainId for Base (8453)
-        command += " --chainId 8453";
-        command += " --quiet";
-        
-        std::cout << "\n=== DEBUG: Executing TypeScript Signing Script ===" << std::endl;
-        std::cout << "Command: " << command << std::endl;
-        std::cout << "Working directory: " << script_path << std::endl;
-        std::cout << "Parameters:" << std::endl;
-        std::cout << "  --to: " << (form_data["toAddress"].empty() ? "(empty)" : form_data["toAddress"]) << std::endl;
-        std::cout << "  --amount: " << (form_data["amount"].empty() ? "(empty)" : form_data["amount"]) << std::endl;
-        std::cout << "  --nonce: " << (form_data["nonce"].empty() ? "(empty)" : form_data["nonce"]) << std::endl;
-        std::cout << "  --chainId: 8453" << std::endl;
-        std::cout << "  --quiet: true" << std::endl;
-        std::cout << "================================================" << std::endl;
-        
-        // Execute the command and capture output
-        std::string output = execCommand(command);
-        
+    batch_streamed = 0;
+    app::SignRequest request;
+    request.to = form_data["toAddress"];
+    request.amount = form_data["amount"];
+    request.nonce = form_data["nonce"];
+    request.chain_id = std::to_string(kBaseChainId);
+    
+    auto result = std::make_shared<app::SignResult>();
+    auto elapsed_ms = std::make_shared<long long>(0);
+    executor.submit(
+      [&signer, request, result, elapsed_ms](const app::CancellationToken& token) {
+        auto started = std::chrono::steady_clock::now();
+        *result = signer.sign(request, std::chrono::minutes(5), token);
+        *elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started).count();
+      },
+      [&, request, result, elapsed_ms]() {
         // Store the output as the transaction result
-        tx_hash = output;
+        tx_hash = result->ok ? result->payload : "Error executing signing script: " + result->payload;
+        stop_browsing_history();
+        if (result->ok) {
+          app::UnsignedTx parsed;
+          std::optional<uint64_t> nonce;
+          if (parsed.setNonceFromString(request.nonce)) nonce = parsed.nonce;
+          record_signed({history_record(request, nonce, *result)});
+        }
         
-        std::cout << "\n=== DEBUG: Script Output ===" << std::endl;
-        std::cout << "Output length: " << output.length() << " characters" << std::endl;
-        std::cout << "Output: " << output << std::endl;
-        std::cout << "=============================" << std::endl;
+        // Never the payload itself, and never stdout: the screen owns it
+        LOG_DEBUGF("Signer responded in {} ms with {} characters", *elapsed_ms, result->payload.length());
         
-      } catch (const std::exception& e) {
-        tx_hash = "Error executing signing script: " + std::string(e.what());
-        std::cout << "Error: " << e.what() << std::endl;
-      }
-      
-      is_signing = false;
-      navigate_to_screen(Screen::RESULT);
-    }).detach();
+        is_signing = false;
+        navigate_to_screen(Screen::RESULT);
+      },
+      screen_tasks.token());
+  };
+  
+  // Sign the whole batch over the running signer session. The worker has
+  // every request queued, so each one is waiting as soon as the device has
+  // confirmed the last; leaving the screen cancels the rest.
+  auto execute_batch_signing = [&]() {
+    is_signing = true;
+    batch_done = 0;
+    batch_signed = 0;
+    batch_failures.clear();
+    batch_streamed = 0;
+    std::vector<app::SignRequest> requests;
+    requests.reserve(batch->entries.size());
+    for (const auto& entry : batch->entries) requests.push_back(app::ToSignRequest(entry.tx));
+    
+    auto results = std::make_shared<std::vector<app::SignResult>>(requests.size());
+    executor.submit(
+      [&, requests = std::move(requests), results](const app::CancellationToken& token) {
+        signer.signBatch(requests, [&](size_t index, const app::SignResult& result) {
+          (*results)[index] = result;
+          if (result.ok) batch_signed++;
+          batch_done++;
+          if (ScreenInteractive* screen = active_screen.load()) screen->PostEvent(Event::Custom);
+        }, std::chrono::minutes(5), token);
+      },
+      [&, results]() {
+        std::vector<app::TransactionHistory::Record> signed_records;
+        for (size_t i = 0; i < results->size(); ++i) {
+          const app::UnsignedTx& tx = batch->entries[i].tx;
+          if ((*results)[i].ok) {
+            signed_records.push_back(history_record(app::ToSignRequest(tx), tx.nonce, (*results)[i]));
+            signed_records.back().chain_id = tx.chain_id;
+            continue;
+          }
+          batch_failures.push_back("line " + std::to_string(batch->entries[i].line) + ": " +
+                                   (*results)[i].payload);
+        }
+        record_signed(std::move(signed_records));
+        stop_browsing_history();
+        is_signing = false;
+        if (batch_signed > 0) {
+          // One stream for the whole run, which the broadcaster sends in
+          // nonce order; the fountain view copes best with a payload this size
+          tx_hash = app::CombineSignedTransactions(*results);
+          batch_streamed = batch_signed;
+          current_result_view = ResultView::QR_CODE_FOUNTAIN;
+          batch_pending = false;
+          navigate_to_screen(Screen::RESULT);
+        }
+      },
+      screen_tasks.token());
   };
   
   // Input components
@@ -383,7 +626,9 @@ int RunSimpleTransaction() {
     if (show_confirm_dialog) {
       if (event == Event::Character('y') || event == Event::Character('Y')) {
         if (confirm_dialog_message.find("quit") != std::string::npos) {
-          std::exit(0);
+          // Leave through the loop so the teardown below it, and main's
+          // trace and metrics output, run before anything is destroyed
+          if (ScreenInteractive* screen = active_screen.load()) screen->Exit();
         } else if (confirm_dialog_message.find("clear") != std::string::npos) {
           for (auto& pair : form_data) {
             pair.second = "";
@@ -410,6 +655,8 @@ int RunSimpleTransaction() {
         // Execute command
         if (command_buffer == "help" || command_buffer == "h") {
           show_help = !show_help;
+        } else if (command_buffer == "metrics" || command_buffer == "m") {
+          show_metrics = !show_metrics;
         } else if (command_buffer == "quit" || command_buffer == "q") {
           show_confirm_dialog = true;
           confirm_dialog_message = "Are you sure you want to quit?";
@@ -421,7 +668,7 @@ int RunSimpleTransaction() {
           go_back();
         } else if (command_buffer == "scan" || command_buffer == "usb") {
           if (current_screen == Screen::USB_CONTACTS) {
-            simulate_usb_scan();
+            start_usb_scan();
           }
         }
         command_mode = false;
@@ -493,15 +740,15 @@ int RunSimpleTransaction() {
             form_data["toAddress"] = contacts[selected_contact_index].address;
             navigate_to_screen(Screen::TRANSACTION_INPUT);
           } else if (!is_scanning) {
-            simulate_usb_scan();
+            start_usb_scan();
           }
           return true;
         case Screen::TRANSACTION_INPUT:
-          navigate_to_screen(Screen::CONFIRMATION);
+          review_transaction();
           return true;
         case Screen::CONFIRMATION:
           if (!is_signing) {
-            execute_signing_script();
+            batch_pending ? execute_batch_signing() : execute_signing_script();
           }
           return true;
         case Screen::RESULT:
@@ -512,6 +759,9 @@ int RunSimpleTransaction() {
           contacts.clear();
           selected_contact_index = -1;
           tx_hash = "";
+          batch_failures.clear();
+          batch_streamed = 0;
+          stop_browsing_history();
           navigation_history = {Screen::CONNECT_WALLET};
           navigate_to_screen(Screen::CONNECT_WALLET);
           return true;
@@ -538,8 +788,9 @@ int RunSimpleTransaction() {
       if (event == Event::Character('1')) { navigate_to_screen(Screen::CONNECT_WALLET); return true; }
       if (event == Event::Character('2')) { navigate_to_screen(Screen::USB_CONTACTS); return true; }
       if (event == Event::Character('3')) { navigate_to_screen(Screen::TRANSACTION_INPUT); return true; }
-      if (event == Event::Character('4')) { navigate_to_screen(Screen::CONFIRMATION); return true; }
+      if (event == Event::Character('4')) { review_transaction(); return true; }
       if (event == Event::Character('5')) { navigate_to_screen(Screen::RESULT); return true; }
+      if (event == Event::Character('m')) { show_metrics = !show_metrics; return true; }
     } else {
       // When in input fields, let the input components handle character events
       return false;
@@ -549,8 +800,10 @@ int RunSimpleTransaction() {
       if (event == Event::ArrowLeft || event == Event::Character('h')) {
         if (current_result_view == ResultView::QR_CODE_UNCOMPRESSED) {
           current_result_view = ResultView::QR_CODE_COMPRESSED;
-        } else if (current_result_view == ResultView::TX_DATA) {
+        } else if (current_result_view == ResultView::QR_CODE_FOUNTAIN) {
           current_result_view = ResultView::QR_CODE_UNCOMPRESSED;
+        } else if (current_result_view == ResultView::TX_DATA) {
+          current_result_view = ResultView::QR_CODE_FOUNTAIN;
         }
         return true;
       }
@@ -558,10 +811,14 @@ int RunSimpleTransaction() {
         if (current_result_view == ResultView::QR_CODE_COMPRESSED) {
           current_result_view = ResultView::QR_CODE_UNCOMPRESSED;
         } else if (current_result_view == ResultView::QR_CODE_UNCOMPRESSED) {
+          current_result_view = ResultView::QR_CODE_FOUNTAIN;
+        } else if (current_result_view == ResultView::QR_CODE_FOUNTAIN) {
           current_result_view = ResultView::TX_DATA;
         }
         return true;
       }
+      if (event == Event::Character('[')) { step_history(-1); return true; }
+      if (event == Event::Character(']')) { step_history(1); return true; }
     }
     
     // USB contacts navigation
@@ -597,7 +854,7 @@ int RunSimpleTransaction() {
     
     // USB scan shortcut
     if (event == Event::Character('u') && current_screen == Screen::USB_CONTACTS) {
-      simulate_usb_scan();
+      start_usb_scan();
       return true;
     }
     
@@ -607,24 +864,24 @@ int RunSimpleTransaction() {
   // Monitor address input for autocomplete
   to_address_input = to_address_input | CatchEvent([&](Event event) {
     if (event.is_character() || event == Event::Backspace) {
-      // Delay filtering to allow input to update
-      std::thread([&]() {
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        filter_addresses(form_data["toAddress"]);
-      }).detach();
+      // Filter once the input has taken the key, and only after typing
+      // pauses: each keystroke replaces the pending run
+      autocomplete_debounce.reset();
+      executor.submitAfter(std::chrono::milliseconds(50), nullptr,
+                           [&] { filter_addresses(form_data["toAddress"]); },
+                           autocomplete_debounce.token());
     }
     return false;
   });
   
+  app::Histogram& render_latency = app::Metrics::shared().histogram("ui.render");
   auto renderer = Renderer(main_component, [&] {
+    app::ScopedLatency frame_timer(render_latency);
     // Build screen content based on current screen
     Element content;
     
     switch (current_screen) {
       case Screen::CONNECT_WALLET: {
-        // Initialize wallet detection when on this screen
-        setup_wallet_detection();
-        
         // Determine status color and icon
         Color status_color = Color::Red;
         std::string status_icon = "❌";
@@ -675,7 +932,7 @@ int RunSimpleTransaction() {
       }
         
       case Screen::USB_CONTACTS:
-        if (is_scanning) {
+        if (is_scanning && contacts.empty()) {
           content = vbox({
             text("") | center,
             text("[SCAN]") | center | size(HEIGHT, EQUAL, 3),
@@ -727,7 +984,8 @@ int RunSimpleTransaction() {
             text("[CONTACTS] USB Contacts Manager") | bold | center | color(Color::Blue),
             separator(),
             text(""),
-            text("Found " + std::to_string(contacts.size()) + " contacts • Use j/k or ↓↑ to navigate • Enter to select") | center | dim,
+            text((is_scanning ? "Scanning... found " : "Found ") + std::to_string(contacts.size()) +
+                 " contacts • Use j/k or ↓↑ to navigate • Enter to select") | center | dim,
             text(""),
             vbox(contact_list) | border | size(HEIGHT, LESS_THAN, 15),
             text(""),
@@ -752,6 +1010,7 @@ int RunSimpleTransaction() {
         
         // Create styled form elements with proper component structure
         Elements form_elements;
+        validate_form();
         
         for (size_t i = 0; i < field_labels.size(); i++) {
           bool is_focused = focused_element == (int)i;
@@ -764,6 +1023,10 @@ int RunSimpleTransaction() {
           });
           
           form_elements.push_back(field_element);
+          std::string error = form_error(i);
+          if (!error.empty()) {
+            form_elements.push_back(hbox({text("") | size(WIDTH, EQUAL, 22), text(error) | color(Color::Red)}));
+          }
           if (i < field_labels.size() - 1) {
             form_elements.push_back(text(""));
           }
@@ -774,10 +1037,10 @@ int RunSimpleTransaction() {
         // Add autocomplete dropdown
         Elements autocomplete_elements;
         if (show_autocomplete && focused_element == 0 && !autocomplete_results.empty()) {
-          autocomplete_elements.push_back(text("Suggestions (" + std::to_string(autocomplete_results.size()) + " matches):") | 
+          autocomplete_elements.push_back(text("Suggestions (" + std::to_string(autocomplete_match_count) + " matches):") | 
                                         color(Color::Yellow) | bold);
           
-          for (size_t i = 0; i < std::min((size_t)5, autocomplete_results.size()); i++) {
+          for (size_t i = 0; i < autocomplete_results.size(); i++) {
             const auto& result = autocomplete_results[i];
             bool is_highlighted = (int)i == autocomplete_index;
             
@@ -822,9 +1085,72 @@ int RunSimpleTransaction() {
       }
         
       case Screen::CONFIRMATION:
-        if (is_signing) {
+        if (batch_pending) {
+          size_t total = batch->entries.size();
+          if (is_signing) {
+            size_t done = batch_done;
+            content = vbox({
+              text("") | center,
+              text("[SIGN] Signing Batch") | bold | center | color(Color::Magenta),
+              text("") | center,
+              text(std::to_string(done) + " of " + std::to_string(total) + " answered, " +
+                   std::to_string(batch_signed.load()) + " signed") | center,
+              gauge(total ? static_cast<float>(done) / total : 0.0f) | color(Color::Green) | border,
+              text("") | center,
+              text("[DEVICE] Confirm each transaction on the Ledger as it appears") | center | color(Color::Yellow),
+              text("Please wait, do not close the application") | center | dim
+            });
+            break;
+          }
+          
+          // The first rows of the file, then the totals
+          constexpr size_t kPreviewRows = 8;
+          Elements rows;
+          for (size_t i = 0; i < total && i < kPreviewRows; ++i) {
+            const auto& tx = batch->entries[i].tx;
+            rows.push_back(hbox({
+              text("#" + std::to_string(*tx.nonce)) | size(WIDTH, EQUAL, 8) | color(Color::Green),
+              text(tx.to) | size(WIDTH, EQUAL, 44) | color(Color::Cyan),
+              text(tx.value->toUnits(18) + " ETH") | color(Color::Yellow)
+            }));
+          }
+          if (total > kPreviewRows) {
+            rows.push_back(text("... " + std::to_string(total - kPreviewRows) + " more") | dim);
+          }
+          auto sum = batch->totalValue();
+          Elements failures;
+          for (const auto& failure : batch_failures) failures.push_back(text(failure) | color(Color::Red));
+          
+          content = vbox({
+            text("[REVIEW] Review Batch") | bold | center | color(Color::Blue),
+            separator(),
+            text(""),
+            hbox({
+              text("Transfers: ") | size(WIDTH, EQUAL, 15) | bold,
+              text(std::to_string(total)) | color(Color::Cyan)
+            }),
+            hbox({
+              text("Nonces: ") | size(WIDTH, EQUAL, 15) | bold,
+              text(std::to_string(*batch->entries.front().tx.nonce) + " - " +
+                   std::to_string(*batch->entries.back().tx.nonce)) | color(Color::Green)
+            }),
+            hbox({
+              text("Total Amount: ") | size(WIDTH, EQUAL, 15) | bold,
+              text(sum ? sum->toUnits(18) + " ETH" : "overflow") | color(Color::Red) | bold
+            }),
+            separator(),
+            vbox(std::move(rows)),
+            failures.empty() ? text("") : vbox(std::move(failures)) | border,
+            text(""),
+            text("[WARNING] Each transfer is shown on the device; check it before approving") | center | color(Color::Yellow),
+            text(""),
+            hbox({
+              text("[Enter] Sign All " + std::to_string(total)) | color(Color::Green)
+            }) | center
+          });
+        } else if (is_signing) {
           // Build the command string for display
-          std::string display_command = "npx ts-node eth-signer-cli.ts";
+          std::string display_command = "sign";
           if (!form_data["toAddress"].empty()) {
             display_command += " --to " + form_data["toAddress"];
           }
@@ -834,19 +1160,19 @@ int RunSimpleTransaction() {
           if (!form_data["nonce"].empty()) {
             display_command += " --nonce " + form_data["nonce"];
           }
-          display_command += " --chainId 8453 --quiet";
+          display_command += " --chainId 8453";
           
           content = vbox({
             text("") | center,
             text("[SIGN]") | center | size(HEIGHT, EQUAL, 3),
             text("Executing Signing Script...") | bold | center | color(Color::Magenta),
             text("") | center,
-            text("[WAIT] Running TypeScript signing script...") | center | color(Color::Yellow),
+            text("[WAIT] Waiting for the signing worker...") | center | color(Color::Yellow),
             text("[SECURE] Connecting to Ledger device") | center | color(Color::Green),
             text("") | center,
             text("Please wait, do not close the application") | center | dim,
             text("") | center,
-            text("Command: " + display_command) | center | dim | color(Color::Cyan),
+            text("Request: " + display_command) | center | dim | color(Color::Cyan),
             text("") | center,
             text("Awaiting device confirmation...") | center | dim
           });
@@ -923,26 +1249,50 @@ int RunSimpleTransaction() {
         // QR CODE GENERATION - Using Nayuki QR Code Generator (MIT Licensed)
         // ============================================================================
         
-        // Generate QR codes for both compressed and uncompressed data
-        std::string compressed_data = compressData(qr_payload_data);
-        app::QRCode qr_compressed = app::GenerateQR(compressed_data);
-        app::QRCode qr_uncompressed = app::GenerateQR(qr_payload_data);
+        // Symbols are encoded on first draw and then served from the render
+        // cache, so redraws don't re-run compression or encoding
+        if (compressed_source != qr_payload_data || compressed_data.empty()) {
+          compressed_data = app::CompressPayload(qr_payload_data);
+          compressed_source = qr_payload_data;
+        }
         
         Element view_element;
         if (current_result_view == ResultView::QR_CODE_COMPRESSED) {
           view_element = vbox({
             text("Compressed QR Code") | bold | center | color(Color::Yellow),
             text("Size: " + std::to_string(compressed_data.length()) + " chars") | center | dim,
-            ResponsiveQrCode(qr_compressed) | flex
+            ResponsiveQrCode(compressed_data) | flex
           });
         } else if (current_result_view == ResultView::QR_CODE_UNCOMPRESSED) {
           view_element = vbox({
             text("Uncompressed QR Code") | bold | center | color(Color::Green),
             text("Size: " + std::to_string(qr_payload_data.length()) + " chars") | center | dim,
-            ResponsiveQrCode(qr_uncompressed) | flex
+            ResponsiveQrCode(qr_payload_data) | flex
+          });
+        } else if (current_result_view == ResultView::QR_CODE_FOUNTAIN) {
+          // Rebuild the encoder only when the payload changes
+          if (!fountain_encoder || fountain_payload != qr_payload_data) {
+            app::QRPlanOptions fountain_options;
+            fountain_options.fast_mask = true;  // A new frame every 100-250 ms
+            fountain_encoder = std::make_unique<app::FountainEncoder>(qr_payload_data, fountain_options);
+            fountain_payload = qr_payload_data;
+            fountain_seq = 1;
+          }
+          redraw.requestAnimationFrame();
+          
+          uint32_t seq = fountain_seq;
+          view_element = vbox({
+            text("Animated Fountain QR Code") | bold | center | color(Color::Magenta),
+            text("Frame " + std::to_string(seq) + " • " + std::to_string(fountain_encoder->fragmentCount()) +
+                 " fragments • keep scanning until the phone completes") | center | dim,
+            ResponsiveQrCode(fountain_encoder->frame(seq), {"fountain/fast-mask", [&fountain_encoder, seq] {
+              return fountain_encoder->qr(seq);
+            }}) | flex
           });
         } else {
           // Display the actual script output
+          int modules = app::QRRenderCache::shared().get(qr_payload_data, 0, 0,
+                                                         app::QRRenderStyle::HalfBlock)->modules;
           std::string display_output = tx_hash;
           if (display_output.length() > 200) {
             display_output = display_output.substr(0, 197) + "...";
@@ -956,20 +1306,46 @@ int RunSimpleTransaction() {
             text(""),
             text("Compressed Size: " + std::to_string(compressed_data.length()) + " characters"),
             text("Uncompressed Size: " + std::to_string(qr_payload_data.length()) + " characters"),
-            text("QR Code Modules: " + std::to_string(qr_uncompressed.size) + "x" + std::to_string(qr_uncompressed.size)),
+            text("QR Code Modules: " + std::to_string(modules) + "x" + std::to_string(modules)),
           }) | center;
         }
 
         auto qr_compressed_tab = text(" [1] Compressed QR ") | (current_result_view == ResultView::QR_CODE_COMPRESSED ? bgcolor(Color::Yellow) | color(Color::Black) : color(Color::GrayDark));
         auto qr_uncompressed_tab = text(" [2] Uncompressed QR ") | (current_result_view == ResultView::QR_CODE_UNCOMPRESSED ? bgcolor(Color::Green) | color(Color::Black) : color(Color::GrayDark));
-        auto data_tab = text(" [3] Raw Data ") | (current_result_view == ResultView::TX_DATA ? bgcolor(Color::Cyan) | color(Color::Black) : color(Color::GrayDark));
+        auto qr_fountain_tab = text(" [3] Animated QR ") | (current_result_view == ResultView::QR_CODE_FOUNTAIN ? bgcolor(Color::Magenta) | color(Color::Black) : color(Color::GrayDark));
+        auto data_tab = text(" [4] Raw Data ") | (current_result_view == ResultView::TX_DATA ? bgcolor(Color::Cyan) | color(Color::Black) : color(Color::GrayDark));
 
+        Element note = text("");
+        if (browsing_history) {
+          const auto& past = history_entries[history_position];
+          note = text("Past transaction " + std::to_string(history_position + 1) + "/" +
+                      std::to_string(history_entries.size()) + " • " + format_timestamp(past.timestamp_ms) +
+                      " • nonce " + (past.nonce ? std::to_string(*past.nonce) : "-") + " • " +
+                      (past.amount.empty() ? "-" : past.amount) + " ETH to " + (past.to.empty() ? "-" : past.to)) |
+                 center | color(Color::Cyan);
+        } else if (batch_streamed > 0) {
+          const auto& entries = batch->entries;
+          note = text("Batch of " + std::to_string(batch_streamed) + " signed transfer(s), nonces " +
+                      std::to_string(*entries.front().tx.nonce) + " - " +
+                      std::to_string(*entries[batch_streamed - 1].tx.nonce) + ", in one stream") |
+                 center | color(Color::Cyan);
+        }
+        if (!browsing_history && !batch_failures.empty()) {
+          note = vbox({
+            note,
+            text("Signing stopped at " + batch_failures.front() + "; " +
+                 std::to_string(batch_failures.size()) + " transfer(s) from there on were not signed") |
+                center | color(Color::Red)
+          });
+        }
+        
         content = vbox({
-          text("🎉 TRANSACTION SIGNED SUCCESSFULLY 🎉") | bold | center | color(Color::Green),
+          text(browsing_history ? "📜 TRANSACTION HISTORY" : "🎉 TRANSACTION SIGNED SUCCESSFULLY 🎉") | bold | center | color(Color::Green),
           separator(),
-          hbox({qr_compressed_tab, qr_uncompressed_tab, data_tab}) | center,
+          hbox({qr_compressed_tab, qr_uncompressed_tab, qr_fountain_tab, data_tab}) | center,
           view_element | flex | border,
-          text("←/→ to switch view  |  [Enter] Sign Another  |  [q] Quit") | center | color(Color::Yellow)
+          note,
+          text("←/→ to switch view  |  [/] Past transactions  |  [Enter] Sign Another  |  [q] Quit") | center | color(Color::Yellow)
         });
 
         // Handle error case by overriding the content if there's an error
@@ -1058,13 +1434,41 @@ int RunSimpleTransaction() {
             text("g : Go to first screen"),
             text("q/r : Quit/Restart"),
             text(": : Command mode"),
+            text("m : Toggle metrics"),
             text("?/F1 : Toggle help")
           })
         }),
-        text("Commands: help, quit, next, prev/back, clear, sign, home, 1-5") | dim
+        text("Commands: help, metrics, quit, next, prev/back, clear, sign, home, 1-5") | dim
       }) | border | color(Color::Blue));
     }
     
+    // Metrics panel, read fresh each frame
+    if (show_metrics) {
+      auto metrics = app::Metrics::shared().snapshot();
+      auto cell = [](const std::string& value, int width) {
+        return text(value) | size(WIDTH, EQUAL, width);
+      };
+      Elements metric_rows;
+      metric_rows.push_back(text("Metrics:") | bold | color(Color::Blue));
+      metric_rows.push_back(hbox({
+        cell("Latency", 24), cell("count", 8), cell("p50", 9), cell("p99", 9), cell("max", 9)
+      }) | dim);
+      for (const auto& [name, h] : metrics.histograms) {
+        if (h.count == 0) continue;
+        metric_rows.push_back(hbox({
+          cell(name, 24),
+          cell(std::to_string(h.count), 8),
+          cell(app::FormatNanoseconds(h.percentileNs(50)), 9),
+          cell(app::FormatNanoseconds(h.percentileNs(99)), 9),
+          cell(app::FormatNanoseconds(h.max_ns), 9)
+        }));
+      }
+      for (const auto& [name, value] : metrics.counters) {
+        metric_rows.push_back(hbox({cell(name, 24), cell(std::to_string(value), 8)}));
+      }
+      ui_elements.push_back(vbox(std::move(metric_rows)) | border | color(Color::Blue));
+    }
+    
     // Confirmation dialog
     if (show_confirm_dialog) {
       ui_elements.push_back(vbox({
@@ -1086,11 +1490,32 @@ int RunSimpleTransaction() {
     }
     ui_elements.push_back(text(footer_text) | center | dim | color(Color::Green));
     
+    redraw.frameRendered();
+    
+    // Tasks posted from here run once this frame has been flushed
+    ScreenInteractive* screen = active_screen.load();
+    if (screen && qr_overlay.active()) {
+      screen->Post([&qr_overlay] { qr_overlay.present(); });
+    }
+    if (!first_frame_drawn && screen) {
+      first_frame_drawn = true;
+      screen->Post(start_deferred_init);
+    }
+    
     return vbox(ui_elements) | size(WIDTH, EQUAL, Terminal::Size().dimx) | size(HEIGHT, EQUAL, Terminal::Size().dimy);
   });
   
   auto screen = ScreenInteractive::Fullscreen();
+  active_screen = &screen;
+  app::StartupTrace::instance().mark("ui_ready");
   screen.Loop(renderer);
   
+  screen_tasks.cancel();
+  executor.shutdown();
+  if (wallet_detector) wallet_detector->stopDetection();
+  usb_scanner.reset();  // joins scan threads before active_screen goes away
+  redraw.stop();
+  active_screen = nullptr;
+  
   return 0;
 }
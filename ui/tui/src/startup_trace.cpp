@@ -0,0 +1,83 @@
+#include "app/startup_trace.hpp"
+#include "app/logger.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+namespace app {
+
+namespace {
+
+// Taken during static initialisation, before main() runs
+const StartupTrace::Clock::time_point kProcessStart = StartupTrace::Clock::now();
+
+double Milliseconds(StartupTrace::Clock::duration d) {
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+
+} // namespace
+
+StartupTrace& StartupTrace::instance() {
+  static StartupTrace trace;
+  return trace;
+}
+
+void StartupTrace::mark(const char* phase) noexcept {
+  if (!enabled()) return;
+  record(phase, Clock::now(), Clock::duration::zero());
+}
+
+void StartupTrace::phase(const char* name, Clock::time_point started) noexcept {
+  if (!enabled()) return;
+  auto now = Clock::now();
+  record(name, now, now - started);
+}
+
+void StartupTrace::record(const char* phase, Clock::time_point at, Clock::duration duration) noexcept {
+  try {
+    std::lock_guard<std::mutex> lock(mutex_);
+    marks_.push_back({phase ? phase : "", at, duration, std::this_thread::get_id()});
+  } catch (...) {
+    // A lost mark only makes the report shorter
+  }
+}
+
+std::string StartupTrace::report() const {
+  std::vector<Mark> marks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    marks = marks_;
+  }
+  std::stable_sort(marks.begin(), marks.end(),
+                   [](const Mark& a, const Mark& b) { return a.at < b.at; });
+
+  std::string out = "Startup trace (ms since process start):\n";
+  auto previous = kProcessStart;
+  char line[160];
+  for (const auto& mark : marks) {
+    int length = std::snprintf(line, sizeof(line), "  %9.3f  +%8.3f  %-24s %s",
+                               Milliseconds(mark.at - kProcessStart), Milliseconds(mark.at - previous),
+                               mark.phase.c_str(), mark.thread == main_thread_ ? "main" : "background");
+    if (length > 0) out.append(line, std::min<size_t>(static_cast<size_t>(length), sizeof(line) - 1));
+    if (mark.duration != Clock::duration::zero()) {
+      length = std::snprintf(line, sizeof(line), "  (took %.3f)", Milliseconds(mark.duration));
+      if (length > 0) out.append(line, std::min<size_t>(static_cast<size_t>(length), sizeof(line) - 1));
+    }
+    out += '\n';
+    previous = mark.at;
+  }
+  return out;
+}
+
+void StartupTrace::dump() noexcept {
+  if (!enabled()) return;
+  try {
+    std::string text = report();
+    std::cerr << text << std::flush;
+    LOG_INFO(text);
+  } catch (const std::exception& e) {
+    LOG_EXCEPTION(e, "StartupTrace::dump");
+  }
+}
+
+} // namespace app
@@ -1,15 +1,30 @@
 #include "app/state.hpp"
+#include "app/address_book_file.hpp"
 #include "app/config.hpp"
 #include "app/logger.hpp"
 #include "app/validation.hpp"
+#include "app/text_scan.hpp"
 #include <algorithm>
-#include <regex>
 #include <limits>
 #include <chrono>
 #include <iostream>
 
 namespace app {
 
+namespace {
+
+// Batch EIP-55 check over a whole address list
+bool passChecksums(const std::vector<KnownAddress>& entries) {
+    std::vector<std::string> addresses;
+    addresses.reserve(entries.size());
+    for (const auto& entry : entries) addresses.push_back(entry.address);
+    
+    auto results = Validator::passChecksums(addresses);
+    return std::all_of(results.begin(), results.end(), [](bool ok) { return ok; });
+}
+
+} // namespace
+
 // KnownAddress implementation
 bool KnownAddress::isValid() const noexcept {
     try {
@@ -40,16 +55,27 @@ std::optional<KnownAddress> KnownAddress::create(const std::string& address,
 }
 
 // UnsignedTx implementation
+namespace {
+
+// Fees are entered in Gwei and stored in Wei
+bool SetGweiAmount(std::optional<U256>& field, const std::string& gwei_str) {
+    auto wei = U256::fromUnits(gwei_str, kGweiDecimals);
+    if (!wei || *wei > U256(ValidationLimits::MAX_GAS_PRICE)) {
+        return false;
+    }
+    field = wei;
+    return true;
+}
+
+} // namespace
+
 bool UnsignedTx::isValid() const noexcept {
     try {
         return !to.empty() && 
                IsAddress(to) &&
-               !value.empty() && 
-               IsNumeric(value) &&
-               !nonce.empty() && 
-               IsNumeric(nonce) &&
-               !gas_limit.empty() && 
-               IsNumeric(gas_limit) &&
+               value.has_value() &&
+               nonce.has_value() &&
+               gas_limit.has_value() &&
                chain_id > 0 &&
                (type == 0 || type == 2) &&
                data.size() <= 1000000; // Reasonable data size limit
@@ -68,43 +94,20 @@ std::vector<std::string> UnsignedTx::getValidationErrors() const noexcept {
             errors.push_back("Invalid recipient address format");
         }
         
-        if (value.empty()) {
+        if (!value) {
             errors.push_back("Transaction value is required");
-        } else if (!IsNumeric(value)) {
-            errors.push_back("Transaction value must be numeric");
-        } else {
-            // Check for reasonable value limits
-            try {
-                auto val = std::stoull(value);
-                if (val > std::numeric_limits<uint64_t>::max() / 2) {
-                    errors.push_back("Transaction value is too large");
-                }
-            } catch (...) {
-                errors.push_back("Transaction value is invalid");
-            }
         }
         
-        if (nonce.empty()) {
+        if (!nonce) {
             errors.push_back("Transaction nonce is required");
-        } else if (!IsNumeric(nonce)) {
-            errors.push_back("Nonce must be numeric");
         }
         
-        if (gas_limit.empty()) {
+        if (!gas_limit) {
             errors.push_back("Gas limit is required");
-        } else if (!IsNumeric(gas_limit)) {
-            errors.push_back("Gas limit must be numeric");
-        } else {
-            try {
-                auto gas = std::stoull(gas_limit);
-                if (gas < 21000) {
-                    errors.push_back("Gas limit too low (minimum 21000)");
-                } else if (gas > 30000000) {
-                    errors.push_back("Gas limit too high (maximum 30M)");
-                }
-            } catch (...) {
-                errors.push_back("Gas limit value is invalid");
-            }
+        } else if (*gas_limit < ValidationLimits::MIN_GAS_LIMIT) {
+            errors.push_back("Gas limit too low (minimum 21000)");
+        } else if (*gas_limit > ValidationLimits::MAX_GAS_LIMIT) {
+            errors.push_back("Gas limit too high (maximum 30M)");
         }
         
         if (chain_id <= 0) {
@@ -116,14 +119,14 @@ std::vector<std::string> UnsignedTx::getValidationErrors() const noexcept {
         }
         
         if (isEIP1559()) {
-            if (max_fee_per_gas.empty() || !IsNumeric(max_fee_per_gas)) {
+            if (!max_fee_per_gas) {
                 errors.push_back("Max fee per gas is required for EIP-1559");
             }
-            if (max_priority_fee_per_gas.empty() || !IsNumeric(max_priority_fee_per_gas)) {
+            if (!max_priority_fee_per_gas) {
                 errors.push_back("Priority fee is required for EIP-1559");
             }
         } else {
-            if (gas_price.empty() || !IsNumeric(gas_price)) {
+            if (!gas_price) {
                 errors.push_back("Gas price is required for legacy transactions");
             }
         }
@@ -145,17 +148,26 @@ std::vector<std::string> UnsignedTx::getValidationErrors() const noexcept {
 
 bool UnsignedTx::setValueFromString(const std::string& value_str) noexcept {
     try {
-        if (value_str.empty() || !IsNumeric(value_str)) {
+        auto wei = U256::fromString(value_str);
+        if (!wei) {
             return false;
         }
         
-        // Check for overflow
-        auto val = std::stoull(value_str);
-        if (val > std::numeric_limits<uint64_t>::max() / 2) {
+        value = wei;
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool UnsignedTx::setValueFromEth(const std::string& eth_str) noexcept {
+    try {
+        auto wei = U256::fromUnits(eth_str, kEtherDecimals);
+        if (!wei) {
             return false;
         }
         
-        value = value_str;
+        value = wei;
         return true;
     } catch (...) {
         return false;
@@ -164,16 +176,12 @@ bool UnsignedTx::setValueFromString(const std::string& value_str) noexcept {
 
 bool UnsignedTx::setNonceFromString(const std::string& nonce_str) noexcept {
     try {
-        if (nonce_str.empty() || !IsNumeric(nonce_str)) {
-            return false;
-        }
-        
-        auto nonce_val = std::stoull(nonce_str);
-        if (nonce_val > std::numeric_limits<uint32_t>::max()) {
+        auto parsed = U256::fromDecimal(nonce_str);
+        if (!parsed || *parsed > U256(ValidationLimits::MAX_NONCE)) {
             return false;
         }
         
-        nonce = nonce_str;
+        nonce = parsed->low64();
         return true;
     } catch (...) {
         return false;
@@ -182,40 +190,128 @@ bool UnsignedTx::setNonceFromString(const std::string& nonce_str) noexcept {
 
 bool UnsignedTx::setGasLimitFromString(const std::string& gas_limit_str) noexcept {
     try {
-        if (gas_limit_str.empty() || !IsNumeric(gas_limit_str)) {
-            return false;
-        }
-        
-        auto gas = std::stoull(gas_limit_str);
-        if (gas < 21000 || gas > 30000000) {
+        auto gas = U256::fromDecimal(gas_limit_str);
+        if (!gas || *gas < U256(ValidationLimits::MIN_GAS_LIMIT) ||
+            *gas > U256(ValidationLimits::MAX_GAS_LIMIT)) {
             return false;
         }
         
-        gas_limit = gas_limit_str;
+        gas_limit = gas->low64();
         return true;
     } catch (...) {
         return false;
     }
 }
 
+bool UnsignedTx::setGasPriceFromGwei(const std::string& gwei_str) noexcept {
+    try {
+        return SetGweiAmount(gas_price, gwei_str);
+    } catch (...) {
+        return false;
+    }
+}
+
+bool UnsignedTx::setMaxFeeFromGwei(const std::string& gwei_str) noexcept {
+    try {
+        return SetGweiAmount(max_fee_per_gas, gwei_str);
+    } catch (...) {
+        return false;
+    }
+}
+
+bool UnsignedTx::setPriorityFeeFromGwei(const std::string& gwei_str) noexcept {
+    try {
+        return SetGweiAmount(max_priority_fee_per_gas, gwei_str);
+    } catch (...) {
+        return false;
+    }
+}
+
 UnsignedTx UnsignedTx::createFromDefaults(int chain_id, bool use_eip1559) noexcept {
     UnsignedTx tx;
     tx.chain_id = chain_id;
     tx.type = use_eip1559 ? 2 : 0;
-    tx.gas_limit = "21000";
+    tx.gas_limit = 21000;
     tx.data = "0x";
     
     if (use_eip1559) {
-        tx.max_fee_per_gas = "50";
-        tx.max_priority_fee_per_gas = "2";
+        tx.setMaxFeeFromGwei("50");
+        tx.setPriorityFeeFromGwei("2");
     } else {
-        tx.gas_price = "20";
+        tx.setGasPriceFromGwei("20");
     }
     
     return tx;
 }
 
 // AppState implementation
+AppState::AppState() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    publishLocked();
+}
+
+namespace {
+
+// The previous snapshot's copy of a collection, or a new copy if it changed
+template <typename T>
+std::shared_ptr<const T> ShareOrCopy(const T& field, const std::shared_ptr<const T>& previous, bool& changed) {
+    if (previous && !changed) {
+        return previous;
+    }
+    changed = false;
+    return std::make_shared<const T>(field);
+}
+
+} // namespace
+
+void AppState::publishLocked() {
+    auto next = std::make_shared<Snapshot>();
+    next->version = version_.load(std::memory_order_relaxed) + 1;
+    next->route = route;
+    next->previous_route = previous_route;
+    next->unsigned_tx = unsigned_tx;
+    next->signed_hex = signed_hex;
+    next->status = status;
+    next->error = error;
+    next->info = info;
+    next->last_error = last_error;
+    next->account_path = account_path;
+    next->address_suggestion = address_suggestion;
+    next->network_name = network_name;
+    next->address_book = address_book_;
+
+    const Snapshot* previous = snapshot_.get();
+    if (known_addresses_changed_ || !previous) {
+        auto index = std::make_shared<AddressIndex>();
+        for (size_t i = 0; i < known_addresses.size(); ++i) {
+            index->insert(i, known_addresses[i].address, known_addresses[i].name);
+        }
+        next->known_address_index = std::move(index);
+    } else {
+        next->known_address_index = previous->known_address_index;
+    }
+    next->devices = ShareOrCopy(devices, previous ? previous->devices : nullptr, devices_changed_);
+    next->known_addresses = ShareOrCopy(known_addresses, previous ? previous->known_addresses : nullptr,
+                                        known_addresses_changed_);
+    next->usb_contacts = ShareOrCopy(usb_contacts, previous ? previous->usb_contacts : nullptr,
+                                     usb_contacts_changed_);
+    next->field_errors = ShareOrCopy(field_errors, previous ? previous->field_errors : nullptr,
+                                     field_errors_changed_);
+
+    uint64_t version = next->version;
+    std::atomic_store_explicit(&snapshot_, std::shared_ptr<const Snapshot>(std::move(next)),
+                               std::memory_order_release);
+    version_.store(version, std::memory_order_release);
+
+    for (const auto& callback : change_callbacks_) {
+        try {
+            callback(version);
+        } catch (...) {
+            // Ignore callback errors
+        }
+    }
+}
+
 bool AppState::setRoute(Route new_route) noexcept {
     try {
         std::lock_guard<std::mutex> lock(mutex_);
@@ -223,6 +319,7 @@ bool AppState::setRoute(Route new_route) noexcept {
         Route old_route = route;
         previous_route = route;
         route = new_route;
+        publishLocked();
         
         // Notify callbacks
         for (const auto& callback : route_change_callbacks_) {
@@ -253,6 +350,7 @@ bool AppState::setUnsignedTx(const UnsignedTx& tx) noexcept {
         std::lock_guard<std::mutex> lock(mutex_);
         unsigned_tx = tx;
         has_unsigned.store(true);
+        publishLocked();
         
         LOG_DEBUG("Transaction set successfully");
         return true;
@@ -277,6 +375,7 @@ bool AppState::setSignedHex(const std::string& hex) noexcept {
         std::lock_guard<std::mutex> lock(mutex_);
         signed_hex = hex;
         has_signed.store(true);
+        publishLocked();
         
         LOG_INFO("Signed transaction set successfully");
         return true;
@@ -290,6 +389,7 @@ void AppState::setStatus(const std::string& status_str) noexcept {
     try {
         std::lock_guard<std::mutex> lock(mutex_);
         status = status_str.substr(0, 1000);  // Limit length
+        publishLocked();
         LOG_DEBUG("Status updated: " + status);
     } catch (...) {
         LOG_ERROR("Failed to set status");
@@ -303,6 +403,7 @@ void AppState::setError(const std::string& error_str) noexcept {
         last_error = error;
         last_error_time_ = std::chrono::system_clock::now();
         error_count_++;
+        publishLocked();
         
         // Notify error callbacks
         for (const auto& callback : error_callbacks_) {
@@ -328,6 +429,7 @@ void AppState::setInfo(const std::string& info_str) noexcept {
     try {
         std::lock_guard<std::mutex> lock(mutex_);
         info = info_str.substr(0, 1000);  // Limit length
+        publishLocked();
         LOG_INFO("Info message: " + info);
     } catch (...) {
         LOG_ERROR("Failed to set info message");
@@ -352,6 +454,8 @@ bool AppState::setDevices(const std::vector<DeviceInfo>& device_list) noexcept {
         
         std::lock_guard<std::mutex> lock(mutex_);
         devices = device_list;
+        devices_changed_ = true;
+        publishLocked();
         
         LOG_INFO("Device list updated with " + std::to_string(device_list.size()) + " devices");
         return true;
@@ -368,6 +472,11 @@ bool AppState::addKnownAddress(const KnownAddress& address) noexcept {
             return false;
         }
         
+        if (!Validator::passesChecksum(address.address)) {
+            LOG_WARN("Attempted to add address with invalid EIP-55 checksum");
+            return false;
+        }
+        
         std::lock_guard<std::mutex> lock(mutex_);
         
         // Check for duplicates
@@ -387,6 +496,8 @@ bool AppState::addKnownAddress(const KnownAddress& address) noexcept {
         
         known_addresses.push_back(address);
         std::sort(known_addresses.begin(), known_addresses.end());
+        known_addresses_changed_ = true;
+        publishLocked();
         
         LOG_INFO("Added address to address book: " + address.name);
         return true;
@@ -413,9 +524,16 @@ bool AppState::setKnownAddresses(const std::vector<KnownAddress>& addresses) noe
             return false;
         }
         
+        if (!passChecksums(addresses)) {
+            LOG_WARN("Address with invalid EIP-55 checksum in address list");
+            return false;
+        }
+        
         std::lock_guard<std::mutex> lock(mutex_);
         known_addresses = addresses;
         std::sort(known_addresses.begin(), known_addresses.end());
+        known_addresses_changed_ = true;
+        publishLocked();
         
         LOG_INFO("Address book updated with " + std::to_string(addresses.size()) + " addresses");
         return true;
@@ -425,6 +543,16 @@ bool AppState::setKnownAddresses(const std::vector<KnownAddress>& addresses) noe
     }
 }
 
+void AppState::setAddressBook(std::shared_ptr<const MappedAddressBook> book) noexcept {
+    try {
+        std::lock_guard<std::mutex> lock(mutex_);
+        address_book_ = std::move(book);
+        publishLocked();
+    } catch (...) {
+        LOG_ERROR("Failed to set address book");
+    }
+}
+
 bool AppState::setUsbContacts(const std::vector<KnownAddress>& contacts) noexcept {
     try {
         // Validate all contacts
@@ -436,13 +564,20 @@ bool AppState::setUsbContacts(const std::vector<KnownAddress>& contacts) noexcep
         }
         
         // Limit USB contacts for security
-        if (contacts.size() > 100) {
-            LOG_WARN("Too many USB contacts (limit: 100)");
+        if (contacts.size() > kMaxUsbContacts) {
+            LOG_WARN("Too many USB contacts (limit: " + std::to_string(kMaxUsbContacts) + ")");
+            return false;
+        }
+        
+        if (!passChecksums(contacts)) {
+            LOG_WARN("Contact with invalid EIP-55 checksum in USB contact list");
             return false;
         }
         
         std::lock_guard<std::mutex> lock(mutex_);
         usb_contacts = contacts;
+        usb_contacts_changed_ = true;
+        publishLocked();
         
         LOG_INFO("USB contacts updated with " + std::to_string(contacts.size()) + " contacts");
         return true;
@@ -452,10 +587,39 @@ bool AppState::setUsbContacts(const std::vector<KnownAddress>& contacts) noexcep
     }
 }
 
+bool AppState::appendUsbContacts(const std::vector<KnownAddress>& contacts) noexcept {
+    try {
+        std::vector<std::string> addresses;
+        addresses.reserve(contacts.size());
+        for (const auto& contact : contacts) addresses.push_back(contact.address);
+        auto checksums = Validator::passChecksums(addresses);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t before = usb_contacts.size();
+        for (size_t i = 0; i < contacts.size() && usb_contacts.size() < kMaxUsbContacts; ++i) {
+            if (!contacts[i].isValid() || !checksums[i]) continue;
+            if (std::find(usb_contacts.begin(), usb_contacts.end(), contacts[i]) != usb_contacts.end()) continue;
+            usb_contacts.push_back(contacts[i]);
+        }
+        if (usb_contacts.size() == before) return false;
+        usb_contacts_changed_ = true;
+        publishLocked();
+
+        if (usb_contacts.size() >= kMaxUsbContacts) {
+            LOG_WARN("USB contact list full (limit: " + std::to_string(kMaxUsbContacts) + ")");
+        }
+        return true;
+    } catch (...) {
+        LOG_ERROR("Failed to append USB contacts");
+        return false;
+    }
+}
+
 void AppState::setAddressSuggestion(const std::string& suggestion) noexcept {
     try {
         std::lock_guard<std::mutex> lock(mutex_);
         address_suggestion = suggestion.substr(0, 500);  // Limit length
+        publishLocked();
     } catch (...) {
         LOG_ERROR("Failed to set address suggestion");
     }
@@ -463,17 +627,22 @@ void AppState::setAddressSuggestion(const std::string& suggestion) noexcept {
 
 void AppState::setFieldErrors(const std::map<std::string, std::string>& errors) noexcept {
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        field_errors.clear();
-        
         // Limit number of errors and their length
+        std::map<std::string, std::string> limited;
         int count = 0;
         for (const auto& [field, error] : errors) {
             if (count >= 20) break;  // Max 20 field errors
             
-            field_errors[field.substr(0, 100)] = error.substr(0, 500);
+            limited[field.substr(0, 100)] = error.substr(0, 500);
             count++;
         }
+        
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (limited != field_errors) {
+            field_errors = std::move(limited);
+            field_errors_changed_ = true;
+        }
+        publishLocked();
     } catch (...) {
         LOG_ERROR("Failed to set field errors");
     }
@@ -483,6 +652,7 @@ void AppState::setNetworkName(const std::string& name) noexcept {
     try {
         std::lock_guard<std::mutex> lock(mutex_);
         network_name = name.substr(0, 50);  // Limit length
+        publishLocked();
         LOG_INFO("Network name set to: " + network_name);
     } catch (...) {
         LOG_ERROR("Failed to set network name");
@@ -492,8 +662,7 @@ void AppState::setNetworkName(const std::string& name) noexcept {
 bool AppState::setAccountPath(const std::string& path) noexcept {
     try {
         // Validate BIP-44 path format
-        static const std::regex bip44_regex(R"(m/44'/\d+'/\d+'/\d+/\d+)");
-        if (!std::regex_match(path, bip44_regex)) {
+        if (!MatchesBip44Path(path, false)) {
             LOG_WARN("Invalid BIP-44 derivation path format");
             return false;
         }
@@ -505,6 +674,7 @@ bool AppState::setAccountPath(const std::string& path) noexcept {
         
         std::lock_guard<std::mutex> lock(mutex_);
         account_path = path;
+        publishLocked();
         
         LOG_INFO("Account path set to: " + path);
         return true;
@@ -616,6 +786,8 @@ void AppState::clearTransaction() noexcept {
         signed_hex.clear();
         has_signed.store(false);
         field_errors.clear();
+        field_errors_changed_ = true;
+        publishLocked();
         
         LOG_INFO("Transaction data cleared");
     } catch (...) {
@@ -627,7 +799,11 @@ void AppState::clearError() noexcept {
     try {
         std::lock_guard<std::mutex> lock(mutex_);
         error.clear();
-        field_errors.clear();
+        if (!field_errors.empty()) {
+            field_errors.clear();
+            field_errors_changed_ = true;
+        }
+        publishLocked();
         
         LOG_DEBUG("Errors cleared");
     } catch (...) {
@@ -654,10 +830,13 @@ void AppState::clearAll() noexcept {
         
         selected_device.store(0);
         devices.clear();
+        devices_changed_ = true;
         wallet_connected.store(false);
         
         known_addresses.clear();
+        known_addresses_changed_ = true;
         usb_contacts.clear();
+        usb_contacts_changed_ = true;
         address_suggestion.clear();
         selected_contact.store(0);
         is_scanning_usb.store(false);
@@ -668,6 +847,8 @@ void AppState::clearAll() noexcept {
         is_detecting_wallet.store(false);
         
         field_errors.clear();
+        field_errors_changed_ = true;
+        publishLocked();
         
         LOG_INFO("Application state cleared");
     } catch (...) {
@@ -719,11 +900,21 @@ void AppState::addErrorCallback(std::function<void(const std::string&)> callback
     }
 }
 
+void AppState::addChangeCallback(std::function<void(uint64_t)> callback) {
+    try {
+        std::lock_guard<std::mutex> lock(mutex_);
+        change_callbacks_.push_back(std::move(callback));
+    } catch (...) {
+        LOG_ERROR("Failed to add change callback");
+    }
+}
+
 void AppState::clearCallbacks() noexcept {
     try {
         std::lock_guard<std::mutex> lock(mutex_);
         route_change_callbacks_.clear();
         error_callbacks_.clear();
+        change_callbacks_.clear();
         
         LOG_DEBUG("Callbacks cleared");
     } catch (...) {
@@ -731,10 +922,39 @@ void AppState::clearCallbacks() noexcept {
     }
 }
 
+std::vector<KnownAddress> AppState::searchKnownAddresses(const std::string& query, size_t limit) const {
+    auto snap = snapshot();
+    std::vector<KnownAddress> results;
+    for (const auto& match : snap->known_address_index->search(query, limit)) {
+        results.push_back((*snap->known_addresses)[match.id]);
+    }
+    if (snap->address_book && results.size() < limit) {
+        for (size_t id : snap->address_book->searchPrefix(query, limit)) {
+            if (results.size() >= limit) break;
+            KnownAddress entry = snap->address_book->toKnownAddress(id);
+            if (std::find(results.begin(), results.end(), entry) == results.end()) {
+                results.push_back(std::move(entry));
+            }
+        }
+    }
+    return results;
+}
+
+std::optional<KnownAddress> AppState::findKnownAddress(const std::string& address) const {
+    auto snap = snapshot();
+    auto known = snap->known_address_index->search(address, 1);
+    if (!known.empty() && known.front().score == AddressIndex::kExactAddressScore) {
+        return (*snap->known_addresses)[known.front().id];
+    }
+    if (snap->address_book) {
+        if (auto id = snap->address_book->find(address)) return snap->address_book->toKnownAddress(*id);
+    }
+    return std::nullopt;
+}
+
 size_t AppState::getKnownAddressCount() const noexcept {
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return known_addresses.size();
+        return snapshot()->known_addresses->size();
     } catch (...) {
         return 0;
     }
@@ -742,8 +962,7 @@ size_t AppState::getKnownAddressCount() const noexcept {
 
 size_t AppState::getUsbContactCount() const noexcept {
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return usb_contacts.size();
+        return snapshot()->usb_contacts->size();
     } catch (...) {
         return 0;
     }
@@ -751,8 +970,7 @@ size_t AppState::getUsbContactCount() const noexcept {
 
 bool AppState::hasFieldError(const std::string& field) const noexcept {
     try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return field_errors.count(field) > 0;
+        return snapshot()->field_errors->count(field) > 0;
     } catch (...) {
         return false;
     }
@@ -772,6 +990,7 @@ bool AppState::loadFromConfig() noexcept {
         
         // Initialize transaction with defaults
         unsigned_tx = UnsignedTx::createFromDefaults(network_config.chain_id, network_config.use_eip1559);
+        publishLocked();
         
         LOG_INFO("State loaded from configuration");
         return true;
@@ -0,0 +1,122 @@
+#include "app/task_executor.hpp"
+#include "app/logger.hpp"
+#include <algorithm>
+
+namespace app {
+
+TaskExecutor::TaskExecutor(size_t num_threads, Poster poster, std::chrono::milliseconds tick,
+                           size_t wheel_slots)
+    : poster_(std::move(poster)),
+      tick_(std::max(tick, std::chrono::milliseconds(1))),
+      wheel_(std::max<size_t>(wheel_slots, 1)),
+      workers_(std::make_unique<WorkerPool>(num_threads)) {
+  timer_thread_ = std::thread([this] { timerLoop(); });
+}
+
+TaskExecutor::~TaskExecutor() {
+  shutdown();
+}
+
+void TaskExecutor::submit(Work work, Completion done, CancellationToken token) {
+  enqueue(Task{std::move(work), std::move(done), std::move(token)});
+}
+
+void TaskExecutor::submitAfter(std::chrono::milliseconds delay, Work work, Completion done,
+                               CancellationToken token) {
+  if (delay.count() <= 0) {
+    submit(std::move(work), std::move(done), std::move(token));
+    return;
+  }
+  // Rounded up so a timer never fires more than one tick early
+  uint64_t ticks = static_cast<uint64_t>((delay + tick_ - std::chrono::milliseconds(1)) / tick_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) return;
+    size_t slot = (cursor_ + ticks) % wheel_.size();
+    wheel_[slot].push_back(Timer{(ticks - 1) / wheel_.size(),
+                                 Task{std::move(work), std::move(done), std::move(token)}});
+    ++timer_count_;
+  }
+  cv_.notify_one();
+}
+
+void TaskExecutor::shutdown() noexcept {
+  std::unique_ptr<WorkerPool> workers;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) return;
+    stopping_ = true;
+    stop_.cancel();
+    for (auto& slot : wheel_) slot.clear();
+    timer_count_ = 0;
+    workers = std::move(workers_);
+  }
+  cv_.notify_all();
+  if (timer_thread_.joinable()) timer_thread_.join();
+  // Queued tasks see stopped_ and return at once; running ones are waited for
+  workers.reset();
+}
+
+void TaskExecutor::enqueue(Task task) {
+  if (task.token.cancelled()) return;
+  auto shared = std::make_shared<Task>(std::move(task));
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stopping_ || !workers_) return;
+  workers_->submit([this, shared] { run(*shared); });
+}
+
+void TaskExecutor::run(Task& task) noexcept {
+  if (stopped_.cancelled() || task.token.cancelled()) return;
+  try {
+    if (task.work) task.work(task.token);
+  } catch (const std::exception& e) {
+    LOG_EXCEPTION(e, "TaskExecutor task");
+  } catch (...) {
+    LOG_ERROR("TaskExecutor task threw a non-standard exception");
+  }
+  if (!task.done || !poster_ || stopped_.cancelled() || task.token.cancelled()) return;
+  try {
+    poster_(std::move(task.done));
+  } catch (const std::exception& e) {
+    LOG_EXCEPTION(e, "TaskExecutor completion");
+  }
+}
+
+void TaskExecutor::timerLoop() {
+  auto next_tick = std::chrono::steady_clock::now() + tick_;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    if (timer_count_ == 0) {
+      // Idle: sleep until a timer is added, then count ticks from there
+      cv_.wait(lock, [this] { return stopping_ || timer_count_ > 0; });
+      next_tick = std::chrono::steady_clock::now() + tick_;
+      continue;
+    }
+    if (cv_.wait_until(lock, next_tick, [this] { return stopping_; })) break;
+    if (std::chrono::steady_clock::now() < next_tick) continue;
+
+    // One slot per tick; a late thread catches up without sleeping
+    next_tick += tick_;
+    cursor_ = (cursor_ + 1) % wheel_.size();
+    std::vector<Task> due;
+    auto& slot = wheel_[cursor_];
+    for (size_t i = 0; i < slot.size();) {
+      if (slot[i].rounds == 0) {
+        due.push_back(std::move(slot[i].task));
+        slot[i] = std::move(slot.back());
+        slot.pop_back();
+      } else {
+        --slot[i].rounds;
+        ++i;
+      }
+    }
+    timer_count_ -= due.size();
+    if (due.empty()) continue;
+
+    lock.unlock();
+    for (auto& task : due) enqueue(std::move(task));
+    lock.lock();
+  }
+}
+
+} // namespace app
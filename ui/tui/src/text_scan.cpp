@@ -0,0 +1,113 @@
+#include "app/text_scan.hpp"
+#include <array>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define APP_HEX_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define APP_HEX_NEON 1
+#endif
+
+namespace app {
+
+// The grammars are constexpr; keep their edge cases pinned at compile time
+static_assert(MatchesEnsName("vitalik.eth"));
+static_assert(MatchesEnsName("bob.base.eth"));
+static_assert(MatchesEnsName("a..eth"));
+static_assert(!MatchesEnsName(".eth"));
+static_assert(!MatchesEnsName("name.e"));
+static_assert(!MatchesEnsName("name.eth1"));
+static_assert(!MatchesEnsName("na me.eth"));
+static_assert(MatchesBip44Path("m/44'/60'/0'/0/0", true));
+static_assert(MatchesBip44Path("m/44'/60'/0'/2/15", false));
+static_assert(!MatchesBip44Path("m/44'/60'/0'/2/15", true));
+static_assert(!MatchesBip44Path("m/44'/60'/0'/01/0", true));
+static_assert(!MatchesBip44Path("m/44'/60'/0'/0/", true));
+static_assert(!MatchesBip44Path("m/44'/60/0'/0/0", false));
+
+namespace {
+
+constexpr std::array<bool, 256> MakeHexTable() {
+  std::array<bool, 256> table{};
+  for (int c = '0'; c <= '9'; ++c) table[c] = true;
+  for (int c = 'a'; c <= 'f'; ++c) table[c] = true;
+  for (int c = 'A'; c <= 'F'; ++c) table[c] = true;
+  return table;
+}
+
+constexpr std::array<bool, 256> kHexTable = MakeHexTable();
+
+bool IsHexScalar(const unsigned char* p, size_t size) {
+  // Accumulate instead of branching per byte; bail out once per 16
+  bool ok = true;
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    for (size_t k = 0; k < 16; ++k) ok &= kHexTable[p[i + k]];
+    if (!ok) return false;
+  }
+  for (; i < size; ++i) ok &= kHexTable[p[i]];
+  return ok;
+}
+
+#if defined(APP_HEX_SSE2)
+
+// Bytes >= 0x80 are negative under the signed compares and fail both ranges
+inline __m128i HexMask(__m128i v) {
+  const __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));  // fold A-F onto a-f
+  __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                                _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+  __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                 _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+  return _mm_or_si128(digit, letter);
+}
+
+bool IsHexSimd(const unsigned char* p, size_t size) {
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    __m128i a = HexMask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)));
+    __m128i b = HexMask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + 16)));
+    if (_mm_movemask_epi8(_mm_and_si128(a, b)) != 0xffff) return false;
+  }
+  for (; i + 16 <= size; i += 16) {
+    __m128i a = HexMask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)));
+    if (_mm_movemask_epi8(a) != 0xffff) return false;
+  }
+  return IsHexScalar(p + i, size - i);
+}
+
+#elif defined(APP_HEX_NEON)
+
+inline uint8x16_t HexMask(uint8x16_t v) {
+  uint8x16_t lower = vorrq_u8(v, vdupq_n_u8(0x20));
+  uint8x16_t digit = vandq_u8(vcgeq_u8(v, vdupq_n_u8('0')), vcleq_u8(v, vdupq_n_u8('9')));
+  uint8x16_t letter = vandq_u8(vcgeq_u8(lower, vdupq_n_u8('a')), vcleq_u8(lower, vdupq_n_u8('f')));
+  return vorrq_u8(digit, letter);
+}
+
+bool IsHexSimd(const unsigned char* p, size_t size) {
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    uint8x16_t ok = vandq_u8(HexMask(vld1q_u8(p + i)), HexMask(vld1q_u8(p + i + 16)));
+    if (vminvq_u8(ok) != 0xff) return false;
+  }
+  for (; i + 16 <= size; i += 16) {
+    if (vminvq_u8(HexMask(vld1q_u8(p + i))) != 0xff) return false;
+  }
+  return IsHexScalar(p + i, size - i);
+}
+
+#endif
+
+} // namespace
+
+bool IsHexDigits(const char* data, size_t size) noexcept {
+  const auto* p = reinterpret_cast<const unsigned char*>(data);
+#if defined(APP_HEX_SSE2) || defined(APP_HEX_NEON)
+  return IsHexSimd(p, size);
+#else
+  return IsHexScalar(p, size);
+#endif
+}
+
+} // namespace app
@@ -0,0 +1,435 @@
+#include "app/tx_history.hpp"
+#include "app/fountain.hpp"
+#include "app/logger.hpp"
+#include "app/validation.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace app {
+
+namespace {
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;  // kByteOrderMark as written; rejects foreign-endian files
+  uint64_t reserved[2];
+};
+
+// Precedes every record body
+struct FrameHeader {
+  uint32_t length;  // of the body
+  uint32_t crc;     // CRC-32 of the body
+};
+
+struct RecordHeader {
+  uint64_t seq;
+  uint64_t timestamp_ms;
+  uint64_t nonce;
+  int32_t chain_id;
+  uint16_t flags;
+  uint16_t amount_length;
+  uint32_t payload_length;
+  uint8_t to[20];
+};
+
+static_assert(sizeof(FileHeader) == 32, "transaction history header layout");
+static_assert(sizeof(FrameHeader) == 8, "transaction history frame layout");
+static_assert(sizeof(RecordHeader) == 56, "transaction history record layout");
+
+constexpr char kMagic[8] = {'B', 'O', 'S', 'T', 'X', 'L', 'O', 'G'};
+constexpr uint32_t kByteOrderMark = 0x01020304;
+constexpr uint16_t kHasNonce = 1;
+constexpr uint16_t kHasRecipient = 2;
+constexpr size_t kAddressSize = 20;
+constexpr size_t kMaxPayload = 1 << 20;  // far beyond any signed transaction
+
+int Nibble(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+bool ParseAddress(std::string_view text, uint8_t* out) {
+  if (text.size() >= 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) text.remove_prefix(2);
+  if (text.size() != 2 * kAddressSize) return false;
+  for (size_t i = 0; i < kAddressSize; ++i) {
+    int hi = Nibble(text[2 * i]);
+    int lo = Nibble(text[2 * i + 1]);
+    if (hi < 0 || lo < 0) return false;
+    out[i] = static_cast<uint8_t>(hi << 4 | lo);
+  }
+  return true;
+}
+
+std::string AddressString(const uint8_t* address) {
+  static const char kDigits[] = "0123456789abcdef";
+  std::string hex = "0x";
+  for (size_t i = 0; i < kAddressSize; ++i) {
+    hex += kDigits[address[i] >> 4];
+    hex += kDigits[address[i] & 0x0f];
+  }
+  return Validator::toChecksumAddress(hex).value_or(hex);
+}
+
+bool WriteAll(int fd, const uint8_t* data, size_t size) {
+  while (size > 0) {
+    ssize_t n = ::write(fd, data, size);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    data += n;
+    size -= static_cast<size_t>(n);
+  }
+  return true;
+}
+
+// Makes a rename into the directory durable
+void SyncParentDir(const std::string& path) {
+  size_t slash = path.find_last_of('/');
+  std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+  int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) return;
+  ::fsync(fd);
+  ::close(fd);
+}
+
+uint64_t NowMs() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+TransactionHistory::~TransactionHistory() {
+  close();
+}
+
+bool TransactionHistory::open(const std::string& path, size_t max_records) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  closeLocked();
+  path_ = path;
+  max_records_ = max_records;
+  return openLocked();
+}
+
+void TransactionHistory::close() noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  closeLocked();
+}
+
+bool TransactionHistory::isOpen() const noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return fd_ >= 0;
+}
+
+bool TransactionHistory::openLocked() noexcept {
+  int fd = ::open(path_.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0600);
+  if (fd < 0) {
+    LOG_WARN("Cannot open transaction history: " + path_);
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    ::close(fd);
+    return false;
+  }
+  size_t size = static_cast<size_t>(st.st_size);
+  if (size == 0) {
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byte_order = kByteOrderMark;
+    if (!WriteAll(fd, reinterpret_cast<const uint8_t*>(&header), sizeof(header)) || fdatasync(fd) != 0) {
+      ::close(fd);
+      LOG_WARN("Cannot create transaction history: " + path_);
+      return false;
+    }
+    size = sizeof(header);
+  }
+  fd_ = fd;
+
+  FileHeader header{};
+  if (size >= sizeof(FileHeader) && remapLocked(size)) std::memcpy(&header, data_, sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+      header.byte_order != kByteOrderMark) {
+    closeLocked();
+    LOG_WARN("Not a transaction history log: " + path_);
+    return false;
+  }
+
+  // Index every intact record; whatever follows the first damaged one is
+  // the tail of an interrupted append and is cut off
+  size_t pos = sizeof(FileHeader);
+  while (size - pos >= sizeof(FrameHeader)) {
+    FrameHeader frame;
+    std::memcpy(&frame, data_ + pos, sizeof(frame));
+    size_t body = pos + sizeof(FrameHeader);
+    if (frame.length > size - body || Crc32(data_ + body, frame.length) != frame.crc ||
+        !indexLocked(body, frame.length)) {
+      break;
+    }
+    pos = body + frame.length;
+  }
+  if (pos < size) {
+    LOG_WARN("Dropping " + std::to_string(size - pos) + " damaged bytes at the end of " + path_);
+    if (!remapLocked(pos) || ftruncate(fd_, static_cast<off_t>(pos)) != 0 || fdatasync(fd_) != 0) {
+      closeLocked();
+      return false;
+    }
+  }
+  return true;
+}
+
+void TransactionHistory::closeLocked() noexcept {
+  if (data_) munmap(const_cast<uint8_t*>(data_), size_);
+  if (fd_ >= 0) ::close(fd_);
+  fd_ = -1;
+  data_ = nullptr;
+  size_ = 0;
+  slots_.clear();
+  last_seq_ = 0;
+  last_timestamp_ms_ = 0;
+  next_nonce_.clear();
+}
+
+bool TransactionHistory::remapLocked(size_t size) noexcept {
+  if (data_) munmap(const_cast<uint8_t*>(data_), size_);
+  data_ = nullptr;
+  size_ = 0;
+  void* map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd_, 0);
+  if (map == MAP_FAILED) {
+    LOG_WARN("Failed to map transaction history: " + path_);
+    return false;
+  }
+  data_ = static_cast<const uint8_t*>(map);
+  size_ = size;
+  return true;
+}
+
+bool TransactionHistory::indexLocked(size_t offset, size_t length) noexcept {
+  RecordHeader header;
+  if (length < sizeof(header)) return false;
+  std::memcpy(&header, data_ + offset, sizeof(header));
+  if (sizeof(header) + header.amount_length + header.payload_length != length ||
+      header.seq <= last_seq_ || header.timestamp_ms < last_timestamp_ms_) {
+    return false;
+  }
+  try {
+    Slot slot{offset, header.seq, header.timestamp_ms, header.nonce, header.chain_id, header.flags,
+              header.amount_length, header.payload_length, {}};
+    std::memcpy(slot.to, header.to, sizeof(slot.to));
+    slots_.push_back(slot);
+    if (header.flags & kHasNonce) {
+      uint64_t& next = next_nonce_[header.chain_id];
+      next = std::max(next, header.nonce + 1);
+    }
+  } catch (const std::exception& e) {
+    LOG_EXCEPTION(e, "TransactionHistory index");
+    return false;
+  }
+  last_seq_ = header.seq;
+  last_timestamp_ms_ = header.timestamp_ms;
+  return true;
+}
+
+bool TransactionHistory::append(const Record& record) noexcept {
+  try {
+    return append(std::vector<Record>{record});
+  } catch (const std::exception& e) {
+    LOG_EXCEPTION(e, "TransactionHistory::append");
+    return false;
+  }
+}
+
+bool TransactionHistory::append(const std::vector<Record>& records) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (fd_ < 0) return false;
+  if (records.empty()) return true;
+  try {
+    // Framed in memory first so the batch goes out in one write and one sync
+    std::vector<uint8_t> buffer;
+    uint64_t seq = last_seq_;
+    uint64_t timestamp_ms = last_timestamp_ms_;
+    for (const auto& record : records) {
+      if (record.amount.size() > UINT16_MAX || record.payload.size() > kMaxPayload) {
+        LOG_WARN("Transaction too large for the history log");
+        return false;
+      }
+      RecordHeader header{};
+      header.seq = ++seq;
+      timestamp_ms = std::max(timestamp_ms, record.timestamp_ms ? record.timestamp_ms : NowMs());
+      header.timestamp_ms = timestamp_ms;
+      if (record.nonce) {
+        header.nonce = *record.nonce;
+        header.flags |= kHasNonce;
+      }
+      if (ParseAddress(record.to, header.to)) header.flags |= kHasRecipient;
+      header.chain_id = record.chain_id;
+      header.amount_length = static_cast<uint16_t>(record.amount.size());
+      header.payload_length = static_cast<uint32_t>(record.payload.size());
+
+      size_t length = sizeof(header) + record.amount.size() + record.payload.size();
+      size_t at = buffer.size();
+      buffer.resize(at + sizeof(FrameHeader) + length);
+      uint8_t* body = buffer.data() + at + sizeof(FrameHeader);
+      std::memcpy(body, &header, sizeof(header));
+      std::memcpy(body + sizeof(header), record.amount.data(), record.amount.size());
+      std::memcpy(body + sizeof(header) + record.amount.size(), record.payload.data(), record.payload.size());
+      FrameHeader frame{static_cast<uint32_t>(length), Crc32(body, length)};
+      std::memcpy(buffer.data() + at, &frame, sizeof(frame));
+    }
+
+    size_t end = size_;
+    if (!WriteAll(fd_, buffer.data(), buffer.size()) || fdatasync(fd_) != 0) {
+      LOG_ERROR("Failed to write transaction history: " + path_);
+      // Don't leave a partial record behind for the next open to cut off
+      if (ftruncate(fd_, static_cast<off_t>(end)) != 0) LOG_WARN("Failed to roll back " + path_);
+      return false;
+    }
+    if (!remapLocked(end + buffer.size())) {
+      closeLocked();
+      return false;
+    }
+    for (size_t pos = end; pos < size_;) {
+      FrameHeader frame;
+      std::memcpy(&frame, data_ + pos, sizeof(frame));
+      indexLocked(pos + sizeof(FrameHeader), frame.length);
+      pos += sizeof(FrameHeader) + frame.length;
+    }
+    return true;
+  } catch (const std::exception& e) {
+    LOG_EXCEPTION(e, "TransactionHistory::append");
+    return false;
+  }
+}
+
+size_t TransactionHistory::size() const noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return slots_.size();
+}
+
+std::string_view TransactionHistory::stringLocked(const Slot& slot, size_t skip, size_t length) const noexcept {
+  return std::string_view(reinterpret_cast<const char*>(data_ + slot.offset + sizeof(RecordHeader) + skip), length);
+}
+
+TransactionHistory::Entry TransactionHistory::entryLocked(const Slot& slot) const {
+  Entry e;
+  e.seq = slot.seq;
+  e.timestamp_ms = slot.timestamp_ms;
+  e.chain_id = slot.chain_id;
+  if (slot.flags & kHasNonce) e.nonce = slot.nonce;
+  if (slot.flags & kHasRecipient) e.to = AddressString(slot.to);
+  e.amount = std::string(stringLocked(slot, 0, slot.amount_length));
+  return e;
+}
+
+size_t TransactionHistory::findLocked(uint64_t seq) const noexcept {
+  auto it = std::lower_bound(slots_.begin(), slots_.end(), seq,
+                             [](const Slot& slot, uint64_t s) { return slot.seq < s; });
+  return it != slots_.end() && it->seq == seq ? static_cast<size_t>(it - slots_.begin()) : slots_.size();
+}
+
+std::vector<TransactionHistory::Entry> TransactionHistory::recent(size_t limit) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Entry> entries;
+  for (size_t i = slots_.size(); i > 0 && entries.size() < limit; --i) entries.push_back(entryLocked(slots_[i - 1]));
+  return entries;
+}
+
+std::optional<TransactionHistory::Entry> TransactionHistory::entry(uint64_t seq) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t i = findLocked(seq);
+  if (i == slots_.size()) return std::nullopt;
+  return entryLocked(slots_[i]);
+}
+
+std::optional<std::string> TransactionHistory::payload(uint64_t seq) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t i = findLocked(seq);
+  if (i == slots_.size()) return std::nullopt;
+  return std::string(stringLocked(slots_[i], slots_[i].amount_length, slots_[i].payload_length));
+}
+
+std::vector<uint64_t> TransactionHistory::findByNonce(int chain_id, uint64_t nonce) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<uint64_t> found;
+  for (size_t i = slots_.size(); i > 0; --i) {
+    const Slot& slot = slots_[i - 1];
+    if ((slot.flags & kHasNonce) && slot.chain_id == chain_id && slot.nonce == nonce) found.push_back(slot.seq);
+  }
+  return found;
+}
+
+std::vector<uint64_t> TransactionHistory::findByRecipient(std::string_view address) const {
+  std::vector<uint64_t> found;
+  uint8_t key[kAddressSize];
+  if (!ParseAddress(address, key)) return found;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t i = slots_.size(); i > 0; --i) {
+    const Slot& slot = slots_[i - 1];
+    if ((slot.flags & kHasRecipient) && std::memcmp(slot.to, key, kAddressSize) == 0) found.push_back(slot.seq);
+  }
+  return found;
+}
+
+std::vector<uint64_t> TransactionHistory::findSince(uint64_t timestamp_ms) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto first = std::lower_bound(slots_.begin(), slots_.end(), timestamp_ms,
+                                [](const Slot& slot, uint64_t t) { return slot.timestamp_ms < t; });
+  std::vector<uint64_t> found;
+  for (auto it = slots_.end(); it != first;) found.push_back((--it)->seq);
+  return found;
+}
+
+std::optional<uint64_t> TransactionHistory::nextNonce(int chain_id) const noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = next_nonce_.find(chain_id);
+  if (it == next_nonce_.end()) return std::nullopt;
+  return it->second;
+}
+
+bool TransactionHistory::needsCompaction() const noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return fd_ >= 0 && max_records_ > 0 && slots_.size() > max_records_ + std::max<size_t>(max_records_ / 4, 1);
+}
+
+bool TransactionHistory::compact() noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (fd_ < 0 || max_records_ == 0 || slots_.size() <= max_records_) return false;
+  try {
+    // The records kept are the tail of the log, so it is one copy
+    size_t dropped = slots_.size() - max_records_;
+    size_t from = slots_[dropped].offset - sizeof(FrameHeader);
+    std::string tmp = path_ + ".tmp";
+    int out = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    bool ok = out >= 0 && WriteAll(out, data_, sizeof(FileHeader)) &&
+              WriteAll(out, data_ + from, size_ - from) && ::fsync(out) == 0;
+    if (out >= 0 && ::close(out) != 0) ok = false;
+    if (!ok || std::rename(tmp.c_str(), path_.c_str()) != 0) {
+      std::remove(tmp.c_str());
+      LOG_WARN("Failed to compact transaction history: " + path_);
+      return false;
+    }
+    SyncParentDir(path_);
+
+    closeLocked();
+    if (!openLocked()) return false;
+    LOG_INFOF("Compacted transaction history: dropped %zu oldest records", dropped);
+    return true;
+  } catch (const std::exception& e) {
+    LOG_EXCEPTION(e, "TransactionHistory::compact");
+    return false;
+  }
+}
+
+} // namespace app
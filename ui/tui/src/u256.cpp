@@ -0,0 +1,221 @@
+#include "app/u256.hpp"
+#include <algorithm>
+
+namespace app {
+
+namespace {
+
+constexpr uint32_t kPow10[10] = {1,      10,      100,      1000,      10000,
+                                 100000, 1000000, 10000000, 100000000, 1000000000};
+
+// Largest chunk of decimal digits whose value fits in one word
+constexpr size_t kDecimalChunk = 9;
+
+inline int HexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  c = static_cast<char>(c | 0x20);
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+bool AllDigits(std::string_view text) {
+  return std::all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; });
+}
+
+} // namespace
+
+std::optional<U256> U256::fromDecimal(std::string_view text) {
+  if (text.empty() || text.size() > 100 || !AllDigits(text)) return std::nullopt;
+
+  // Nine digits per multiply-add rather than one
+  U256 v;
+  size_t i = 0;
+  size_t head = text.size() % kDecimalChunk;
+  if (head == 0) head = kDecimalChunk;
+  while (i < text.size()) {
+    size_t n = i == 0 ? head : kDecimalChunk;
+    uint32_t chunk = 0;
+    for (size_t k = 0; k < n; ++k) chunk = chunk * 10 + static_cast<uint32_t>(text[i + k] - '0');
+    if (!v.mulAddSmall(kPow10[n], chunk)) return std::nullopt;
+    i += n;
+  }
+  return v;
+}
+
+std::optional<U256> U256::fromHex(std::string_view text) {
+  if (text.size() >= 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+    text.remove_prefix(2);
+  } else if (text.empty()) {
+    return std::nullopt;
+  }
+
+  // Leading zeros don't count against the 64-digit limit
+  size_t first = 0;
+  while (first < text.size() && text[first] == '0') ++first;
+  if (text.size() - first > 64) {
+    return std::nullopt;
+  }
+
+  U256 v;
+  size_t bit = 0;
+  for (size_t i = text.size(); i-- > 0;) {
+    int nibble = HexValue(text[i]);
+    if (nibble < 0) return std::nullopt;
+    if (i >= first) {
+      v.words_[bit / 32] |= static_cast<uint32_t>(nibble) << (bit % 32);
+      bit += 4;
+    }
+  }
+  return v;
+}
+
+std::optional<U256> U256::fromString(std::string_view text) {
+  if (text.size() >= 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+    return fromHex(text);
+  }
+  return fromDecimal(text);
+}
+
+std::optional<U256> U256::fromUnits(std::string_view text, unsigned decimals) {
+  if (decimals > 77) return std::nullopt;
+  size_t dot = text.find('.');
+  std::string_view whole = text.substr(0, dot);
+  std::string_view fraction = dot == std::string_view::npos ? std::string_view() : text.substr(dot + 1);
+  if (whole.empty() && fraction.empty()) return std::nullopt;
+  if (!AllDigits(whole) || !AllDigits(fraction)) return std::nullopt;
+
+  // Trailing zeros beyond the unit's precision are harmless ("1.50" gwei in wei)
+  while (fraction.size() > decimals && fraction.back() == '0') fraction.remove_suffix(1);
+  if (fraction.size() > decimals) return std::nullopt;
+
+  // Scale by shifting digits: whole, fraction, then zero padding
+  std::string digits;
+  digits.reserve(whole.size() + decimals);
+  digits.append(whole.data(), whole.size());
+  digits.append(fraction.data(), fraction.size());
+  digits.append(decimals - fraction.size(), '0');
+  size_t first = digits.find_first_not_of('0');
+  if (first == std::string::npos) return U256();
+  return fromDecimal(std::string_view(digits).substr(first));
+}
+
+std::string U256::toDecimal() const {
+  if (isZero()) return "0";
+  U256 v = *this;
+  std::string out;
+  while (!v.isZero()) {
+    uint32_t chunk = v.divSmall(kPow10[kDecimalChunk]);
+    for (size_t k = 0; k < kDecimalChunk; ++k) {
+      out += static_cast<char>('0' + chunk % 10);
+      chunk /= 10;
+    }
+  }
+  while (out.size() > 1 && out.back() == '0') out.pop_back();
+  std::reverse(out.begin(), out.end());
+  return out;
+}
+
+std::string U256::toHex() const {
+  static const char kDigits[] = "0123456789abcdef";
+  std::string out = "0x";
+  bool started = false;
+  for (size_t w = kWords; w-- > 0;) {
+    for (int shift = 28; shift >= 0; shift -= 4) {
+      unsigned nibble = (words_[w] >> shift) & 0xf;
+      if (nibble == 0 && !started) continue;
+      started = true;
+      out += kDigits[nibble];
+    }
+  }
+  if (!started) out += '0';
+  return out;
+}
+
+std::string U256::toUnits(unsigned decimals) const {
+  std::string digits = toDecimal();
+  if (decimals == 0) return digits;
+  if (digits.size() <= decimals) digits.insert(0, decimals - digits.size() + 1, '0');
+  std::string whole = digits.substr(0, digits.size() - decimals);
+  std::string fraction = digits.substr(digits.size() - decimals);
+  while (!fraction.empty() && fraction.back() == '0') fraction.pop_back();
+  return fraction.empty() ? whole : whole + "." + fraction;
+}
+
+bool U256::isZero() const noexcept {
+  return std::all_of(std::begin(words_), std::end(words_), [](uint32_t w) { return w == 0; });
+}
+
+bool U256::fitsUint64() const noexcept {
+  return std::all_of(words_ + 2, words_ + kWords, [](uint32_t w) { return w == 0; });
+}
+
+size_t U256::byteLength() const noexcept {
+  for (size_t w = kWords; w-- > 0;) {
+    if (words_[w] == 0) continue;
+    size_t bytes = 4;
+    while ((words_[w] >> (8 * (bytes - 1))) == 0) --bytes;
+    return w * 4 + bytes;
+  }
+  return 0;
+}
+
+void U256::writeBigEndian(uint8_t* out) const noexcept {
+  size_t n = byteLength();
+  for (size_t i = 0; i < n; ++i) {
+    size_t byte = n - 1 - i;  // byte index from the least significant end
+    out[i] = static_cast<uint8_t>(words_[byte / 4] >> (8 * (byte % 4)));
+  }
+}
+
+std::optional<U256> U256::checkedAdd(const U256& other) const noexcept {
+  U256 sum;
+  uint64_t carry = 0;
+  for (size_t w = 0; w < kWords; ++w) {
+    uint64_t t = uint64_t(words_[w]) + other.words_[w] + carry;
+    sum.words_[w] = static_cast<uint32_t>(t);
+    carry = t >> 32;
+  }
+  if (carry) return std::nullopt;
+  return sum;
+}
+
+std::optional<U256> U256::checkedMul(uint64_t factor) const noexcept {
+  // (hi * 2^32 + lo) * this, with the high product shifted up one word
+  U256 lo = *this;
+  U256 hi = *this;
+  if (!lo.mulAddSmall(static_cast<uint32_t>(factor), 0)) return std::nullopt;
+  if (!hi.mulAddSmall(static_cast<uint32_t>(factor >> 32), 0)) return std::nullopt;
+  if (hi.words_[kWords - 1] != 0) return std::nullopt;
+  for (size_t w = kWords - 1; w > 0; --w) hi.words_[w] = hi.words_[w - 1];
+  hi.words_[0] = 0;
+  return lo.checkedAdd(hi);
+}
+
+int U256::compare(const U256& a, const U256& b) noexcept {
+  for (size_t w = kWords; w-- > 0;) {
+    if (a.words_[w] != b.words_[w]) return a.words_[w] < b.words_[w] ? -1 : 1;
+  }
+  return 0;
+}
+
+bool U256::mulAddSmall(uint32_t factor, uint32_t addend) noexcept {
+  uint64_t carry = addend;
+  for (size_t w = 0; w < kWords; ++w) {
+    uint64_t t = uint64_t(words_[w]) * factor + carry;
+    words_[w] = static_cast<uint32_t>(t);
+    carry = t >> 32;
+  }
+  return carry == 0;
+}
+
+uint32_t U256::divSmall(uint32_t divisor) noexcept {
+  uint64_t rem = 0;
+  for (size_t w = kWords; w-- > 0;) {
+    uint64_t cur = (rem << 32) | words_[w];
+    words_[w] = static_cast<uint32_t>(cur / divisor);
+    rem = cur % divisor;
+  }
+  return static_cast<uint32_t>(rem);
+}
+
+} // namespace app
@@ -0,0 +1,311 @@
+#include "app/usb_contact_scanner.hpp"
+#include "app/contact_stream_parser.hpp"
+#include "app/logger.hpp"
+#include "app/metrics.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <condition_variable>
+#include <deque>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_set>
+
+namespace app {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr size_t kReadChunk = 16 * 1024;
+constexpr const char* kContactsFileName = "contacts.json";
+
+std::string Lowercase(std::string text) {
+  for (char& c : text) {
+    if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+  }
+  return text;
+}
+
+#ifndef __APPLE__
+// /proc/mounts escapes space, tab, newline and backslash as \ooo
+std::string UnescapeMountPath(const std::string& path) {
+  std::string out;
+  for (size_t i = 0; i < path.size(); ++i) {
+    if (path[i] == '\\' && i + 3 < path.size() && std::isdigit(static_cast<unsigned char>(path[i + 1]))) {
+      out += static_cast<char>(std::stoi(path.substr(i + 1, 3), nullptr, 8));
+      i += 3;
+    } else {
+      out += path[i];
+    }
+  }
+  return out;
+}
+
+bool ReadsOne(const fs::path& path) {
+  std::ifstream in(path);
+  char c = 0;
+  return in.get(c) && c == '1';
+}
+
+// The block device (or, for a partition, its parent disk) is flagged removable
+bool IsRemovableDevice(const std::string& device) {
+  std::error_code ec;
+  fs::path resolved = fs::canonical(device, ec);
+  if (ec) return false;
+  fs::path sys = fs::path("/sys/class/block") / resolved.filename();
+  return ReadsOne(sys / "removable") || ReadsOne(sys / ".." / "removable");
+}
+
+bool IsMediaMountPoint(const std::string& path) {
+  for (const char* prefix : {"/media/", "/run/media/", "/mnt/"}) {
+    if (path.rfind(prefix, 0) == 0) return true;
+  }
+  return false;
+}
+#endif
+
+} // namespace
+
+struct UsbContactScanner::Scan {
+  UsbScanOptions options;
+  BatchCallback on_batch;
+  DoneCallback on_done;
+  std::atomic<bool> cancelled{false};
+  std::atomic<bool> finished{false};
+
+  // Directory work queue shared by the walkers
+  std::mutex queue_mutex;
+  std::condition_variable queue_cv;
+  std::deque<std::pair<fs::path, int>> dirs;
+  size_t busy = 0;
+
+  // Contacts found but not yet delivered
+  std::mutex results_mutex;
+  std::unordered_set<std::string> seen;  // lowercase addresses
+  std::vector<KnownAddress> pending;
+  size_t found = 0;
+
+  std::mutex deliver_mutex;  // one on_batch at a time, and none after cancel
+
+  void cancel() {
+    cancelled.store(true);
+    // Taken so a walker between its predicate check and wait can't miss it
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    queue_cv.notify_all();
+  }
+
+  void push(fs::path dir, int depth) {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex);
+      dirs.emplace_back(std::move(dir), depth);
+    }
+    queue_cv.notify_one();
+  }
+
+  void add(KnownAddress contact) {
+    bool full;
+    {
+      std::lock_guard<std::mutex> lock(results_mutex);
+      if (!seen.insert(Lowercase(contact.address)).second) return;
+      pending.push_back(std::move(contact));
+      ++found;
+      full = pending.size() >= options.batch_size;
+    }
+    if (full) flush();
+  }
+
+  void flush() {
+    std::vector<KnownAddress> batch;
+    {
+      std::lock_guard<std::mutex> lock(results_mutex);
+      batch.swap(pending);
+    }
+    if (batch.empty()) return;
+    std::lock_guard<std::mutex> lock(deliver_mutex);
+    if (!cancelled.load()) on_batch(std::move(batch));
+  }
+
+  void parseFile(const fs::path& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) > options.max_file_size) {
+      ::close(fd);
+      LOG_WARN("Skipping oversized contacts file: " + path.string());
+      return;
+    }
+
+    ContactStreamParser parser([this](KnownAddress contact) { add(std::move(contact)); });
+    char buffer[kReadChunk];
+    size_t total = 0;
+    while (!cancelled.load()) {
+      ssize_t n = ::read(fd, buffer, sizeof(buffer));
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) break;
+      total += static_cast<size_t>(n);
+      // The file may grow after fstat; the limit holds for what is read
+      if (total > options.max_file_size || !parser.feed(buffer, static_cast<size_t>(n))) break;
+    }
+    ::close(fd);
+    if (!cancelled.load() && !parser.finish()) {
+      LOG_WARN("Malformed contacts file: " + path.string());
+    }
+    if (parser.rejected() > 0) {
+      LOG_WARN("Skipped " + std::to_string(parser.rejected()) + " invalid contacts in " + path.string());
+    }
+    flush();  // deliver what this file had without waiting for a full batch
+  }
+
+  void walk(const fs::path& dir, int depth) {
+    std::error_code ec;
+    fs::directory_iterator it(dir, fs::directory_options::skip_permission_denied, ec);
+    for (; !ec && it != fs::directory_iterator() && !cancelled.load(); it.increment(ec)) {
+      const auto& entry = *it;
+      std::string name = entry.path().filename().string();
+      std::error_code type_ec;
+      auto status = entry.symlink_status(type_ec);  // symlinks are never followed
+      if (type_ec) continue;
+      if (fs::is_directory(status)) {
+        if (depth < options.max_depth && !name.empty() && name[0] != '.') push(entry.path(), depth + 1);
+      } else if (fs::is_regular_file(status) && Lowercase(name) == kContactsFileName) {
+        parseFile(entry.path());
+      }
+    }
+  }
+
+  void walker() {
+    for (;;) {
+      std::pair<fs::path, int> item;
+      {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        queue_cv.wait(lock, [&] { return cancelled.load() || !dirs.empty() || busy == 0; });
+        if (cancelled.load() || dirs.empty()) {
+          queue_cv.notify_all();
+          return;
+        }
+        item = std::move(dirs.front());
+        dirs.pop_front();
+        ++busy;
+      }
+      walk(item.first, item.second);
+      {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        --busy;
+      }
+      queue_cv.notify_all();
+    }
+  }
+};
+
+UsbContactScanner::UsbContactScanner(UsbScanOptions options) : options_(std::move(options)) {
+  options_.max_concurrent_io = std::max<size_t>(options_.max_concurrent_io, 1);
+  options_.batch_size = std::max<size_t>(options_.batch_size, 1);
+}
+
+UsbContactScanner::~UsbContactScanner() {
+  cancel();
+  for (auto& [scan, thread] : scans_) thread.join();
+}
+
+void UsbContactScanner::start(BatchCallback on_batch, DoneCallback on_done) {
+  auto scan = std::make_shared<Scan>();
+  scan->options = options_;
+  scan->on_batch = std::move(on_batch);
+  scan->on_done = std::move(on_done);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (current_) current_->cancel();
+  // Reap coordinators of earlier scans that have wound down
+  for (auto it = scans_.begin(); it != scans_.end();) {
+    if (it->first->finished.load()) {
+      it->second.join();
+      it = scans_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  current_ = scan;
+  scans_.emplace_back(scan, std::thread(&UsbContactScanner::run, scan));
+}
+
+void UsbContactScanner::cancel() noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (current_) current_->cancel();
+}
+
+bool UsbContactScanner::running() const noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return current_ && !current_->finished.load();
+}
+
+void UsbContactScanner::run(std::shared_ptr<Scan> scan) {
+  static Histogram& scan_time = Metrics::shared().histogram("usb.scan");
+  static Counter& contacts_found = Metrics::shared().counter("usb.contacts_found");
+  static Counter& scans_cancelled = Metrics::shared().counter("usb.scans_cancelled");
+  auto started = std::chrono::steady_clock::now();
+  try {
+    auto roots = scan->options.roots.empty() ? RemovableMounts() : scan->options.roots;
+    LOG_INFO("Scanning " + std::to_string(roots.size()) + " volumes for contacts");
+    for (const auto& root : roots) scan->push(root, 0);
+
+    std::vector<std::thread> walkers;
+    for (size_t i = 1; i < scan->options.max_concurrent_io; ++i) {
+      walkers.emplace_back([scan] { scan->walker(); });
+    }
+    scan->walker();
+    for (auto& walker : walkers) walker.join();
+    scan->flush();
+  } catch (const std::exception& e) {
+    LOG_EXCEPTION(e, "UsbContactScanner::run");
+  }
+
+  bool cancelled = scan->cancelled.load();
+  if (cancelled) {
+    scans_cancelled.add();
+  } else {
+    // Only complete walks, so the histogram tracks how long a full scan takes
+    scan_time.record(std::chrono::steady_clock::now() - started);
+    contacts_found.add(scan->found);
+    LOG_INFO("USB scan found " + std::to_string(scan->found) + " contacts");
+  }
+  scan->finished.store(true);
+  try {
+    if (scan->on_done) scan->on_done(scan->found, cancelled);
+  } catch (...) {
+    LOG_ERROR("USB scan completion callback failed");
+  }
+}
+
+std::vector<std::string> UsbContactScanner::RemovableMounts() {
+  std::vector<std::string> mounts;
+#ifdef __APPLE__
+  std::error_code ec;
+  for (fs::directory_iterator it("/Volumes", ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+    // The boot volume appears here as a symlink to /
+    std::error_code type_ec;
+    if (fs::is_directory(it->symlink_status(type_ec)) && !type_ec) mounts.push_back(it->path().string());
+  }
+#else
+  std::ifstream in("/proc/mounts");
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream fields(line);
+    std::string device, mount_point;
+    if (!(fields >> device >> mount_point)) continue;
+    mount_point = UnescapeMountPath(mount_point);
+    if (mount_point == "/") continue;
+    bool removable = device.rfind("/dev/", 0) == 0 && IsRemovableDevice(device);
+    if (removable || (device.rfind("/dev/", 0) == 0 && IsMediaMountPoint(mount_point))) {
+      if (std::find(mounts.begin(), mounts.end(), mount_point) == mounts.end()) mounts.push_back(mount_point);
+    }
+  }
+#endif
+  return mounts;
+}
+
+} // namespace app
@@ -1,23 +1,81 @@
 #include "app/validation.hpp"
 #include "app/state.hpp"
 #include "app/logger.hpp"
-#include <regex>
+#include "app/keccak.hpp"
+#include "app/text_scan.hpp"
+#include "app/u256.hpp"
 #include <algorithm>
+#include <array>
 #include <cctype>
-#include <unordered_map>
 #include <chrono>
 #include <filesystem>
-#include <sstream>
-#include <iomanip>
+#include <functional>
+#include <mutex>
 
 namespace app {
 
-// Rate limiting state (simple DoS protection)
+// Rate limiting state (simple DoS protection): a token bucket per input
+// type in a fixed open-addressed table, so a check neither allocates nor
+// walks other input types. A bucket holds a burst of MAX_INPUT_BURST inputs
+// and earns one back every INPUT_REFILL_INTERVAL.
 namespace {
-    std::unordered_map<std::string, std::chrono::steady_clock::time_point> last_input_times;
-    std::unordered_map<std::string, int> input_counts;
-    constexpr int MAX_INPUTS_PER_MINUTE = 100;
-    constexpr auto INPUT_TIMEOUT = std::chrono::minutes(1);
+    struct InputBucket {
+        size_t type_hash = 0;  // 0 marks a free slot
+        int64_t tokens = 0;
+        std::chrono::steady_clock::time_point refilled;
+    };
+    constexpr size_t INPUT_BUCKET_COUNT = 32;
+    constexpr int64_t MAX_INPUT_BURST = 100;
+    constexpr auto INPUT_REFILL_INTERVAL = std::chrono::milliseconds(100);
+    std::array<InputBucket, INPUT_BUCKET_COUNT> input_buckets;
+    std::mutex input_buckets_mutex;
+
+    // The bucket for a type, claiming a free slot or, with the table full,
+    // the one idle longest
+    InputBucket& FindInputBucket(size_t type_hash, std::chrono::steady_clock::time_point now) {
+        size_t start = type_hash % INPUT_BUCKET_COUNT;
+        InputBucket* stalest = &input_buckets[start];
+        for (size_t i = 0; i < INPUT_BUCKET_COUNT; ++i) {
+            InputBucket& bucket = input_buckets[(start + i) % INPUT_BUCKET_COUNT];
+            if (bucket.type_hash == type_hash) {
+                return bucket;
+            }
+            if (bucket.type_hash == 0) {
+                stalest = &bucket;
+                break;
+            }
+            if (bucket.refilled < stalest->refilled) {
+                stalest = &bucket;
+            }
+        }
+        
+        stalest->type_hash = type_hash;
+        stalest->tokens = MAX_INPUT_BURST;
+        stalest->refilled = now;
+        return *stalest;
+    }
+
+    // EIP-55: hex letter i is uppercase when nibble i of keccak256(lowercase hex) >= 8
+    std::string ApplyChecksum(const std::string& lower_hex, const Hash256& hash) {
+        std::string result = "0x" + lower_hex;
+        for (size_t i = 0; i < lower_hex.size(); ++i) {
+            uint8_t nibble = (hash[i / 2] >> (i % 2 == 0 ? 4 : 0)) & 0x0f;
+            if (nibble >= 8) {
+                result[i + 2] = static_cast<char>(std::toupper(static_cast<unsigned char>(lower_hex[i])));
+            }
+        }
+        return result;
+    }
+
+    bool HasMixedCase(const std::string& address) {
+        bool has_lower = false;
+        bool has_upper = false;
+        for (size_t i = 2; i < address.size(); ++i) {
+            has_lower |= address[i] >= 'a' && address[i] <= 'f';
+            has_upper |= address[i] >= 'A' && address[i] <= 'F';
+        }
+        return has_lower && has_upper;
+    }
 }
 
 // Validator class implementation
@@ -25,22 +83,13 @@ bool Validator::isHex(const std::string& s) noexcept {
     try {
         if (s.empty()) return false;
         if (s.length() < 2) return false;
-        if (s.substr(0, 2) != "0x" && s.substr(0, 2) != "0X") return false;
+        if (s[0] != '0' || (s[1] != 'x' && s[1] != 'X')) return false;
         
         // Check length limits
         if (s.length() > ValidationLimits::MAX_INPUT_LENGTH) return false;
         
-        // Check each character
-        for (size_t i = 2; i < s.length(); ++i) {
-            char c = s[i];
-            if (!((c >= '0' && c <= '9') || 
-                  (c >= 'a' && c <= 'f') || 
-                  (c >= 'A' && c <= 'F'))) {
-                return false;
-            }
-        }
-        
-        return true;
+        // Check each character; calldata can be long, so this is vectorised
+        return IsHexDigits(s.data() + 2, s.length() - 2);
     } catch (...) {
         return false;
     }
@@ -81,6 +130,44 @@ std::optional<std::string> Validator::toChecksumAddress(const std::string& addre
     }
 }
 
+bool Validator::passesChecksum(const std::string& address) noexcept {
+    try {
+        if (!isAddress(address)) return false;
+        return !HasMixedCase(address) || isAddressChecksum(address);
+    } catch (...) {
+        return false;
+    }
+}
+
+std::vector<bool> Validator::passChecksums(const std::vector<std::string>& addresses) noexcept {
+    std::vector<bool> results(addresses.size(), false);
+    
+    try {
+        // Only mixed-case addresses need hashing
+        std::vector<size_t> pending;
+        std::vector<std::string> lower_hex;
+        for (size_t i = 0; i < addresses.size(); ++i) {
+            const auto& address = addresses[i];
+            if (!isAddress(address)) continue;
+            if (!HasMixedCase(address)) {
+                results[i] = true;
+                continue;
+            }
+            pending.push_back(i);
+            lower_hex.push_back(toLowerCase(address.substr(2)));
+        }
+        
+        auto hashes = Keccak256Batch(lower_hex);
+        for (size_t k = 0; k < pending.size(); ++k) {
+            results[pending[k]] = ApplyChecksum(lower_hex[k], hashes[k]) == addresses[pending[k]];
+        }
+    } catch (...) {
+        std::fill(results.begin(), results.end(), false);
+    }
+    
+    return results;
+}
+
 bool Validator::isENSName(const std::string& s) noexcept {
     try {
         if (s.empty() || s.length() > 255) return false;
@@ -88,9 +175,8 @@ bool Validator::isENSName(const std::string& s) noexcept {
         // Basic ENS validation - ends with .eth or contains .
         if (s.find('.') == std::string::npos) return false;
         
-        // Must contain only valid DNS characters
-        static const std::regex ens_regex(R"([a-zA-Z0-9\-\.]+\.[a-zA-Z]{2,})");
-        return std::regex_match(s, ens_regex);
+        // Must contain only valid DNS characters, ending in an alphabetic TLD
+        return MatchesEnsName(s);
     } catch (...) {
         return false;
     }
@@ -111,10 +197,8 @@ bool Validator::isNumeric(const std::string& s) noexcept {
 
 bool Validator::isValidWeiAmount(const std::string& value) noexcept {
     try {
-        if (!isNumeric(value)) return false;
-        if (value == "0") return true;
-        
-        return isOverflowSafe(value, ValidationLimits::MAX_WEI_AMOUNT);
+        // Any amount up to 2^256 - 1 Wei
+        return isNumeric(value) && U256::fromDecimal(value).has_value();
     } catch (...) {
         return false;
     }
@@ -122,11 +206,9 @@ bool Validator::isValidWeiAmount(const std::string& value) noexcept {
 
 bool Validator::isValidGasLimit(const std::string& gas_limit) noexcept {
     try {
-        if (!isNumeric(gas_limit)) return false;
-        
-        uint64_t gas = std::stoull(gas_limit);
-        return gas >= ValidationLimits::MIN_GAS_LIMIT && 
-               gas <= ValidationLimits::MAX_GAS_LIMIT;
+        auto gas = U256::fromDecimal(gas_limit);
+        return gas && *gas >= U256(ValidationLimits::MIN_GAS_LIMIT) &&
+               *gas <= U256(ValidationLimits::MAX_GAS_LIMIT);
     } catch (...) {
         return false;
     }
@@ -134,9 +216,9 @@ bool Validator::isValidGasLimit(const std::string& gas_limit) noexcept {
 
 bool Validator::isValidGasPrice(const std::string& gas_price) noexcept {
     try {
-        if (!isNumeric(gas_price)) return false;
-        
-        return isOverflowSafe(gas_price, ValidationLimits::MAX_GAS_PRICE);
+        // Entered in Gwei, fractions allowed (e.g. 0.027)
+        auto wei = U256::fromUnits(gas_price, kGweiDecimals);
+        return wei && *wei <= U256(ValidationLimits::MAX_GAS_PRICE);
     } catch (...) {
         return false;
     }
@@ -144,10 +226,8 @@ bool Validator::isValidGasPrice(const std::string& gas_price) noexcept {
 
 bool Validator::isValidNonce(const std::string& nonce) noexcept {
     try {
-        if (!isNumeric(nonce)) return false;
-        
-        uint64_t nonce_val = std::stoull(nonce);
-        return nonce_val <= ValidationLimits::MAX_NONCE;
+        auto nonce_val = U256::fromDecimal(nonce);
+        return nonce_val && *nonce_val <= U256(ValidationLimits::MAX_NONCE);
     } catch (...) {
         return false;
     }
@@ -220,24 +300,24 @@ std::vector<std::string> Validator::validateTransaction(const UnsignedTx& tx, bo
             errors.push_back("Address checksum validation failed");
         }
         
-        // Validate amount
-        if (tx.value.empty()) {
+        // Numeric fields were parsed when they were entered; only presence
+        // and ranges are left to check
+        if (!tx.value) {
             errors.push_back("Transaction amount is required");
-        } else if (!isValidWeiAmount(tx.value)) {
-            errors.push_back("Invalid transaction amount");
         }
         
         // Validate nonce
-        if (tx.nonce.empty()) {
+        if (!tx.nonce) {
             errors.push_back("Transaction nonce is required");
-        } else if (!isValidNonce(tx.nonce)) {
+        } else if (*tx.nonce > ValidationLimits::MAX_NONCE) {
             errors.push_back("Invalid nonce value");
         }
         
         // Validate gas limit
-        if (tx.gas_limit.empty()) {
+        if (!tx.gas_limit) {
             errors.push_back("Gas limit is required");
-        } else if (!isValidGasLimit(tx.gas_limit)) {
+        } else if (*tx.gas_limit < ValidationLimits::MIN_GAS_LIMIT ||
+                   *tx.gas_limit > ValidationLimits::MAX_GAS_LIMIT) {
             errors.push_back("Gas limit must be between 21,000 and 30,000,000");
         }
         
@@ -252,36 +332,30 @@ std::vector<std::string> Validator::validateTransaction(const UnsignedTx& tx, bo
         }
         
         // EIP-1559 specific validation
+        const U256 max_gas_price(ValidationLimits::MAX_GAS_PRICE);
         if (tx.isEIP1559()) {
-            if (tx.max_fee_per_gas.empty()) {
+            if (!tx.max_fee_per_gas) {
                 errors.push_back("Max fee per gas is required for EIP-1559 transactions");
-            } else if (!isValidGasPrice(tx.max_fee_per_gas)) {
+            } else if (*tx.max_fee_per_gas > max_gas_price) {
                 errors.push_back("Invalid max fee per gas");
             }
             
-            if (tx.max_priority_fee_per_gas.empty()) {
+            if (!tx.max_priority_fee_per_gas) {
                 errors.push_back("Priority fee is required for EIP-1559 transactions");
-            } else if (!isValidGasPrice(tx.max_priority_fee_per_gas)) {
+            } else if (*tx.max_priority_fee_per_gas > max_gas_price) {
                 errors.push_back("Invalid priority fee");
             }
             
             // Priority fee should not exceed max fee
-            if (!tx.max_fee_per_gas.empty() && !tx.max_priority_fee_per_gas.empty()) {
-                try {
-                    uint64_t max_fee = std::stoull(tx.max_fee_per_gas);
-                    uint64_t priority_fee = std::stoull(tx.max_priority_fee_per_gas);
-                    if (priority_fee > max_fee) {
-                        errors.push_back("Priority fee cannot exceed max fee");
-                    }
-                } catch (...) {
-                    // Already caught by individual validations above
-                }
+            if (tx.max_fee_per_gas && tx.max_priority_fee_per_gas &&
+                *tx.max_priority_fee_per_gas > *tx.max_fee_per_gas) {
+                errors.push_back("Priority fee cannot exceed max fee");
             }
         } else {
             // Legacy transaction validation
-            if (tx.gas_price.empty()) {
+            if (!tx.gas_price) {
                 errors.push_back("Gas price is required for legacy transactions");
-            } else if (!isValidGasPrice(tx.gas_price)) {
+            } else if (*tx.gas_price > max_gas_price) {
                 errors.push_back("Invalid gas price");
             }
         }
@@ -410,8 +484,7 @@ bool Validator::containsNoControlChars(const std::string& s) noexcept {
 bool Validator::isValidDerivationPath(const std::string& path) noexcept {
     try {
         // BIP-44 path validation: m/44'/coin'/account'/change/index
-        static const std::regex bip44_regex(R"(^m/44'/\d+'/\d+'/[01]/\d+$)");
-        return std::regex_match(path, bip44_regex) && path.length() <= 50;
+        return path.length() <= 50 && MatchesBip44Path(path, true);
     } catch (...) {
         return false;
     }
@@ -450,32 +523,25 @@ bool Validator::isSafeForLogging(const std::string& s) noexcept {
 bool Validator::checkInputFrequency(const std::string& input_type) noexcept {
     try {
         auto now = std::chrono::steady_clock::now();
+        size_t type_hash = std::hash<std::string>{}(input_type) | 1;
         
-        // Clean up old entries
-        auto it = last_input_times.begin();
-        while (it != last_input_times.end()) {
-            if (now - it->second > INPUT_TIMEOUT) {
-                input_counts.erase(it->first);
-                it = last_input_times.erase(it);
-            } else {
-                ++it;
-            }
-        }
+        std::lock_guard<std::mutex> lock(input_buckets_mutex);
+        InputBucket& bucket = FindInputBucket(type_hash, now);
         
-        // Check current input frequency
-        auto& count = input_counts[input_type];
-        auto& last_time = last_input_times[input_type];
+        int64_t earned = (now - bucket.refilled) / INPUT_REFILL_INTERVAL;
+        if (earned > 0) {
+            bucket.tokens = std::min(MAX_INPUT_BURST, bucket.tokens + earned);
+            bucket.refilled += earned * INPUT_REFILL_INTERVAL;
+        }
+        if (bucket.tokens == MAX_INPUT_BURST) {
+            bucket.refilled = now;  // a full bucket doesn't bank time
+        }
         
-        if (now - last_time < std::chrono::milliseconds(100)) {
-            count++;
-            if (count > MAX_INPUTS_PER_MINUTE) {
-                return false;  // Rate limit exceeded
-            }
-        } else {
-            count = 1;
+        if (bucket.tokens == 0) {
+            return false;  // Rate limit exceeded
         }
         
-        last_time = now;
+        bucket.tokens--;
         return true;
     } catch (...) {
         return true;  // Allow on error to avoid blocking user
@@ -483,12 +549,8 @@ bool Validator::checkInputFrequency(const std::string& input_type) noexcept {
 }
 
 void Validator::resetInputFrequency() noexcept {
-    try {
-        last_input_times.clear();
-        input_counts.clear();
-    } catch (...) {
-        // Silent failure
-    }
+    std::lock_guard<std::mutex> lock(input_buckets_mutex);
+    input_buckets.fill(InputBucket{});
 }
 
 // Private helper methods
@@ -514,40 +576,12 @@ std::string Validator::toUpperCase(const std::string& s) noexcept {
     }
 }
 
-bool Validator::isOverflowSafe(const std::string& numeric_str, uint64_t max_value) noexcept {
-    try {
-        if (numeric_str.empty()) return false;
-        
-        // Quick length check - if longer than max uint64 string, it's too big
-        if (numeric_str.length() > 20) return false;
-        
-        uint64_t value = std::stoull(numeric_str);
-        return value <= max_value;
-    } catch (...) {
-        return false;
-    }
-}
-
 std::string Validator::calculateAddressChecksum(const std::string& address) noexcept {
     try {
         if (!isAddress(address)) return "";
         
-        // Simplified checksum calculation (not full Keccak-256)
-        // In production, you'd use a proper Keccak-256 implementation
         std::string addr_lower = toLowerCase(address.substr(2));  // Remove 0x prefix
-        std::string result = "0x";
-        
-        // Simple checksum: uppercase if position is even and char >= 'a'
-        for (size_t i = 0; i < addr_lower.length(); ++i) {
-            char c = addr_lower[i];
-            if (c >= 'a' && c <= 'f' && i % 2 == 0) {
-                result += std::toupper(c);
-            } else {
-                result += c;
-            }
-        }
-        
-        return result;
+        return ApplyChecksum(addr_lower, Keccak256(addr_lower));
     } catch (...) {
         return "";
     }
@@ -602,17 +636,10 @@ ValidationResult InputValidators::validateAmountInput(const std::string& input,
             return ValidationResult(false, "Amount must be greater than 0", "Enter a positive amount");
         }
         
-        // Helpful conversion info
-        try {
-            uint64_t wei_amount = std::stoull(input);
-            if (wei_amount >= 1000000000000000000ULL) {  // 1 ETH in Wei
-                double eth_amount = static_cast<double>(wei_amount) / 1000000000000000000.0;
-                std::ostringstream oss;
-                oss << std::fixed << std::setprecision(6) << eth_amount;
-                return ValidationResult(true, "", "≈ " + oss.str() + " ETH");
-            }
-        } catch (...) {
-            // Ignore conversion errors
+        // Helpful conversion info, exact at any magnitude
+        auto wei_amount = U256::fromDecimal(input);
+        if (wei_amount && *wei_amount >= U256(1000000000000000000ULL)) {  // 1 ETH in Wei
+            return ValidationResult(true, "", "= " + wei_amount->toUnits(kEtherDecimals) + " ETH");
         }
         
         return ValidationResult(true);
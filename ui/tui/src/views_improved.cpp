@@ -21,15 +21,8 @@ using app::UnsignedTx;
 namespace {
 
 // Utility: Convert Wei to ETH string with better formatting
-std::string weiToEth(const std::string& wei) {
-  if (wei.empty() || wei == "0") return "0 ETH";
-  
-  // For display purposes, show both Wei and estimated ETH
-  if (wei.length() > 18) {
-    return wei + " Wei (~" + wei.substr(0, wei.length() - 18) + "." + 
-           wei.substr(wei.length() - 18, 4) + " ETH)";
-  }
-  return wei + " Wei";
+std::string weiToEth(const app::U256& wei) {
+  return wei.toDecimal() + " Wei (" + wei.toUnits(app::kEtherDecimals) + " ETH)";
 }
 
 // Utility: Format address for display with middle ellipsis
@@ -376,13 +369,10 @@ Component ImprovedTransactionInputView(AppState& s) {
   
   auto validate_value = [](const std::string& val) -> std::string {
     if (val.empty()) return "Required";
-    try {
-      auto num = std::stoull(val);
-      if (num == 0) return "Warning: Sending 0 Wei";
-      return "✓ " + weiToEth(val);
-    } catch (...) {
-      return "Invalid number";
-    }
+    auto wei = app::U256::fromDecimal(val);
+    if (!wei) return "Invalid number";
+    if (wei->isZero()) return "Warning: Sending 0 Wei";
+    return "✓ " + weiToEth(*wei);
   };
   
   // Create labeled inputs with validation
@@ -430,8 +420,14 @@ Component ImprovedTransactionInputView(AppState& s) {
     }
     
     s.unsigned_tx.to = to_addr;
-    s.unsigned_tx.value = value_wei;
-    s.unsigned_tx.gas_limit = gas_limit;
+    if (!s.unsigned_tx.setValueFromString(value_wei)) {
+      s.error = "Amount must be a whole number of Wei";
+      return;
+    }
+    if (!s.unsigned_tx.setGasLimitFromString(gas_limit)) {
+      s.error = "Gas limit must be between 21,000 and 30,000,000";
+      return;
+    }
     s.unsigned_tx.data = data_hex;
     s.has_unsigned = true;
     s.route = app::Route::Confirmation;
@@ -6,6 +6,9 @@
 #include "app/state.hpp"
 #include "app/validation.hpp"
 #include "app/qr_generator.hpp"
+#include "app/payload_codec.hpp"
+#include "app/redraw_scheduler.hpp"
+#include "app/task_executor.hpp"
 #include <functional>
 #include <fstream>
 #include <thread>
@@ -13,6 +16,7 @@
 #include <sstream>
 #include <iomanip>
 #include <cmath>
+#include <memory>
 
 using namespace ftxui;
 using app::AppState;
@@ -20,13 +24,37 @@ using app::UnsignedTx;
 
 namespace {
 
+// Schedules redraws for RunApp; null until the screen exists
+std::unique_ptr<app::RedrawScheduler> g_redraw;
+
+// Background work changed the state; redraw once it is on screen.
+void RequestRedraw() {
+  if (g_redraw) g_redraw->invalidate();
+}
+
+// Runs the simulated device/USB work off the UI thread; the completions run
+// on the UI thread, so AppState is only ever touched there
+std::unique_ptr<app::TaskExecutor> g_tasks;
+
+void RunInBackground(std::chrono::milliseconds delay, app::TaskExecutor::Completion done) {
+  if (g_tasks) g_tasks->submitAfter(delay, nullptr, std::move(done));
+}
+
+// Animation frame for a visible spinner/progress widget; keeps frames coming
+// only while it is being rendered.
+int AnimationFrame(const AppState& s) {
+  if (g_redraw) g_redraw->requestAnimationFrame();
+  return s.animation_frame;
+}
+
 // Utility: Convert Wei to ETH string
-std::string weiToEth(const std::string& wei) {
-  if (wei.empty() || wei == "0") return "0";
-  
-  // Simple conversion - TODO: Implement proper big number math
-  // For now, just show Wei with note
-  return wei + " Wei";
+std::string weiToEth(const app::U256& wei) {
+  return wei.toUnits(app::kEtherDecimals) + " ETH";
+}
+
+// Utility: Gwei text for a fee stored in Wei
+std::string weiToGwei(const std::optional<app::U256>& wei) {
+  return wei ? wei->toUnits(app::kGweiDecimals) : "";
 }
 
 // Utility: Convert ETH to Wei string  
@@ -60,9 +88,7 @@ void loadUSBContacts(AppState& s) {
   
   // TODO: Implement actual USB scanning for contacts.json files
   // Simulate finding contacts with different types
-  std::thread([&](){
-    std::this_thread::sleep_for(std::chrono::seconds(2));
-    
+  RunInBackground(std::chrono::seconds(2), [&s](){
     // Mock USB contacts with various types
     s.usb_contacts = {
       {"alice.eth", "Alice Johnson", "ENS name for Alice", app::ContactType::ENS},
@@ -74,7 +100,7 @@ void loadUSBContacts(AppState& s) {
     
     s.is_scanning_usb = false;
     s.usb_scan_complete = true;
-  }).detach();
+  });
 }
 
 // Utility: Get contact type icon
@@ -181,8 +207,7 @@ Component ConnectWalletView(AppState& s) {
     // TODO: Actually detect hardware wallet
     // For now, simulate detection
     s.is_detecting_wallet = true;
-    std::thread([&](){
-      std::this_thread::sleep_for(std::chrono::seconds(1));
+    RunInBackground(std::chrono::seconds(1), [&s](){
       s.devices = {
         {"Ledger Nano X", "/dev/hidraw0", true, false},
         {"Trezor Model T", "/dev/hidraw1", false, false}
@@ -196,7 +221,7 @@ Component ConnectWalletView(AppState& s) {
       } else {
         s.setError("No hardware wallet detected. Please connect your device and try again.");
       }
-    }).detach();
+    });
   });
   
   auto content = Renderer(continue_btn, [&]{
@@ -219,16 +244,10 @@ Component ConnectWalletView(AppState& s) {
     // Status
     if (s.is_detecting_wallet) {
       content.push_back(hbox({
-        Spinner(s.animation_frame),
+        Spinner(AnimationFrame(s)),
         text(" Detecting hardware wallets"),
-        ProgressDots(s.animation_frame)
+        ProgressDots(AnimationFrame(s))
       }) | center);
-      
-      // Update animation
-      std::thread([&](){
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        if (s.is_detecting_wallet) s.animation_frame++;
-      }).detach();
     } else if (!s.devices.empty()) {
       content.push_back(text("Detected devices:") | dim);
       for (const auto& dev : s.devices) {
@@ -291,16 +310,10 @@ Component USBContactsView(AppState& s) {
     
     if (s.is_scanning_usb) {
       content.push_back(hbox({
-        Spinner(s.animation_frame),
+        Spinner(AnimationFrame(s)),
         text(" Scanning USB devices for contacts.json files"),
-        ProgressDots(s.animation_frame)
+        ProgressDots(AnimationFrame(s))
       }) | center | color(Color::GreenLight));
-      
-      // Update animation
-      std::thread([&](){
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        if (s.is_scanning_usb) s.animation_frame++;
-      }).detach();
     } else if (s.usb_scan_complete) {
       if (s.usb_contacts.empty()) {
         content.push_back(text("No contacts.json files found on USB devices") | center | color(Color::Yellow));
@@ -397,12 +410,12 @@ Component USBContactsView(AppState& s) {
 Component TransactionInputView(AppState& s) {
   // Local copies for input binding
   static std::string to = s.unsigned_tx.to;
-  static std::string value = s.unsigned_tx.value;
-  static std::string nonce = s.unsigned_tx.nonce;
-  static std::string gas_limit = s.unsigned_tx.gas_limit.empty() ? "21000" : s.unsigned_tx.gas_limit;
-  static std::string gas_price = s.unsigned_tx.gas_price;
-  static std::string max_fee = s.unsigned_tx.max_fee_per_gas;
-  static std::string max_priority = s.unsigned_tx.max_priority_fee_per_gas;
+  static std::string value = s.unsigned_tx.value ? s.unsigned_tx.value->toDecimal() : "";
+  static std::string nonce = s.unsigned_tx.nonce ? std::to_string(*s.unsigned_tx.nonce) : "";
+  static std::string gas_limit = std::to_string(s.unsigned_tx.gas_limit.value_or(21000));
+  static std::string gas_price = weiToGwei(s.unsigned_tx.gas_price);
+  static std::string max_fee = weiToGwei(s.unsigned_tx.max_fee_per_gas);
+  static std::string max_priority = weiToGwei(s.unsigned_tx.max_priority_fee_per_gas);
   static std::string data = s.unsigned_tx.data.empty() ? "0x" : s.unsigned_tx.data;
   
   // Input components
@@ -432,17 +445,34 @@ Component TransactionInputView(AppState& s) {
       s.field_errors["to"] = "Invalid Ethereum address format";
     }
     
+    // Numbers are parsed once here; the stored transaction keeps the values
+    UnsignedTx tx = s.unsigned_tx;
+    tx.to = to;
+    tx.data = data;
+    
     // Validate numeric fields
-    if (value.empty() || !std::all_of(value.begin(), value.end(), ::isdigit)) {
-      s.field_errors["value"] = "Amount must be a number";
+    if (!tx.setValueFromString(value)) {
+      s.field_errors["value"] = "Amount must be a whole number of Wei";
     }
     
-    if (nonce.empty() || !std::all_of(nonce.begin(), nonce.end(), ::isdigit)) {
+    if (!tx.setNonceFromString(nonce)) {
       s.field_errors["nonce"] = "Nonce must be a number";
     }
     
-    if (gas_limit.empty() || !std::all_of(gas_limit.begin(), gas_limit.end(), ::isdigit)) {
-      s.field_errors["gas_limit"] = "Gas limit must be a number";
+    if (!tx.setGasLimitFromString(gas_limit)) {
+      s.field_errors["gas_limit"] = "Gas limit must be between 21,000 and 30,000,000";
+    }
+    
+    if (s.use_eip1559) {
+      if (!tx.setMaxFeeFromGwei(max_fee) || !tx.setPriorityFeeFromGwei(max_priority)) {
+        s.field_errors["gas_price"] = "Fees must be Gwei amounts up to 1000";
+      }
+      tx.type = 2;
+    } else {
+      if (!tx.setGasPriceFromGwei(gas_price)) {
+        s.field_errors["gas_price"] = "Gas price must be a Gwei amount up to 1000";
+      }
+      tx.type = 0;
     }
     
     if (!s.field_errors.empty()) {
@@ -455,20 +485,7 @@ Component TransactionInputView(AppState& s) {
     }
     
     // Save to state
-    s.unsigned_tx.to = to;
-    s.unsigned_tx.value = value;
-    s.unsigned_tx.nonce = nonce;
-    s.unsigned_tx.gas_limit = gas_limit;
-    s.unsigned_tx.data = data;
-    
-    if (s.use_eip1559) {
-      s.unsigned_tx.max_fee_per_gas = max_fee;
-      s.unsigned_tx.max_priority_fee_per_gas = max_priority;
-      s.unsigned_tx.type = 2;
-    } else {
-      s.unsigned_tx.gas_price = gas_price;
-      s.unsigned_tx.type = 0;
-    }
+    s.unsigned_tx = tx;
     
     s.has_unsigned = true;
     s.clearError();
@@ -543,11 +560,11 @@ Component TransactionInputView(AppState& s) {
       text("Amount (Wei):") | size(WIDTH, EQUAL, 20) | color(Color::GreenLight),
       in_value->Render()
     }));
-    if (!value.empty() && std::all_of(value.begin(), value.end(), ::isdigit)) {
+    if (auto wei = app::U256::fromDecimal(value)) {
       // Show ETH equivalent
       content.push_back(hbox({
         text("") | size(WIDTH, EQUAL, 20),
-        text("  ≈ " + weiToEth(value)) | color(Color::GrayDark)
+        text("  = " + weiToEth(*wei)) | color(Color::GrayDark)
       }));
     }
     
@@ -614,9 +631,7 @@ Component ConfirmationView(AppState& s) {
     
     // TODO: Actual hardware wallet signing
     // Simulate signing process
-    std::thread([&](){
-      std::this_thread::sleep_for(std::chrono::seconds(3));
-      
+    RunInBackground(std::chrono::seconds(3), [&s](){
       // Mock signed transaction
       s.signed_hex = "0xf86c0185046c7cfe0083016dea94" + 
                      s.unsigned_tx.to.substr(2) +
@@ -624,7 +639,7 @@ Component ConfirmationView(AppState& s) {
       s.has_signed = true;
       s.is_signing = false;
       s.route = app::Route::Result;
-    }).detach();
+    });
   });
   
   auto edit_btn = Button("Edit", [&]{
@@ -668,7 +683,7 @@ Component ConfirmationView(AppState& s) {
     // Amount
     details.push_back(hbox({
       text("Amount: ") | bold | color(Color::Green),
-      text(weiToEth(tx.value)) | color(Color::GreenLight)
+      text(tx.value ? weiToEth(*tx.value) : "-") | color(Color::GreenLight)
     }));
     
     details.push_back(text(""));
@@ -676,27 +691,27 @@ Component ConfirmationView(AppState& s) {
     // Transaction parameters
     details.push_back(hbox({
       text("Nonce: ") | bold | color(Color::Green),
-      text(tx.nonce) | color(Color::GreenLight)
+      text(tx.nonce ? std::to_string(*tx.nonce) : "-") | color(Color::GreenLight)
     }));
     
     details.push_back(hbox({
       text("Gas Limit: ") | bold | color(Color::Green),
-      text(tx.gas_limit) | color(Color::GreenLight)
+      text(tx.gas_limit ? std::to_string(*tx.gas_limit) : "-") | color(Color::GreenLight)
     }));
     
     if (tx.isEIP1559()) {
       details.push_back(hbox({
         text("Max Fee: ") | bold | color(Color::Green),
-        text(tx.max_fee_per_gas + " Gwei") | color(Color::GreenLight)
+        text(weiToGwei(tx.max_fee_per_gas) + " Gwei") | color(Color::GreenLight)
       }));
       details.push_back(hbox({
         text("Priority Fee: ") | bold | color(Color::Green),
-        text(tx.max_priority_fee_per_gas + " Gwei") | color(Color::GreenLight)
+        text(weiToGwei(tx.max_priority_fee_per_gas) + " Gwei") | color(Color::GreenLight)
       }));
     } else {
       details.push_back(hbox({
         text("Gas Price: ") | bold,
-        text(tx.gas_price + " Gwei")
+        text(weiToGwei(tx.gas_price) + " Gwei")
       }));
     }
     
@@ -759,9 +774,9 @@ Component SigningView(AppState& s) {
     // Animation and status
     content.push_back(hbox({
       filler(),
-      Spinner(s.animation_frame),
+      Spinner(AnimationFrame(s)),
       text("  Please confirm the transaction on your hardware wallet") | color(Color::Green),
-      ProgressDots(s.animation_frame),
+      ProgressDots(AnimationFrame(s)),
       filler()
     }) | bold);
     
@@ -791,7 +806,7 @@ Component SigningView(AppState& s) {
     content.push_back(text(""));
     
     // Progress indicator
-    int progress = (s.animation_frame * 5) % 100;
+    int progress = (AnimationFrame(s) * 5) % 100;
     std::string bar = "[";
     for (int i = 0; i < 40; ++i) {
       if (i < progress * 40 / 100) {
@@ -812,12 +827,6 @@ Component SigningView(AppState& s) {
       filler()
     }));
     
-    // Update animation
-    std::thread([&](){
-      std::this_thread::sleep_for(std::chrono::milliseconds(100));
-      if (s.is_signing) s.animation_frame++;
-    }).detach();
-    
     return vbox(std::move(content)) | border | size(WIDTH, EQUAL, 80) | center;
   });
 }
@@ -827,6 +836,7 @@ Component ResultView(AppState& s) {
   static std::string save_path = "/home/user/signed_transaction.txt";
   static std::string save_status;
   static int current_qr_part = 0;
+  static std::string qr_codes_source;  // signed_hex that s.qr_codes was built from
   
   auto save_to_file = [&](){
     // TODO: Actually save to file
@@ -877,8 +887,14 @@ Component ResultView(AppState& s) {
     
     // QR Code
     if (!s.signed_hex.empty()) {
-      // Generate QR codes with chunking (max 100 chars per chunk)
-      s.qr_codes = app::GenerateQRs(s.signed_hex, 100);
+      // Compress, then pack each frame up to the planner's version cap. The
+      // renderer runs on every animation tick, so only re-encode on change.
+      if (qr_codes_source != s.signed_hex || s.qr_codes.empty()) {
+        app::QRPlanOptions options;
+        options.fast_mask = true;  // The parts cycle on the animation tick
+        s.qr_codes = app::GenerateQRsPlanned(app::CompressPayload(s.signed_hex), options);
+        qr_codes_source = s.signed_hex;
+      }
       
       if (!s.qr_codes.empty()) {
         // Ensure current_qr_part is within bounds
@@ -1123,6 +1139,16 @@ int RunApp() {
   auto screen = ScreenInteractive::FitComponent();
   auto exit = screen.ExitLoopClosure();
   
+  // Animation frames are only produced while a spinner is rendered
+  g_redraw = std::make_unique<app::RedrawScheduler>(
+      [&screen] { screen.PostEvent(Event::Custom); },
+      app::RedrawScheduler::configuredFrameInterval(),
+      [&state] { state.incrementAnimationFrame(); });
+  g_tasks = std::make_unique<app::TaskExecutor>(1, [&screen](app::TaskExecutor::Completion done) {
+    screen.Post(std::move(done));
+    RequestRedraw();
+  });
+  
   // Main route renderer
   auto route = Renderer([&]{ 
     return MakeRoute(state)->Render(); 
@@ -1134,12 +1160,14 @@ int RunApp() {
   auto status = StatusBar(state);
   
   auto root = Renderer(layout, [&]{
-    return vbox({ 
+    auto frame = vbox({ 
       banner->Render(), 
       route->Render() | flex,
       separator(), 
       status->Render() 
     });
+    g_redraw->frameRendered();
+    return frame;
   });
   
   // Global keyboard shortcuts
@@ -1291,5 +1319,7 @@ int RunApp() {
   });
   
   screen.Loop(root);
+  g_tasks.reset();
+  g_redraw.reset();
   return 0;
 }
\ No newline at end of file
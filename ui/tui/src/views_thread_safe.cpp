@@ -4,9 +4,22 @@
 #include <ftxui/dom/elements.hpp>
 #include <ftxui/screen/color.hpp>
 #include "app/state.hpp"
+#include "app/address_book_file.hpp"
+#include "app/config.hpp"
 #include "app/validation.hpp"
+#include "app/form_validation.hpp"
 #include "app/qr_generator.hpp"
+#include "app/qr_render_cache.hpp"
+#include "app/redraw_scheduler.hpp"
+#include "app/usb_contact_scanner.hpp"
+#include "app/startup_trace.hpp"
+#include "app/metrics.hpp"
+#include "app/task_executor.hpp"
+#include "app/signing_plan.hpp"
+#include "app/tx_history.hpp"
+#include <algorithm>
 #include <functional>
+#include <filesystem>
 #include <fstream>
 #include <thread>
 #include <chrono>
@@ -15,6 +28,8 @@
 #include <cmath>
 #include <atomic>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 
 using namespace ftxui;
 using app::AppState;
@@ -27,51 +42,118 @@ class UIUpdater {
 private:
     ScreenInteractive* screen_;
     std::atomic<bool> shutdown_requested_{false};
+    app::RedrawScheduler scheduler_;
+    std::mutex route_mutex_;
+    app::CancellationSource route_tasks_;  // reset on every route change
+    app::TaskExecutor executor_;           // last: joined before the rest goes away
     
 public:
-    explicit UIUpdater(ScreenInteractive* screen) : screen_(screen) {}
+    UIUpdater(ScreenInteractive* screen, AppState& state)
+        : screen_(screen),
+          scheduler_([this] { if (screen_) screen_->PostEvent(Event::Custom); },
+                     app::RedrawScheduler::configuredFrameInterval(),
+                     [&state] { state.incrementAnimationFrame(); }),
+          executor_(2, [this](app::TaskExecutor::Completion done) {
+              if (shutdown_requested_.load() || !screen_) return;
+              screen_->Post(std::move(done));
+              postUpdate();
+          }) {}
     
     void requestShutdown() {
         shutdown_requested_.store(true);
+        {
+            std::lock_guard<std::mutex> lock(route_mutex_);
+            route_tasks_.cancel();
+        }
+        scheduler_.stop();
+    }
+    
+    // Cancels the route-scoped operations started for the previous screen
+    void routeChanged() {
+        std::lock_guard<std::mutex> lock(route_mutex_);
+        route_tasks_.reset();
     }
     
     bool isShutdownRequested() const {
         return shutdown_requested_.load();
     }
     
+    // Coalesced: several posts before the next frame produce one redraw
     void postUpdate() {
-        if (screen_ && !shutdown_requested_.load()) {
-            screen_->PostEvent(Event::Custom);
+        if (!shutdown_requested_.load()) {
+            scheduler_.invalidate();
+        }
+    }
+    
+    // Renderers showing a spinner or progress bar ask for their next frame
+    void requestAnimationFrame() {
+        scheduler_.requestAnimationFrame();
+    }
+    
+    void frameRendered() {
+        scheduler_.frameRendered();
+    }
+    
+    // Runs operation(token) on the shared executor and redraws once when it
+    // is done. A route-scoped operation is cancelled when the route changes
+    // (or on shutdown) and should return early once its token says so.
+    template<typename Func>
+    void runAsyncOperation(AppState& state, Func&& operation, bool route_scoped = true) {
+        app::CancellationToken token;
+        if (route_scoped) {
+            std::lock_guard<std::mutex> lock(route_mutex_);
+            token = route_tasks_.token();
         }
+        runWithToken(state, std::move(token), std::forward<Func>(operation));
     }
     
-    // Safe async operation that properly updates UI
+    // Same, for work whose lifetime the caller manages with its own token
     template<typename Func>
-    void runAsyncOperation(AppState& state, Func&& operation) {
-        std::thread([this, &state, op = std::forward<Func>(operation)]() {
-            try {
-                op();
-                if (!shutdown_requested_.load()) {
-                    postUpdate();
+    void runWithToken(AppState& state, app::CancellationToken token, Func&& operation) {
+        executor_.submit(
+            [&state, op = std::forward<Func>(operation)](const app::CancellationToken& token) {
+                try {
+                    op(token);
+                } catch (const std::exception& e) {
+                    state.setError("Operation failed: " + std::string(e.what()));
+                } catch (...) {
+                    state.setError("Unknown error occurred during operation");
                 }
-            } catch (const std::exception& e) {
-                state.setError("Operation failed: " + std::string(e.what()));
-                postUpdate();
-            } catch (...) {
-                state.setError("Unknown error occurred during operation");
-                postUpdate();
-            }
-        }).detach();
+            },
+            [] {},
+            token);
     }
 };
 
 // Global UI updater (will be initialized in RunApp)
 static std::unique_ptr<UIUpdater> g_ui_updater;
 
+// Animation frame for a visible spinner/progress widget; keeps frames coming
+// only while something animated is on screen.
+int AnimationFrame(const AppState& s) {
+  if (g_ui_updater) g_ui_updater->requestAnimationFrame();
+  return s.getAnimationFrame();
+}
+
+// Waits like sleep_for but returns false as soon as the token is cancelled
+bool SleepUnlessCancelled(const app::CancellationToken& token, std::chrono::milliseconds duration) {
+  auto deadline = std::chrono::steady_clock::now() + duration;
+  while (!token.cancelled()) {
+    auto left = deadline - std::chrono::steady_clock::now();
+    if (left <= std::chrono::steady_clock::duration::zero()) return true;
+    std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(left, std::chrono::milliseconds(50)));
+  }
+  return false;
+}
+
 // Utility: Convert Wei to ETH string
-std::string weiToEth(const std::string& wei) {
-  if (wei.empty() || wei == "0") return "0";
-  return wei + " Wei";
+std::string weiToEth(const app::U256& wei) {
+  return wei.toUnits(app::kEtherDecimals) + " ETH";
+}
+
+// Utility: Gwei text for a fee stored in Wei
+std::string weiToGwei(const std::optional<app::U256>& wei) {
+  return wei ? wei->toUnits(app::kGweiDecimals) : "";
 }
 
 // Utility: Format address for display (shorten if needed)
@@ -109,59 +191,97 @@ void loadAddressBook(AppState& s) {
   if (addr3) addresses.push_back(*addr3);
   
   s.setKnownAddresses(addresses);
+
+  // A configured book is mapped as-is; a JSON/CSV one is converted to the
+  // binary format next to it once, and again only when the source changes
+  if (auto book = app::OpenAddressBook(app::Config::getInstance().getAppConfig().address_book_path)) {
+    s.setAddressBook(std::move(book));
+  }
 }
 
-// Utility: Load USB contacts from mounted devices (thread-safe)
+// Signing work done while the user reviews the transaction: the unsigned
+// payload, its hash and the broadcast QR layout. Leaving Confirmation to
+// edit throws it away; Sign uses it if the fields still match.
+class SigningSpeculation {
+public:
+  void start(AppState& s) {
+    app::CancellationToken token;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_.reset();
+      token = pending_.token();
+      if (plan_ && plan_->matches(s.getUnsignedTx())) return;
+      plan_.reset();
+    }
+    if (!g_ui_updater) return;
+    g_ui_updater->runWithToken(s, token, [this, &s](const app::CancellationToken& token) {
+      auto plan = app::PlanSigning(s.getUnsignedTx());
+      if (!plan || token.cancelled()) return;
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!token.cancelled()) plan_ = std::make_shared<const app::SigningPlan>(std::move(*plan));
+    });
+  }
+  
+  void discard() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.reset();
+    plan_.reset();
+  }
+  
+  // The speculative plan if it is for tx; null while it is still being built
+  std::shared_ptr<const app::SigningPlan> ready(const UnsignedTx& tx) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return plan_ && plan_->matches(tx) ? plan_ : nullptr;
+  }
+  
+  // The speculative plan, or one built now if it is missing or stale
+  std::shared_ptr<const app::SigningPlan> planFor(const UnsignedTx& tx) const {
+    if (auto plan = ready(tx)) return plan;
+    auto plan = app::PlanSigning(tx);
+    return plan ? std::make_shared<const app::SigningPlan>(std::move(*plan)) : nullptr;
+  }
+  
+private:
+  mutable std::mutex mutex_;
+  std::shared_ptr<const app::SigningPlan> plan_;
+  app::CancellationSource pending_;
+};
+
+static SigningSpeculation g_speculation;
+
+// Log of transactions signed here, read for the next nonce; opened before
+// the first screen
+static app::TransactionHistory g_history;
+
+// This app has no signer yet, so signing stops at the payload the device
+// would sign. The Result screen shows it labelled as an unsigned preview;
+// nothing is QR-encoded for broadcast or logged as signed. Written by the
+// signing worker, read by the renderer (std::atomic_load/store).
+static std::shared_ptr<const app::SigningPlan> g_unsigned_preview;
+
+// Contact scanner shared by the USB screen and the 'u' shortcut
+static std::unique_ptr<app::UsbContactScanner> g_usb_scanner;
+
+// Utility: Load USB contacts from mounted devices (thread-safe). Contacts
+// appear batch by batch while the scan runs; leaving the screen cancels it.
 void loadUSBContacts(AppState& s) {
-  if (!g_ui_updater) return;
+  if (!g_ui_updater || !g_usb_scanner) return;
   
   s.setScanningUsb(true);
+  s.setUsbScanComplete(false);
   s.setUsbContacts({});  // Clear existing contacts
   
-  g_ui_updater->runAsyncOperation(s, [&s]() {
-    // Simulate USB scanning delay
-    std::this_thread::sleep_for(std::chrono::seconds(2));
-    
-    if (g_ui_updater->isShutdownRequested()) return;
-    
-    // Create mock USB contacts safely
-    std::vector<app::KnownAddress> contacts;
-    
-    auto contact1 = app::KnownAddress::create(
-      "0x742d35Cc6641C154db0bEF6a74B0742e5b4b4e7c", 
-      "bob.base.eth", 
-      "Base name for Bob", 
-      app::ContactType::Base
-    );
-    auto contact2 = app::KnownAddress::create(
-      "0x8ba1f109551bD432803012645Hac136c", 
-      "Team Multisig", 
-      "Development team multisig wallet", 
-      app::ContactType::Multisig
-    );
-    auto contact3 = app::KnownAddress::create(
-      "0x1234567890abcdef1234567890abcdef12345678", 
-      "DEX Contract", 
-      "Decentralized exchange contract", 
-      app::ContactType::Contract
-    );
-    auto contact4 = app::KnownAddress::create(
-      "0x9876543210fedcba9876543210fedcba98765432", 
-      "John Doe", 
-      "Personal wallet", 
-      app::ContactType::EOA
-    );
-    
-    if (contact1) contacts.push_back(*contact1);
-    if (contact2) contacts.push_back(*contact2);
-    if (contact3) contacts.push_back(*contact3);
-    if (contact4) contacts.push_back(*contact4);
-    
-    // Thread-safe state updates
-    s.setUsbContacts(contacts);
-    s.setScanningUsb(false);
-    s.setUsbScanComplete(true);
-  });
+  g_usb_scanner->start(
+    [&s](std::vector<app::KnownAddress> batch) {
+      if (!g_ui_updater || g_ui_updater->isShutdownRequested()) return;
+      s.appendUsbContacts(batch);
+    },
+    [&s](size_t, bool cancelled) {
+      if (cancelled) return;  // a newer scan or leaving the screen owns the flags
+      s.setScanningUsb(false);
+      s.setUsbScanComplete(true);
+      if (g_ui_updater && !g_ui_updater->isShutdownRequested()) g_ui_updater->postUpdate();
+    });
 }
 
 // Utility: Get contact type icon
@@ -188,6 +308,27 @@ Color getContactColor(app::ContactType type) {
   }
 }
 
+// Subtree memoised on the state version it was built from, plus an extra
+// key for view-local inputs such as a selection index. The animator redraws
+// every frame, but lists only change when a state setter publishes.
+class VersionedElement {
+public:
+  template <typename Build>
+  Element get(uint64_t version, int key, Build&& build) {
+    if (!element_ || version != version_ || key != key_) {
+      element_ = build();
+      version_ = version;
+      key_ = key;
+    }
+    return element_;
+  }
+
+private:
+  Element element_;
+  uint64_t version_ = 0;
+  int key_ = 0;
+};
+
 // Component: Animated spinner (no threading)
 Element Spinner(int frame) {
   const std::vector<std::string> frames = {
@@ -208,8 +349,9 @@ Element ProgressDots(int frame) {
 // Component: Status bar at bottom
 Component StatusBar(AppState& s) {
   return Renderer([&] {
-    auto left = text("Offline Signer • " + s.getNetworkName() + " (Chain " + std::to_string(s.getUnsignedTx().chain_id) + ")") | color(Color::GrayDark);
-    auto mid = s.getStatus().empty() ? text("") : text(" " + s.getStatus() + " ") | color(Color::Green);
+    auto snap = s.snapshot();
+    auto left = text("Offline Signer • " + snap->network_name + " (Chain " + std::to_string(snap->unsigned_tx.chain_id) + ")") | color(Color::GrayDark);
+    auto mid = snap->status.empty() ? text("") : text(" " + snap->status + " ") | color(Color::Green);
     auto right = text("hjkl:Move 1-5:Screens g:Home u:USB F1:Help") | color(Color::GrayDark);
     return hbox({ left, filler(), mid, filler(), right }) | bgcolor(Color::Black) | color(Color::Green);
   });
@@ -219,8 +361,9 @@ Component StatusBar(AppState& s) {
 Component Banner(AppState& s) {
   return Renderer([&]{
     Elements lines;
-    std::string error = s.getError();
-    std::string info = s.getInfo();
+    auto snap = s.snapshot();
+    const std::string& error = snap->error;
+    const std::string& info = snap->info;
     
     if (!error.empty()) {
       lines.push_back(hbox({
@@ -247,11 +390,12 @@ Component ConnectWalletView(AppState& s) {
     s.setDetectingWallet(true);
     s.clearError();
     
-    g_ui_updater->runAsyncOperation(s, [&s]() {
+    g_ui_updater->runAsyncOperation(s, [&s](const app::CancellationToken& token) {
       // Simulate wallet detection
-      std::this_thread::sleep_for(std::chrono::seconds(1));
-      
-      if (g_ui_updater->isShutdownRequested()) return;
+      if (!SleepUnlessCancelled(token, std::chrono::seconds(1))) {
+        s.setDetectingWallet(false);
+        return;
+      }
       
       // Create mock devices safely
       std::vector<app::DeviceInfo> devices = {
@@ -272,7 +416,9 @@ Component ConnectWalletView(AppState& s) {
     });
   });
   
-  auto content = Renderer(continue_btn, [&]{
+  auto device_list = std::make_shared<VersionedElement>();
+  
+  auto content = Renderer(continue_btn, [&, device_list]{
     Elements content;
     
     // Title
@@ -292,25 +438,29 @@ Component ConnectWalletView(AppState& s) {
     // Status
     if (s.isDetectingWallet()) {
       content.push_back(hbox({
-        Spinner(s.getAnimationFrame()),
+        Spinner(AnimationFrame(s)),
         text(" Detecting hardware wallets"),
-        ProgressDots(s.getAnimationFrame())
+        ProgressDots(AnimationFrame(s))
       }) | center);
     } else {
-      auto devices = s.getDevices();
-      if (!devices.empty()) {
-        content.push_back(text("Detected devices:") | dim);
-        for (const auto& dev : devices) {
-          std::string status = dev.connected ? "✓ Connected" : "✗ Not connected";
-          if (dev.connected && !dev.app_open) status += " (Open Ethereum app)";
-          content.push_back(hbox({
-            text("  • "),
-            text(dev.model) | bold,
-            text(" - "),
-            text(status) | (dev.connected ? color(Color::Green) : color(Color::Red))
-          }));
-        }
-        content.push_back(text(""));
+      auto snap = s.snapshot();
+      if (!snap->devices->empty()) {
+        content.push_back(device_list->get(snap->version, 0, [&]{
+          Elements lines;
+          lines.push_back(text("Detected devices:") | dim);
+          for (const auto& dev : *snap->devices) {
+            std::string status = dev.connected ? "✓ Connected" : "✗ Not connected";
+            if (dev.connected && !dev.app_open) status += " (Open Ethereum app)";
+            lines.push_back(hbox({
+              text("  • "),
+              text(dev.model) | bold,
+              text(" - "),
+              text(status) | (dev.connected ? color(Color::Green) : color(Color::Red))
+            }));
+          }
+          lines.push_back(text(""));
+          return vbox(std::move(lines));
+        }));
       }
     }
     
@@ -338,10 +488,11 @@ Component USBContactsView(AppState& s) {
   });
   
   auto select_btn = Button("Select Contact", [&]{
-    auto contacts = s.getUsbContacts();
+    auto snap = s.snapshot();
+    const auto& contacts = *snap->usb_contacts;
     int selected = s.getSelectedContact();
     if (!contacts.empty() && selected >= 0 && selected < static_cast<int>(contacts.size())) {
-      auto tx = s.getUnsignedTx();
+      auto tx = snap->unsigned_tx;
       tx.to = contacts[selected].address;
       s.setUnsignedTx(tx);
       s.setRoute(app::Route::TransactionInput);
@@ -353,64 +504,76 @@ Component USBContactsView(AppState& s) {
   });
   
   auto layout = Container::Horizontal({scan_btn, skip_btn, select_btn, back_btn});
+  auto contact_list = std::make_shared<VersionedElement>();
   
-  return Renderer(layout, [&]{
+  return Renderer(layout, [&, contact_list]{
     Elements content;
+    auto snap = s.snapshot();
+    const auto& contacts = *snap->usb_contacts;
     
     content.push_back(text(""));
     content.push_back(text("USB Contacts") | bold | center | color(Color::Green));
     content.push_back(text("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━") | center | color(Color::GrayDark));
     content.push_back(text(""));
     
-    if (s.isScanningUsb()) {
+    // Contacts found so far are listed under the spinner while a scan runs
+    bool scanning = s.isScanningUsb();
+    if (scanning) {
       content.push_back(hbox({
-        Spinner(s.getAnimationFrame()),
+        Spinner(AnimationFrame(s)),
         text(" Scanning USB devices for contacts.json files"),
-        ProgressDots(s.getAnimationFrame())
+        ProgressDots(AnimationFrame(s))
       }) | center | color(Color::GreenLight));
-    } else if (s.isUsbScanComplete()) {
-      auto contacts = s.getUsbContacts();
+      if (!contacts.empty()) content.push_back(text(""));
+    }
+    if (scanning || s.isUsbScanComplete()) {
       if (contacts.empty()) {
-        content.push_back(text("No contacts.json files found on USB devices") | center | color(Color::Yellow));
-        content.push_back(text("You can skip this step or manually scan again") | center | color(Color::GrayDark));
+        if (!scanning) {
+          content.push_back(text("No contacts.json files found on USB devices") | center | color(Color::Yellow));
+          content.push_back(text("You can skip this step or manually scan again") | center | color(Color::GrayDark));
+        }
       } else {
         content.push_back(text("Found " + std::to_string(contacts.size()) + " contacts:") | color(Color::GreenLight));
         content.push_back(text(""));
         
         int selected_contact = s.getSelectedContact();
-        // Display contacts with selection
-        for (size_t i = 0; i < contacts.size(); ++i) {
-          const auto& contact = contacts[i];
-          std::string icon = getContactIcon(contact.type);
-          Color typeColor = getContactColor(contact.type);
+        content.push_back(contact_list->get(snap->version, selected_contact, [&]{
+          Elements lines;
+          // Display contacts with selection
+          for (size_t i = 0; i < contacts.size(); ++i) {
+            const auto& contact = contacts[i];
+            std::string icon = getContactIcon(contact.type);
+            Color typeColor = getContactColor(contact.type);
           
-          Element line;
-          if (static_cast<int>(i) == selected_contact) {
-            line = hbox({
-              text("> ") | color(Color::Green) | bold,
-              text(icon + " ") | color(typeColor),
-              text(contact.name) | color(Color::Green) | bold,
-              text(" - ") | color(Color::GrayDark),
-              text(formatAddress(contact.address, true)) | color(Color::GreenLight)
-            }) | bgcolor(Color::Black);
-          } else {
-            line = hbox({
-              text("  "),
-              text(icon + " ") | color(typeColor),
-              text(contact.name) | color(Color::GreenLight),
-              text(" - ") | color(Color::GrayDark),
-              text(formatAddress(contact.address, true)) | color(Color::GrayDark)
-            });
-          }
-          content.push_back(line);
+            Element line;
+            if (static_cast<int>(i) == selected_contact) {
+              line = hbox({
+                text("> ") | color(Color::Green) | bold,
+                text(icon + " ") | color(typeColor),
+                text(contact.name) | color(Color::Green) | bold,
+                text(" - ") | color(Color::GrayDark),
+                text(formatAddress(contact.address, true)) | color(Color::GreenLight)
+              }) | bgcolor(Color::Black);
+            } else {
+              line = hbox({
+                text("  "),
+                text(icon + " ") | color(typeColor),
+                text(contact.name) | color(Color::GreenLight),
+                text(" - ") | color(Color::GrayDark),
+                text(formatAddress(contact.address, true)) | color(Color::GrayDark)
+              });
+            }
+            lines.push_back(line);
           
-          if (static_cast<int>(i) == selected_contact && !contact.description.empty()) {
-            content.push_back(hbox({
-              text("    "),
-              text(contact.description) | color(Color::GrayDark) | italic
-            }));
+            if (static_cast<int>(i) == selected_contact && !contact.description.empty()) {
+              lines.push_back(hbox({
+                text("    "),
+                text(contact.description) | color(Color::GrayDark) | italic
+              }));
+            }
           }
-        }
+          return vbox(std::move(lines));
+        }));
         
         content.push_back(text(""));
         content.push_back(text("Use j/k to navigate, Enter to select") | center | color(Color::GrayDark));
@@ -425,7 +588,6 @@ Component USBContactsView(AppState& s) {
     content.push_back(separator());
     
     // Buttons
-    auto contacts = s.getUsbContacts();
     content.push_back(hbox({
       filler(),
       scan_btn->Render(),
@@ -440,7 +602,8 @@ Component USBContactsView(AppState& s) {
     
     return vbox(std::move(content)) | border | size(WIDTH, EQUAL, 80) | center | bgcolor(Color::Black);
   }) | CatchEvent([&](Event e) {
-    auto contacts = s.getUsbContacts();
+    auto snap = s.snapshot();
+    const auto& contacts = *snap->usb_contacts;
     int selected = s.getSelectedContact();
     
     // Vim-like navigation for contacts
@@ -453,7 +616,7 @@ Component USBContactsView(AppState& s) {
       return true;
     }
     if (e == Event::Return && !contacts.empty() && selected >= 0 && selected < static_cast<int>(contacts.size())) {
-      auto tx = s.getUnsignedTx();
+      auto tx = snap->unsigned_tx;
       tx.to = contacts[selected].address;
       s.setUnsignedTx(tx);
       s.setRoute(app::Route::TransactionInput);
@@ -472,12 +635,13 @@ Component TransactionInputView(AppState& s) {
   // Use state-backed values instead of static variables
   auto tx = s.getUnsignedTx();
   static std::string to = tx.to;
-  static std::string value = tx.value;
-  static std::string nonce = tx.nonce;
-  static std::string gas_limit = tx.gas_limit.empty() ? "21000" : tx.gas_limit;
-  static std::string gas_price = tx.gas_price;
-  static std::string max_fee = tx.max_fee_per_gas;
-  static std::string max_priority = tx.max_priority_fee_per_gas;
+  static std::string value = tx.value ? tx.value->toDecimal() : "";
+  auto next_nonce = tx.nonce ? tx.nonce : g_history.nextNonce(tx.chain_id);
+  static std::string nonce = next_nonce ? std::to_string(*next_nonce) : "";
+  static std::string gas_limit = std::to_string(tx.gas_limit.value_or(21000));
+  static std::string gas_price = weiToGwei(tx.gas_price);
+  static std::string max_fee = weiToGwei(tx.max_fee_per_gas);
+  static std::string max_priority = weiToGwei(tx.max_priority_fee_per_gas);
   static std::string data = tx.data.empty() ? "0x" : tx.data;
   
   // Input components
@@ -498,31 +662,27 @@ Component TransactionInputView(AppState& s) {
   
   auto in_data = Input(&data, "0x");
   
+  // Each field is re-checked only when its text changes, along with the
+  // cross-field rules that read it
+  static app::TransactionFormValidator form_validation(s.useEip1559());
+  auto refresh_validation = [&s]{
+    form_validation.setEip1559(s.useEip1559());
+    form_validation.update(app::TxField::To, to);
+    form_validation.update(app::TxField::Value, value);
+    form_validation.update(app::TxField::Nonce, nonce);
+    form_validation.update(app::TxField::GasLimit, gas_limit);
+    form_validation.update(app::TxField::GasPrice, gas_price);
+    form_validation.update(app::TxField::MaxFee, max_fee);
+    form_validation.update(app::TxField::PriorityFee, max_priority);
+    form_validation.update(app::TxField::Data, data);
+  };
+  
   // Validation and next button
-  auto validate_and_continue = [&](){
-    // Clear previous errors
-    s.setFieldErrors({});
-    std::map<std::string, std::string> field_errors;
+  auto validate_and_continue = [&, refresh_validation](){
+    refresh_validation();
     
-    // Validate address
-    if (!app::IsAddress(to)) {
-      field_errors["to"] = "Invalid Ethereum address format";
-    }
-    
-    // Validate numeric fields
-    if (value.empty() || !app::IsNumeric(value)) {
-      field_errors["value"] = "Amount must be a number";
-    }
-    
-    if (nonce.empty() || !app::IsNumeric(nonce)) {
-      field_errors["nonce"] = "Nonce must be a number";
-    }
-    
-    if (gas_limit.empty() || !app::IsNumeric(gas_limit)) {
-      field_errors["gas_limit"] = "Gas limit must be a number";
-    }
-    
-    if (!field_errors.empty()) {
+    if (!form_validation.valid()) {
+      auto field_errors = form_validation.errors();
       std::string err = "Please fix the following errors:\n";
       for (const auto& [field, msg] : field_errors) {
         err += "  • " + msg + "\n";
@@ -532,28 +692,16 @@ Component TransactionInputView(AppState& s) {
       return;
     }
     
-    // Create and validate transaction
+    // Numbers were parsed as they were typed; the stored transaction keeps the values
     UnsignedTx new_tx = s.getUnsignedTx();
-    new_tx.to = to;
-    new_tx.value = value;
-    new_tx.nonce = nonce;
-    new_tx.gas_limit = gas_limit;
-    new_tx.data = data;
-    
-    if (s.useEip1559()) {
-      new_tx.max_fee_per_gas = max_fee;
-      new_tx.max_priority_fee_per_gas = max_priority;
-      new_tx.type = 2;
-    } else {
-      new_tx.gas_price = gas_price;
-      new_tx.type = 0;
-    }
+    form_validation.apply(new_tx);
     
     if (!s.setUnsignedTx(new_tx)) {
       s.setError("Failed to save transaction. Please check all fields.");
       return;
     }
     
+    s.setFieldErrors({});
     s.clearError();
     s.setRoute(app::Route::Confirmation);
   };
@@ -580,7 +728,20 @@ Component TransactionInputView(AppState& s) {
   
   auto layout = Container::Vertical(inputs);
   
-  return Renderer(layout, [&]{
+  return Renderer(layout, [&, refresh_validation]{
+    {
+      // Every keystroke redraws this view, so this runs once per key
+      static app::Histogram& validation_latency = app::Metrics::shared().histogram("validation.keystroke");
+      static uint64_t published_revision = 0;
+      app::ScopedLatency timer(validation_latency);
+      refresh_validation();
+      // Fields not typed into yet aren't flagged until the form is submitted
+      if (form_validation.revision() != published_revision) {
+        published_revision = form_validation.revision();
+        s.setFieldErrors(form_validation.errors(false));
+      }
+    }
+    
     Elements content;
     
     content.push_back(text("Enter Transaction Details") | bold | center | color(Color::Green));
@@ -593,13 +754,18 @@ Component TransactionInputView(AppState& s) {
       in_to->Render()
     }));
     
-    auto field_errors = s.getFieldErrors();
-    if (field_errors.count("to")) {
-      content.push_back(hbox({
-        text("") | size(WIDTH, EQUAL, 20),
-        text("  ⚠ " + field_errors.at("to")) | color(Color::Red)
-      }));
-    }
+    auto snap = s.snapshot();
+    const auto& field_errors = *snap->field_errors;
+    auto show_error = [&](const char* key) {
+      auto it = field_errors.find(key);
+      if (it != field_errors.end()) {
+        content.push_back(hbox({
+          text("") | size(WIDTH, EQUAL, 20),
+          text("  ⚠ " + it->second) | color(Color::Red)
+        }));
+      }
+    };
+    show_error("to");
     
     content.push_back(text(""));
     
@@ -608,12 +774,14 @@ Component TransactionInputView(AppState& s) {
       text("Amount (Wei):") | size(WIDTH, EQUAL, 20) | color(Color::GreenLight),
       in_value->Render()
     }));
-    if (!value.empty() && app::IsNumeric(value)) {
+    const auto& wei = form_validation.parsed().value;
+    if (wei) {
       content.push_back(hbox({
         text("") | size(WIDTH, EQUAL, 20),
-        text("  ≈ " + weiToEth(value)) | color(Color::GrayDark)
+        text("  = " + weiToEth(*wei)) | color(Color::GrayDark)
       }));
     }
+    show_error("value");
     
     content.push_back(text(""));
     
@@ -624,6 +792,8 @@ Component TransactionInputView(AppState& s) {
       text("  Gas Limit:") | size(WIDTH, EQUAL, 12),
       in_gas_limit->Render()
     }));
+    show_error("nonce");
+    show_error("gas_limit");
     
     content.push_back(text(""));
     
@@ -638,11 +808,14 @@ Component TransactionInputView(AppState& s) {
         text("Priority Fee:") | size(WIDTH, EQUAL, 20),
         Input(&max_priority, "Priority fee")->Render()
       }));
+      show_error("max_fee");
+      show_error("max_priority");
     } else {
       content.push_back(hbox({
         text("Gas Price (Gwei):") | size(WIDTH, EQUAL, 20),
         Input(&gas_price, "Gas price")->Render()
       }));
+      show_error("gas_price");
     }
     
     content.push_back(text(""));
@@ -652,6 +825,7 @@ Component TransactionInputView(AppState& s) {
       text("Data (hex):") | size(WIDTH, EQUAL, 20),
       in_data->Render()
     }));
+    show_error("data");
     
     content.push_back(text(""));
     content.push_back(separator());
@@ -678,27 +852,22 @@ Component ConfirmationView(AppState& s) {
     s.setSigning(true);
     s.setAnimationFrame(0);
     
-    g_ui_updater->runAsyncOperation(s, [&s]() {
-      // Simulate signing process
-      std::this_thread::sleep_for(std::chrono::seconds(3));
-      
-      if (g_ui_updater->isShutdownRequested()) return;
-      
-      // Mock signed transaction
-      auto tx = s.getUnsignedTx();
-      std::string signed_hex = "0xf86c0185046c7cfe0083016dea94" + 
-                               tx.to.substr(2) +
-                               "880de0b6b3a764000080269fc7eaaa9c21f59adf8ad43ed66cf5ef9ee1c317bd4d32cd65401e7aacbda51687";
-      
-      // Thread-safe state updates
-      if (s.setSignedHex(signed_hex)) {
+    g_ui_updater->runAsyncOperation(s, [&s](const app::CancellationToken& token) {
+      auto plan = g_speculation.planFor(s.getUnsignedTx());
+      if (token.cancelled()) {
         s.setSigning(false);
-        s.setRoute(app::Route::Result);
-      } else {
+        return;
+      }
+      if (!plan) {
         s.setSigning(false);
-        s.setError("Failed to process signed transaction");
+        s.setError("Transaction is incomplete and cannot be signed");
         s.setRoute(app::Route::Confirmation);
+        return;
       }
+      
+      std::atomic_store(&g_unsigned_preview, plan);
+      s.setSigning(false);
+      s.setRoute(app::Route::Result);
     });
   });
   
@@ -709,7 +878,8 @@ Component ConfirmationView(AppState& s) {
   auto layout = Container::Horizontal({sign_btn, edit_btn});
   
   return Renderer(layout, [&]{
-    auto tx = s.getUnsignedTx();
+    auto snap = s.snapshot();
+    const auto& tx = snap->unsigned_tx;
     
     Elements content;
     content.push_back(text("Review Transaction") | bold | center | color(Color::Green));
@@ -728,15 +898,11 @@ Component ConfirmationView(AppState& s) {
     }));
     
     // Check if known address
-    auto known_addresses = s.getKnownAddresses();
-    for (const auto& ka : known_addresses) {
-      if (ka.address == tx.to) {
-        details.push_back(hbox({
-          text("    "),
-          text("(" + ka.name + ")") | color(Color::Cyan)
-        }));
-        break;
-      }
+    if (auto known = s.findKnownAddress(tx.to)) {
+      details.push_back(hbox({
+        text("    "),
+        text("(" + known->name + ")") | color(Color::Cyan)
+      }));
     }
     
     details.push_back(text(""));
@@ -744,7 +910,7 @@ Component ConfirmationView(AppState& s) {
     // Amount
     details.push_back(hbox({
       text("Amount: ") | bold | color(Color::Green),
-      text(weiToEth(tx.value)) | color(Color::GreenLight)
+      text(tx.value ? weiToEth(*tx.value) : "-") | color(Color::GreenLight)
     }));
     
     details.push_back(text(""));
@@ -752,27 +918,27 @@ Component ConfirmationView(AppState& s) {
     // Transaction parameters
     details.push_back(hbox({
       text("Nonce: ") | bold | color(Color::Green),
-      text(tx.nonce) | color(Color::GreenLight)
+      text(tx.nonce ? std::to_string(*tx.nonce) : "-") | color(Color::GreenLight)
     }));
     
     details.push_back(hbox({
       text("Gas Limit: ") | bold | color(Color::Green),
-      text(tx.gas_limit) | color(Color::GreenLight)
+      text(tx.gas_limit ? std::to_string(*tx.gas_limit) : "-") | color(Color::GreenLight)
     }));
     
     if (tx.isEIP1559()) {
       details.push_back(hbox({
         text("Max Fee: ") | bold | color(Color::Green),
-        text(tx.max_fee_per_gas + " Gwei") | color(Color::GreenLight)
+        text(weiToGwei(tx.max_fee_per_gas) + " Gwei") | color(Color::GreenLight)
       }));
       details.push_back(hbox({
         text("Priority Fee: ") | bold | color(Color::Green),
-        text(tx.max_priority_fee_per_gas + " Gwei") | color(Color::GreenLight)
+        text(weiToGwei(tx.max_priority_fee_per_gas) + " Gwei") | color(Color::GreenLight)
       }));
     } else {
       details.push_back(hbox({
         text("Gas Price: ") | bold,
-        text(tx.gas_price + " Gwei")
+        text(weiToGwei(tx.gas_price) + " Gwei")
       }));
     }
     
@@ -791,6 +957,20 @@ Component ConfirmationView(AppState& s) {
     }));
     
     content.push_back(vbox(std::move(details)) | border);
+    
+    // Filled in by the speculative plan a moment after the screen opens
+    if (auto plan = g_speculation.ready(tx)) {
+      std::string hash = app::ToHex(plan->hash);
+      std::string layout = plan->qr_version > 0
+          ? "1 QR, version " + std::to_string(plan->qr_version)
+          : std::to_string(plan->qr_frames) + " QR frames";
+      content.push_back(hbox({
+        text("Signing hash: ") | dim,
+        text("0x" + hash.substr(0, 8) + "..." + hash.substr(hash.size() - 8)) | dim,
+        text("   Broadcast: ") | dim,
+        text(layout) | dim
+      }));
+    }
     content.push_back(text(""));
     
     // Warning
@@ -834,9 +1014,9 @@ Component SigningView(AppState& s) {
     // Animation and status
     content.push_back(hbox({
       filler(),
-      Spinner(s.getAnimationFrame()),
+      Spinner(AnimationFrame(s)),
       text("  Please confirm the transaction on your hardware wallet") | color(Color::Green),
-      ProgressDots(s.getAnimationFrame()),
+      ProgressDots(AnimationFrame(s)),
       filler()
     }) | bold);
     
@@ -844,7 +1024,8 @@ Component SigningView(AppState& s) {
     content.push_back(text(""));
     
     // Device-specific instructions
-    auto devices = s.getDevices();
+    auto snap = s.snapshot();
+    const auto& devices = *snap->devices;
     int selected_device = s.getSelectedDevice();
     if (selected_device >= 0 && selected_device < static_cast<int>(devices.size())) {
       const auto& device = devices[selected_device];
@@ -868,7 +1049,7 @@ Component SigningView(AppState& s) {
     content.push_back(text(""));
     
     // Progress indicator
-    int progress = (s.getAnimationFrame() * 5) % 100;
+    int progress = (AnimationFrame(s) * 5) % 100;
     std::string bar = "[";
     for (int i = 0; i < 40; ++i) {
       if (i < progress * 40 / 100) {
@@ -935,6 +1116,28 @@ Component ResultView(AppState& s) {
   return Renderer(layout, [&]{
     Elements content;
     
+    auto snap = s.snapshot();
+    const std::string& signed_hex = snap->signed_hex;
+    auto preview = std::atomic_load(&g_unsigned_preview);
+    if (signed_hex.empty() && preview && preview->matches(snap->unsigned_tx)) {
+      content.push_back(text("UNSIGNED PREVIEW - NOT A SIGNED TRANSACTION") | bold | center | color(Color::Yellow));
+      content.push_back(text("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━") | center | dim);
+      content.push_back(text(""));
+      content.push_back(text("No signer is connected in this build. This is the payload a device") | center | color(Color::Yellow));
+      content.push_back(text("would sign; it cannot be broadcast.") | center | color(Color::Yellow));
+      content.push_back(text(""));
+      
+      content.push_back(text("Signing hash: 0x" + app::ToHex(preview->hash)) | center | color(Color::GrayDark));
+      content.push_back(text("Unsigned payload:") | color(Color::GrayDark));
+      std::string payload = "0x" + app::ToHex(preview->payload.data(), preview->payload.size());
+      for (size_t i = 0; i < payload.length(); i += 64) {
+        content.push_back(text(payload.substr(i, 64)) | color(Color::GrayDark) | center);
+      }
+      content.push_back(text(""));
+      content.push_back(hbox({filler(), new_tx_btn->Render(), text("  "), exit_btn->Render(), filler()}));
+      return vbox(std::move(content)) | border | size(WIDTH, LESS_THAN, 120) | center;
+    }
+    
     content.push_back(text("Transaction Signed Successfully!") | bold | center | color(Color::Green));
     content.push_back(text("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━") | center | dim);
     content.push_back(text(""));
@@ -944,16 +1147,16 @@ Component ResultView(AppState& s) {
     content.push_back(text(""));
     
     // QR Code
-    std::string signed_hex = s.getSignedHex();
     if (!signed_hex.empty()) {
       try {
-        auto qrCode = app::GenerateQR(signed_hex);
-        std::string qrAscii = qrCode.toASCII();
+        // The animator redraws every 100ms; the cache encodes the symbol once
+        auto raster = app::QRRenderCache::shared().get(signed_hex, 0, 0, app::QRRenderStyle::HalfBlock);
+        if (raster->modules == 0) {
+          throw std::runtime_error("payload does not fit in a QR code");
+        }
         
-        std::istringstream stream(qrAscii);
-        std::string line;
         Elements qrLines;
-        while (std::getline(stream, line)) {
+        for (const auto& line : raster->rows) {
           qrLines.push_back(text(line) | center);
         }
         
@@ -1086,6 +1289,30 @@ Component SettingsView(AppState& s) {
   
   return Renderer(layout, [&]{
     auto tx = s.getUnsignedTx();
+    
+    // Live view of the in-process metrics (also written by --metrics-out)
+    auto metrics = app::Metrics::shared().snapshot();
+    auto cell = [](const std::string& value, int width) {
+      return text(value) | size(WIDTH, EQUAL, width);
+    };
+    Elements metric_rows;
+    metric_rows.push_back(hbox({
+      cell("Latency", 24), cell("count", 8), cell("p50", 9), cell("p99", 9), cell("max", 9)
+    }) | dim);
+    for (const auto& [name, h] : metrics.histograms) {
+      if (h.count == 0) continue;
+      metric_rows.push_back(hbox({
+        cell(name, 24),
+        cell(std::to_string(h.count), 8),
+        cell(app::FormatNanoseconds(h.percentileNs(50)), 9),
+        cell(app::FormatNanoseconds(h.percentileNs(99)), 9),
+        cell(app::FormatNanoseconds(h.max_ns), 9)
+      }));
+    }
+    for (const auto& [name, value] : metrics.counters) {
+      metric_rows.push_back(hbox({cell(name, 24), cell(std::to_string(value), 8)}));
+    }
+    
     return vbox({
       text("Settings") | bold | center,
       separator(),
@@ -1101,6 +1328,9 @@ Component SettingsView(AppState& s) {
       }),
       text(""),
       separator(),
+      text("Metrics") | bold,
+      vbox(std::move(metric_rows)),
+      separator(),
       hbox({
         filler(),
         save_btn->Render(),
@@ -1144,15 +1374,55 @@ Component MakeThreadSafeRoute(AppState& s) {
 int RunThreadSafeApp() {
   AppState state;
   
-  // Load address book on startup
-  loadAddressBook(state);
+  // Read before the first screen so the nonce field can be filled from it
+  {
+    app::StartupPhase phase("tx_history");
+    const auto& config = app::Config::getInstance().getAppConfig();
+    if (!config.transaction_history_path.empty()) {
+      g_history.open(config.transaction_history_path,
+                     static_cast<size_t>(std::max(config.max_transaction_history, 0)));
+    }
+  }
   
   // Use FitComponent for better terminal compatibility
   auto screen = ScreenInteractive::FitComponent();
   auto exit = screen.ExitLoopClosure();
   
   // Initialize global UI updater
-  g_ui_updater = std::make_unique<UIUpdater>(&screen);
+  g_ui_updater = std::make_unique<UIUpdater>(&screen, state);
+  g_usb_scanner = std::make_unique<app::UsbContactScanner>();
+  
+  // Work started for a screen, a USB scan included, only runs while it is open
+  state.addRouteChangeCallback([&state](app::Route from, app::Route to) {
+    if (g_ui_updater) g_ui_updater->routeChanged();
+    if (to == app::Route::Confirmation) {
+      g_speculation.start(state);
+    } else if (to == app::Route::TransactionInput) {
+      g_speculation.discard();
+    }
+    if (from == app::Route::USBContacts && to != app::Route::USBContacts && g_usb_scanner) {
+      g_usb_scanner->cancel();
+      state.setScanningUsb(false);
+    }
+  });
+  
+  // The address book is loaded (and imported, if stale) in the background
+  // the first time a screen that resolves addresses is opened
+  auto address_book_requested = std::make_shared<std::atomic<bool>>(false);
+  state.addRouteChangeCallback([&state, address_book_requested](app::Route, app::Route to) {
+    bool uses_book = to == app::Route::TransactionInput || to == app::Route::Confirmation ||
+                     to == app::Route::Result;
+    if (!uses_book || address_book_requested->exchange(true) || !g_ui_updater) return;
+    g_ui_updater->runAsyncOperation(state, [&state](const app::CancellationToken&) {
+      app::StartupPhase phase("address_book");
+      loadAddressBook(state);
+    }, /*route_scoped=*/false);
+  });
+  
+  // Redraw whenever a setter publishes a new snapshot
+  state.addChangeCallback([](uint64_t) {
+    if (g_ui_updater) g_ui_updater->postUpdate();
+  });
   
   // Main route renderer
   auto route = Renderer([&]{ 
@@ -1164,13 +1434,22 @@ int RunThreadSafeApp() {
   auto banner = Banner(state);
   auto status = StatusBar(state);
   
+  bool first_frame_drawn = false;
+  app::Histogram& render_latency = app::Metrics::shared().histogram("ui.render");
   auto root = Renderer(layout, [&]{
-    return vbox({ 
+    app::ScopedLatency frame_timer(render_latency);
+    auto frame = vbox({ 
       banner->Render(), 
       route->Render() | flex,
       separator(), 
       status->Render() 
     });
+    g_ui_updater->frameRendered();
+    if (!first_frame_drawn) {
+      first_frame_drawn = true;
+      screen.Post([] { app::StartupTrace::instance().mark("first_frame"); });
+    }
+    return frame;
   });
   
   // Global keyboard shortcuts (same as before)
@@ -1256,25 +1535,16 @@ int RunThreadSafeApp() {
     return false;
   });
   
-  // Managed animation loop (replaces the problematic detached thread)
-  std::thread animator([&state](){
-    while (!state.isShutdownRequested() && !g_ui_updater->isShutdownRequested()) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(100));
-      state.incrementAnimationFrame();
-      if (g_ui_updater) {
-        g_ui_updater->postUpdate();
-      }
-    }
-  });
-  
+  // Frames are scheduled on demand by g_ui_updater: an idle screen is not redrawn
   screen.Loop(root);
   
   // Clean shutdown
   state.requestShutdown();
+  state.clearCallbacks();
   if (g_ui_updater) {
     g_ui_updater->requestShutdown();
   }
-  animator.join();
+  g_usb_scanner.reset();  // joins the scan threads, whose callbacks use g_ui_updater
   g_ui_updater.reset();
   
   return 0;
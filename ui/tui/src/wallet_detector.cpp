@@ -2,9 +2,11 @@
 #include "app/logger.hpp"
 #include <iostream>
 #include <algorithm>
-#include <regex>
 #include <cstring>
 #include <iomanip>
+#include <cstdio>
+#include <unordered_map>
+#include <unordered_set>
 
 #ifdef _WIN32
     #include <windows.h>
@@ -17,18 +19,76 @@
     #include <CoreFoundation/CoreFoundation.h>
 #else
     #include <libusb-1.0/libusb.h>
+    #include <sys/time.h>
+    #define APP_USB_HOTPLUG 1
 #endif
 
 namespace app {
 
+namespace {
+
+constexpr uint16_t kLedgerVendorId = 0x2c97;
+
+// With hotplug events nothing needs polling, but rescan now and then anyway
+// so a missed event can't leave the device list stale forever.
+constexpr std::chrono::milliseconds kHotplugResyncInterval{30000};
+
+#ifdef APP_USB_HOTPLUG
+int LIBUSB_CALL OnHotplugEvent(libusb_context*, libusb_device*, libusb_hotplug_event event, void* user_data) {
+    // Reading descriptors is a synchronous transfer, which libusb forbids
+    // inside hotplug callbacks; hand the rescan to the detection thread.
+    LOG_DEBUG(event == LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED ? "USB hotplug: Ledger arrived"
+                                                           : "USB hotplug: Ledger left");
+    static_cast<WalletDetector*>(user_data)->requestRescan();
+    return 0; // Stay registered
+}
+
+// "bus-port.port...:vid:pid", unique per physical socket and device model
+std::string UsbDeviceKey(libusb_device* device, const libusb_device_descriptor& desc) {
+    uint8_t ports[8];
+    int depth = libusb_get_port_numbers(device, ports, sizeof(ports));
+    std::string key = std::to_string(libusb_get_bus_number(device));
+    for (int i = 0; i < depth; ++i) {
+        key += (i == 0 ? '-' : '.');
+        key += std::to_string(ports[i]);
+    }
+    char ids[16];
+    std::snprintf(ids, sizeof(ids), ":%04x:%04x", desc.idVendor, desc.idProduct);
+    return key + ids;
+}
+
+// "vid:pid", the same format as eth-signer-cpp
+std::string UsbDevicePath(const libusb_device_descriptor& desc) {
+    char path[16];
+    std::snprintf(path, sizeof(path), "%04x:%04x", desc.idVendor, desc.idProduct);
+    return path;
+}
+#endif
+
+} // namespace
+
 WalletDetector::WalletDetector() 
     : last_scan_time_(std::chrono::steady_clock::now())
     , last_connection_attempt_(std::chrono::steady_clock::now()) {
+#ifdef APP_USB_HOTPLUG
+    // One context for the detector's lifetime instead of one per scan
+    if (libusb_init(&usb_context_) < 0) {
+        LOG_ERROR("Failed to initialize libusb");
+        usb_context_ = nullptr;
+    }
+#endif
     LOG_DEBUG("WalletDetector initialized");
 }
 
 WalletDetector::~WalletDetector() {
     stopDetection();
+    clearDeviceTable();
+#ifdef APP_USB_HOTPLUG
+    if (usb_context_) {
+        libusb_exit(usb_context_);
+        usb_context_ = nullptr;
+    }
+#endif
     LOG_DEBUG("WalletDetector destroyed");
 }
 
@@ -46,12 +106,19 @@ bool WalletDetector::startDetection() {
     LOG_INFO("Performing initial device scan...");
     updateDeviceList();
     
+    bool hotplug = registerHotplug();
+    
     try {
         detection_thread_ = std::make_unique<std::thread>(&WalletDetector::detectionLoop, this);
-        LOG_INFO("Wallet detection started with 1-second polling");
+        if (hotplug) {
+            LOG_INFO("Wallet detection started with USB hotplug events");
+        } else {
+            LOG_INFOF("Wallet detection started with {}ms polling", poll_interval_.load().count());
+        }
         return true;
     } catch (const std::exception& e) {
-        LOG_ERROR("Failed to start detection thread: " + std::string(e.what()));
+        LOG_ERRORF("Failed to start detection thread: {}", e.what());
+        deregisterHotplug();
         is_detecting_.store(false);
         return false;
     }
@@ -63,12 +130,19 @@ void WalletDetector::stopDetection() {
     }
     
     should_stop_.store(true);
+    wake_cv_.notify_all();
+#ifdef APP_USB_HOTPLUG
+    if (hotplug_registered_.load() && usb_context_) {
+        libusb_interrupt_event_handler(usb_context_);
+    }
+#endif
     
     if (detection_thread_ && detection_thread_->joinable()) {
         detection_thread_->join();
     }
     
     detection_thread_.reset();
+    deregisterHotplug();
     is_detecting_.store(false);
     updateStatus(DetectionStatus::DISCONNECTED);
     
@@ -93,7 +167,7 @@ std::string WalletDetector::getLastError() const {
 void WalletDetector::setPollInterval(std::chrono::milliseconds interval) noexcept {
     if (interval.count() >= 500) { // Minimum 500ms for reasonable polling
         poll_interval_.store(interval);
-        LOG_DEBUG("Poll interval set to " + std::to_string(interval.count()) + "ms");
+        LOG_DEBUGF("Poll interval set to {}ms", interval.count());
     }
 }
 
@@ -121,7 +195,7 @@ bool WalletDetector::connectToDevice(const std::string& device_path) {
         });
     
     if (it == devices_.end()) {
-        LOG_WARN("Device not found: " + device_path);
+        LOG_WARNF("Device not found: {}", device_path);
         return false;
     }
     
@@ -143,9 +217,27 @@ bool WalletDetector::testConnection() {
     return testDeviceConnection(current_device_);
 }
 
+void WalletDetector::requestRescan() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        rescan_requested_.store(true);
+    }
+    wake_cv_.notify_all();
+}
+
 void WalletDetector::detectionLoop() {
     LOG_DEBUG("Detection loop started");
     
+    if (hotplug_registered_.load()) {
+        hotplugLoop();
+    } else {
+        pollLoop();
+    }
+    
+    LOG_DEBUG("Detection loop ended");
+}
+
+void WalletDetector::pollLoop() {
     while (!should_stop_.load()) {
         try {
             updateDeviceList();
@@ -153,17 +245,98 @@ void WalletDetector::detectionLoop() {
             // Just check device status, don't auto-connect
             // The status will be updated based on device detection in updateDeviceList()
             
-            // Sleep for poll interval
-            std::this_thread::sleep_for(poll_interval_.load());
+            // Sleep for poll interval, waking early for stop or a rescan request
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_cv_.wait_for(lock, poll_interval_.load(), [this] {
+                return should_stop_.load() || rescan_requested_.load();
+            });
+            rescan_requested_.store(false);
             
         } catch (const std::exception& e) {
-            LOG_ERROR("Error in detection loop: " + std::string(e.what()));
+            LOG_ERRORF("Error in detection loop: {}", e.what());
             notifyError("Detection error: " + std::string(e.what()));
             std::this_thread::sleep_for(std::chrono::seconds(1));
         }
     }
+}
+
+void WalletDetector::hotplugLoop() {
+#ifdef APP_USB_HOTPLUG
+    while (!should_stop_.load()) {
+        try {
+            // A Ledger that enumerated but can't be opened yet (udev rules
+            // still applying, or claimed elsewhere) raises no further events,
+            // so keep retrying it at the poll interval.
+            bool retry_pending = false;
+            {
+                std::lock_guard<std::mutex> lock(devices_mutex_);
+                retry_pending = std::any_of(devices_.begin(), devices_.end(),
+                    [](const WalletDevice& device) { return !device.connected; });
+            }
+            auto timeout = retry_pending ? poll_interval_.load() : kHotplugResyncInterval;
+            
+            // Blocks in the kernel until a hotplug event, the timeout, or
+            // libusb_interrupt_event_handler from stopDetection
+            timeval tv;
+            tv.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+            tv.tv_usec = static_cast<suseconds_t>((timeout.count() % 1000) * 1000);
+            int rc = libusb_handle_events_timeout_completed(usb_context_, &tv, nullptr);
+            if (rc < 0 && rc != LIBUSB_ERROR_INTERRUPTED) {
+                LOG_WARNF("libusb event handling failed: {}", libusb_error_name(rc));
+            }
+            if (should_stop_.load()) {
+                break;
+            }
+            
+            rescan_requested_.store(false);
+            updateDeviceList();
+            
+        } catch (const std::exception& e) {
+            LOG_ERRORF("Error in detection loop: {}", e.what());
+            notifyError("Detection error: " + std::string(e.what()));
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+        }
+    }
+#else
+    pollLoop();
+#endif
+}
+
+bool WalletDetector::registerHotplug() {
+#ifdef APP_USB_HOTPLUG
+    if (hotplug_registered_.load()) {
+        return true;
+    }
+    if (!usb_context_ || !libusb_has_capability(LIBUSB_CAP_HAS_HOTPLUG)) {
+        LOG_INFO("USB hotplug not supported, falling back to polling");
+        return false;
+    }
     
-    LOG_DEBUG("Detection loop ended");
+    // No ENUMERATE flag: startDetection has just scanned the bus itself
+    int rc = libusb_hotplug_register_callback(
+        usb_context_,
+        static_cast<libusb_hotplug_event>(LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED | LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT),
+        static_cast<libusb_hotplug_flag>(0),
+        kLedgerVendorId, LIBUSB_HOTPLUG_MATCH_ANY, LIBUSB_HOTPLUG_MATCH_ANY,
+        OnHotplugEvent, this, &hotplug_handle_);
+    if (rc != LIBUSB_SUCCESS) {
+        LOG_WARNF("USB hotplug registration failed ({}), falling back to polling", libusb_error_name(rc));
+        return false;
+    }
+    
+    hotplug_registered_.store(true);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void WalletDetector::deregisterHotplug() {
+#ifdef APP_USB_HOTPLUG
+    if (hotplug_registered_.exchange(false) && usb_context_) {
+        libusb_hotplug_deregister_callback(usb_context_, hotplug_handle_);
+    }
+#endif
 }
 
 void WalletDetector::updateStatus(DetectionStatus new_status) {
@@ -176,12 +349,12 @@ void WalletDetector::updateStatus(DetectionStatus new_status) {
             try {
                 status_change_callback_(new_status);
             } catch (const std::exception& e) {
-                LOG_ERROR("Error in status change callback: " + std::string(e.what()));
+                LOG_ERRORF("Error in status change callback: {}", e.what());
             }
         }
         
-        LOG_DEBUG("Status changed from " + getDeviceStatusString(old_status) + 
-                 " to " + getDeviceStatusString(new_status));
+        LOG_DEBUGF("Status changed from {} to {}", getDeviceStatusString(old_status),
+                   getDeviceStatusString(new_status));
     }
 }
 
@@ -191,7 +364,7 @@ void WalletDetector::notifyDeviceFound(const WalletDevice& device) {
         try {
             device_found_callback_(device);
         } catch (const std::exception& e) {
-            LOG_ERROR("Error in device found callback: " + std::string(e.what()));
+            LOG_ERRORF("Error in device found callback: {}", e.what());
         }
     }
 }
@@ -207,7 +380,7 @@ void WalletDetector::notifyError(const std::string& error) {
         try {
             error_callback_(error);
         } catch (const std::exception& e) {
-            LOG_ERROR("Error in error callback: " + std::string(e.what()));
+            LOG_ERRORF("Error in error callback: {}", e.what());
         }
     }
 }
@@ -224,9 +397,6 @@ bool WalletDetector::testDeviceConnection(const WalletDevice& device) {
         return false;
     }
     
-    // Simulate connection test delay
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    
 #ifdef _WIN32
     // Windows: Test if device is accessible via SetupAPI
     // This is a simplified test - in practice you'd try to open the device
@@ -266,53 +436,65 @@ bool WalletDetector::testDeviceConnection(const WalletDevice& device) {
     return false;
     
 #else
-    // Linux: Test if device is accessible via libusb
-    // This is a simplified test - in practice you'd try to open the device
-    libusb_context* context = nullptr;
-    if (libusb_init(&context) < 0) {
+    // Linux: reuse the handle opened when the device entered the table and
+    // issue a GET_STATUS request, which fails once the device is gone
+    std::lock_guard<std::mutex> lock(table_mutex_);
+    auto it = device_table_.find(device.key);
+    if (it == device_table_.end()) {
         return false;
     }
     
-    libusb_device** device_list;
-    ssize_t device_count = libusb_get_device_list(context, &device_list);
-    bool found = false;
-    
-    if (device_count >= 0) {
-        for (ssize_t i = 0; i < device_count; i++) {
-            libusb_device* usb_device = device_list[i];
-            libusb_device_descriptor desc;
-            
-            if (libusb_get_device_descriptor(usb_device, &desc) == 0) {
-                if (desc.idVendor == 0x2c97) {
-                    // Try to open the device to test connection
-                    libusb_device_handle* handle;
-                    if (libusb_open(usb_device, &handle) == 0) {
-                        libusb_close(handle);
-                        found = true;
-                        break;
-                    }
-                }
-            }
-        }
-        libusb_free_device_list(device_list, 1);
+    CachedUsbDevice& entry = it->second;
+    if (!entry.handle && !openCachedDevice(entry)) {
+        return false;
     }
     
-    libusb_exit(context);
-    return found;
+    unsigned char status[2];
+    int rc = libusb_control_transfer(entry.handle, 0x80 /* device-to-host, standard */,
+                                     0x00 /* GET_STATUS */, 0, 0, status, sizeof(status), 1000);
+    if (rc < 0) {
+        LOG_DEBUGF("Connection test failed: {}", libusb_error_name(rc));
+        libusb_close(entry.handle);
+        entry.handle = nullptr;
+        entry.device.connected = false;
+        return false;
+    }
+    return true;
 #endif
 }
 
 void WalletDetector::updateDeviceList() {
-    auto new_devices = scanForDevices();
+    std::vector<WalletDevice> new_devices;
+    if (device_source_) {
+        new_devices = device_source_();
+    } else {
+#ifdef APP_USB_HOTPLUG
+        new_devices = scanDeviceTable();
+#else
+        new_devices = scanForDevices(usb_context_);
+#endif
+    }
     
     {
         std::lock_guard<std::mutex> lock(devices_mutex_);
         
+        // Whether each known device was accessible on the previous scan
+        std::unordered_map<std::string, bool> old_connected;
+        old_connected.reserve(devices_.size());
+        for (const auto& device : devices_) {
+            old_connected.emplace(device.key, device.connected);
+        }
+        std::unordered_set<std::string> new_keys;
+        new_keys.reserve(new_devices.size());
+        for (const auto& device : new_devices) {
+            new_keys.insert(device.key);
+        }
+        
         // Check for new devices
         for (const auto& new_device : new_devices) {
-            auto it = std::find(devices_.begin(), devices_.end(), new_device);
-            if (it == devices_.end()) {
-                LOG_INFO("New device detected: " + new_device.product);
+            auto old = old_connected.find(new_device.key);
+            if (old == old_connected.end()) {
+                LOG_INFOF("New device detected: {}", new_device.product);
                 notifyDeviceFound(new_device);
                 
                 // If this is a connected Ledger device, update status
@@ -321,21 +503,25 @@ void WalletDetector::updateDeviceList() {
                     // Set as current device
                     current_device_ = new_device;
                 }
+            } else if (!old->second && new_device.connected &&
+                       isLedgerDevice(new_device.manufacturer, new_device.product) &&
+                       status_.load() == DetectionStatus::DISCONNECTED) {
+                // A device that became accessible after its arrival (udev
+                // rules applied late). CONNECTING and ERROR belong to a
+                // connection attempt and are left alone.
+                current_device_ = new_device;
+                updateStatus(DetectionStatus::CONNECTED);
             }
         }
         
         // Check for removed devices
-        for (auto it = devices_.begin(); it != devices_.end();) {
-            auto new_it = std::find(new_devices.begin(), new_devices.end(), *it);
-            if (new_it == new_devices.end()) {
-                LOG_INFO("Device removed: " + it->product);
-                if (current_device_.path == it->path) {
+        for (const auto& old_device : devices_) {
+            if (new_keys.count(old_device.key) == 0) {
+                LOG_INFOF("Device removed: {}", old_device.product);
+                if (current_device_.key == old_device.key) {
                     current_device_.connected = false;
                     updateStatus(DetectionStatus::DISCONNECTED);
                 }
-                it = devices_.erase(it);
-            } else {
-                ++it;
             }
         }
         
@@ -358,8 +544,132 @@ void WalletDetector::updateDeviceList() {
     }
 }
 
+std::vector<WalletDevice> WalletDetector::scanDeviceTable() {
+    std::vector<WalletDevice> devices;
+#ifdef APP_USB_HOTPLUG
+    if (!usb_context_) {
+        return scanForDevices(nullptr);
+    }
+    
+    libusb_device** device_list;
+    ssize_t device_count = libusb_get_device_list(usb_context_, &device_list);
+    if (device_count < 0) {
+        LOG_ERRORF("Failed to list USB devices: {}", libusb_error_name(static_cast<int>(device_count)));
+        return devices;
+    }
+    
+    std::lock_guard<std::mutex> lock(table_mutex_);
+    std::unordered_set<std::string> present;
+    for (ssize_t i = 0; i < device_count; i++) {
+        libusb_device* usb_device = device_list[i];
+        libusb_device_descriptor desc;
+        
+        // Descriptors are cached by libusb; this does no USB I/O
+        if (libusb_get_device_descriptor(usb_device, &desc) != 0 || desc.idVendor != kLedgerVendorId) {
+            continue;
+        }
+        
+        std::string key = UsbDeviceKey(usb_device, desc);
+        present.insert(key);
+        
+        auto it = device_table_.find(key);
+        if (it != device_table_.end() && it->second.usb_device != usb_device) {
+            // Re-plugged into the same port between scans
+            closeCachedDevice(it->second);
+            device_table_.erase(it);
+            it = device_table_.end();
+        }
+        
+        if (it == device_table_.end()) {
+            CachedUsbDevice entry;
+            entry.usb_device = libusb_ref_device(usb_device);
+            entry.device.manufacturer = "Ledger";
+            entry.device.product = "Ledger Device";
+            entry.device.path = UsbDevicePath(desc);
+            entry.device.key = key;
+            it = device_table_.emplace(key, entry).first;
+            openCachedDevice(it->second);
+        } else if (!it->second.handle) {
+            // Still inaccessible; udev may have fixed permissions since
+            openCachedDevice(it->second);
+        }
+        
+        devices.push_back(it->second.device);
+    }
+    libusb_free_device_list(device_list, 1);
+    
+    for (auto it = device_table_.begin(); it != device_table_.end();) {
+        if (present.count(it->first) == 0) {
+            closeCachedDevice(it->second);
+            it = device_table_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+#endif
+    return devices;
+}
+
+bool WalletDetector::openCachedDevice(CachedUsbDevice& entry) {
+#ifdef APP_USB_HOTPLUG
+    if (libusb_open(entry.usb_device, &entry.handle) != 0) {
+        entry.handle = nullptr;
+        entry.device.connected = false;
+        return false;
+    }
+    
+    libusb_device_descriptor desc;
+    if (libusb_get_device_descriptor(entry.usb_device, &desc) == 0) {
+        char product[256];
+        if (libusb_get_string_descriptor_ascii(entry.handle, desc.iProduct,
+                                              (unsigned char*)product,
+                                              sizeof(product)) > 0) {
+            entry.device.product = product;
+        }
+    }
+    // Device is accessible, mark as connected
+    entry.device.connected = true;
+    return true;
+#else
+    (void)entry;
+    return false;
+#endif
+}
+
+void WalletDetector::closeCachedDevice(CachedUsbDevice& entry) {
+#ifdef APP_USB_HOTPLUG
+    if (entry.handle) {
+        libusb_close(entry.handle);
+        entry.handle = nullptr;
+    }
+    if (entry.usb_device) {
+        libusb_unref_device(entry.usb_device);
+        entry.usb_device = nullptr;
+    }
+#else
+    (void)entry;
+#endif
+}
+
+void WalletDetector::clearDeviceTable() {
+    std::lock_guard<std::mutex> lock(table_mutex_);
+    for (auto& item : device_table_) {
+        closeCachedDevice(item.second);
+    }
+    device_table_.clear();
+}
+
 std::vector<WalletDevice> WalletDetector::scanForDevices() {
+    return scanForDevices(nullptr);
+}
+
+// `context` is the detector's long-lived libusb context; when null (static
+// callers) a temporary one is created for this scan.
+std::vector<WalletDevice> WalletDetector::scanForDevices(libusb_context* context) {
     std::vector<WalletDevice> devices;
+#ifndef APP_USB_HOTPLUG
+    (void)context;
+#endif
     
 #ifdef _WIN32
     // Windows implementation using SetupAPI
@@ -401,6 +711,7 @@ std::vector<WalletDevice> WalletDetector::scanForDevices() {
                     device.product = "Ledger Device";
                 }
                 
+                device.key = device.path;
                 devices.push_back(device);
             }
         }
@@ -466,6 +777,7 @@ std::vector<WalletDevice> WalletDetector::scanForDevices() {
                         
                         // Mark as connected (device is accessible via IOKit)
                         device.connected = true;
+                        device.key = device.path;
                         devices.push_back(device);
                     }
                 }
@@ -479,10 +791,13 @@ std::vector<WalletDevice> WalletDetector::scanForDevices() {
     
 #else
     // Linux implementation using libusb
-    libusb_context* context = nullptr;
-    if (libusb_init(&context) < 0) {
-        LOG_ERROR("Failed to initialize libusb");
-        return devices;
+    libusb_context* owned_context = nullptr;
+    if (!context) {
+        if (libusb_init(&owned_context) < 0) {
+            LOG_ERROR("Failed to initialize libusb");
+            return devices;
+        }
+        context = owned_context;
     }
     
     libusb_device** device_list;
@@ -519,11 +834,8 @@ std::vector<WalletDevice> WalletDetector::scanForDevices() {
                     }
                     
                     // Create device path
-                    std::stringstream path_stream;
-                    path_stream << std::hex << std::setfill('0') 
-                               << std::setw(4) << desc.idVendor << ":"
-                               << std::setw(4) << desc.idProduct;
-                    wallet_device.path = path_stream.str();
+                    wallet_device.path = UsbDevicePath(desc);
+                    wallet_device.key = UsbDeviceKey(device, desc);
                     
                     devices.push_back(wallet_device);
                 }
@@ -532,7 +844,9 @@ std::vector<WalletDevice> WalletDetector::scanForDevices() {
         libusb_free_device_list(device_list, 1);
     }
     
-    libusb_exit(context);
+    if (owned_context) {
+        libusb_exit(owned_context);
+    }
 #endif
     
     return devices;
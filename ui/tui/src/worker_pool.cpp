@@ -0,0 +1,91 @@
+#include "app/worker_pool.hpp"
+#include <algorithm>
+
+namespace app {
+
+WorkerPool::WorkerPool(size_t num_threads) {
+  if (num_threads == 0) num_threads = 1;
+  workers_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_.emplace_back([this] { workerLoop(); });
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    if (worker.joinable()) worker.join();
+  }
+}
+
+void WorkerPool::submit(std::function<void()> job) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(std::move(job));
+  }
+  cv_.notify_one();
+}
+
+void WorkerPool::workerLoop() {
+  for (;;) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+      if (stopping_ && jobs_.empty()) return;
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+    job();
+  }
+}
+
+bool WorkerPool::runOne() {
+  std::function<void()> job;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (jobs_.empty()) return false;
+    job = std::move(jobs_.front());
+    jobs_.pop_front();
+  }
+  job();
+  return true;
+}
+
+void WorkerPool::parallelFor(size_t count, const std::function<void(size_t)>& fn) {
+  if (count == 0) return;
+  if (count == 1) {
+    try { fn(0); } catch (...) {}
+    return;
+  }
+
+  std::mutex done_mutex;
+  std::condition_variable done_cv;
+  size_t remaining = count;
+
+  for (size_t i = 0; i < count; ++i) {
+    submit([&, i] {
+      try { fn(i); } catch (...) {}
+      std::lock_guard<std::mutex> lock(done_mutex);
+      if (--remaining == 0) done_cv.notify_all();
+    });
+  }
+
+  // Help out instead of idling; this also keeps nested calls from deadlocking
+  // when every worker is itself blocked inside parallelFor.
+  while (runOne()) {}
+
+  std::unique_lock<std::mutex> lock(done_mutex);
+  done_cv.wait(lock, [&] { return remaining == 0; });
+}
+
+WorkerPool& WorkerPool::shared() {
+  static WorkerPool pool(std::min<size_t>(8, std::max(1u, std::thread::hardware_concurrency())));
+  return pool;
+}
+
+} // namespace app